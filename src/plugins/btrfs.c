@@ -269,6 +269,28 @@ static BDBtrfsSubvolumeInfo* get_subvolume_info_from_match (GMatchInfo *match_in
     return ret;
 }
 
+/* state of parsing the 'btrfs subvol list' output line by line */
+typedef struct SubvolumeListParse {
+    GRegex *regex;
+    GPtrArray *subvol_infos;
+    guint n_lines;
+} SubvolumeListParse;
+
+static gboolean parse_subvolume_line (const gchar *line, gpointer user_data) {
+    SubvolumeListParse *parse = (SubvolumeListParse *) user_data;
+    GMatchInfo *match_info = NULL;
+
+    if (*line == '\0')
+        return TRUE;
+    parse->n_lines++;
+
+    if (g_regex_match (parse->regex, line, 0, &match_info))
+        g_ptr_array_add (parse->subvol_infos, get_subvolume_info_from_match (match_info));
+    g_match_info_free (match_info);
+
+    return TRUE;
+}
+
 static BDBtrfsFilesystemInfo* get_filesystem_info_from_match (GMatchInfo *match_info) {
     BDBtrfsFilesystemInfo *ret = g_new(BDBtrfsFilesystemInfo, 1);
     gchar *item = NULL;
@@ -685,16 +707,12 @@ BDBtrfsDeviceInfo** bd_btrfs_list_devices (const gchar *device, GError **error)
  */
 BDBtrfsSubvolumeInfo** bd_btrfs_list_subvolumes (const gchar *mountpoint, gboolean snapshots_only, GError **error) {
     const gchar *argv[7] = {"btrfs", "subvol", "list", "-p", NULL, NULL, NULL};
-    gchar *output = NULL;
     gboolean success = FALSE;
-    gchar **lines = NULL;
-    gchar **line_p = NULL;
     gchar const * const pattern = "ID\\s+(?P<id>\\d+)\\s+gen\\s+\\d+\\s+(cgen\\s+\\d+\\s+)?" \
                                   "parent\\s+(?P<parent_id>\\d+)\\s+top\\s+level\\s+\\d+\\s+" \
                                   "(otime\\s+\\d{4}-\\d{2}-\\d{2}\\s+\\d\\d:\\d\\d:\\d\\d\\s+)?"\
                                   "path\\s+(?P<path>\\S+)";
-    GRegex *regex = NULL;
-    GMatchInfo *match_info = NULL;
+    SubvolumeListParse parse = {NULL, NULL, 0};
     guint64 i = 0;
     guint64 y = 0;
     guint64 next_sorted_idx = 0;
@@ -713,50 +731,39 @@ BDBtrfsSubvolumeInfo** bd_btrfs_list_subvolumes (const gchar *mountpoint, gboole
     } else
         argv[4] = mountpoint;
 
-    regex = g_regex_new (pattern, G_REGEX_EXTENDED, 0, error);
-    if (!regex) {
+    parse.regex = g_regex_new (pattern, G_REGEX_EXTENDED, 0, error);
+    if (!parse.regex) {
         bd_utils_log_format (BD_UTILS_LOG_WARNING, "Failed to create new GRegex");
         /* error is already populated */
         return NULL;
     }
 
-    success = bd_utils_exec_and_capture_output (argv, NULL, &output, error);
+    /* the list can be huge, parse it as it comes instead of keeping it all in memory */
+    subvol_infos = parse.subvol_infos = g_ptr_array_new_with_free_func ((GDestroyNotify) bd_btrfs_subvolume_info_free);
+    success = bd_utils_exec_and_process_lines (argv, NULL, parse_subvolume_line, &parse,
+                                               BD_UTILS_EXEC_DEFAULT_MAX_STDERR, error);
+    g_regex_unref (parse.regex);
     if (!success) {
-        g_regex_unref (regex);
-        if (g_error_matches (*error,  BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_NOOUT)) {
-            /* no output -> no subvolumes */
-            g_clear_error (error);
-            return g_new0 (BDBtrfsSubvolumeInfo*, 1);
-        } else {
-            /* error is already populated from the call above or simply no output*/
-            return NULL;
-        }
+        /* error is already populated from the call above */
+        g_ptr_array_free (subvol_infos, TRUE);
+        return NULL;
     }
 
-    lines = g_strsplit (output, "\n", 0);
-    g_free (output);
-
-    subvol_infos = g_ptr_array_new ();
-    for (line_p = lines; *line_p; line_p++) {
-        success = g_regex_match (regex, *line_p, 0, &match_info);
-        if (!success) {
-            g_match_info_free (match_info);
-            continue;
-        }
-
-        g_ptr_array_add (subvol_infos, get_subvolume_info_from_match (match_info));
-        g_match_info_free (match_info);
+    if (parse.n_lines == 0) {
+        /* no output -> no subvolumes */
+        g_ptr_array_free (subvol_infos, TRUE);
+        return g_new0 (BDBtrfsSubvolumeInfo*, 1);
     }
 
-    g_strfreev (lines);
-    g_regex_unref (regex);
-
     if (subvol_infos->len == 0) {
         g_set_error (error, BD_BTRFS_ERROR, BD_BTRFS_ERROR_PARSE, "Failed to parse information about subvolumes");
         g_ptr_array_free (subvol_infos, TRUE);
         return NULL;
     }
 
+    /* the items are moved to the result below */
+    g_ptr_array_set_free_func (subvol_infos, NULL);
+
     /* now we know how much space to allocate for the result (subvols + NULL) */
     ret = g_new0 (BDBtrfsSubvolumeInfo*, subvol_infos->len + 1);
 
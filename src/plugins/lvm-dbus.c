@@ -28,6 +28,9 @@
 #include "check_deps.h"
 #include "dm_logging.h"
 #include "vdo_stats.h"
+#include "lvm_dm.h"
+#include "lvm_placement.h"
+#include "lvm_report.h"
 
 #define INT_FLOAT_EPS 1e-5
 #define SECTOR_SIZE 512
@@ -73,8 +76,13 @@ static gchar *global_config_str = NULL;
 #define VDO_POOL_INTF LVM_BUS_NAME".VdoPool"
 #define DBUS_PROPS_IFACE "org.freedesktop.DBus.Properties"
 #define DBUS_INTRO_IFACE "org.freedesktop.DBus.Introspectable"
+#define DBUS_OBJ_MANAGER_IFACE "org.freedesktop.DBus.ObjectManager"
+#define DBUS_TOP_IFACE "org.freedesktop.DBus"
+#define DBUS_TOP_OBJ "/org/freedesktop/DBus"
 #define METHOD_CALL_TIMEOUT 5000
-#define PROGRESS_WAIT 500 * 1000 /* microseconds */
+#define PROGRESS_WAIT 500 * 1000 /* microseconds, fallback polling interval for jobs */
+#define OBJECT_CACHE_DRAIN_INTERVAL (5 * G_USEC_PER_SEC) /* how often queued signals are applied to the object cache */
+#define OBJECT_CACHE_IDLE_TIMEOUT (60 * G_USEC_PER_SEC)  /* how long an unused object cache is kept */
 
 #define UNUSED __attribute__((unused))
 
@@ -223,6 +231,9 @@ BDLVMCacheStats* bd_lvm_cache_stats_copy (BDLVMCacheStats *data) {
     new->write_hits = data->write_hits;
     new->write_misses = data->write_misses;
     new->mode = data->mode;
+    new->promotions = data->promotions;
+    new->demotions = data->demotions;
+    new->cache_dirty = data->cache_dirty;
 
     return new;
 }
@@ -231,6 +242,316 @@ void bd_lvm_cache_stats_free (BDLVMCacheStats *data) {
     g_free (data);
 }
 
+BDLVMCacheSettings* bd_lvm_cache_settings_new (const gchar *policy, gint64 migration_threshold, gint64 sequential_threshold,
+                                               gint64 random_threshold) {
+    BDLVMCacheSettings *ret = g_new0 (BDLVMCacheSettings, 1);
+
+    ret->policy = g_strdup (policy);
+    ret->migration_threshold = migration_threshold;
+    ret->sequential_threshold = sequential_threshold;
+    ret->random_threshold = random_threshold;
+
+    return ret;
+}
+
+BDLVMCacheSettings* bd_lvm_cache_settings_copy (BDLVMCacheSettings *data) {
+    if (data == NULL)
+        return NULL;
+
+    return bd_lvm_cache_settings_new (data->policy, data->migration_threshold, data->sequential_threshold,
+                                      data->random_threshold);
+}
+
+void bd_lvm_cache_settings_free (BDLVMCacheSettings *data) {
+    if (data == NULL)
+        return;
+
+    g_free (data->policy);
+    g_free (data);
+}
+
+BDLVMPVSEGdata* bd_lvm_pvsegdata_copy (BDLVMPVSEGdata *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMPVSEGdata *new_data = g_new0 (BDLVMPVSEGdata, 1);
+
+    new_data->pv_uuid = g_strdup (data->pv_uuid);
+    new_data->lv_uuid = g_strdup (data->lv_uuid);
+    new_data->pv_start_pe = data->pv_start_pe;
+    new_data->size_pe = data->size_pe;
+    new_data->pv_index = data->pv_index;
+    new_data->lv_index = data->lv_index;
+    return new_data;
+}
+
+void bd_lvm_pvsegdata_free (BDLVMPVSEGdata *data) {
+    if (data == NULL)
+        return;
+
+    g_free (data->pv_uuid);
+    g_free (data->lv_uuid);
+    g_free (data);
+}
+
+BDLVMInventory* bd_lvm_inventory_copy (BDLVMInventory *data) {
+    guint i = 0;
+
+    if (data == NULL)
+        return NULL;
+
+    BDLVMInventory *new_data = g_new0 (BDLVMInventory, 1);
+
+    new_data->n_vgs = data->n_vgs;
+    new_data->vgs = g_new0 (BDLVMVGdata*, data->n_vgs + 1);
+    for (i=0; i < data->n_vgs; i++)
+        new_data->vgs[i] = bd_lvm_vgdata_copy (data->vgs[i]);
+
+    new_data->n_pvs = data->n_pvs;
+    new_data->pvs = g_new0 (BDLVMPVdata*, data->n_pvs + 1);
+    new_data->pv_vgs = g_new0 (gint, data->n_pvs);
+    for (i=0; i < data->n_pvs; i++) {
+        new_data->pvs[i] = bd_lvm_pvdata_copy (data->pvs[i]);
+        new_data->pv_vgs[i] = data->pv_vgs[i];
+    }
+
+    new_data->n_lvs = data->n_lvs;
+    new_data->lvs = g_new0 (BDLVMLVdata*, data->n_lvs + 1);
+    new_data->lv_vgs = g_new0 (gint, data->n_lvs);
+    for (i=0; i < data->n_lvs; i++) {
+        new_data->lvs[i] = bd_lvm_lvdata_copy (data->lvs[i]);
+        new_data->lv_vgs[i] = data->lv_vgs[i];
+    }
+
+    new_data->n_pvsegs = data->n_pvsegs;
+    new_data->pvsegs = g_new0 (BDLVMPVSEGdata*, data->n_pvsegs + 1);
+    for (i=0; i < data->n_pvsegs; i++)
+        new_data->pvsegs[i] = bd_lvm_pvsegdata_copy (data->pvsegs[i]);
+
+    return new_data;
+}
+
+void bd_lvm_inventory_free (BDLVMInventory *data) {
+    guint i = 0;
+
+    if (data == NULL)
+        return;
+
+    for (i=0; i < data->n_vgs; i++)
+        bd_lvm_vgdata_free (data->vgs[i]);
+    g_free (data->vgs);
+    for (i=0; i < data->n_pvs; i++)
+        bd_lvm_pvdata_free (data->pvs[i]);
+    g_free (data->pvs);
+    for (i=0; i < data->n_lvs; i++)
+        bd_lvm_lvdata_free (data->lvs[i]);
+    g_free (data->lvs);
+    for (i=0; i < data->n_pvsegs; i++)
+        bd_lvm_pvsegdata_free (data->pvsegs[i]);
+    g_free (data->pvsegs);
+    g_free (data->pv_vgs);
+    g_free (data->lv_vgs);
+    g_free (data);
+}
+
+BDLVMCachedLVStats* bd_lvm_cached_lv_stats_copy (BDLVMCachedLVStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMCachedLVStats *new_data = g_new0 (BDLVMCachedLVStats, 1);
+
+    new_data->vg_name = g_strdup (data->vg_name);
+    new_data->lv_name = g_strdup (data->lv_name);
+    new_data->stats = bd_lvm_cache_stats_copy (data->stats);
+
+    return new_data;
+}
+
+void bd_lvm_cached_lv_stats_free (BDLVMCachedLVStats *data) {
+    if (data == NULL)
+        return;
+
+    g_free (data->vg_name);
+    g_free (data->lv_name);
+    bd_lvm_cache_stats_free (data->stats);
+    g_free (data);
+}
+
+BDLVMThPoolStats* bd_lvm_thpool_stats_copy (BDLVMThPoolStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMThPoolStats *new = g_new0 (BDLVMThPoolStats, 1);
+
+    new->transaction_id = data->transaction_id;
+    new->data_block_size = data->data_block_size;
+    new->data_size = data->data_size;
+    new->data_used = data->data_used;
+    new->md_block_size = data->md_block_size;
+    new->md_size = data->md_size;
+    new->md_used = data->md_used;
+    new->held_md_root = data->held_md_root;
+    new->mode = data->mode;
+    new->needs_check = data->needs_check;
+    new->error_if_no_space = data->error_if_no_space;
+
+    return new;
+}
+
+void bd_lvm_thpool_stats_free (BDLVMThPoolStats *data) {
+    g_free (data);
+}
+
+BDLVMThLVStats* bd_lvm_thlv_stats_copy (BDLVMThLVStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMThLVStats *new = g_new0 (BDLVMThLVStats, 1);
+
+    new->mapped = data->mapped;
+    new->highest_mapped = data->highest_mapped;
+    new->failed = data->failed;
+
+    return new;
+}
+
+void bd_lvm_thlv_stats_free (BDLVMThLVStats *data) {
+    g_free (data);
+}
+
+BDLVMWritecacheSettings* bd_lvm_writecache_settings_new (gint64 high_watermark, gint64 low_watermark, gint64 writeback_jobs,
+                                                         gint64 autocommit_blocks, gint64 autocommit_time, gint64 block_size,
+                                                         gint64 cleaner) {
+    BDLVMWritecacheSettings *ret = g_new0 (BDLVMWritecacheSettings, 1);
+
+    ret->high_watermark = high_watermark;
+    ret->low_watermark = low_watermark;
+    ret->writeback_jobs = writeback_jobs;
+    ret->autocommit_blocks = autocommit_blocks;
+    ret->autocommit_time = autocommit_time;
+    ret->block_size = block_size;
+    ret->cleaner = cleaner;
+
+    return ret;
+}
+
+BDLVMWritecacheSettings* bd_lvm_writecache_settings_copy (BDLVMWritecacheSettings *data) {
+    if (data == NULL)
+        return NULL;
+
+    return bd_lvm_writecache_settings_new (data->high_watermark, data->low_watermark, data->writeback_jobs,
+                                           data->autocommit_blocks, data->autocommit_time, data->block_size,
+                                           data->cleaner);
+}
+
+void bd_lvm_writecache_settings_free (BDLVMWritecacheSettings *data) {
+    g_free (data);
+}
+
+BDLVMVDOTuning* bd_lvm_vdo_tuning_new (gint64 cpu_threads, gint64 bio_threads, gint64 ack_threads, gint64 hash_zone_threads,
+                                       gint64 logical_threads, gint64 physical_threads, gint64 block_map_cache_size,
+                                       gint64 bio_rotation) {
+    BDLVMVDOTuning *ret = g_new0 (BDLVMVDOTuning, 1);
+
+    ret->cpu_threads = cpu_threads;
+    ret->bio_threads = bio_threads;
+    ret->ack_threads = ack_threads;
+    ret->hash_zone_threads = hash_zone_threads;
+    ret->logical_threads = logical_threads;
+    ret->physical_threads = physical_threads;
+    ret->block_map_cache_size = block_map_cache_size;
+    ret->bio_rotation = bio_rotation;
+
+    return ret;
+}
+
+BDLVMVDOTuning* bd_lvm_vdo_tuning_copy (BDLVMVDOTuning *data) {
+    if (data == NULL)
+        return NULL;
+
+    return bd_lvm_vdo_tuning_new (data->cpu_threads, data->bio_threads, data->ack_threads, data->hash_zone_threads,
+                                  data->logical_threads, data->physical_threads, data->block_map_cache_size,
+                                  data->bio_rotation);
+}
+
+void bd_lvm_vdo_tuning_free (BDLVMVDOTuning *data) {
+    g_free (data);
+}
+
+BDLVMRaidStats* bd_lvm_raid_stats_copy (BDLVMRaidStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMRaidStats *new = g_new0 (BDLVMRaidStats, 1);
+
+    new->raid_type = g_strdup (data->raid_type);
+    new->dev_count = data->dev_count;
+    new->dev_health = g_strdup (data->dev_health);
+    new->failed_devs = data->failed_devs;
+    new->sync_size = data->sync_size;
+    new->sync_done = data->sync_done;
+    new->sync_percent = data->sync_percent;
+    new->sync_action = g_strdup (data->sync_action);
+    new->mismatch_count = data->mismatch_count;
+
+    return new;
+}
+
+void bd_lvm_raid_stats_free (BDLVMRaidStats *data) {
+    if (data == NULL)
+        return;
+
+    g_free (data->raid_type);
+    g_free (data->dev_health);
+    g_free (data->sync_action);
+    g_free (data);
+}
+
+BDLVMPlacement* bd_lvm_placement_copy (BDLVMPlacement *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMPlacement *new = g_new0 (BDLVMPlacement, 1);
+
+    new->pvs = g_strdupv (data->pvs);
+    new->stripes = data->stripes;
+    new->stripe_size = data->stripe_size;
+    new->rotational = data->rotational;
+
+    return new;
+}
+
+void bd_lvm_placement_free (BDLVMPlacement *data) {
+    if (data == NULL)
+        return;
+
+    g_strfreev (data->pvs);
+    g_free (data);
+}
+
+BDLVMWritecacheStats* bd_lvm_writecache_stats_copy (BDLVMWritecacheStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMWritecacheStats *new = g_new0 (BDLVMWritecacheStats, 1);
+
+    new->block_size = data->block_size;
+    new->total_blocks = data->total_blocks;
+    new->free_blocks = data->free_blocks;
+    new->writeback_blocks = data->writeback_blocks;
+    new->read_blocks = data->read_blocks;
+    new->read_hits = data->read_hits;
+    new->write_blocks = data->write_blocks;
+    new->write_hits = data->write_hits;
+    new->error = data->error;
+
+    return new;
+}
+
+void bd_lvm_writecache_stats_free (BDLVMWritecacheStats *data) {
+    g_free (data);
+}
+
 static gboolean setup_dbus_connection (GError **error) {
     gchar *addr = NULL;
 
@@ -257,6 +578,371 @@ static gboolean setup_dbus_connection (GError **error) {
     return TRUE;
 }
 
+/* client-side cache of the objects exported by lvmdbusd, seeded by a single
+   GetManagedObjects call and kept up to date using the ObjectManager and
+   PropertiesChanged signals */
+typedef struct ObjectCache {
+    GMainContext *context;  /* signal callbacks are dispatched here (only with the lock held) */
+    guint signal_ids[4];
+    GHashTable *objects;    /* object path -> (interface -> properties (a{sv})), NULL if not seeded */
+    GThread *drain_thread;  /* applies the queued signals periodically, drops the cache when unused */
+    gboolean stopping;      /* tells @drain_thread to exit */
+    gint64 last_used;       /* monotonic time of the last lock_object_cache() */
+} ObjectCache;
+
+/* protects the object_cache pointer as well as the cache itself, the signal
+   callbacks below are only dispatched with the lock held */
+static GMutex object_cache_lock;
+static GCond object_cache_cond;
+static ObjectCache *object_cache = NULL;
+
+static void object_cache_add_interfaces (GHashTable *objects, const gchar *obj_path, GVariant *ifaces) {
+    GHashTable *obj_ifaces = NULL;
+    GVariantIter iter;
+    const gchar *iface = NULL;
+    GVariant *props = NULL;
+
+    obj_ifaces = g_hash_table_lookup (objects, obj_path);
+    if (!obj_ifaces) {
+        obj_ifaces = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+        g_hash_table_insert (objects, g_strdup (obj_path), obj_ifaces);
+    }
+
+    g_variant_iter_init (&iter, ifaces);
+    while (g_variant_iter_next (&iter, "{&s@a{sv}}", &iface, &props))
+        g_hash_table_replace (obj_ifaces, g_strdup (iface), props);
+}
+
+static void object_cache_interfaces_added (GDBusConnection *connection UNUSED, const gchar *sender UNUSED,
+                                           const gchar *obj_path UNUSED, const gchar *iface UNUSED,
+                                           const gchar *signal UNUSED, GVariant *params, gpointer user_data) {
+    ObjectCache *cache = (ObjectCache *) user_data;
+    const gchar *path = NULL;
+    GVariant *ifaces = NULL;
+
+    if (!cache->objects || !g_variant_check_format_string (params, "(&o@a{sa{sv}})", FALSE))
+        return;
+
+    g_variant_get (params, "(&o@a{sa{sv}})", &path, &ifaces);
+    object_cache_add_interfaces (cache->objects, path, ifaces);
+    g_variant_unref (ifaces);
+}
+
+static void object_cache_interfaces_removed (GDBusConnection *connection UNUSED, const gchar *sender UNUSED,
+                                             const gchar *obj_path UNUSED, const gchar *iface UNUSED,
+                                             const gchar *signal UNUSED, GVariant *params, gpointer user_data) {
+    ObjectCache *cache = (ObjectCache *) user_data;
+    const gchar *path = NULL;
+    GVariantIter *iter = NULL;
+    const gchar *removed = NULL;
+    GHashTable *obj_ifaces = NULL;
+
+    if (!cache->objects || !g_variant_check_format_string (params, "(&oas)", FALSE))
+        return;
+
+    g_variant_get (params, "(&oas)", &path, &iter);
+    obj_ifaces = g_hash_table_lookup (cache->objects, path);
+    if (obj_ifaces) {
+        while (g_variant_iter_next (iter, "&s", &removed))
+            g_hash_table_remove (obj_ifaces, removed);
+        if (g_hash_table_size (obj_ifaces) == 0)
+            g_hash_table_remove (cache->objects, path);
+    }
+    g_variant_iter_free (iter);
+}
+
+static void object_cache_properties_changed (GDBusConnection *connection UNUSED, const gchar *sender UNUSED,
+                                             const gchar *obj_path, const gchar *iface UNUSED,
+                                             const gchar *signal UNUSED, GVariant *params, gpointer user_data) {
+    ObjectCache *cache = (ObjectCache *) user_data;
+    const gchar *intf = NULL;
+    GVariant *changed = NULL;
+    GVariant *invalidated = NULL;
+    GHashTable *obj_ifaces = NULL;
+    GVariant *props = NULL;
+    GVariantDict dict;
+    GVariantIter iter;
+    const gchar *prop = NULL;
+    GVariant *value = NULL;
+
+    if (!cache->objects || !g_variant_check_format_string (params, "(&s@a{sv}@as)", FALSE))
+        return;
+
+    g_variant_get (params, "(&s@a{sv}@as)", &intf, &changed, &invalidated);
+    obj_ifaces = g_hash_table_lookup (cache->objects, obj_path);
+    props = obj_ifaces ? g_hash_table_lookup (obj_ifaces, intf) : NULL;
+    if (!props) {
+        /* not known (yet), the whole interface will come with InterfacesAdded */
+        g_variant_unref (changed);
+        g_variant_unref (invalidated);
+        return;
+    }
+
+    if (g_variant_n_children (invalidated) > 0) {
+        /* we don't know the new values, just drop everything and start over
+           next time the cache is used */
+        g_hash_table_unref (cache->objects);
+        cache->objects = NULL;
+    } else {
+        g_variant_dict_init (&dict, props);
+        g_variant_iter_init (&iter, changed);
+        while (g_variant_iter_next (&iter, "{&sv}", &prop, &value)) {
+            g_variant_dict_insert_value (&dict, prop, value);
+            g_variant_unref (value);
+        }
+        g_hash_table_replace (obj_ifaces, g_strdup (intf), g_variant_ref_sink (g_variant_dict_end (&dict)));
+    }
+
+    g_variant_unref (changed);
+    g_variant_unref (invalidated);
+}
+
+static void object_cache_owner_changed (GDBusConnection *connection UNUSED, const gchar *sender UNUSED,
+                                        const gchar *obj_path UNUSED, const gchar *iface UNUSED,
+                                        const gchar *signal UNUSED, GVariant *params UNUSED, gpointer user_data) {
+    ObjectCache *cache = (ObjectCache *) user_data;
+
+    /* lvmdbusd (re)started or exited, nothing we have is valid anymore */
+    if (cache->objects) {
+        g_hash_table_unref (cache->objects);
+        cache->objects = NULL;
+    }
+}
+
+static gpointer object_cache_drain (gpointer user_data);
+
+static ObjectCache* object_cache_new (void) {
+    ObjectCache *cache = g_new0 (ObjectCache, 1);
+
+    /* signals are delivered in the thread-default main context of the
+       subscription, the private context is only iterated with the lock held
+       (when the cache is used and periodically by the drain thread) so that
+       the signals don't pile up in it */
+    cache->context = g_main_context_new ();
+    g_main_context_push_thread_default (cache->context);
+    cache->signal_ids[0] = g_dbus_connection_signal_subscribe (bus, LVM_BUS_NAME, DBUS_OBJ_MANAGER_IFACE, "InterfacesAdded",
+                                                               LVM_OBJ_PREFIX, NULL, G_DBUS_SIGNAL_FLAGS_NONE,
+                                                               object_cache_interfaces_added, cache, NULL);
+    cache->signal_ids[1] = g_dbus_connection_signal_subscribe (bus, LVM_BUS_NAME, DBUS_OBJ_MANAGER_IFACE, "InterfacesRemoved",
+                                                               LVM_OBJ_PREFIX, NULL, G_DBUS_SIGNAL_FLAGS_NONE,
+                                                               object_cache_interfaces_removed, cache, NULL);
+    cache->signal_ids[2] = g_dbus_connection_signal_subscribe (bus, LVM_BUS_NAME, DBUS_PROPS_IFACE, "PropertiesChanged",
+                                                               NULL, NULL, G_DBUS_SIGNAL_FLAGS_NONE,
+                                                               object_cache_properties_changed, cache, NULL);
+    cache->signal_ids[3] = g_dbus_connection_signal_subscribe (bus, DBUS_TOP_IFACE, DBUS_TOP_IFACE, "NameOwnerChanged",
+                                                               DBUS_TOP_OBJ, LVM_BUS_NAME, G_DBUS_SIGNAL_FLAGS_NONE,
+                                                               object_cache_owner_changed, cache, NULL);
+    g_main_context_pop_thread_default (cache->context);
+
+    cache->last_used = g_get_monotonic_time ();
+    cache->drain_thread = g_thread_new ("bd-lvm-dbus-cache", object_cache_drain, cache);
+
+    return cache;
+}
+
+/* must not be called for a cache with a running drain thread, see object_cache_stop() */
+static void object_cache_free (ObjectCache *cache) {
+    guint i = 0;
+
+    /* one-shot caches (see object_cache_fetch()) have no signal subscriptions */
+    if (cache->context) {
+        for (i=0; i < G_N_ELEMENTS (cache->signal_ids); i++)
+            g_dbus_connection_signal_unsubscribe (bus, cache->signal_ids[i]);
+
+        /* get rid of the signals possibly still waiting for dispatch */
+        while (g_main_context_iteration (cache->context, FALSE));
+        g_main_context_unref (cache->context);
+    }
+
+    if (cache->objects)
+        g_hash_table_unref (cache->objects);
+    g_free (cache);
+}
+
+/**
+ * object_cache_drain: (skip)
+ *
+ * Applies the signals queued in @user_data's context every
+ * %OBJECT_CACHE_DRAIN_INTERVAL and frees the cache (unsubscribing from the
+ * signals) once it's not used for %OBJECT_CACHE_IDLE_TIMEOUT. A new cache is
+ * created and seeded by the next lock_object_cache() call then.
+ */
+static gpointer object_cache_drain (gpointer user_data) {
+    ObjectCache *cache = (ObjectCache *) user_data;
+
+    g_mutex_lock (&object_cache_lock);
+    while (!cache->stopping) {
+        g_cond_wait_until (&object_cache_cond, &object_cache_lock,
+                           g_get_monotonic_time () + OBJECT_CACHE_DRAIN_INTERVAL);
+        if (cache->stopping)
+            break;
+
+        while (g_main_context_iteration (cache->context, FALSE));
+
+        if (g_get_monotonic_time () - cache->last_used > OBJECT_CACHE_IDLE_TIMEOUT) {
+            if (object_cache == cache)
+                object_cache = NULL;
+            g_thread_unref (cache->drain_thread);
+            cache->drain_thread = NULL;
+            object_cache_free (cache);
+            break;
+        }
+    }
+    g_mutex_unlock (&object_cache_lock);
+
+    return NULL;
+}
+
+/**
+ * object_cache_stop: (skip)
+ *
+ * Stops the drain thread of the global object cache (if any) and frees the
+ * cache. Must be called without @object_cache_lock held.
+ */
+static void object_cache_stop (void) {
+    ObjectCache *cache = NULL;
+    GThread *thread = NULL;
+
+    g_mutex_lock (&object_cache_lock);
+    cache = object_cache;
+    object_cache = NULL;
+    if (cache) {
+        cache->stopping = TRUE;
+        thread = cache->drain_thread;
+        cache->drain_thread = NULL;
+        g_cond_broadcast (&object_cache_cond);
+    }
+    g_mutex_unlock (&object_cache_lock);
+
+    if (cache) {
+        g_thread_join (thread);
+        object_cache_free (cache);
+    }
+}
+
+static gboolean object_cache_seed (ObjectCache *cache, GError **error) {
+    GVariant *ret = NULL;
+    GVariant *objects = NULL;
+    GVariantIter iter;
+    const gchar *obj_path = NULL;
+    GVariant *ifaces = NULL;
+
+    ret = g_dbus_connection_call_sync (bus, LVM_BUS_NAME, LVM_OBJ_PREFIX, DBUS_OBJ_MANAGER_IFACE,
+                                       "GetManagedObjects", NULL, G_VARIANT_TYPE ("(a{oa{sa{sv}}})"),
+                                       G_DBUS_CALL_FLAGS_NONE, -1, NULL, error);
+    if (!ret)
+        return FALSE;
+
+    /* signals received before the reply are already reflected in it, drop
+       them (the callbacks ignore them with no objects in the cache) */
+    while (g_main_context_iteration (cache->context, FALSE));
+
+    cache->objects = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_hash_table_unref);
+    g_variant_get (ret, "(@a{oa{sa{sv}}})", &objects);
+    g_variant_iter_init (&iter, objects);
+    while (g_variant_iter_next (&iter, "{&o@a{sa{sv}}}", &obj_path, &ifaces)) {
+        object_cache_add_interfaces (cache->objects, obj_path, ifaces);
+        g_variant_unref (ifaces);
+    }
+    g_variant_unref (objects);
+    g_variant_unref (ret);
+
+    return TRUE;
+}
+
+/**
+ * lock_object_cache: (skip)
+ *
+ * Returns: (transfer none): the up-to-date object cache locked with
+ *          @object_cache_lock or %NULL if the cache cannot be used (with the
+ *          lock released), the caller should query lvmdbusd directly then
+ */
+static ObjectCache* lock_object_cache (void) {
+    GError *l_error = NULL;
+
+    g_mutex_lock (&object_cache_lock);
+    if (!object_cache)
+        object_cache = object_cache_new ();
+    object_cache->last_used = g_get_monotonic_time ();
+
+    /* apply the changes signalled since the cache was used last time */
+    while (g_main_context_iteration (object_cache->context, FALSE));
+
+    if (!object_cache->objects && !object_cache_seed (object_cache, &l_error)) {
+        g_debug ("Failed to get the managed objects from lvmdbusd, not using the object cache: %s",
+                 l_error->message);
+        g_clear_error (&l_error);
+        g_mutex_unlock (&object_cache_lock);
+        return NULL;
+    }
+
+    return object_cache;
+}
+
+static void unlock_object_cache (void) {
+    g_mutex_unlock (&object_cache_lock);
+}
+
+/* returns a new reference to the cached properties of the @iface interface of
+   the @obj_path object or %NULL if not known */
+static GVariant* object_cache_get_properties (ObjectCache *cache, const gchar *obj_path, const gchar *iface) {
+    GHashTable *obj_ifaces = NULL;
+    GVariant *props = NULL;
+
+    obj_ifaces = g_hash_table_lookup (cache->objects, obj_path);
+    if (obj_ifaces)
+        props = g_hash_table_lookup (obj_ifaces, iface);
+
+    return props ? g_variant_ref (props) : NULL;
+}
+
+static const gchar *const lv_obj_prefixes[] = {LV_OBJ_PREFIX, THIN_POOL_OBJ_PREFIX, CACHE_POOL_OBJ_PREFIX,
+                                               VDO_POOL_OBJ_PREFIX, HIDDEN_LV_OBJ_PREFIX, NULL};
+
+static guint obj_path_rank (const gchar *obj_path) {
+    guint i = 0;
+
+    for (i=0; lv_obj_prefixes[i]; i++)
+        if (g_str_has_prefix (obj_path, lv_obj_prefixes[i]) && obj_path[strlen (lv_obj_prefixes[i])] == '/')
+            return i;
+    return i;
+}
+
+/* sorts the object paths the same way lvmdbusd lists them (LVs of the same
+   type together, in the order of their numeric IDs) */
+static gint compare_obj_paths (gconstpointer a, gconstpointer b) {
+    const gchar *path_a = *((const gchar **) a);
+    const gchar *path_b = *((const gchar **) b);
+    guint rank_a = obj_path_rank (path_a);
+    guint rank_b = obj_path_rank (path_b);
+    gsize len_a = strlen (path_a);
+    gsize len_b = strlen (path_b);
+
+    if (rank_a != rank_b)
+        return rank_a < rank_b ? -1 : 1;
+    if (len_a != len_b)
+        return len_a < len_b ? -1 : 1;
+    return strcmp (path_a, path_b);
+}
+
+/* returns a NULL-terminated list of paths of the cached objects implementing
+   the @iface interface */
+static gchar** object_cache_get_objects (ObjectCache *cache, const gchar *iface) {
+    GPtrArray *ret = g_ptr_array_new ();
+    GHashTableIter iter;
+    const gchar *obj_path = NULL;
+    GHashTable *obj_ifaces = NULL;
+
+    g_hash_table_iter_init (&iter, cache->objects);
+    while (g_hash_table_iter_next (&iter, (gpointer *) &obj_path, (gpointer *) &obj_ifaces))
+        if (g_hash_table_contains (obj_ifaces, iface))
+            g_ptr_array_add (ret, g_strdup (obj_path));
+    g_ptr_array_sort (ret, compare_obj_paths);
+    g_ptr_array_add (ret, NULL);
+
+    return (gchar **) g_ptr_array_free (ret, FALSE);
+}
+
 static volatile guint avail_dbus_deps = 0;
 static volatile guint avail_features = 0;
 static volatile guint avail_module_deps = 0;
@@ -356,6 +1042,11 @@ gboolean bd_lvm_init (void) {
 void bd_lvm_close (void) {
     GError *error = NULL;
 
+    object_cache_stop ();
+
+    /* close the VDO statistics files kept open (if any) */
+    vdo_stats_close_all ();
+
     /* the check() call should create the DBus connection for us, but let's not
        completely rely on it */
     if (!g_dbus_connection_flush_sync (bus, NULL, &error))
@@ -629,24 +1320,149 @@ static GVariant* call_lvm_method (const gchar *obj, const gchar *intf, const gch
     bd_utils_log_task_status (*task_id, log_msg);
     g_free (log_msg);
 
-    /* now do the call with all the parameters */
-    ret = g_dbus_connection_call_sync (bus, LVM_BUS_NAME, obj, intf, method, all_params,
-                                       NULL, G_DBUS_CALL_FLAGS_NONE, METHOD_CALL_TIMEOUT, NULL, error);
+    /* now do the call with all the parameters */
+    ret = g_dbus_connection_call_sync (bus, LVM_BUS_NAME, obj, intf, method, all_params,
+                                       NULL, G_DBUS_CALL_FLAGS_NONE, METHOD_CALL_TIMEOUT, NULL, error);
+
+    if (lock_config)
+         g_mutex_unlock (&global_config_lock);
+    prog_msg = g_strdup_printf ("Started the '%s.%s' method on the '%s' object with the following parameters: '%s'",
+                               intf, method, obj, params_str);
+    g_free (params_str);
+    *progress_id = bd_utils_report_started (prog_msg);
+    g_free (prog_msg);
+
+    if (!ret) {
+        g_prefix_error (error, "Failed to call the '%s' method on the '%s' object: ", method, obj);
+        return NULL;
+    }
+
+    return ret;
+}
+
+typedef struct JobWaitData {
+    gboolean changed;
+    gboolean completed;
+    gboolean progress_changed;
+    gdouble progress;
+    gboolean timed_out;
+} JobWaitData;
+
+static void job_properties_changed (GDBusConnection *connection UNUSED, const gchar *sender UNUSED,
+                                    const gchar *obj_path UNUSED, const gchar *iface UNUSED,
+                                    const gchar *signal UNUSED, GVariant *params, gpointer user_data) {
+    JobWaitData *data = (JobWaitData *) user_data;
+    const gchar *intf = NULL;
+    GVariant *changed = NULL;
+    gboolean completed = FALSE;
+
+    if (!g_variant_check_format_string (params, "(&s@a{sv}@as)", FALSE))
+        return;
+
+    g_variant_get (params, "(&s@a{sv}@as)", &intf, &changed, NULL);
+    if (g_strcmp0 (intf, JOB_INTF) == 0) {
+        if (g_variant_lookup (changed, "Complete", "b", &completed) && completed)
+            data->completed = TRUE;
+        if (g_variant_lookup (changed, "Percent", "d", &(data->progress)))
+            data->progress_changed = TRUE;
+        data->changed = TRUE;
+    }
+    g_variant_unref (changed);
+}
+
+static gboolean job_wait_timeout (gpointer user_data) {
+    JobWaitData *data = (JobWaitData *) user_data;
+
+    data->timed_out = TRUE;
+    return G_SOURCE_REMOVE;
+}
+
+/* gets the Complete and Percent properties of the job, returns FALSE in case
+   of error (progress errors are ignored) */
+static gboolean poll_job (const gchar *task_path, JobWaitData *data, GError **error) {
+    GVariant *ret = NULL;
+    GError *l_error = NULL;
+
+    ret = get_object_property (task_path, JOB_INTF, "Complete", error);
+    if (!ret)
+        return FALSE;
+    g_variant_get (ret, "b", &(data->completed));
+    g_variant_unref (ret);
+
+    if (!data->completed) {
+        ret = get_object_property (task_path, JOB_INTF, "Percent", &l_error);
+        if (ret) {
+            g_variant_get (ret, "d", &(data->progress));
+            data->progress_changed = TRUE;
+            g_variant_unref (ret);
+        } else {
+            g_debug ("Got error when getting progress: %s", l_error->message);
+            g_clear_error (&l_error);
+        }
+    }
+
+    return TRUE;
+}
 
-    if (lock_config)
-         g_mutex_unlock (&global_config_lock);
-    prog_msg = g_strdup_printf ("Started the '%s.%s' method on the '%s' object with the following parameters: '%s'",
-                               intf, method, obj, params_str);
-    g_free (params_str);
-    *progress_id = bd_utils_report_started (prog_msg);
-    g_free (prog_msg);
+/**
+ * wait_for_job: (skip)
+ *
+ * Waits for the job @task_path to complete. Changes of the job's properties
+ * are signalled by lvmdbusd so the waiting is driven by the PropertiesChanged
+ * signals, the properties are only polled (every %PROGRESS_WAIT microseconds)
+ * if no signal arrives in time.
+ */
+static void wait_for_job (const gchar *task_path, guint64 log_task_id, guint64 prog_id, GError **error) {
+    GMainContext *context = NULL;
+    GSource *timeout = NULL;
+    JobWaitData data = {FALSE, FALSE, FALSE, 0.0, FALSE};
+    guint sub_id = 0;
+    gboolean poll = TRUE;
+    gchar *log_msg = NULL;
 
-    if (!ret) {
-        g_prefix_error (error, "Failed to call the '%s' method on the '%s' object: ", method, obj);
-        return NULL;
+    /* signals are delivered in the thread-default main context of the
+       subscription, use a private one to not interfere with the caller's */
+    context = g_main_context_new ();
+    g_main_context_push_thread_default (context);
+    sub_id = g_dbus_connection_signal_subscribe (bus, LVM_BUS_NAME, DBUS_PROPS_IFACE, "PropertiesChanged",
+                                                 task_path, JOB_INTF, G_DBUS_SIGNAL_FLAGS_NONE,
+                                                 job_properties_changed, &data, NULL);
+    g_main_context_pop_thread_default (context);
+
+    while (!data.completed) {
+        /* poll right after subscribing (the job may have completed before
+           that) and whenever no signal came in time */
+        if (poll && !poll_job (task_path, &data, error))
+            break;
+        if (data.progress_changed) {
+            bd_utils_report_progress (prog_id, (gint) data.progress, NULL);
+            data.progress_changed = FALSE;
+        }
+        if (data.completed)
+            break;
+
+        log_msg = g_strdup_printf ("Still waiting for job '%s' to finish", task_path);
+        bd_utils_log_task_status (log_task_id, log_msg);
+        g_free (log_msg);
+
+        data.changed = FALSE;
+        data.timed_out = FALSE;
+        timeout = g_timeout_source_new ((PROGRESS_WAIT) / 1000);
+        g_source_set_callback (timeout, job_wait_timeout, &data, NULL);
+        g_source_attach (timeout, context);
+        while (!data.changed && !data.timed_out)
+            g_main_context_iteration (context, TRUE);
+        g_source_destroy (timeout);
+        g_source_unref (timeout);
+
+        poll = !data.changed;
     }
 
-    return ret;
+    g_dbus_connection_signal_unsubscribe (bus, sub_id);
+
+    /* get rid of the signals possibly still waiting for dispatch */
+    while (g_main_context_iteration (context, FALSE));
+    g_main_context_unref (context);
 }
 
 static void call_lvm_method_sync (const gchar *obj, const gchar *intf, const gchar *method, GVariant *params, GVariant *extra_params, const BDExtraArg **extra_args, gboolean lock_config, GError **error) {
@@ -655,9 +1471,7 @@ static void call_lvm_method_sync (const gchar *obj, const gchar *intf, const gch
     gchar *task_path = NULL;
     guint64 log_task_id = 0;
     guint64 prog_id = 0;
-    gdouble progress = 0.0;
     gchar *log_msg = NULL;
-    gboolean completed = FALSE;
     gint64 error_code = 0;
     gchar *error_msg = NULL;
 
@@ -726,33 +1540,7 @@ static void call_lvm_method_sync (const gchar *obj, const gchar *intf, const gch
     bd_utils_log_task_status (log_task_id, log_msg);
     g_free (log_msg);
 
-    ret = NULL;
-    while (!completed && !(*error)) {
-        g_usleep (PROGRESS_WAIT);
-        ret = get_object_property (task_path, JOB_INTF, "Complete", error);
-        if (ret) {
-            g_variant_get (ret, "b", &completed);
-            g_variant_unref (ret);
-            ret = NULL;
-        }
-        if (!completed && !(*error)) {
-            /* let's report progress and wait longer */
-            ret = get_object_property (task_path, JOB_INTF, "Percent", error);
-            if (ret) {
-                g_variant_get (ret, "d", &progress);
-                bd_utils_report_progress (prog_id, (gint) progress, NULL);
-                g_variant_unref (ret);
-                ret = NULL;
-            } else {
-                g_debug ("Got error when getting progress: %s", (*error)->message);
-                g_clear_error (error);
-            }
-            log_msg = g_strdup_printf ("Still waiting for job '%s' to finish", task_path);
-            bd_utils_log_task_status (log_task_id, log_msg);
-            g_free (log_msg);
-        }
-
-    }
+    wait_for_job (task_path, log_task_id, prog_id, error);
     log_msg = g_strdup_printf ("Job '%s' finished", task_path);
     bd_utils_log_task_status (log_task_id, log_msg);
     g_free (log_msg);
@@ -875,6 +1663,191 @@ static GVariant* get_object_properties (const gchar *obj_path, const gchar *ifac
     return real_ret;
 }
 
+/* gets the properties from the @cache (if given and known there) or from lvmdbusd */
+static GVariant* lookup_object_properties (ObjectCache *cache, const gchar *obj_path, const gchar *iface, GError **error) {
+    GVariant *ret = NULL;
+
+    if (cache)
+        ret = object_cache_get_properties (cache, obj_path, iface);
+    if (!ret)
+        ret = get_object_properties (obj_path, iface, error);
+
+    return ret;
+}
+
+/* gets the property from the @cache (if given and known there) or from lvmdbusd */
+static GVariant* lookup_object_property (ObjectCache *cache, const gchar *obj_path, const gchar *iface, const gchar *property, GError **error) {
+    GVariant *props = NULL;
+    GVariant *ret = NULL;
+
+    if (cache) {
+        props = object_cache_get_properties (cache, obj_path, iface);
+        if (props) {
+            ret = g_variant_lookup_value (props, property, NULL);
+            g_variant_unref (props);
+        }
+    }
+    if (!ret)
+        ret = get_object_property (obj_path, iface, property, error);
+
+    return ret;
+}
+
+/* maximum number of GetAll calls waiting for a reply at the same time, the
+   system bus limits the number of pending replies per connection (128 by
+   default) */
+#define MAX_PENDING_CALLS 64
+
+typedef struct PropertiesBatch {
+    GHashTable *objects;    /* object path -> (interface -> properties (a{sv})) */
+    GPtrArray *requests;    /* PropertiesRequest */
+    guint next;
+    guint pending;
+    GMainContext *context;
+    GError *error;
+} PropertiesBatch;
+
+typedef struct PropertiesRequest {
+    PropertiesBatch *batch;
+    gchar *obj_path;
+    const gchar *iface;
+} PropertiesRequest;
+
+static void properties_request_free (PropertiesRequest *request) {
+    g_free (request->obj_path);
+    g_free (request);
+}
+
+static void properties_batch_send (PropertiesBatch *batch);
+
+static void properties_batch_done (GObject *source, GAsyncResult *result, gpointer user_data) {
+    PropertiesRequest *request = (PropertiesRequest *) user_data;
+    PropertiesBatch *batch = request->batch;
+    GHashTable *obj_ifaces = NULL;
+    GVariant *ret = NULL;
+    GError *l_error = NULL;
+
+    batch->pending--;
+    ret = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), result, &l_error);
+    if (!ret) {
+        if (!batch->error) {
+            g_prefix_error (&l_error, "Failed to get properties of the %s object: ", request->obj_path);
+            g_propagate_error (&(batch->error), l_error);
+        } else
+            g_clear_error (&l_error);
+        return;
+    }
+
+    obj_ifaces = g_hash_table_lookup (batch->objects, request->obj_path);
+    if (!obj_ifaces) {
+        obj_ifaces = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+        g_hash_table_insert (batch->objects, g_strdup (request->obj_path), obj_ifaces);
+    }
+    g_hash_table_replace (obj_ifaces, g_strdup (request->iface), g_variant_get_child_value (ret, 0));
+    g_variant_unref (ret);
+
+    properties_batch_send (batch);
+}
+
+static void properties_batch_send (PropertiesBatch *batch) {
+    PropertiesRequest *request = NULL;
+
+    /* replies are delivered in the thread-default main context of the call */
+    g_main_context_push_thread_default (batch->context);
+    while (!batch->error && batch->pending < MAX_PENDING_CALLS && batch->next < batch->requests->len) {
+        request = g_ptr_array_index (batch->requests, batch->next);
+        batch->next++;
+        batch->pending++;
+        g_dbus_connection_call (bus, LVM_BUS_NAME, request->obj_path, DBUS_PROPS_IFACE, "GetAll",
+                                g_variant_new ("(s)", request->iface), G_VARIANT_TYPE ("(a{sv})"),
+                                G_DBUS_CALL_FLAGS_NONE, -1, NULL, properties_batch_done, request);
+    }
+    g_main_context_pop_thread_default (batch->context);
+}
+
+typedef struct ObjectFetchSpec {
+    const gchar *obj_prefix;
+    const gchar *ifaces[3];     /* NULL-terminated */
+} ObjectFetchSpec;
+
+static const ObjectFetchSpec pvs_fetch_spec[] = {
+    {PV_OBJ_PREFIX, {PV_INTF, NULL}},
+    {VG_OBJ_PREFIX, {VG_INTF, NULL}},
+    {NULL, {NULL}},
+};
+
+static const ObjectFetchSpec vgs_fetch_spec[] = {
+    {VG_OBJ_PREFIX, {VG_INTF, NULL}},
+    {NULL, {NULL}},
+};
+
+static const ObjectFetchSpec lvs_fetch_spec[] = {
+    {LV_OBJ_PREFIX, {LV_CMN_INTF, NULL}},
+    {THIN_POOL_OBJ_PREFIX, {LV_CMN_INTF, THPOOL_INTF, NULL}},
+    {CACHE_POOL_OBJ_PREFIX, {LV_CMN_INTF, CACHE_POOL_INTF, NULL}},
+    {VDO_POOL_OBJ_PREFIX, {LV_CMN_INTF, VDO_POOL_INTF, NULL}},
+    {HIDDEN_LV_OBJ_PREFIX, {LV_CMN_INTF, NULL}},
+    {VG_OBJ_PREFIX, {VG_INTF, NULL}},
+    {NULL, {NULL}},
+};
+
+/**
+ * object_cache_fetch: (skip)
+ *
+ * Creates a one-shot object cache (not kept up to date) with the properties of
+ * the objects described by @specs. All the GetAll calls are sent at once
+ * (well, up to %MAX_PENDING_CALLS of them) instead of waiting for the replies
+ * one by one.
+ */
+static ObjectCache* object_cache_fetch (const ObjectFetchSpec *specs, GError **error) {
+    ObjectCache *cache = NULL;
+    PropertiesBatch batch = {NULL, NULL, 0, 0, NULL, NULL};
+    PropertiesRequest *request = NULL;
+    const ObjectFetchSpec *spec = NULL;
+    const gchar *const *iface = NULL;
+    gchar **objects = NULL;
+    gchar **obj_p = NULL;
+
+    batch.requests = g_ptr_array_new_with_free_func ((GDestroyNotify) properties_request_free);
+    for (spec=specs; spec->obj_prefix; spec++) {
+        objects = get_existing_objects (spec->obj_prefix, error);
+        if (!objects) {
+            /* error is already populated */
+            g_ptr_array_free (batch.requests, TRUE);
+            return NULL;
+        }
+        for (obj_p=objects; *obj_p; obj_p++)
+            for (iface=spec->ifaces; *iface; iface++) {
+                request = g_new0 (PropertiesRequest, 1);
+                request->batch = &batch;
+                request->obj_path = g_strdup (*obj_p);
+                request->iface = *iface;
+                g_ptr_array_add (batch.requests, request);
+            }
+        g_strfreev (objects);
+    }
+
+    cache = g_new0 (ObjectCache, 1);
+    cache->objects = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_hash_table_unref);
+    batch.objects = cache->objects;
+    batch.context = g_main_context_new ();
+
+    properties_batch_send (&batch);
+    while (batch.pending > 0)
+        g_main_context_iteration (batch.context, TRUE);
+
+    g_main_context_unref (batch.context);
+    g_ptr_array_free (batch.requests, TRUE);
+
+    if (batch.error) {
+        g_propagate_error (error, batch.error);
+        object_cache_free (cache);
+        return NULL;
+    }
+
+    return cache;
+}
+
 static GVariant* get_lvm_object_properties (const gchar *obj_id, const gchar *iface, GError **error) {
     GVariant *args = NULL;
     GVariant *ret = NULL;
@@ -947,7 +1920,7 @@ static GVariant* get_vdo_properties (const gchar *vg_name, const gchar *pool_nam
     return ret;
 }
 
-static BDLVMPVdata* get_pv_data_from_props (GVariant *props, GError **error) {
+static BDLVMPVdata* get_pv_data_from_props (GVariant *props, ObjectCache *cache, GError **error) {
     BDLVMPVdata *data = g_new0 (BDLVMPVdata, 1);
     GVariantDict dict;
     gchar *path = NULL;
@@ -984,7 +1957,7 @@ static BDLVMPVdata* get_pv_data_from_props (GVariant *props, GError **error) {
         return data;
     }
 
-    vg_props = get_object_properties (path, VG_INTF, error);
+    vg_props = lookup_object_properties (cache, path, VG_INTF, error);
     g_variant_dict_clear (&dict);
     if (!vg_props)
         return data;
@@ -1134,7 +2107,7 @@ static gchar* _lvm_metadata_lv_name (const gchar *vg_name, const gchar *lv_name,
     return g_strstrip (g_strdelimit (ret, "[]", ' '));
 }
 
-static BDLVMLVdata* get_lv_data_from_props (GVariant *props, GError **error) {
+static BDLVMLVdata* get_lv_data_from_props (GVariant *props, ObjectCache *cache, GError **error) {
     BDLVMLVdata *data = g_new0 (BDLVMLVdata, 1);
     GVariantDict dict;
     GVariant *value = NULL;
@@ -1176,14 +2149,14 @@ static BDLVMLVdata* get_lv_data_from_props (GVariant *props, GError **error) {
 
     /* returns an object path for the VG */
     g_variant_dict_lookup (&dict, "Vg", "o", &path);
-    name = get_object_property (path, VG_INTF, "Name", error);
+    name = lookup_object_property (cache, path, VG_INTF, "Name", error);
     g_free (path);
     g_variant_get (name, "s", &(data->vg_name));
     g_variant_unref (name);
 
     g_variant_dict_lookup (&dict, "OriginLv", "o", &path);
     if (g_strcmp0 (path, "/") != 0) {
-        name = get_object_property (path, LV_CMN_INTF, "Name", error);
+        name = lookup_object_property (cache, path, LV_CMN_INTF, "Name", error);
         g_variant_get (name, "s", &(data->origin));
         g_variant_unref (name);
     }
@@ -1192,7 +2165,7 @@ static BDLVMLVdata* get_lv_data_from_props (GVariant *props, GError **error) {
 
     g_variant_dict_lookup (&dict, "PoolLv", "o", &path);
     if (g_strcmp0 (path, "/") != 0) {
-        name = get_object_property (path, LV_CMN_INTF, "Name", error);
+        name = lookup_object_property (cache, path, LV_CMN_INTF, "Name", error);
         g_variant_get (name, "s", &(data->pool_lv));
         g_variant_unref (name);
     }
@@ -1203,7 +2176,7 @@ static BDLVMLVdata* get_lv_data_from_props (GVariant *props, GError **error) {
     if (path && g_strcmp0 (path, "/") != 0) {
         g_debug ("Have path");
         g_debug ("  %s", path);
-        name = get_object_property (path, PV_INTF, "Name", error);
+        name = lookup_object_property (cache, path, PV_INTF, "Name", error);
         g_variant_get (name, "s", &(data->move_pv));
         g_variant_unref (name);
     }
@@ -1684,6 +2657,36 @@ gboolean bd_lvm_pvmove (const gchar *src, const gchar *dest, const BDExtraArg **
     return ((*error) == NULL);
 }
 
+/**
+ * bd_lvm_pvmove_with_rate:
+ * @src: the PV device to move extents off of
+ * @dest: (allow-none): the PV device to move extents onto or %NULL
+ * @max_rate: maximum copy rate (in bytes per second) or 0 for no limit
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the PV move
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the extents from the @src PV where successfully moved or not
+ *
+ * If @dest is %NULL, VG allocation rules are used for the extents from the @src
+ * PV (see pvmove(8)).
+ *
+ * Note: The LVM DBus API has no way to limit the copy rate of a PV move so
+ *       only @max_rate of 0 is supported by this plugin (the progress is
+ *       reported from the LVM DBus job the same way as with bd_lvm_pvmove()).
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_pvmove_with_rate (const gchar *src, const gchar *dest, guint64 max_rate, const BDExtraArg **extra, GError **error) {
+    if (max_rate > 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                     "Limiting PV move rate is not supported by the LVM DBus plugin");
+        return FALSE;
+    }
+
+    return bd_lvm_pvmove (src, dest, extra, error);
+}
+
 /**
  * bd_lvm_pvscan:
  * @device: (allow-none): the device to scan for PVs or %NULL
@@ -1853,51 +2856,32 @@ BDLVMPVdata* bd_lvm_pvinfo (const gchar *device, GError **error) {
         /* the error is already populated */
         return NULL;
 
-    ret = get_pv_data_from_props (props, error);
+    ret = get_pv_data_from_props (props, NULL, error);
     g_variant_unref (props);
 
     return ret;
 }
 
-/**
- * bd_lvm_pvs:
- * @error: (out): place to store error (if any)
- *
- * Returns: (array zero-terminated=1): information about PVs found in the system
- *
- * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
- */
-BDLVMPVdata** bd_lvm_pvs (GError **error) {
+static BDLVMPVdata** get_pvs (ObjectCache *cache, GError **error) {
     gchar **objects = NULL;
     guint64 n_pvs = 0;
     GVariant *props = NULL;
     BDLVMPVdata **ret = NULL;
     guint64 i = 0;
 
-    objects = get_existing_objects (PV_OBJ_PREFIX, error);
-    if (!objects) {
-        if (!(*error)) {
-            /* no PVs */
-            ret = g_new0 (BDLVMPVdata*, 1);
-            ret[0] = NULL;
-            return ret;
-        } else
-            /* error is already populated */
-            return NULL;
-    }
-
+    objects = object_cache_get_objects (cache, PV_INTF);
     n_pvs = g_strv_length ((gchar **) objects);
 
     /* now create the return value -- NULL-terminated array of BDLVMPVdata */
     ret = g_new0 (BDLVMPVdata*, n_pvs + 1);
     for (i=0; i < n_pvs; i++) {
-        props = get_object_properties (objects[i], PV_INTF, error);
+        props = lookup_object_properties (cache, objects[i], PV_INTF, error);
         if (!props) {
             g_strfreev (objects);
             g_free (ret);
             return NULL;
         }
-        ret[i] = get_pv_data_from_props (props, error);
+        ret[i] = get_pv_data_from_props (props, cache, error);
         g_variant_unref (props);
         if (!(ret[i])) {
             g_strfreev (objects);
@@ -1911,6 +2895,58 @@ BDLVMPVdata** bd_lvm_pvs (GError **error) {
     return ret;
 }
 
+/**
+ * bd_lvm_pvs:
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): information about PVs found in the system
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMPVdata** bd_lvm_pvs (GError **error) {
+    ObjectCache *cache = NULL;
+    BDLVMPVdata **ret = NULL;
+
+    /* answered from the object cache if possible */
+    cache = lock_object_cache ();
+    if (cache) {
+        ret = get_pvs (cache, error);
+        unlock_object_cache ();
+        return ret;
+    }
+
+    /* otherwise get all the data needed at once */
+    cache = object_cache_fetch (pvs_fetch_spec, error);
+    if (!cache)
+        /* error is already populated */
+        return NULL;
+    ret = get_pvs (cache, error);
+    object_cache_free (cache);
+
+    return ret;
+}
+
+/**
+ * bd_lvm_pvs_select:
+ * @selection: (allow-none): LVM selection criteria for the PVs or %NULL to get all PVs
+ * @fields: a combination of (ORed) #BDLVMPVField specifying which fields of
+ *          the returned structs should be filled, 0 means all of them
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): information about PVs matching the
+ * @selection
+ *
+ * Note: The LVM DBus API doesn't support LVM selection criteria so this
+ *       function is not supported by this plugin.
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMPVdata** bd_lvm_pvs_select (const gchar *selection UNUSED, BDLVMPVField fields UNUSED, GError **error) {
+    g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                 "Selecting PVs is not supported by the LVM DBus plugin");
+    return NULL;
+}
+
 /**
  * bd_lvm_vgcreate:
  * @name: name of the newly created VG
@@ -2180,39 +3216,20 @@ BDLVMVGdata* bd_lvm_vginfo (const gchar *vg_name, GError **error) {
     return ret;
 }
 
-/**
- * bd_lvm_vgs:
- * @error: (out): place to store error (if any)
- *
- * Returns: (array zero-terminated=1): information about VGs found in the system
- *
- * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
- */
-BDLVMVGdata** bd_lvm_vgs (GError **error) {
+static BDLVMVGdata** get_vgs (ObjectCache *cache, GError **error) {
     gchar **objects = NULL;
     guint64 n_vgs = 0;
     GVariant *props = NULL;
     BDLVMVGdata **ret = NULL;
     guint64 i = 0;
 
-    objects = get_existing_objects (VG_OBJ_PREFIX, error);
-    if (!objects) {
-        if (!(*error)) {
-            /* no VGs */
-            ret = g_new0 (BDLVMVGdata*, 1);
-            ret[0] = NULL;
-            return ret;
-        } else
-            /* error is already populated */
-            return NULL;
-    }
-
+    objects = object_cache_get_objects (cache, VG_INTF);
     n_vgs = g_strv_length ((gchar **) objects);
 
     /* now create the return value -- NULL-terminated array of BDLVMVGdata */
     ret = g_new0 (BDLVMVGdata*, n_vgs + 1);
     for (i=0; i < n_vgs; i++) {
-        props = get_object_properties (objects[i], VG_INTF, error);
+        props = lookup_object_properties (cache, objects[i], VG_INTF, error);
         if (!props) {
             g_strfreev (objects);
             g_free (ret);
@@ -2232,6 +3249,37 @@ BDLVMVGdata** bd_lvm_vgs (GError **error) {
     return ret;
 }
 
+/**
+ * bd_lvm_vgs:
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): information about VGs found in the system
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVGdata** bd_lvm_vgs (GError **error) {
+    ObjectCache *cache = NULL;
+    BDLVMVGdata **ret = NULL;
+
+    /* answered from the object cache if possible */
+    cache = lock_object_cache ();
+    if (cache) {
+        ret = get_vgs (cache, error);
+        unlock_object_cache ();
+        return ret;
+    }
+
+    /* otherwise get all the data needed at once */
+    cache = object_cache_fetch (vgs_fetch_spec, error);
+    if (!cache)
+        /* error is already populated */
+        return NULL;
+    ret = get_vgs (cache, error);
+    object_cache_free (cache);
+
+    return ret;
+}
+
 /**
  * bd_lvm_lvorigin:
  * @vg_name: name of the VG containing the queried LV
@@ -2265,29 +3313,100 @@ gchar* bd_lvm_lvorigin (const gchar *vg_name, const gchar *lv_name, GError **err
         return NULL;
     }
 
-    g_variant_get (prop, "s", &ret);
-    g_variant_unref (prop);
+    g_variant_get (prop, "s", &ret);
+    g_variant_unref (prop);
+
+    return ret;
+}
+
+/**
+ * bd_lvm_lvcreate:
+ * @vg_name: name of the VG to create a new LV in
+ * @lv_name: name of the to-be-created LV
+ * @size: requested size of the new LV
+ * @type: (allow-none): type of the new LV ("striped", "raid1",..., see lvcreate (8))
+ * @pv_list: (allow-none) (array zero-terminated=1): list of PVs the newly created LV should use or %NULL
+ * if not specified
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the LV creation
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the given @vg_name/@lv_name LV was successfully created or not
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_CREATE
+ */
+gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 size, const gchar *type, const gchar **pv_list, const BDExtraArg **extra, GError **error) {
+    GVariantBuilder builder;
+    gchar *path = NULL;
+    const gchar **pv = NULL;
+    GVariant *pvs = NULL;
+    GVariantType *var_type = NULL;
+    GVariant *params = NULL;
+    GVariant *extra_params = NULL;
+
+    /* build the array of PVs (object paths) */
+    if (pv_list) {
+        g_variant_builder_init (&builder, G_VARIANT_TYPE_ARRAY);
+        for (pv=pv_list; *pv; pv++) {
+            path = get_object_path (*pv, error);
+            if (!path) {
+                g_variant_builder_clear (&builder);
+                return FALSE;
+            }
+            g_variant_builder_add_value (&builder, g_variant_new ("(ott)", path, (guint64) 0, (guint64) 0));
+        }
+        pvs = g_variant_builder_end (&builder);
+        g_variant_builder_clear (&builder);
+    } else {
+        var_type = g_variant_type_new ("a(ott)");
+        pvs = g_variant_new_array (var_type, NULL, 0);
+        g_variant_type_free (var_type);
+    }
+
+    /* build the params tuple */
+    g_variant_builder_init (&builder, G_VARIANT_TYPE_TUPLE);
+    g_variant_builder_add_value (&builder, g_variant_new ("s", lv_name));
+    g_variant_builder_add_value (&builder, g_variant_new ("t", size));
+    g_variant_builder_add_value (&builder, pvs);
+    params = g_variant_builder_end (&builder);
+    g_variant_builder_clear (&builder);
+
+    if (type) {
+        /* and now the extra_params params */
+        g_variant_builder_init (&builder, G_VARIANT_TYPE_DICTIONARY);
+        if (pv_list && g_strcmp0 (type, "striped") == 0)
+            g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "stripes", g_variant_new ("i", g_strv_length ((gchar **) pv_list))));
+        else
+            g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "type", g_variant_new ("s", type)));
+        extra_params = g_variant_builder_end (&builder);
+        g_variant_builder_clear (&builder);
+    }
+
+    call_lvm_obj_method_sync (vg_name, VG_INTF, "LvCreate", params, extra_params, extra, TRUE, error);
 
-    return ret;
+    return ((*error) == NULL);
 }
 
 /**
- * bd_lvm_lvcreate:
- * @vg_name: name of the VG to create a new LV in
- * @lv_name: name of the to-be-created LV
+ * bd_lvm_raid_create:
+ * @vg_name: name of the VG to create a new RAID LV in
+ * @lv_name: name of the to-be-created RAID LV
+ * @raid_type: RAID type of the new LV ("raid1", "raid5", "raid10",..., see lvmraid (7))
  * @size: requested size of the new LV
- * @type: (allow-none): type of the new LV ("striped", "raid1",..., see lvcreate (8))
- * @pv_list: (allow-none) (array zero-terminated=1): list of PVs the newly created LV should use or %NULL
- * if not specified
+ * @stripes: number of stripes (data devices) or 0 for default
+ * @stripe_size: stripe size (in bytes) or 0 for default
+ * @mirrors: number of additional mirror images or 0 for default
+ * @pv_list: (allow-none) (array zero-terminated=1): list of PVs the new LV should be allocated from
+ *                                                   or %NULL if not specified
  * @extra: (allow-none) (array zero-terminated=1): extra options for the LV creation
  *                                                 (just passed to LVM as is)
  * @error: (out): place to store error (if any)
  *
- * Returns: whether the given @vg_name/@lv_name LV was successfully created or not
+ * Returns: whether the given @vg_name/@lv_name RAID LV was successfully created or not
  *
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_CREATE
  */
-gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 size, const gchar *type, const gchar **pv_list, const BDExtraArg **extra, GError **error) {
+gboolean bd_lvm_raid_create (const gchar *vg_name, const gchar *lv_name, const gchar *raid_type, guint64 size, guint stripes, guint64 stripe_size, guint mirrors, const gchar **pv_list, const BDExtraArg **extra, GError **error) {
     GVariantBuilder builder;
     gchar *path = NULL;
     const gchar **pv = NULL;
@@ -2295,6 +3414,13 @@ gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 si
     GVariantType *var_type = NULL;
     GVariant *params = NULL;
     GVariant *extra_params = NULL;
+    gchar *stripe_size_str = NULL;
+
+    if (!raid_type || !g_str_has_prefix (raid_type, "raid")) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "Invalid RAID type '%s'", raid_type ? raid_type : "");
+        return FALSE;
+    }
 
     /* build the array of PVs (object paths) */
     if (pv_list) {
@@ -2323,22 +3449,128 @@ gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 si
     params = g_variant_builder_end (&builder);
     g_variant_builder_clear (&builder);
 
-    if (type) {
-        /* and now the extra_params params */
-        g_variant_builder_init (&builder, G_VARIANT_TYPE_DICTIONARY);
-        if (pv_list && g_strcmp0 (type, "striped") == 0)
-            g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "stripes", g_variant_new ("i", g_strv_length ((gchar **) pv_list))));
-        else
-            g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "type", g_variant_new ("s", type)));
-        extra_params = g_variant_builder_end (&builder);
-        g_variant_builder_clear (&builder);
+    /* and now the extra_params params */
+    g_variant_builder_init (&builder, G_VARIANT_TYPE_DICTIONARY);
+    g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "type", g_variant_new ("s", raid_type)));
+    if (stripes > 0)
+        g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "stripes", g_variant_new ("i", stripes)));
+    if (stripe_size > 0) {
+        stripe_size_str = g_strdup_printf ("%"G_GUINT64_FORMAT"K", stripe_size / 1024);
+        g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "stripesize", g_variant_new ("s", stripe_size_str)));
+        g_free (stripe_size_str);
     }
+    if (mirrors > 0)
+        g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "mirrors", g_variant_new ("i", mirrors)));
+    extra_params = g_variant_builder_end (&builder);
+    g_variant_builder_clear (&builder);
 
     call_lvm_obj_method_sync (vg_name, VG_INTF, "LvCreate", params, extra_params, extra, TRUE, error);
 
     return ((*error) == NULL);
 }
 
+/**
+ * bd_lvm_raid_set_recovery_rate:
+ * @vg_name: name of the VG containing the @lv_name RAID LV
+ * @lv_name: name of the RAID LV to set the recovery rate for
+ * @min_rate: minimum recovery rate (in bytes per second per device), 0 for no
+ *            limit or %BD_LVM_RAID_RATE_UNCHANGED to keep the current value
+ * @max_rate: maximum recovery rate (in bytes per second per device), 0 for no
+ *            limit or %BD_LVM_RAID_RATE_UNCHANGED to keep the current value
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the LV change
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Throttles the resynchronization/recovery of the @vg_name/@lv_name RAID LV so
+ * that it doesn't starve the regular I/O (@max_rate) or makes progress even
+ * under load (@min_rate). The rates can be changed while the LV is active. LVM
+ * takes the rates in KiB/s so they are rounded up to whole KiB/s. Negative
+ * rates other than %BD_LVM_RAID_RATE_UNCHANGED are rejected.
+ *
+ * Returns: whether the recovery rate of the @vg_name/@lv_name was successfully set or not
+ *
+ * Note: The LVM DBus API has no way to change the recovery rate of an existing
+ *       RAID LV so this function is not supported by this plugin.
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_raid_set_recovery_rate (const gchar *vg_name UNUSED, const gchar *lv_name UNUSED, gint64 min_rate UNUSED, gint64 max_rate UNUSED, const BDExtraArg **extra UNUSED, GError **error) {
+    g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                 "Changing RAID recovery rate is not supported by the LVM DBus plugin");
+    return FALSE;
+}
+
+/**
+ * bd_lvm_raid_stats:
+ * @vg_name: name of the VG containing the @lv_name RAID LV
+ * @lv_name: name of the RAID LV to get stats for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: sync progress and health of the @lv_name RAID LV or %NULL in case of error
+ *
+ * The stats are gathered from the status of the LV's 'raid' DM map, no LVM
+ * commands are run.
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMRaidStats* bd_lvm_raid_stats (const gchar *vg_name, const gchar *lv_name, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
+        return NULL;
+    }
+
+    return lvm_dm_raid_stats (vg_name, lv_name, error);
+}
+
+/**
+ * bd_lvm_plan_placement:
+ * @vg_name: name of the VG to plan the placement of a new LV in
+ * @size: requested size of the new LV
+ * @max_stripes: maximum number of stripes or 0 for no limit
+ * @error: (out): place to store error (if any)
+ *
+ * Picks PVs, number of stripes and stripe size for a new LV of @size in the
+ * @vg_name VG based on the free space of the PVs and the properties of the
+ * disks the PVs are stored on:
+ *
+ * - as many stripes as possible (up to @max_stripes) are used,
+ * - PVs stored on the same disk (partitions, stacked devices) are never used
+ *   as stripes of the same LV,
+ * - non-rotational PVs are preferred and rotational and non-rotational PVs
+ *   are not mixed unless the LV doesn't fit otherwise,
+ * - the stripe size is based on the optimal I/O size and physical block size
+ *   of the devices (64 KiB by default).
+ *
+ * If the LV cannot be striped, a linear placement over as few PVs as possible
+ * is returned. Use the resulting PVs with bd_lvm_lvcreate() with the "striped"
+ * type if #BDLVMPlacement.stripes is greater than 1 or with %NULL type
+ * otherwise. The number of stripes is given by the number of PVs passed as
+ * @pv_list to bd_lvm_lvcreate() so only "--stripesize" (set to
+ * #BDLVMPlacement.stripe_size) needs to be given as an extra argument.
+ *
+ * Returns: (transfer full): the suggested placement of the new LV or %NULL in
+ *                           case of error (e.g. not enough free space in the VG)
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMPlacement* bd_lvm_plan_placement (const gchar *vg_name, guint64 size, guint max_stripes, GError **error) {
+    BDLVMPVdata **pvs = NULL;
+    BDLVMPlacement *ret = NULL;
+
+    pvs = bd_lvm_pvs (error);
+    if (!pvs)
+        return NULL;
+
+    ret = lvm_plan_placement (pvs, vg_name, size, max_stripes, error);
+
+    for (BDLVMPVdata **pv = pvs; *pv; pv++)
+        bd_lvm_pvdata_free (*pv);
+    g_free (pvs);
+
+    return ret;
+}
+
 /**
  * bd_lvm_lvremove:
  * @vg_name: name of the VG containing the to-be-removed LV
@@ -2594,7 +3826,7 @@ BDLVMLVdata* bd_lvm_lvinfo (const gchar *vg_name, const gchar *lv_name, GError *
         /* the error is already populated */
         return NULL;
 
-    ret = get_lv_data_from_props (props, error);
+    ret = get_lv_data_from_props (props, NULL, error);
     if (ret && ((g_strcmp0 (ret->segtype, "thin-pool") == 0) ||
                 (g_strcmp0 (ret->segtype, "cache-pool") == 0))) {
         ret->data_lv = _lvm_data_lv_name (vg_name, lv_name, error);
@@ -2607,16 +3839,16 @@ BDLVMLVdata* bd_lvm_lvinfo (const gchar *vg_name, const gchar *lv_name, GError *
     return ret;
 }
 
-static gchar* get_lv_vg_name (const gchar *lv_obj_path, GError **error) {
+static gchar* get_lv_vg_name (ObjectCache *cache, const gchar *lv_obj_path, GError **error) {
     GVariant *value = NULL;
     gchar *vg_obj_path = NULL;
     gchar *ret = NULL;
 
-    value = get_object_property (lv_obj_path, LV_CMN_INTF, "Vg", error);
+    value = lookup_object_property (cache, lv_obj_path, LV_CMN_INTF, "Vg", error);
     g_variant_get (value, "o", &vg_obj_path);
     g_variant_unref (value);
 
-    value = get_object_property (vg_obj_path, VG_INTF, "Name", error);
+    value = lookup_object_property (cache, vg_obj_path, VG_INTF, "Name", error);
     g_variant_get (value, "s", &ret);
     g_free (vg_obj_path);
     g_variant_unref (value);
@@ -2629,7 +3861,7 @@ static gchar* get_lv_vg_name (const gchar *lv_obj_path, GError **error) {
  *
  * Filter LVs by VG name and prepend the matching ones to the @out list.
  */
-static gboolean filter_lvs_by_vg (gchar **lvs, const gchar *vg_name, GSList **out, guint64 *n_lvs, GError **error) {
+static gboolean filter_lvs_by_vg (ObjectCache *cache, gchar **lvs, const gchar *vg_name, GSList **out, guint64 *n_lvs, GError **error) {
     gchar **lv_p = NULL;
     gchar *lv_vg_name = NULL;
     gboolean success = TRUE;
@@ -2640,7 +3872,7 @@ static gboolean filter_lvs_by_vg (gchar **lvs, const gchar *vg_name, GSList **ou
 
     for (lv_p=lvs; *lv_p; lv_p++) {
         if (vg_name) {
-            lv_vg_name = get_lv_vg_name (*lv_p, error);
+            lv_vg_name = get_lv_vg_name (cache, *lv_p, error);
             if (!lv_vg_name) {
                 g_free (*lv_p);
                 success = FALSE;
@@ -2663,17 +3895,32 @@ static gboolean filter_lvs_by_vg (gchar **lvs, const gchar *vg_name, GSList **ou
     return success;
 }
 
-/**
- * bd_lvm_lvs:
- * @vg_name: (allow-none): name of the VG to get information about LVs from
- * @error: (out): place to store error (if any)
- *
- * Returns: (array zero-terminated=1): information about LVs found in the given
- * @vg_name VG or in system if @vg_name is %NULL
- *
- * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
- */
-BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error) {
+/* gets the name of the LV referenced by the @property of the @iface interface
+   of the @obj_path pool LV from the @cache */
+static gchar* object_cache_get_sub_lv_name (ObjectCache *cache, const gchar *obj_path, const gchar *iface, const gchar *property) {
+    GVariant *props = NULL;
+    GVariant *lv_props = NULL;
+    const gchar *lv_path = NULL;
+    gchar *ret = NULL;
+
+    props = object_cache_get_properties (cache, obj_path, iface);
+    if (!props)
+        return NULL;
+
+    if (g_variant_lookup (props, property, "&o", &lv_path) && g_strcmp0 (lv_path, "/") != 0)
+        lv_props = object_cache_get_properties (cache, lv_path, LV_CMN_INTF);
+    g_variant_unref (props);
+    if (!lv_props)
+        return NULL;
+
+    if (g_variant_lookup (lv_props, "Name", "s", &ret))
+        g_strstrip (g_strdelimit (ret, "[]", ' '));
+    g_variant_unref (lv_props);
+
+    return ret;
+}
+
+static BDLVMLVdata** get_lvs (ObjectCache *cache, const gchar *vg_name, GError **error) {
     gchar **lvs = NULL;
     guint64 n_lvs = 0;
     GVariant *props = NULL;
@@ -2682,65 +3929,11 @@ BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error) {
     GSList *matched_lvs = NULL;
     GSList *lv = NULL;
     gboolean success = FALSE;
+    const gchar *pool_intf = NULL;
 
-    lvs = get_existing_objects (LV_OBJ_PREFIX, error);
-    if (!lvs && (*error)) {
-        /* error is already populated */
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-
-    lvs = get_existing_objects (THIN_POOL_OBJ_PREFIX, error);
-    if (!lvs && (*error)) {
-        /* error is already populated */
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-
-    lvs = get_existing_objects (CACHE_POOL_OBJ_PREFIX, error);
-    if (!lvs && (*error)) {
-        /* error is already populated */
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-
-    lvs = get_existing_objects (VDO_POOL_OBJ_PREFIX, error);
-    if (!lvs && (*error)) {
-        /* error is already populated */
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-
-    lvs = get_existing_objects (HIDDEN_LV_OBJ_PREFIX, error);
-    if (!lvs && (*error)) {
-        /* error is already populated */
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
+    /* all the LV types implement the common LV interface */
+    lvs = object_cache_get_objects (cache, LV_CMN_INTF);
+    success = filter_lvs_by_vg (cache, lvs, vg_name, &matched_lvs, &n_lvs, error);
     g_free (lvs);
     if (!success) {
         g_slist_free_full (matched_lvs, g_free);
@@ -2764,25 +3957,35 @@ BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error) {
 
     lv = matched_lvs;
     while (lv) {
-        props = get_object_properties (lv->data, LV_CMN_INTF, error);
+        props = lookup_object_properties (cache, lv->data, LV_CMN_INTF, error);
         if (!props) {
             g_slist_free_full (matched_lvs, g_free);
             g_free (ret);
             return NULL;
         }
-        ret[j] = get_lv_data_from_props (props, error);
+        ret[j] = get_lv_data_from_props (props, cache, error);
         if (!(ret[j])) {
             g_slist_free_full (matched_lvs, g_free);
             for (guint64 i = 0; i < j; i++)
                 bd_lvm_lvdata_free (ret[i]);
             g_free (ret);
             return NULL;
-        } else if ((g_strcmp0 (ret[j]->segtype, "thin-pool") == 0) ||
-                   (g_strcmp0 (ret[j]->segtype, "cache-pool") == 0)) {
-            ret[j]->data_lv = _lvm_data_lv_name (ret[j]->vg_name, ret[j]->lv_name, error);
-            ret[j]->metadata_lv = _lvm_metadata_lv_name (ret[j]->vg_name, ret[j]->lv_name, error);
-        } else if (g_strcmp0 (ret[j]->segtype, "vdo-pool") == 0) {
-            ret[j]->data_lv = _lvm_data_lv_name (ret[j]->vg_name, ret[j]->lv_name, error);
+        }
+
+        if (g_strcmp0 (ret[j]->segtype, "thin-pool") == 0)
+            pool_intf = THPOOL_INTF;
+        else if (g_strcmp0 (ret[j]->segtype, "cache-pool") == 0)
+            pool_intf = CACHE_POOL_INTF;
+        else if (g_strcmp0 (ret[j]->segtype, "vdo-pool") == 0)
+            pool_intf = VDO_POOL_INTF;
+        else
+            pool_intf = NULL;
+
+        if (pool_intf) {
+            /* the pool objects know their data and metadata LVs */
+            ret[j]->data_lv = object_cache_get_sub_lv_name (cache, lv->data, pool_intf, "DataLv");
+            if (g_strcmp0 (pool_intf, VDO_POOL_INTF) != 0)
+                ret[j]->metadata_lv = object_cache_get_sub_lv_name (cache, lv->data, pool_intf, "MetaDataLv");
         }
         if (error && *error) {
             g_slist_free_full (matched_lvs, g_free);
@@ -2800,6 +4003,178 @@ BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error) {
     return ret;
 }
 
+/**
+ * bd_lvm_lvs:
+ * @vg_name: (allow-none): name of the VG to get information about LVs from
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): information about LVs found in the given
+ * @vg_name VG or in system if @vg_name is %NULL
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error) {
+    ObjectCache *cache = NULL;
+    BDLVMLVdata **ret = NULL;
+
+    /* answered from the object cache if possible */
+    cache = lock_object_cache ();
+    if (cache) {
+        ret = get_lvs (cache, vg_name, error);
+        unlock_object_cache ();
+        return ret;
+    }
+
+    /* otherwise get all the data needed at once */
+    cache = object_cache_fetch (lvs_fetch_spec, error);
+    if (!cache)
+        /* error is already populated */
+        return NULL;
+    ret = get_lvs (cache, vg_name, error);
+    object_cache_free (cache);
+
+    return ret;
+}
+
+/**
+ * bd_lvm_lvs_select:
+ * @selection: (allow-none): LVM selection criteria for the LVs or %NULL to get all LVs
+ * @fields: a combination of (ORed) #BDLVMLVField specifying which fields of
+ *          the returned structs should be filled, 0 means all of them
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): information about LVs matching the
+ * @selection
+ *
+ * Note: The LVM DBus API doesn't support LVM selection criteria so this
+ *       function is not supported by this plugin.
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMLVdata** bd_lvm_lvs_select (const gchar *selection UNUSED, BDLVMLVField fields UNUSED, GError **error) {
+    g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                 "Selecting LVs is not supported by the LVM DBus plugin");
+    return NULL;
+}
+
+/**
+ * bd_lvm_get_inventory:
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): the LVM inventory of the system or %NULL in case
+ * of error (the @error) gets populated in those cases)
+ *
+ * Note: The LVM DBus API has no equivalent of 'lvm fullreport' so this
+ *       function is not supported by this plugin, use bd_lvm_vgs(),
+ *       bd_lvm_pvs() and bd_lvm_lvs() instead.
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMInventory* bd_lvm_get_inventory (GError **error) {
+    g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                 "Getting the LVM inventory is not supported by the LVM DBus plugin");
+    return NULL;
+}
+
+/* moves the @records (NULL-terminated array) into a new result set, the
+   records are built one by one from the DBus properties so this only saves
+   the allocations when the set is used and freed */
+static BDLVMResultSet* records_to_result_set (gpointer *records, const LVMReportField *fields, gsize data_size,
+                                              GDestroyNotify free_func, BDLVMResultSetType item_type) {
+    LVMReportArena arena;
+    GPtrArray *items = g_ptr_array_new ();
+    gpointer *record_p = NULL;
+
+    lvm_report_arena_init (&arena);
+    for (record_p=records; *record_p; record_p++) {
+        g_ptr_array_add (items, lvm_report_arena_copy_record (&arena, *record_p, fields, data_size));
+        free_func (*record_p);
+    }
+    g_free (records);
+
+    return lvm_report_arena_to_result_set (&arena, item_type, items);
+}
+
+/**
+ * bd_lvm_pvs_result_set:
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_pvs(), but with all the results allocated in a single
+ * #BDLVMResultSet which makes a big difference for systems with many PVs.
+ *
+ * Returns: (transfer full): information about PVs found in the system or %NULL
+ * in case of error (the @error) gets populated in those cases)
+ *
+ * Note: The LVM DBus API provides the information object by object so only
+ *       freeing the result is cheaper with this plugin, not getting it.
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMResultSet* bd_lvm_pvs_result_set (GError **error) {
+    BDLVMPVdata **pvs = bd_lvm_pvs (error);
+
+    if (!pvs)
+        /* the error is already populated from the call */
+        return NULL;
+
+    return records_to_result_set ((gpointer *) pvs, lvm_report_pv_fields, sizeof (BDLVMPVdata),
+                                  (GDestroyNotify) bd_lvm_pvdata_free, BD_LVM_RESULT_SET_PVS);
+}
+
+/**
+ * bd_lvm_vgs_result_set:
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_vgs(), but with all the results allocated in a single
+ * #BDLVMResultSet which makes a big difference for systems with many VGs.
+ *
+ * Returns: (transfer full): information about VGs found in the system or %NULL
+ * in case of error (the @error) gets populated in those cases)
+ *
+ * Note: The LVM DBus API provides the information object by object so only
+ *       freeing the result is cheaper with this plugin, not getting it.
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMResultSet* bd_lvm_vgs_result_set (GError **error) {
+    BDLVMVGdata **vgs = bd_lvm_vgs (error);
+
+    if (!vgs)
+        /* the error is already populated from the call */
+        return NULL;
+
+    return records_to_result_set ((gpointer *) vgs, lvm_report_vg_fields, sizeof (BDLVMVGdata),
+                                  (GDestroyNotify) bd_lvm_vgdata_free, BD_LVM_RESULT_SET_VGS);
+}
+
+/**
+ * bd_lvm_lvs_result_set:
+ * @vg_name: (allow-none): name of the VG to get information about LVs from
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_lvs(), but with all the results allocated in a single
+ * #BDLVMResultSet which makes a big difference for systems with many LVs.
+ *
+ * Returns: (transfer full): information about LVs found in the given
+ * @vg_name VG or in system if @vg_name is %NULL or %NULL in case of error
+ * (the @error) gets populated in those cases)
+ *
+ * Note: The LVM DBus API provides the information object by object so only
+ *       freeing the result is cheaper with this plugin, not getting it.
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMResultSet* bd_lvm_lvs_result_set (const gchar *vg_name, GError **error) {
+    BDLVMLVdata **lvs = bd_lvm_lvs (vg_name, error);
+
+    if (!lvs)
+        /* the error is already populated from the call */
+        return NULL;
+
+    return records_to_result_set ((gpointer *) lvs, lvm_report_lv_fields, sizeof (BDLVMLVdata),
+                                  (GDestroyNotify) bd_lvm_lvdata_free, BD_LVM_RESULT_SET_LVS);
+}
+
 /**
  * bd_lvm_thpoolcreate:
  * @vg_name: name of the VG to create a thin pool in
@@ -2955,9 +4330,55 @@ gboolean bd_lvm_thsnapshotcreate (const gchar *vg_name, const gchar *origin_name
         g_variant_builder_clear (&builder);
     }
 
-    call_lv_method_sync (vg_name, origin_name, "Snapshot", params, extra_params, extra, TRUE, error);
+    call_lv_method_sync (vg_name, origin_name, "Snapshot", params, extra_params, extra, TRUE, error);
+
+    return (*error == NULL);
+}
+
+/**
+ * bd_lvm_thpool_stats:
+ * @vg_name: name of the VG containing the @pool_name thin pool
+ * @pool_name: name of the thin pool to get stats for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: stats for the @pool_name thin pool or %NULL in case of error
+ *
+ * The stats are gathered from the status and table of the pool's 'thin-pool'
+ * DM map, no LVM commands are run so this is cheap enough to be polled often.
+ *
+ * Tech category: %BD_LVM_TECH_THIN-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMThPoolStats* bd_lvm_thpool_stats (const gchar *vg_name, const gchar *pool_name, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
+        return NULL;
+    }
+
+    return lvm_dm_thpool_stats (vg_name, pool_name, error);
+}
 
-    return (*error == NULL);
+/**
+ * bd_lvm_thlv_stats:
+ * @vg_name: name of the VG containing the @lv_name thin LV
+ * @lv_name: name of the thin LV to get stats for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: stats for the @lv_name thin LV or %NULL in case of error
+ *
+ * The stats are gathered from the status of the LV's 'thin' DM map, no LVM
+ * commands are run.
+ *
+ * Tech category: %BD_LVM_TECH_THIN-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMThLVStats* bd_lvm_thlv_stats (const gchar *vg_name, const gchar *lv_name, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
+        return NULL;
+    }
+
+    return lvm_dm_thlv_stats (vg_name, lv_name, error);
 }
 
 /**
@@ -3006,6 +4427,100 @@ gchar* bd_lvm_get_global_config (GError **error UNUSED) {
     return ret;
 }
 
+/**
+ * bd_lvm_set_devices_filter:
+ * @devices: (allow-none) (array zero-terminated=1): list of devices for LVM
+ *                                                   commands to work with or
+ *                                                   %NULL (or empty list) to
+ *                                                   remove the filter
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the devices filter was successfully set or not
+ *
+ * Note: The LVM DBus API doesn't allow limiting the devices LVM works with so
+ *       the devices filter is not supported by this plugin (and can only be
+ *       removed).
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_set_devices_filter (const gchar **devices, GError **error) {
+    if (devices && *devices) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                     "Devices filter is not supported by the LVM DBus plugin");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * bd_lvm_get_devices_filter:
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full) (array zero-terminated=1): a copy of the currently
+ *                                                     set global devices filter
+ *                                                     (always %NULL with this plugin)
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gchar** bd_lvm_get_devices_filter (GError **error UNUSED) {
+    return NULL;
+}
+
+/**
+ * bd_lvm_set_thread_devices_filter:
+ * @devices: (allow-none) (array zero-terminated=1): list of devices for LVM
+ *                                                   commands run from the
+ *                                                   current thread to work with
+ *                                                   or %NULL (or empty list) to
+ *                                                   use the global filter
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the devices filter was successfully set or not
+ *
+ * Note: Not supported by this plugin, see bd_lvm_set_devices_filter().
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_set_thread_devices_filter (const gchar **devices, GError **error) {
+    return bd_lvm_set_devices_filter (devices, error);
+}
+
+/**
+ * bd_lvm_set_persistent_shell:
+ * @enabled: whether to run LVM commands in persistent 'lvm shell' processes or not
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the persistent shell mode was successfully set or not
+ *
+ * Note: The LVM DBus API doesn't run LVM commands directly so the persistent
+ *       shell mode is not supported by this plugin (and can only be disabled).
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_set_persistent_shell (gboolean enabled, GError **error) {
+    if (enabled) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                     "Persistent lvm shell is not supported by the LVM DBus plugin");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * bd_lvm_get_persistent_shell:
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the persistent shell mode is enabled or not (always %FALSE
+ *          for this plugin)
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_get_persistent_shell (GError **error UNUSED) {
+    return FALSE;
+}
+
 /**
  * bd_lvm_cache_get_default_md_size:
  * @cache_size: size of the cache to determine MD size for
@@ -3367,10 +4882,31 @@ gboolean bd_lvm_cache_create_cached_lv (const gchar *vg_name, const gchar *lv_na
  * Tech category: %BD_LVM_TECH_WRITECACHE-%BD_LVM_TECH_MODE_MODIFY
  */
 gboolean bd_lvm_writecache_attach (const gchar *vg_name, const gchar *data_lv, const gchar *cache_lv, const BDExtraArg **extra, GError **error) {
+    return bd_lvm_writecache_attach_with_settings (vg_name, data_lv, cache_lv, NULL, extra, error);
+}
+
+/**
+ * bd_lvm_writecache_attach_with_settings:
+ * @vg_name: name of the VG containing the @data_lv and the @cache_pool_lv LVs
+ * @data_lv: data LV to attach the @cache_lv to
+ * @cache_lv: cache (fast) LV to attach to the @data_lv
+ * @settings: (allow-none): writecache settings to use or %NULL for the defaults
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the cache attachment
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the @cache_lv was successfully attached to the @data_lv or not
+ *
+ * Tech category: %BD_LVM_TECH_WRITECACHE-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_writecache_attach_with_settings (const gchar *vg_name, const gchar *data_lv, const gchar *cache_lv,
+                                                 const BDLVMWritecacheSettings *settings, const BDExtraArg **extra, GError **error) {
     GVariantBuilder builder;
     GVariant *params = NULL;
+    GVariant *extra_params = NULL;
     gchar *lv_id = NULL;
     gchar *lv_obj_path = NULL;
+    gchar *settings_str = NULL;
     gboolean success = FALSE;
 
     /* both LVs need to be inactive for the writecache convert to work */
@@ -3392,14 +4928,69 @@ gboolean bd_lvm_writecache_attach (const gchar *vg_name, const gchar *data_lv, c
     params = g_variant_builder_end (&builder);
     g_variant_builder_clear (&builder);
 
+    settings_str = lvm_dm_writecache_settings_str (settings);
+    if (settings_str) {
+        g_variant_builder_init (&builder, G_VARIANT_TYPE_DICTIONARY);
+        g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "--cachesettings", g_variant_new ("s", settings_str)));
+        extra_params = g_variant_builder_end (&builder);
+        g_variant_builder_clear (&builder);
+        g_free (settings_str);
+    }
+
     lv_id = g_strdup_printf ("%s/%s", vg_name, cache_lv);
 
-    call_lvm_obj_method_sync (lv_id, LV_INTF, "WriteCacheLv", params, NULL, extra, TRUE, error);
+    call_lvm_obj_method_sync (lv_id, LV_INTF, "WriteCacheLv", params, extra_params, extra, TRUE, error);
     g_free (lv_id);
     g_free (lv_obj_path);
     return ((*error) == NULL);
 }
 
+/**
+ * bd_lvm_writecache_set_settings:
+ * @vg_name: name of the VG containing the @cached_lv
+ * @cached_lv: name of the writecache LV to change the settings of
+ * @settings: new writecache settings (fields set to %BD_LVM_WRITECACHE_SETTING_DEFAULT are left unchanged)
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the settings change
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the settings of the @cached_lv were successfully changed or not
+ *
+ * Note: The LVM DBus API has no way to change the settings of an existing
+ *       writecache so this function is not supported by this plugin.
+ *
+ * Tech category: %BD_LVM_TECH_WRITECACHE-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_writecache_set_settings (const gchar *vg_name UNUSED, const gchar *cached_lv UNUSED, const BDLVMWritecacheSettings *settings UNUSED,
+                                         const BDExtraArg **extra UNUSED, GError **error) {
+    g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                 "Changing writecache settings is not supported by the LVM DBus plugin");
+    return FALSE;
+}
+
+/**
+ * bd_lvm_writecache_stats:
+ * @vg_name: name of the VG containing the @cached_lv
+ * @cached_lv: writecache LV to get stats for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: stats for the @cached_lv or %NULL in case of error
+ *
+ * The stats are gathered from the status of the LV's 'writecache' DM map, no
+ * LVM commands are run.
+ *
+ * Tech category: %BD_LVM_TECH_WRITECACHE-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMWritecacheStats* bd_lvm_writecache_stats (const gchar *vg_name, const gchar *cached_lv, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
+        return NULL;
+    }
+
+    return lvm_dm_writecache_stats (vg_name, cached_lv, error);
+}
+
 /**
  * bd_lvm_writecache_detach:
  * @vg_name: name of the VG containing the @cached_lv
@@ -3550,7 +5141,6 @@ BDLVMCacheStats* bd_lvm_cache_stats (const gchar *vg_name, const gchar *cached_l
     struct dm_pool *pool = NULL;
     struct dm_task *task = NULL;
     struct dm_info info;
-    struct dm_status_cache *status = NULL;
     gchar *map_name = NULL;
     guint64 start = 0;
     guint64 length = 0;
@@ -3621,46 +5211,83 @@ BDLVMCacheStats* bd_lvm_cache_stats (const gchar *vg_name, const gchar *cached_l
 
     dm_get_next_target (task, NULL, &start, &length, &type, &params);
 
-    if (dm_get_status_cache (pool, params, &status) == 0) {
-        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
-                     "Failed to get status of the cache map '%s': ", map_name);
-        dm_task_destroy (task);
-        dm_pool_destroy (pool);
+    ret = lvm_dm_cache_stats_from_status (pool, params, map_name, error);
+
+    dm_task_destroy (task);
+    dm_pool_destroy (pool);
+
+    return ret;
+}
+
+/**
+ * bd_lvm_cache_stats_all:
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): stats for all the cached LVs in the
+ * system or %NULL in case of error
+ *
+ * The stats are gathered from the status of the 'cache' DM maps created by
+ * LVM, no LVM commands are run so this is much cheaper than calling
+ * bd_lvm_cache_stats() for every cached LV.
+ *
+ * Tech category: %BD_LVM_TECH_CACHE-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMCachedLVStats** bd_lvm_cache_stats_all (GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
         return NULL;
     }
 
-    ret = g_new0 (BDLVMCacheStats, 1);
-    ret->block_size = status->block_size * SECTOR_SIZE;
-    ret->cache_size = status->total_blocks * ret->block_size;
-    ret->cache_used = status->used_blocks * ret->block_size;
-
-    ret->md_block_size = status->metadata_block_size * SECTOR_SIZE;
-    ret->md_size = status->metadata_total_blocks * ret->md_block_size;
-    ret->md_used = status->metadata_used_blocks * ret->md_block_size;
+    return lvm_dm_cache_stats_all (error);
+}
 
-    ret->read_hits = status->read_hits;
-    ret->read_misses = status->read_misses;
-    ret->write_hits = status->write_hits;
-    ret->write_misses = status->write_misses;
+/**
+ * bd_lvm_cache_set_settings:
+ * @vg_name: name of the VG containing the @cached_lv
+ * @cached_lv: cached LV (or cached thin pool) to change the cache settings of
+ * @settings: new cache policy and settings (fields set to %NULL or
+ *            %BD_LVM_CACHE_SETTING_DEFAULT are left unchanged)
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the settings change
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the cache settings of the @cached_lv were successfully changed or not
+ *
+ * Note: The LVM DBus API has no way to change the settings of an existing
+ *       cache so this function is not supported by this plugin.
+ *
+ * Tech category: %BD_LVM_TECH_CACHE-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_cache_set_settings (const gchar *vg_name UNUSED, const gchar *cached_lv UNUSED, const BDLVMCacheSettings *settings UNUSED,
+                                    const BDExtraArg **extra UNUSED, GError **error) {
+    g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                 "Changing cache settings is not supported by the LVM DBus plugin");
+    return FALSE;
+}
 
-    if (status->feature_flags & DM_CACHE_FEATURE_WRITETHROUGH)
-        ret->mode = BD_LVM_CACHE_MODE_WRITETHROUGH;
-    else if (status->feature_flags & DM_CACHE_FEATURE_WRITEBACK)
-        ret->mode = BD_LVM_CACHE_MODE_WRITEBACK;
-    else {
-        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
-                      "Failed to determine status of the cache from '%"G_GUINT64_FORMAT"': ",
-                      status->feature_flags);
-        dm_task_destroy (task);
-        dm_pool_destroy (pool);
-        bd_lvm_cache_stats_free (ret);
+/**
+ * bd_lvm_cache_get_settings:
+ * @vg_name: name of the VG containing the @cached_lv
+ * @cached_lv: cached LV (or cached thin pool) to get the cache settings of
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): the policy and settings the cache of @cached_lv is
+ *                           currently using or %NULL in case of error
+ *
+ * The settings are read from the status of the LV's 'cache' DM map, no LVM
+ * commands are run.
+ *
+ * Tech category: %BD_LVM_TECH_CACHE-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMCacheSettings* bd_lvm_cache_get_settings (const gchar *vg_name, const gchar *cached_lv, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
         return NULL;
     }
 
-    dm_task_destroy (task);
-    dm_pool_destroy (pool);
-
-    return ret;
+    return lvm_dm_cache_get_settings (vg_name, cached_lv, error);
 }
 
 /**
@@ -3784,16 +5411,50 @@ gboolean bd_lvm_cache_pool_convert (const gchar *vg_name, const gchar *data_lv,
  * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_CREATE
  */
 gboolean bd_lvm_vdo_pool_create (const gchar *vg_name, const gchar *lv_name, const gchar *pool_name, guint64 data_size, guint64 virtual_size, guint64 index_memory, gboolean compression, gboolean deduplication, BDLVMVDOWritePolicy write_policy, const BDExtraArg **extra, GError **error) {
+    return bd_lvm_vdo_pool_create_with_tuning (vg_name, lv_name, pool_name, data_size, virtual_size, index_memory,
+                                               compression, deduplication, write_policy, NULL, extra, error);
+}
+
+/**
+ * bd_lvm_vdo_pool_create_with_tuning:
+ * @vg_name: name of the VG to create a new LV in
+ * @lv_name: name of the to-be-created VDO LV
+ * @pool_name: name of the to-be-created VDO pool LV
+ * @data_size: requested size of the data VDO LV (physical size of the @pool_name VDO pool LV)
+ * @virtual_size: requested virtual_size of the @lv_name VDO LV
+ * @index_memory: amount of index memory (in bytes) or 0 for default
+ * @compression: whether to enable compression or not
+ * @deduplication: whether to enable deduplication or not
+ * @write_policy: write policy for the volume
+ * @tuning: (allow-none): performance tuning parameters for the new VDO pool or
+ *                        %NULL to use the defaults from the LVM configuration
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the VDO LV creation
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_vdo_pool_create() but allows setting the number of the VDO
+ * worker threads, size of the block map cache and the bio rotation interval.
+ *
+ * Returns: whether the given @vg_name/@lv_name VDO LV was successfully created or not
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_CREATE
+ */
+gboolean bd_lvm_vdo_pool_create_with_tuning (const gchar *vg_name, const gchar *lv_name, const gchar *pool_name, guint64 data_size, guint64 virtual_size, guint64 index_memory, gboolean compression, gboolean deduplication, BDLVMVDOWritePolicy write_policy, const BDLVMVDOTuning *tuning, const BDExtraArg **extra, GError **error) {
     GVariantBuilder builder;
     GVariant *params = NULL;
     GVariant *extra_params = NULL;
     gchar *old_config = NULL;
     const gchar *write_policy_str = NULL;
+    gchar *settings_str = NULL;
 
     write_policy_str = bd_lvm_get_vdo_write_policy_str (write_policy, error);
     if (*error)
         return FALSE;
 
+    settings_str = lvm_dm_vdo_settings_str (tuning, error);
+    if (*error)
+        return FALSE;
+
     /* build the params tuple */
     g_variant_builder_init (&builder, G_VARIANT_TYPE_TUPLE);
     g_variant_builder_add_value (&builder, g_variant_new ("s", pool_name));
@@ -3807,6 +5468,10 @@ gboolean bd_lvm_vdo_pool_create (const gchar *vg_name, const gchar *lv_name, con
     g_variant_builder_init (&builder, G_VARIANT_TYPE_DICTIONARY);
     g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "--compression", g_variant_new ("s", compression ? "y" : "n")));
     g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "--deduplication", g_variant_new ("s", deduplication ? "y" : "n")));
+    if (settings_str) {
+        g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "--vdosettings", g_variant_new ("s", settings_str)));
+        g_free (settings_str);
+    }
     extra_params = g_variant_builder_end (&builder);
     g_variant_builder_clear (&builder);
 
@@ -3993,6 +5658,35 @@ gboolean bd_lvm_vdo_pool_convert (const gchar *vg_name UNUSED, const gchar *pool
     return bd_lvm_is_tech_avail (BD_LVM_TECH_VDO, BD_LVM_TECH_MODE_CREATE | BD_LVM_TECH_MODE_MODIFY, error);
 }
 
+/**
+ * bd_lvm_vdo_pool_convert_with_tuning:
+ * @vg_name: name of the VG that contains @pool_lv
+ * @pool_lv: name of the LV that should become the new VDO pool LV
+ * @name: (allow-none): name for the VDO LV or %NULL for default name
+ * @virtual_size: virtual size for the new VDO LV
+ * @index_memory: amount of index memory (in bytes) or 0 for default
+ * @compression: whether to enable compression or not
+ * @deduplication: whether to enable deduplication or not
+ * @write_policy: write policy for the volume
+ * @tuning: (allow-none): performance tuning parameters for the new VDO pool or
+ *                        %NULL to use the defaults from the LVM configuration
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the VDO pool creation
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_vdo_pool_convert() but allows setting the number of the VDO
+ * worker threads, size of the block map cache and the bio rotation interval.
+ *
+ * Note: All data on @pool_lv will be irreversibly destroyed.
+ *
+ * Returns: whether the new VDO pool LV was successfully created from @pool_lv and or not
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_CREATE&%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_vdo_pool_convert_with_tuning (const gchar *vg_name UNUSED, const gchar *pool_lv UNUSED, const gchar *name UNUSED, guint64 virtual_size UNUSED, guint64 index_memory UNUSED, gboolean compression UNUSED, gboolean deduplication UNUSED, BDLVMVDOWritePolicy write_policy UNUSED, const BDLVMVDOTuning *tuning UNUSED, const BDExtraArg **extra UNUSED, GError **error) {
+    return bd_lvm_is_tech_avail (BD_LVM_TECH_VDO, BD_LVM_TECH_MODE_CREATE | BD_LVM_TECH_MODE_MODIFY, error);
+}
+
 /**
  * bd_lvm_vdolvpoolname:
  * @vg_name: name of the VG containing the queried VDO LV
@@ -4208,26 +5902,67 @@ GHashTable* bd_lvm_vdo_get_stats_full (const gchar *vg_name, const gchar *pool_n
  * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_QUERY
  */
 BDLVMVDOStats* bd_lvm_vdo_get_stats (const gchar *vg_name, const gchar *pool_name, GError **error) {
-    GHashTable *full_stats = NULL;
-    BDLVMVDOStats *stats = NULL;
+    g_autofree gchar *kvdo_name = g_strdup_printf ("%s-%s-%s", vg_name, pool_name, VDO_POOL_SUFFIX);
+    return vdo_stats_get (kvdo_name, error);
+}
+
+/**
+ * bd_lvm_vdo_get_counters:
+ * @vg_name: name of the VG that contains @pool_name VDO pool
+ * @pool_name: name of the VDO pool to get the counters for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): a snapshot of the VDO counters or %NULL in case of error
+ *                           (@error gets populated in those cases)
+ *
+ * Only the statistics needed for the counters are read. The statistics files
+ * are kept open between the calls so this function is cheap enough to be
+ * called periodically, use bd_lvm_vdo_get_rates() to compute rates between
+ * two snapshots.
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVDOCounters* bd_lvm_vdo_get_counters (const gchar *vg_name, const gchar *pool_name, GError **error) {
+    g_autofree gchar *kvdo_name = g_strdup_printf ("%s-%s-%s", vg_name, pool_name, VDO_POOL_SUFFIX);
+    return vdo_stats_get_counters (kvdo_name, error);
+}
+
+/**
+ * bd_lvm_vdo_get_rates:
+ * @prev: the older snapshot of the counters
+ * @cur: the newer snapshot of the counters (of the same VDO pool)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): rates of the VDO counters between @prev and @cur or
+ *                           %NULL in case of error (@error gets populated in those cases)
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVDORates* bd_lvm_vdo_get_rates (const BDLVMVDOCounters *prev, const BDLVMVDOCounters *cur, GError **error) {
+    return vdo_stats_get_rates (prev, cur, error);
+}
 
-    full_stats = bd_lvm_vdo_get_stats_full (vg_name, pool_name, error);
-    if (!full_stats)
+/**
+ * bd_lvm_vdo_get_tuning:
+ * @vg_name: name of the VG that contains @pool_name VDO pool
+ * @pool_name: name of the VDO pool to get the tuning parameters for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): tuning parameters the active @vg_name/@pool_name VDO
+ *                           pool is running with or %NULL in case of error
+ *                           (@error gets populated in those cases)
+ *
+ * The values are taken from the device-mapper table of the VDO pool so they
+ * reflect the running configuration, not the LVM metadata. Requires root.
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVDOTuning* bd_lvm_vdo_get_tuning (const gchar *vg_name, const gchar *pool_name, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
         return NULL;
+    }
 
-    stats = g_new0 (BDLVMVDOStats, 1);
-    get_stat_val64_default (full_stats, "block_size", &stats->block_size, -1);
-    get_stat_val64_default (full_stats, "logical_block_size", &stats->logical_block_size, -1);
-    get_stat_val64_default (full_stats, "physical_blocks", &stats->physical_blocks, -1);
-    get_stat_val64_default (full_stats, "data_blocks_used", &stats->data_blocks_used, -1);
-    get_stat_val64_default (full_stats, "overhead_blocks_used", &stats->overhead_blocks_used, -1);
-    get_stat_val64_default (full_stats, "logical_blocks_used", &stats->logical_blocks_used, -1);
-    get_stat_val64_default (full_stats, "usedPercent", &stats->used_percent, -1);
-    get_stat_val64_default (full_stats, "savingPercent", &stats->saving_percent, -1);
-    if (!get_stat_val_double (full_stats, "writeAmplificationRatio", &stats->write_amplification_ratio))
-        stats->write_amplification_ratio = -1;
-
-    g_hash_table_destroy (full_stats);
-
-    return stats;
+    return lvm_dm_vdo_get_tuning (vg_name, pool_name, error);
 }
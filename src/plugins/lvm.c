@@ -21,12 +21,18 @@
 #include <math.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
 #include <blockdev/utils.h>
 
 #include "lvm.h"
 #include "check_deps.h"
 #include "dm_logging.h"
 #include "vdo_stats.h"
+#include "lvm_dm.h"
+#include "lvm_placement.h"
+#include "lvm_shell.h"
+#include "lvm_report.h"
 
 #define INT_FLOAT_EPS 1e-5
 #define SECTOR_SIZE 512
@@ -45,9 +51,37 @@
 #endif
 
 #define LVM_MIN_VERSION "2.02.116"
-
+/* first version supporting '--reportformat json' */
+#define LVM_JSON_REPORT_VERSION "2.02.158"
+/* first version supporting '--devices' */
+#define LVM_DEVICES_VERSION "2.03.12"
+/* first version supporting '--vdosettings' */
+#define LVM_VDO_SETTINGS_VERSION "2.03.17"
+
+#define PVS_FIELDS "pv_name,pv_uuid,pv_free,pv_size,pe_start,vg_name,vg_uuid,vg_size,vg_free,vg_extent_size,vg_extent_count,vg_free_count,pv_count,pv_tags"
+#define VGS_FIELDS "vg_name,vg_uuid,vg_size,vg_free,vg_extent_size,vg_extent_count,vg_free_count,pv_count,vg_exported,vg_tags"
+#define LVS_FIELDS "vg_name,lv_name,lv_uuid,lv_size,lv_attr,segtype,origin,pool_lv,data_lv,metadata_lv,role,move_pv,data_percent,metadata_percent,copy_percent,lv_tags"
+#define PVSEGS_FIELDS "pv_uuid,lv_uuid,pvseg_start,pvseg_size"
+
+/* immutable snapshot of the global config, replaced as a whole when a new
+   config is set so that running LVM commands doesn't block other threads */
+typedef struct GlobalConfig {
+    gint ref_count;
+    gchar *str;
+    gchar **devices;
+} GlobalConfig;
+
+/* protects only the pointer, not the (immutable) config */
 static GMutex global_config_lock;
-static gchar *global_config_str = NULL;
+static GlobalConfig *global_config = NULL;
+
+/* per-thread devices filter overriding the global one */
+static GPrivate thread_devices = G_PRIVATE_INIT ((GDestroyNotify) g_strfreev);
+
+/* -1 means not checked yet */
+static volatile gint json_report_avail = -1;
+static volatile gint devices_option_avail = -1;
+static volatile gint vdo_settings_avail = -1;
 
 /**
  * SECTION: lvm
@@ -217,6 +251,9 @@ BDLVMCacheStats* bd_lvm_cache_stats_copy (BDLVMCacheStats *data) {
     new->write_hits = data->write_hits;
     new->write_misses = data->write_misses;
     new->mode = data->mode;
+    new->promotions = data->promotions;
+    new->demotions = data->demotions;
+    new->cache_dirty = data->cache_dirty;
 
     return new;
 }
@@ -225,6 +262,316 @@ void bd_lvm_cache_stats_free (BDLVMCacheStats *data) {
     g_free (data);
 }
 
+BDLVMCacheSettings* bd_lvm_cache_settings_new (const gchar *policy, gint64 migration_threshold, gint64 sequential_threshold,
+                                               gint64 random_threshold) {
+    BDLVMCacheSettings *ret = g_new0 (BDLVMCacheSettings, 1);
+
+    ret->policy = g_strdup (policy);
+    ret->migration_threshold = migration_threshold;
+    ret->sequential_threshold = sequential_threshold;
+    ret->random_threshold = random_threshold;
+
+    return ret;
+}
+
+BDLVMCacheSettings* bd_lvm_cache_settings_copy (BDLVMCacheSettings *data) {
+    if (data == NULL)
+        return NULL;
+
+    return bd_lvm_cache_settings_new (data->policy, data->migration_threshold, data->sequential_threshold,
+                                      data->random_threshold);
+}
+
+void bd_lvm_cache_settings_free (BDLVMCacheSettings *data) {
+    if (data == NULL)
+        return;
+
+    g_free (data->policy);
+    g_free (data);
+}
+
+BDLVMPVSEGdata* bd_lvm_pvsegdata_copy (BDLVMPVSEGdata *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMPVSEGdata *new_data = g_new0 (BDLVMPVSEGdata, 1);
+
+    new_data->pv_uuid = g_strdup (data->pv_uuid);
+    new_data->lv_uuid = g_strdup (data->lv_uuid);
+    new_data->pv_start_pe = data->pv_start_pe;
+    new_data->size_pe = data->size_pe;
+    new_data->pv_index = data->pv_index;
+    new_data->lv_index = data->lv_index;
+    return new_data;
+}
+
+void bd_lvm_pvsegdata_free (BDLVMPVSEGdata *data) {
+    if (data == NULL)
+        return;
+
+    g_free (data->pv_uuid);
+    g_free (data->lv_uuid);
+    g_free (data);
+}
+
+BDLVMInventory* bd_lvm_inventory_copy (BDLVMInventory *data) {
+    guint i = 0;
+
+    if (data == NULL)
+        return NULL;
+
+    BDLVMInventory *new_data = g_new0 (BDLVMInventory, 1);
+
+    new_data->n_vgs = data->n_vgs;
+    new_data->vgs = g_new0 (BDLVMVGdata*, data->n_vgs + 1);
+    for (i=0; i < data->n_vgs; i++)
+        new_data->vgs[i] = bd_lvm_vgdata_copy (data->vgs[i]);
+
+    new_data->n_pvs = data->n_pvs;
+    new_data->pvs = g_new0 (BDLVMPVdata*, data->n_pvs + 1);
+    new_data->pv_vgs = g_new0 (gint, data->n_pvs);
+    for (i=0; i < data->n_pvs; i++) {
+        new_data->pvs[i] = bd_lvm_pvdata_copy (data->pvs[i]);
+        new_data->pv_vgs[i] = data->pv_vgs[i];
+    }
+
+    new_data->n_lvs = data->n_lvs;
+    new_data->lvs = g_new0 (BDLVMLVdata*, data->n_lvs + 1);
+    new_data->lv_vgs = g_new0 (gint, data->n_lvs);
+    for (i=0; i < data->n_lvs; i++) {
+        new_data->lvs[i] = bd_lvm_lvdata_copy (data->lvs[i]);
+        new_data->lv_vgs[i] = data->lv_vgs[i];
+    }
+
+    new_data->n_pvsegs = data->n_pvsegs;
+    new_data->pvsegs = g_new0 (BDLVMPVSEGdata*, data->n_pvsegs + 1);
+    for (i=0; i < data->n_pvsegs; i++)
+        new_data->pvsegs[i] = bd_lvm_pvsegdata_copy (data->pvsegs[i]);
+
+    return new_data;
+}
+
+void bd_lvm_inventory_free (BDLVMInventory *data) {
+    guint i = 0;
+
+    if (data == NULL)
+        return;
+
+    for (i=0; i < data->n_vgs; i++)
+        bd_lvm_vgdata_free (data->vgs[i]);
+    g_free (data->vgs);
+    for (i=0; i < data->n_pvs; i++)
+        bd_lvm_pvdata_free (data->pvs[i]);
+    g_free (data->pvs);
+    for (i=0; i < data->n_lvs; i++)
+        bd_lvm_lvdata_free (data->lvs[i]);
+    g_free (data->lvs);
+    for (i=0; i < data->n_pvsegs; i++)
+        bd_lvm_pvsegdata_free (data->pvsegs[i]);
+    g_free (data->pvsegs);
+    g_free (data->pv_vgs);
+    g_free (data->lv_vgs);
+    g_free (data);
+}
+
+BDLVMCachedLVStats* bd_lvm_cached_lv_stats_copy (BDLVMCachedLVStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMCachedLVStats *new_data = g_new0 (BDLVMCachedLVStats, 1);
+
+    new_data->vg_name = g_strdup (data->vg_name);
+    new_data->lv_name = g_strdup (data->lv_name);
+    new_data->stats = bd_lvm_cache_stats_copy (data->stats);
+
+    return new_data;
+}
+
+void bd_lvm_cached_lv_stats_free (BDLVMCachedLVStats *data) {
+    if (data == NULL)
+        return;
+
+    g_free (data->vg_name);
+    g_free (data->lv_name);
+    bd_lvm_cache_stats_free (data->stats);
+    g_free (data);
+}
+
+BDLVMThPoolStats* bd_lvm_thpool_stats_copy (BDLVMThPoolStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMThPoolStats *new = g_new0 (BDLVMThPoolStats, 1);
+
+    new->transaction_id = data->transaction_id;
+    new->data_block_size = data->data_block_size;
+    new->data_size = data->data_size;
+    new->data_used = data->data_used;
+    new->md_block_size = data->md_block_size;
+    new->md_size = data->md_size;
+    new->md_used = data->md_used;
+    new->held_md_root = data->held_md_root;
+    new->mode = data->mode;
+    new->needs_check = data->needs_check;
+    new->error_if_no_space = data->error_if_no_space;
+
+    return new;
+}
+
+void bd_lvm_thpool_stats_free (BDLVMThPoolStats *data) {
+    g_free (data);
+}
+
+BDLVMThLVStats* bd_lvm_thlv_stats_copy (BDLVMThLVStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMThLVStats *new = g_new0 (BDLVMThLVStats, 1);
+
+    new->mapped = data->mapped;
+    new->highest_mapped = data->highest_mapped;
+    new->failed = data->failed;
+
+    return new;
+}
+
+void bd_lvm_thlv_stats_free (BDLVMThLVStats *data) {
+    g_free (data);
+}
+
+BDLVMWritecacheSettings* bd_lvm_writecache_settings_new (gint64 high_watermark, gint64 low_watermark, gint64 writeback_jobs,
+                                                         gint64 autocommit_blocks, gint64 autocommit_time, gint64 block_size,
+                                                         gint64 cleaner) {
+    BDLVMWritecacheSettings *ret = g_new0 (BDLVMWritecacheSettings, 1);
+
+    ret->high_watermark = high_watermark;
+    ret->low_watermark = low_watermark;
+    ret->writeback_jobs = writeback_jobs;
+    ret->autocommit_blocks = autocommit_blocks;
+    ret->autocommit_time = autocommit_time;
+    ret->block_size = block_size;
+    ret->cleaner = cleaner;
+
+    return ret;
+}
+
+BDLVMWritecacheSettings* bd_lvm_writecache_settings_copy (BDLVMWritecacheSettings *data) {
+    if (data == NULL)
+        return NULL;
+
+    return bd_lvm_writecache_settings_new (data->high_watermark, data->low_watermark, data->writeback_jobs,
+                                           data->autocommit_blocks, data->autocommit_time, data->block_size,
+                                           data->cleaner);
+}
+
+void bd_lvm_writecache_settings_free (BDLVMWritecacheSettings *data) {
+    g_free (data);
+}
+
+BDLVMVDOTuning* bd_lvm_vdo_tuning_new (gint64 cpu_threads, gint64 bio_threads, gint64 ack_threads, gint64 hash_zone_threads,
+                                       gint64 logical_threads, gint64 physical_threads, gint64 block_map_cache_size,
+                                       gint64 bio_rotation) {
+    BDLVMVDOTuning *ret = g_new0 (BDLVMVDOTuning, 1);
+
+    ret->cpu_threads = cpu_threads;
+    ret->bio_threads = bio_threads;
+    ret->ack_threads = ack_threads;
+    ret->hash_zone_threads = hash_zone_threads;
+    ret->logical_threads = logical_threads;
+    ret->physical_threads = physical_threads;
+    ret->block_map_cache_size = block_map_cache_size;
+    ret->bio_rotation = bio_rotation;
+
+    return ret;
+}
+
+BDLVMVDOTuning* bd_lvm_vdo_tuning_copy (BDLVMVDOTuning *data) {
+    if (data == NULL)
+        return NULL;
+
+    return bd_lvm_vdo_tuning_new (data->cpu_threads, data->bio_threads, data->ack_threads, data->hash_zone_threads,
+                                  data->logical_threads, data->physical_threads, data->block_map_cache_size,
+                                  data->bio_rotation);
+}
+
+void bd_lvm_vdo_tuning_free (BDLVMVDOTuning *data) {
+    g_free (data);
+}
+
+BDLVMRaidStats* bd_lvm_raid_stats_copy (BDLVMRaidStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMRaidStats *new = g_new0 (BDLVMRaidStats, 1);
+
+    new->raid_type = g_strdup (data->raid_type);
+    new->dev_count = data->dev_count;
+    new->dev_health = g_strdup (data->dev_health);
+    new->failed_devs = data->failed_devs;
+    new->sync_size = data->sync_size;
+    new->sync_done = data->sync_done;
+    new->sync_percent = data->sync_percent;
+    new->sync_action = g_strdup (data->sync_action);
+    new->mismatch_count = data->mismatch_count;
+
+    return new;
+}
+
+void bd_lvm_raid_stats_free (BDLVMRaidStats *data) {
+    if (data == NULL)
+        return;
+
+    g_free (data->raid_type);
+    g_free (data->dev_health);
+    g_free (data->sync_action);
+    g_free (data);
+}
+
+BDLVMPlacement* bd_lvm_placement_copy (BDLVMPlacement *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMPlacement *new = g_new0 (BDLVMPlacement, 1);
+
+    new->pvs = g_strdupv (data->pvs);
+    new->stripes = data->stripes;
+    new->stripe_size = data->stripe_size;
+    new->rotational = data->rotational;
+
+    return new;
+}
+
+void bd_lvm_placement_free (BDLVMPlacement *data) {
+    if (data == NULL)
+        return;
+
+    g_strfreev (data->pvs);
+    g_free (data);
+}
+
+BDLVMWritecacheStats* bd_lvm_writecache_stats_copy (BDLVMWritecacheStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMWritecacheStats *new = g_new0 (BDLVMWritecacheStats, 1);
+
+    new->block_size = data->block_size;
+    new->total_blocks = data->total_blocks;
+    new->free_blocks = data->free_blocks;
+    new->writeback_blocks = data->writeback_blocks;
+    new->read_blocks = data->read_blocks;
+    new->read_hits = data->read_hits;
+    new->write_blocks = data->write_blocks;
+    new->write_hits = data->write_hits;
+    new->error = data->error;
+
+    return new;
+}
+
+void bd_lvm_writecache_stats_free (BDLVMWritecacheStats *data) {
+    g_free (data);
+}
+
 
 static volatile guint avail_deps = 0;
 static volatile guint avail_features = 0;
@@ -297,6 +644,11 @@ gboolean bd_lvm_check_deps (void) {
  *
  */
 gboolean bd_lvm_init (void) {
+    /* the LVM version may have changed since the last check */
+    g_atomic_int_set (&json_report_avail, -1);
+    g_atomic_int_set (&devices_option_avail, -1);
+    g_atomic_int_set (&vdo_settings_avail, -1);
+
     dm_log_with_errno_init ((dm_log_with_errno_fn) redirect_dm_log);
 #ifdef DEBUG
     dm_log_init_verbose (LOG_DEBUG);
@@ -315,6 +667,12 @@ gboolean bd_lvm_init (void) {
  *
  */
 void bd_lvm_close (void) {
+    /* terminate the persistent lvm shells (if any) */
+    lvm_shell_set_enabled (FALSE);
+
+    /* close the VDO statistics files kept open (if any) */
+    vdo_stats_close_all ();
+
     dm_log_with_errno_init (NULL);
     dm_log_init_verbose (0);
 }
@@ -357,62 +715,308 @@ gboolean bd_lvm_is_tech_avail (BDLVMTech tech, guint64 mode, GError **error) {
     }
 }
 
-static gboolean call_lvm_and_report_error (const gchar **args, const BDExtraArg **extra, gboolean lock_config, GError **error) {
+/**
+ * have_lvm_version: (skip)
+ * @avail: (inout): cached result of the check (-1 if not checked yet)
+ * @version: minimum LVM version required
+ * @what: description of the feature depending on the @version (for logging)
+ *
+ * Returns: whether the available LVM is at least @version or not (checked
+ *          only once)
+ */
+static gboolean have_lvm_version (volatile gint *avail, const gchar *version, const gchar *what) {
+    gint ret = g_atomic_int_get (avail);
+    GError *l_error = NULL;
+
+    if (ret >= 0)
+        return ret == 1;
+
+    if (bd_utils_check_util_version (deps[DEPS_LVM].name, version,
+                                     deps[DEPS_LVM].ver_arg, deps[DEPS_LVM].ver_regexp, &l_error))
+        ret = 1;
+    else {
+        bd_utils_log_format (BD_UTILS_LOG_INFO, "Not using %s: %s", what, l_error->message);
+        g_clear_error (&l_error);
+        ret = 0;
+    }
+    g_atomic_int_set (avail, ret);
+
+    return ret == 1;
+}
+
+/**
+ * have_json_report: (skip)
+ *
+ * Returns: whether the available LVM supports '--reportformat json' or not
+ */
+static gboolean have_json_report (void) {
+    return have_lvm_version (&json_report_avail, LVM_JSON_REPORT_VERSION, "JSON reports from LVM");
+}
+
+/**
+ * get_vdo_settings_str: (skip)
+ *
+ * Returns: (transfer full): the '--vdosettings' value for @tuning or %NULL if
+ *                           there's nothing to set or in case of error (with
+ *                           @error set), e.g. if the available LVM doesn't
+ *                           support the option
+ */
+static gchar* get_vdo_settings_str (const BDLVMVDOTuning *tuning, GError **error) {
+    gchar *settings_str = NULL;
+
+    settings_str = lvm_dm_vdo_settings_str (tuning, error);
+    if (settings_str && !have_lvm_version (&vdo_settings_avail, LVM_VDO_SETTINGS_VERSION, "the '--vdosettings' option")) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                     "LVM >= %s is required for setting the VDO tuning parameters", LVM_VDO_SETTINGS_VERSION);
+        g_free (settings_str);
+        return NULL;
+    }
+
+    return settings_str;
+}
+
+/**
+ * global_config_new: (skip)
+ *
+ * Returns: (transfer full): a new global config snapshot or %NULL if neither
+ *                           @str nor @devices is set
+ */
+static GlobalConfig* global_config_new (const gchar *str, const gchar * const *devices) {
+    GlobalConfig *config = NULL;
+
+    if (!str && (!devices || !*devices))
+        return NULL;
+
+    config = g_new0 (GlobalConfig, 1);
+    config->ref_count = 1;
+    config->str = g_strdup (str);
+    if (devices && *devices)
+        config->devices = g_strdupv ((gchar **) devices);
+
+    return config;
+}
+
+/**
+ * global_config_ref: (skip)
+ *
+ * Returns: (transfer full): snapshot of the current global config or %NULL if
+ *                           no global config is set
+ */
+static GlobalConfig* global_config_ref (void) {
+    GlobalConfig *config = NULL;
+
+    g_mutex_lock (&global_config_lock);
+    config = global_config;
+    if (config)
+        g_atomic_int_inc (&(config->ref_count));
+    g_mutex_unlock (&global_config_lock);
+
+    return config;
+}
+
+static void global_config_unref (GlobalConfig *config) {
+    if (config && g_atomic_int_dec_and_test (&(config->ref_count))) {
+        g_free (config->str);
+        g_strfreev (config->devices);
+        g_free (config);
+    }
+}
+
+/* devices the calls from this thread should be limited to (if any) */
+static const gchar* const* get_devices_filter (GlobalConfig *config) {
+    const gchar * const *devices = g_private_get (&thread_devices);
+
+    if (devices)
+        return devices;
+    else if (config)
+        return (const gchar * const *) config->devices;
+    else
+        return NULL;
+}
+
+/**
+ * get_filter_config: (skip)
+ * @config: (allow-none): LVM config to extend
+ * @devices: (array zero-terminated=1): devices to accept
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): @config extended with a global filter accepting
+ *                           only the @devices (for LVM not supporting '--devices')
+ *                           or %NULL if @config already sets a global filter
+ *                           (the second one would silently override it)
+ */
+static gchar* get_filter_config (const gchar *config, const gchar * const *devices, GError **error) {
+    GString *ret = NULL;
+    gchar *escaped = NULL;
+    gchar **parts = NULL;
+
+    if (config && strstr (config, "global_filter")) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                     "Devices filter cannot be combined with 'global_filter' in the global config "
+                     "with LVM < %s", LVM_DEVICES_VERSION);
+        return NULL;
+    }
+
+    ret = g_string_new (config);
+    g_string_append (ret, " devices {global_filter=[");
+    for (; *devices; devices++) {
+        escaped = g_regex_escape_string (*devices, -1);
+        /* backslashes need to be escaped once more in the config string */
+        parts = g_strsplit (escaped, "\\", -1);
+        g_free (escaped);
+        escaped = g_strjoinv ("\\\\", parts);
+        g_strfreev (parts);
+        g_string_append_printf (ret, "\"a|^%s$|\", ", escaped);
+        g_free (escaped);
+    }
+    g_string_append (ret, "\"r|.*|\"]}");
+
+    return g_string_free (ret, FALSE);
+}
+
+/* passes @output to @line_func line by line (modifying it in place) */
+static gboolean process_output_lines (gchar *output, BDUtilsLineFunc line_func, gpointer line_data, GError **error) {
+    gchar *line = output;
+    gchar *newline = NULL;
+
+    while (line && *line) {
+        newline = strchr (line, '\n');
+        if (newline)
+            *newline = '\0';
+        if (!line_func (line, line_data)) {
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Processing of the output stopped");
+            return FALSE;
+        }
+        line = newline ? newline + 1 : NULL;
+    }
+
+    return TRUE;
+}
+
+/**
+ * call_lvm_with_config: (skip)
+ * @args: (array zero-terminated=1): arguments for lvm
+ * @extra: (allow-none) (array zero-terminated=1): extra arguments
+ * @config: (allow-none): LVM config to run the command with
+ * @devices: (allow-none) (array zero-terminated=1): devices to limit the command to
+ * @output: (allow-none) (out): place to store the output of the command or %NULL
+ *                              if the output is not needed
+ * @line_func: (allow-none): function to pass the output to line by line (instead
+ *                           of storing it in @output)
+ * @line_data: (allow-none): data for @line_func
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the command was successfully run or not
+ */
+static gboolean call_lvm_with_config (const gchar **args, const BDExtraArg **extra, const gchar *config, const gchar * const *devices,
+                                     gchar **output, BDUtilsLineFunc line_func, gpointer line_data, GError **error) {
     gboolean success = FALSE;
     guint i = 0;
     guint args_length = g_strv_length ((gchar **) args);
+    guint next_arg = 0;
+    gchar *devices_str = NULL;
+    gchar *devices_arg = NULL;
+    gchar *filter_config = NULL;
+    gchar *config_arg = NULL;
+    gchar *shell_output = NULL;
+    LVMShellStatus shell_status = LVM_SHELL_UNAVAILABLE;
+    GError *l_error = NULL;
 
     if (!check_deps (&avail_deps, DEPS_LVM_MASK, deps, DEPS_LAST, &deps_check_lock, error))
         return FALSE;
 
-    /* don't allow global config string changes during the run */
-    if (lock_config)
-        g_mutex_lock (&global_config_lock);
+    if (devices && *devices) {
+        if (have_lvm_version (&devices_option_avail, LVM_DEVICES_VERSION, "the '--devices' option")) {
+            devices_str = g_strjoinv (",", (gchar **) devices);
+            devices_arg = g_strdup_printf ("--devices=%s", devices_str);
+            g_free (devices_str);
+        } else {
+            config = filter_config = get_filter_config (config, devices, error);
+            if (!filter_config)
+                return FALSE;
+        }
+    }
 
-    /* allocate enough space for the args plus "lvm", "--config" and NULL */
-    const gchar **argv = g_new0 (const gchar*, args_length + 3);
+    /* allocate enough space for "lvm", the args, "--devices", "--config" and NULL */
+    const gchar **argv = g_new0 (const gchar*, args_length + 4);
 
     /* construct argv from args with "lvm" prepended */
     argv[0] = "lvm";
     for (i=0; i < args_length; i++)
         argv[i+1] = args[i];
-    argv[args_length + 1] = global_config_str ? g_strdup_printf("--config=%s", global_config_str) : NULL;
-    argv[args_length + 2] = NULL;
+    next_arg = args_length + 1;
+    if (devices_arg)
+        argv[next_arg++] = devices_arg;
+
+    /* try the persistent lvm shell first (if enabled) */
+    shell_status = lvm_shell_run (argv + 1, extra, config, line_func ? &shell_output : output, &l_error);
+    if (shell_status != LVM_SHELL_UNAVAILABLE) {
+        if (line_func && g_error_matches (l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_NOOUT)) {
+            /* no output, no lines to process */
+            g_clear_error (&l_error);
+            shell_status = LVM_SHELL_OK;
+        }
+        success = (shell_status == LVM_SHELL_OK);
+        if (!success)
+            g_propagate_error (error, l_error);
+        else if (line_func)
+            /* the shell gives us all the output at once */
+            success = process_output_lines (shell_output, line_func, line_data, error);
+        g_free (shell_output);
+    } else {
+        config_arg = config ? g_strdup_printf ("--config=%s", config) : NULL;
+        argv[next_arg++] = config_arg;
+
+        if (line_func)
+            success = bd_utils_exec_and_process_lines (argv, extra, line_func, line_data,
+                                                       BD_UTILS_EXEC_DEFAULT_MAX_STDERR, error);
+        else if (output)
+            success = bd_utils_exec_and_capture_output (argv, extra, output, error);
+        else
+            success = bd_utils_exec_and_report_error (argv, extra, error);
+    }
 
-    success = bd_utils_exec_and_report_error (argv, extra, error);
-    if (lock_config)
-        g_mutex_unlock (&global_config_lock);
-    g_free ((gchar *) argv[args_length + 1]);
+    g_free (config_arg);
+    g_free (devices_arg);
+    g_free (filter_config);
     g_free (argv);
 
     return success;
 }
 
-static gboolean call_lvm_and_capture_output (const gchar **args, const BDExtraArg **extra, gchar **output, GError **error) {
+static gboolean call_lvm_and_report_error (const gchar **args, const BDExtraArg **extra, GError **error) {
+    GlobalConfig *config = NULL;
     gboolean success = FALSE;
-    guint i = 0;
-    guint args_length = g_strv_length ((gchar **) args);
 
-    if (!check_deps (&avail_deps, DEPS_LVM_MASK, deps, DEPS_LAST, &deps_check_lock, error))
-        return FALSE;
+    /* the snapshot stays valid for the whole run even if the global config
+       is changed in the meantime */
+    config = global_config_ref ();
+    success = call_lvm_with_config (args, extra, config ? config->str : NULL, get_devices_filter (config), NULL, NULL, NULL, error);
+    global_config_unref (config);
 
-    /* don't allow global config string changes during the run */
-    g_mutex_lock (&global_config_lock);
+    return success;
+}
 
-    /* allocate enough space for the args plus "lvm", "--config" and NULL */
-    const gchar **argv = g_new0 (const gchar*, args_length + 3);
+static gboolean call_lvm_and_capture_output (const gchar **args, const BDExtraArg **extra, gchar **output, GError **error) {
+    GlobalConfig *config = NULL;
+    gboolean success = FALSE;
 
-    /* construct argv from args with "lvm" prepended */
-    argv[0] = "lvm";
-    for (i=0; i < args_length; i++)
-        argv[i+1] = args[i];
-    argv[args_length + 1] = global_config_str ? g_strdup_printf("--config=%s", global_config_str) : NULL;
-    argv[args_length + 2] = NULL;
+    config = global_config_ref ();
+    success = call_lvm_with_config (args, extra, config ? config->str : NULL, get_devices_filter (config), output, NULL, NULL, error);
+    global_config_unref (config);
 
-    success = bd_utils_exec_and_capture_output (argv, extra, output, error);
-    g_mutex_unlock (&global_config_lock);
-    g_free ((gchar *) argv[args_length + 1]);
-    g_free (argv);
+    return success;
+}
+
+static gboolean call_lvm_and_process_lines (const gchar **args, BDUtilsLineFunc line_func, gpointer line_data, GError **error) {
+    GlobalConfig *config = NULL;
+    gboolean success = FALSE;
+
+    config = global_config_ref ();
+    success = call_lvm_with_config (args, NULL, config ? config->str : NULL, get_devices_filter (config), NULL,
+                                    line_func, line_data, error);
+    global_config_unref (config);
 
     return success;
 }
@@ -637,9 +1241,12 @@ static BDLVMLVdata* get_lv_data_from_table (GHashTable *table, gboolean free_tab
 
     /* replace '[' and ']' (marking LVs as internal) with spaces and then
        remove all the leading and trailing whitespace */
-    g_strstrip (g_strdelimit (data->pool_lv, "[]", ' '));
-    g_strstrip (g_strdelimit (data->data_lv, "[]", ' '));
-    g_strstrip (g_strdelimit (data->metadata_lv, "[]", ' '));
+    if (data->pool_lv)
+        g_strstrip (g_strdelimit (data->pool_lv, "[]", ' '));
+    if (data->data_lv)
+        g_strstrip (g_strdelimit (data->data_lv, "[]", ' '));
+    if (data->metadata_lv)
+        g_strstrip (g_strdelimit (data->metadata_lv, "[]", ' '));
 
     if (free_table)
         g_hash_table_destroy (table);
@@ -647,6 +1254,178 @@ static BDLVMLVdata* get_lv_data_from_table (GHashTable *table, gboolean free_tab
     return data;
 }
 
+typedef gpointer (*TableDataFunc) (GHashTable *table, gboolean free_table);
+
+typedef struct ReportType {
+    const gchar *section;
+    const gchar *desc;
+    const LVMReportField *fields;
+    gsize data_size;
+    TableDataFunc table_func;
+    GDestroyNotify free_func;
+} ReportType;
+
+static const ReportType pv_report = {"pv", "PVs", lvm_report_pv_fields, sizeof (BDLVMPVdata),
+                                     (TableDataFunc) get_pv_data_from_table, (GDestroyNotify) bd_lvm_pvdata_free};
+static const ReportType vg_report = {"vg", "VGs", lvm_report_vg_fields, sizeof (BDLVMVGdata),
+                                     (TableDataFunc) get_vg_data_from_table, (GDestroyNotify) bd_lvm_vgdata_free};
+static const ReportType lv_report = {"lv", "LVs", lvm_report_lv_fields, sizeof (BDLVMLVdata),
+                                     (TableDataFunc) get_lv_data_from_table, (GDestroyNotify) bd_lvm_lvdata_free};
+
+/* state of parsing a '--nameprefixes' report line by line */
+typedef struct ReportParse {
+    const ReportType *report;
+    guint n_items;
+    LVMReportArena *arena;
+    GPtrArray *records;
+    guint n_lines;
+} ReportParse;
+
+static gboolean parse_report_line (const gchar *line, gpointer user_data) {
+    ReportParse *parse = (ReportParse *) user_data;
+    GHashTable *table = NULL;
+    guint num_items = 0;
+    gpointer data = NULL;
+
+    if (*line == '\0')
+        return TRUE;
+    parse->n_lines++;
+
+    table = parse_lvm_vars (line, &num_items);
+    if (table && (num_items == parse->n_items)) {
+        /* valid line, try to parse and record it */
+        data = parse->report->table_func (table, TRUE);
+        if (parse->arena) {
+            g_ptr_array_add (parse->records, lvm_report_arena_copy_record (parse->arena, data, parse->report->fields,
+                                                                           parse->report->data_size));
+            parse->report->free_func (data);
+        } else
+            g_ptr_array_add (parse->records, data);
+    } else if (table)
+        g_hash_table_destroy (table);
+
+    return TRUE;
+}
+
+/**
+ * get_report_data: (skip)
+ * @args: (array zero-terminated=1): the reporting command (e.g. "lvs") followed
+ *                                   by its arguments except for the output format
+ * @report: type of the report
+ * @n_items: number of fields a valid record has
+ * @list: whether listing all items or asking for a particular one
+ * @arena: (allow-none): arena to allocate the records in or %NULL
+ * @error: (out): place to store error (if any)
+ *
+ * Runs the reporting command with '--reportformat json' if supported by LVM
+ * and parses the output directly into the data structs. With older versions
+ * of LVM, the '--nameprefixes' format is used and parsed line by line as the
+ * output comes (and the records are copied into the @arena). The JSON report
+ * is a single document so it's read into memory as a whole before parsing.
+ *
+ * Returns: (transfer full): records of the report or %NULL in case of error,
+ *                           when listing no output means an empty array
+ */
+static GPtrArray* get_report_data (const gchar **args, const ReportType *report, guint n_items, gboolean list,
+                                   LVMReportArena *arena, GError **error) {
+    guint args_length = g_strv_length ((gchar **) args);
+    const gchar **report_args = NULL;
+    gboolean json = have_json_report ();
+    gboolean success = FALSE;
+    gchar *output = NULL;
+    GPtrArray *records = NULL;
+    ReportParse parse = {report, n_items, arena, NULL, 0};
+    guint i = 0;
+
+    /* allocate enough space for the args plus the two format arguments and NULL */
+    report_args = g_new0 (const gchar*, args_length + 3);
+    report_args[0] = args[0];
+    report_args[1] = json ? "--reportformat" : "--nameprefixes";
+    report_args[2] = json ? "json" : "--unquoted";
+    for (i=1; i < args_length; i++)
+        report_args[i+2] = args[i];
+
+    if (json) {
+        success = call_lvm_and_capture_output (report_args, NULL, &output, error);
+        g_free (report_args);
+        if (!success) {
+            if (list && g_error_matches (*error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_NOOUT)) {
+                /* no output => no items, not an error */
+                g_clear_error (error);
+                return g_ptr_array_new ();
+            }
+            /* the error is already populated from the call */
+            return NULL;
+        }
+
+        records = lvm_json_report_parse (output, report->section, report->fields, n_items,
+                                         report->data_size, report->free_func, arena, error);
+        g_free (output);
+        if (records)
+            g_ptr_array_set_free_func (records, NULL);
+        return records;
+    }
+
+    /* records allocated in the arena are freed with it */
+    parse.records = records = g_ptr_array_new_with_free_func (arena ? NULL : report->free_func);
+    success = call_lvm_and_process_lines (report_args, parse_report_line, &parse, error);
+    g_free (report_args);
+    if (!success) {
+        /* the error is already populated from the call */
+        g_ptr_array_free (records, TRUE);
+        return NULL;
+    }
+
+    if (parse.n_lines == 0 && !list) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_NOOUT,
+                     "Process didn't provide any data on standard output.");
+        g_ptr_array_free (records, TRUE);
+        return NULL;
+    }
+
+    if (list && parse.n_lines > 0 && records->len == 0) {
+        /* some output, but nothing valid in it */
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to parse information about %s", report->desc);
+        g_ptr_array_free (records, TRUE);
+        return NULL;
+    }
+
+    /* the records are owned by the caller now */
+    g_ptr_array_set_free_func (records, NULL);
+    return records;
+}
+
+/* runs the reporting command listing items and puts the records into a new
+   result set */
+static BDLVMResultSet* get_report_result_set (const gchar **args, const ReportType *report, guint n_items,
+                                              BDLVMResultSetType item_type, GError **error) {
+    LVMReportArena arena;
+    GPtrArray *records = NULL;
+
+    lvm_report_arena_init (&arena);
+    records = get_report_data (args, report, n_items, TRUE, &arena, error);
+    if (!records) {
+        /* the error is already populated from the call */
+        lvm_report_arena_clear (&arena);
+        return NULL;
+    }
+
+    return lvm_report_arena_to_result_set (&arena, item_type, records);
+}
+
+/* returns the first record and frees the rest and @records */
+static gpointer take_first_record (GPtrArray *records, const ReportType *report) {
+    gpointer ret = g_ptr_array_index (records, 0);
+    guint i = 0;
+
+    for (i=1; i < records->len; i++)
+        report->free_func (g_ptr_array_index (records, i));
+    g_ptr_array_free (records, TRUE);
+
+    return ret;
+}
+
 static BDLVMVDOPooldata* get_vdo_data_from_table (GHashTable *table, gboolean free_table) {
     BDLVMVDOPooldata *data = g_new0 (BDLVMVDOPooldata, 1);
     gchar *value = NULL;
@@ -955,7 +1734,7 @@ gboolean bd_lvm_pvcreate (const gchar *device, guint64 data_alignment, guint64 m
         args[next_arg++] = metadata_str;
     }
 
-    ret = call_lvm_and_report_error (args, extra, TRUE, error);
+    ret = call_lvm_and_report_error (args, extra, error);
     g_free (dataalign_str);
     g_free (metadata_str);
 
@@ -996,7 +1775,7 @@ gboolean bd_lvm_pvresize (const gchar *device, guint64 size, const BDExtraArg **
 
     args[next_pos] = device;
 
-    ret = call_lvm_and_report_error (args, extra, TRUE, error);
+    ret = call_lvm_and_report_error (args, extra, error);
     if (to_free_pos > 0)
         g_free ((gchar *) args[to_free_pos]);
 
@@ -1019,48 +1798,344 @@ gboolean bd_lvm_pvremove (const gchar *device, const BDExtraArg **extra, GError
        bug, at least not in this code) */
     const gchar *args[6] = {"pvremove", "--force", "--force", "--yes", device, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, error);
+}
+
+#define PVMOVE_POLL_INTERVAL (500 * 1000) /* microseconds */
+#define PVMOVE_MAX_QUERY_FAILURES 5
+/* percentage of the time dm-mirror's kcopyd is allowed to do I/O */
+#define PVMOVE_THROTTLE_FILE "/sys/module/dm_mirror/parameters/raid1_resync_throttle"
+
+static gint get_pvmove_throttle (GError **error) {
+    gchar *contents = NULL;
+    guint64 value = 0;
+
+    if (!g_file_get_contents (PVMOVE_THROTTLE_FILE, &contents, NULL, error))
+        return -1;
+    value = g_ascii_strtoull (contents, NULL, 10);
+    g_free (contents);
+    if (value == 0 || value > 100) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Invalid value in '%s'", PVMOVE_THROTTLE_FILE);
+        return -1;
+    }
+
+    return (gint) value;
+}
+
+static gboolean set_pvmove_throttle (gint throttle, GError **error) {
+    gchar *str = g_strdup_printf ("%d", throttle);
+    gboolean ret = bd_utils_echo_str_to_file (str, PVMOVE_THROTTLE_FILE, error);
+
+    g_free (str);
+    return ret;
+}
+
+/* the throttle is global, the original value is saved by the first of the
+   (possibly concurrent) rate-limited moves and restored by the last one */
+static GMutex pvmove_throttle_lock;
+static guint pvmove_throttle_users = 0;
+static gint pvmove_orig_throttle = -1;
+
+static gint acquire_pvmove_throttle (GError **error) {
+    gint ret = -1;
+
+    g_mutex_lock (&pvmove_throttle_lock);
+    if (pvmove_throttle_users == 0)
+        pvmove_orig_throttle = get_pvmove_throttle (error);
+    if (pvmove_orig_throttle > 0) {
+        pvmove_throttle_users++;
+        ret = pvmove_orig_throttle;
+    }
+    g_mutex_unlock (&pvmove_throttle_lock);
+
+    return ret;
+}
+
+static void release_pvmove_throttle (void) {
+    GError *l_error = NULL;
+
+    g_mutex_lock (&pvmove_throttle_lock);
+    pvmove_throttle_users--;
+    if (pvmove_throttle_users == 0 && !set_pvmove_throttle (pvmove_orig_throttle, &l_error)) {
+        bd_utils_log_format (BD_UTILS_LOG_WARNING, "Failed to restore the dm-mirror resync throttle: %s", l_error->message);
+        g_clear_error (&l_error);
+    }
+    g_mutex_unlock (&pvmove_throttle_lock);
+}
+
+/* the copy rate is (roughly) proportional to the throttle, the step towards the
+   new value is halved to avoid oscillation caused by the bursty copying */
+static gint adjust_pvmove_throttle (gint throttle, gdouble rate, guint64 max_rate) {
+    gdouble target = 0.0;
+
+    if (rate <= 0.0)
+        /* nothing copied in the last interval, let kcopyd do more */
+        return MIN (throttle * 2, 100);
+
+    target = throttle * (gdouble) max_rate / rate;
+    return CLAMP ((gint) ((throttle + target) / 2), 1, 100);
+}
+
+/* gets the name of the pvmove LV moving extents off of the @pv_name PV in the
+   @vg_name VG, fails with %BD_LVM_ERROR_NOEXIST if there is no such LV */
+static gchar* get_pvmove_lv (const gchar *vg_name, const gchar *pv_name, GError **error) {
+    BDLVMLVdata **lvs = NULL;
+    gchar *selection = NULL;
+    gchar *ret = NULL;
+    gsize len = 0;
+
+    selection = g_strdup_printf ("vg_name=\"%s\"", vg_name);
+    lvs = bd_lvm_lvs_select (selection, BD_LVM_LV_FIELD_NAME | BD_LVM_LV_FIELD_MOVE_PV, error);
+    g_free (selection);
+    if (!lvs)
+        /* the error is already populated from the call */
+        return NULL;
+
+    for (BDLVMLVdata **lv_p = lvs; *lv_p; lv_p++) {
+        if (!ret && (*lv_p)->lv_name && g_strcmp0 ((*lv_p)->move_pv, pv_name) == 0) {
+            /* pvmove LVs are internal LVs, reported as '[pvmoveN]' */
+            ret = g_strdup ((*lv_p)->lv_name + ((*lv_p)->lv_name[0] == '[' ? 1 : 0));
+            len = strlen (ret);
+            if (len > 0 && ret[len - 1] == ']')
+                ret[len - 1] = '\0';
+        }
+        bd_lvm_lvdata_free (*lv_p);
+    }
+    g_free (lvs);
+
+    if (!ret)
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOEXIST,
+                     "No pvmove LV moving extents off of the PV '%s' found", pv_name);
+
+    return ret;
+}
+
+/* polls the DM status of the pvmove LV until its map disappears (i.e. all the
+   extents are moved), reporting progress and keeping the copy rate below
+   @max_rate (if not 0) */
+static gboolean wait_for_pvmove (const gchar *vg_name, const gchar *lv_name, dev_t src_dev, guint64 max_rate,
+                                 guint64 progress_id, GError **error) {
+    guint64 moved = 0;
+    guint64 total = 0;
+    guint64 prev_moved = 0;
+    gint64 now = 0;
+    gint64 prev_time = 0;
+    gdouble rate = 0.0;
+    gdouble cur_rate = 0.0;
+    gint orig_throttle = -1;
+    gint throttle = 100;
+    gint new_throttle = 0;
+    guint failures = 0;
+    gchar *msg = NULL;
+    GError *l_error = NULL;
+    gboolean ret = TRUE;
+
+    if (max_rate > 0) {
+        orig_throttle = acquire_pvmove_throttle (&l_error);
+        if (orig_throttle < 0) {
+            bd_utils_log_format (BD_UTILS_LOG_WARNING, "Cannot limit the pvmove rate: %s", l_error->message);
+            g_clear_error (&l_error);
+            max_rate = 0;
+        } else
+            throttle = orig_throttle;
+    }
+
+    while (TRUE) {
+        if (!lvm_dm_pvmove_progress (vg_name, lv_name, src_dev, &moved, &total, &l_error)) {
+            if (g_error_matches (l_error, BD_LVM_ERROR, BD_LVM_ERROR_NOEXIST)) {
+                g_clear_error (&l_error);
+                break;
+            }
+            /* the map is reloaded every time the next segment starts being
+               moved so some of the queries may fail */
+            if (++failures >= PVMOVE_MAX_QUERY_FAILURES) {
+                g_propagate_prefixed_error (error, l_error, "Failed to get pvmove progress: ");
+                ret = FALSE;
+                break;
+            }
+            g_clear_error (&l_error);
+            g_usleep (PVMOVE_POLL_INTERVAL);
+            continue;
+        }
+        failures = 0;
+
+        now = g_get_monotonic_time ();
+        if (prev_time > 0 && now > prev_time) {
+            /* moved data can go down if a segment's mirror is restarted */
+            cur_rate = moved >= prev_moved ? (gdouble) (moved - prev_moved) * G_USEC_PER_SEC / (now - prev_time) : 0.0;
+            /* smooth the rate, the copying is done in bursts of regions */
+            rate = rate > 0.0 ? 0.7 * rate + 0.3 * cur_rate : cur_rate;
+
+            if (max_rate > 0) {
+                new_throttle = adjust_pvmove_throttle (throttle, cur_rate, max_rate);
+                if (new_throttle != throttle) {
+                    if (set_pvmove_throttle (new_throttle, &l_error))
+                        throttle = new_throttle;
+                    else {
+                        bd_utils_log_format (BD_UTILS_LOG_WARNING, "Cannot limit the pvmove rate: %s", l_error->message);
+                        g_clear_error (&l_error);
+                        max_rate = 0;
+                    }
+                }
+            }
+        }
+        prev_moved = moved;
+        prev_time = now;
+
+        if (rate > 0.0 && total > moved)
+            msg = g_strdup_printf ("Moved %"G_GUINT64_FORMAT" of %"G_GUINT64_FORMAT" bytes, ETA %"G_GUINT64_FORMAT" s",
+                                   moved, total, (guint64) ((total - moved) / rate));
+        else
+            msg = g_strdup_printf ("Moved %"G_GUINT64_FORMAT" of %"G_GUINT64_FORMAT" bytes", moved, total);
+        bd_utils_report_progress (progress_id, total > 0 ? moved * 100 / total : 0, msg);
+        g_free (msg);
+
+        g_usleep (PVMOVE_POLL_INTERVAL);
+    }
+
+    if (orig_throttle > 0)
+        release_pvmove_throttle ();
+
+    return ret;
 }
 
-static gboolean extract_pvmove_progress (const gchar *line, guint8 *completion) {
-    gchar *num_start = NULL;
-    gint n_scanned = 0;
-    guint8 try_completion = 0;
+/* waits for the pvmove of the @pv_name PV started in the background to finish */
+static gboolean watch_pvmove (const gchar *vg_name, const gchar *pv_name, dev_t src_dev, guint64 max_rate,
+                              guint64 progress_id, GError **error) {
+    gchar *lv_name = NULL;
+    GError *l_error = NULL;
+    gboolean ret = FALSE;
 
-    num_start = strrchr (line, ' ');
-    if (!num_start)
+    lv_name = get_pvmove_lv (vg_name, pv_name, &l_error);
+    if (!lv_name) {
+        if (g_error_matches (l_error, BD_LVM_ERROR, BD_LVM_ERROR_NOEXIST)) {
+            /* already finished */
+            g_clear_error (&l_error);
+            return TRUE;
+        }
+        g_propagate_error (error, l_error);
         return FALSE;
-    num_start++;
-    n_scanned = sscanf (num_start, "%hhu", &try_completion);
-    if (n_scanned == 1) {
-        *completion = try_completion;
-        return TRUE;
     }
-    return FALSE;
+
+    ret = wait_for_pvmove (vg_name, lv_name, src_dev, max_rate, progress_id, error);
+    g_free (lv_name);
+    if (!ret)
+        return FALSE;
+
+    /* the map is gone, the pvmove LV should be gone too */
+    lv_name = get_pvmove_lv (vg_name, pv_name, &l_error);
+    if (lv_name) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "The pvmove LV '%s/%s' was deactivated before the move finished", vg_name, lv_name);
+        g_free (lv_name);
+        return FALSE;
+    }
+    if (!g_error_matches (l_error, BD_LVM_ERROR, BD_LVM_ERROR_NOEXIST)) {
+        g_propagate_error (error, l_error);
+        return FALSE;
+    }
+    g_clear_error (&l_error);
+
+    return TRUE;
+}
+
+/**
+ * bd_lvm_pvmove:
+ * @src: the PV device to move extents off of
+ * @dest: (allow-none): the PV device to move extents onto or %NULL
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the PV move
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the extents from the @src PV where successfully moved or not
+ *
+ * If @dest is %NULL, VG allocation rules are used for the extents from the @src
+ * PV (see pvmove(8)).
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_pvmove (const gchar *src, const gchar *dest, const BDExtraArg **extra, GError **error) {
+    return bd_lvm_pvmove_with_rate (src, dest, 0, extra, error);
 }
 
 /**
- * bd_lvm_pvmove:
+ * bd_lvm_pvmove_with_rate:
  * @src: the PV device to move extents off of
  * @dest: (allow-none): the PV device to move extents onto or %NULL
+ * @max_rate: maximum copy rate (in bytes per second) or 0 for no limit
  * @extra: (allow-none) (array zero-terminated=1): extra options for the PV move
  *                                                 (just passed to LVM as is)
  * @error: (out): place to store error (if any)
  *
  * Returns: whether the extents from the @src PV where successfully moved or not
  *
- * If @dest is %NULL, VG allocation rules are used for the extents from the @src
- * PV (see pvmove(8)).
+ * The progress (moved bytes and the estimated remaining time) is read from the
+ * DM status of the temporary pvmove LV and reported via the progress reporting
+ * of the utils library. If @dest is %NULL, VG allocation rules are used for
+ * the extents from the @src PV (see pvmove(8)).
+ *
+ * The @max_rate limit is enforced by adjusting the dm-mirror resync throttle
+ * which is a global setting affecting all mirror resyncs on the system while
+ * the move is running (the original value is restored afterwards). If the
+ * throttle cannot be changed, the move is not limited.
  *
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_MODIFY
  */
-gboolean bd_lvm_pvmove (const gchar *src, const gchar *dest, const BDExtraArg **extra, GError **error) {
-    const gchar *args[6] = {"pvmove", "-i", "1", src, NULL, NULL};
-    gint status = 0;
+gboolean bd_lvm_pvmove_with_rate (const gchar *src, const gchar *dest, guint64 max_rate, const BDExtraArg **extra, GError **error) {
+    const gchar *args[5] = {"pvmove", "-b", src, NULL, NULL};
+    BDLVMPVdata *pv_info = NULL;
+    struct stat st;
+    gchar *vg_name = NULL;
+    gchar *pv_name = NULL;
+    gchar *msg = NULL;
+    guint64 progress_id = 0;
+    gboolean ret = FALSE;
+
     if (dest)
-        args[4] = dest;
+        args[3] = dest;
+
+    pv_info = bd_lvm_pvinfo (src, error);
+    if (!pv_info)
+        /* the error is already populated from the call */
+        return FALSE;
+
+    if (!pv_info->vg_name || !*(pv_info->vg_name)) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "The PV '%s' is not part of any VG", src);
+        bd_lvm_pvdata_free (pv_info);
+        return FALSE;
+    }
+
+    if (stat (pv_info->pv_name, &st) != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "Failed to get information about the PV '%s': %s", pv_info->pv_name, g_strerror (errno));
+        bd_lvm_pvdata_free (pv_info);
+        return FALSE;
+    }
+
+    vg_name = g_strdup (pv_info->vg_name);
+    pv_name = g_strdup (pv_info->pv_name);
+    bd_lvm_pvdata_free (pv_info);
+
+    msg = g_strdup_printf ("Started 'pvmove %s'", src);
+    progress_id = bd_utils_report_started (msg);
+    g_free (msg);
+
+    /* let LVM do the move in the background and watch the pvmove LV */
+    ret = call_lvm_and_report_error (args, extra, error) &&
+          watch_pvmove (vg_name, pv_name, st.st_rdev, max_rate, progress_id, error);
+    g_free (pv_name);
+    g_free (vg_name);
+
+    if (!ret) {
+        bd_utils_report_finished (progress_id, (*error)->message);
+        return FALSE;
+    }
 
-    return bd_utils_exec_and_report_progress (args, extra, extract_pvmove_progress, &status, error);
+    bd_utils_report_progress (progress_id, 100, "Completed");
+    bd_utils_report_finished (progress_id, "Completed");
+    return TRUE;
 }
 
 /**
@@ -1088,7 +2163,7 @@ gboolean bd_lvm_pvscan (const gchar *device, gboolean update_cache, const BDExtr
         if (device)
             bd_utils_log_format (BD_UTILS_LOG_WARNING, "Ignoring the device argument in pvscan (cache update not requested)");
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, error);
 }
 
 static gboolean _manage_lvm_tags (const gchar *devspec, const gchar **tags, const gchar *action, const gchar *cmd, GError **error) {
@@ -1105,7 +2180,7 @@ static gboolean _manage_lvm_tags (const gchar *devspec, const gchar **tags, cons
     argv[next_arg++] = devspec;
     argv[next_arg] = NULL;
 
-    success = call_lvm_and_report_error (argv, NULL, TRUE, error);
+    success = call_lvm_and_report_error (argv, NULL, error);
     g_free (argv);
     return success;
 }
@@ -1149,42 +2224,25 @@ gboolean bd_lvm_delete_pv_tags (const gchar *device, const gchar **tags, GError
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
  */
 BDLVMPVdata* bd_lvm_pvinfo (const gchar *device, GError **error) {
-    const gchar *args[10] = {"pvs", "--unit=b", "--nosuffix", "--nameprefixes",
-                       "--unquoted", "--noheadings",
-                       "-o", "pv_name,pv_uuid,pv_free,pv_size,pe_start,vg_name,vg_uuid,vg_size," \
-                       "vg_free,vg_extent_size,vg_extent_count,vg_free_count,pv_count,pv_tags",
+    const gchar *args[8] = {"pvs", "--unit=b", "--nosuffix", "--noheadings",
+                       "-o", PVS_FIELDS,
                        device, NULL};
-    GHashTable *table = NULL;
-    gboolean success = FALSE;
-    gchar *output = NULL;
-    gchar **lines = NULL;
-    gchar **lines_p = NULL;
-    guint num_items;
+    GPtrArray *pvs = NULL;
 
-    success = call_lvm_and_capture_output (args, NULL, &output, error);
-    if (!success)
+    pvs = get_report_data (args, &pv_report, 14, FALSE, NULL, error);
+    if (!pvs)
         /* the error is already populated from the call */
         return NULL;
 
-    lines = g_strsplit (output, "\n", 0);
-    g_free (output);
-
-    for (lines_p = lines; *lines_p; lines_p++) {
-        table = parse_lvm_vars ((*lines_p), &num_items);
-        if (table && (num_items == 14)) {
-            g_clear_error (error);
-            g_strfreev (lines);
-            return get_pv_data_from_table (table, TRUE);
-        } else
-            if (table)
-                g_hash_table_destroy (table);
+    if (pvs->len == 0) {
+        g_ptr_array_free (pvs, TRUE);
+        /* getting here means no usable info was found */
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to parse information about the PV");
+        return NULL;
     }
-    g_strfreev (lines);
 
-    /* getting here means no usable info was found */
-    g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
-                 "Failed to parse information about the PV");
-    return NULL;
+    return (BDLVMPVdata *) take_first_record (pvs, &pv_report);
 }
 
 /**
@@ -1196,61 +2254,66 @@ BDLVMPVdata* bd_lvm_pvinfo (const gchar *device, GError **error) {
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
  */
 BDLVMPVdata** bd_lvm_pvs (GError **error) {
-    const gchar *args[9] = {"pvs", "--unit=b", "--nosuffix", "--nameprefixes",
-                       "--unquoted", "--noheadings",
-                       "-o", "pv_name,pv_uuid,pv_free,pv_size,pe_start,vg_name,vg_uuid,vg_size," \
-                       "vg_free,vg_extent_size,vg_extent_count,vg_free_count,pv_count,pv_tags",
+    const gchar *args[7] = {"pvs", "--unit=b", "--nosuffix", "--noheadings",
+                       "-o", PVS_FIELDS,
                        NULL};
-    GHashTable *table = NULL;
-    gboolean success = FALSE;
-    gchar *output = NULL;
-    gchar **lines = NULL;
-    gchar **lines_p = NULL;
-    guint num_items;
-    GPtrArray *pvs;
-    BDLVMPVdata *pvdata = NULL;
-
-    pvs = g_ptr_array_new ();
+    GPtrArray *pvs = NULL;
 
-    success = call_lvm_and_capture_output (args, NULL, &output, error);
-    if (!success) {
-        if (g_error_matches (*error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_NOOUT)) {
-            /* no output => no VGs, not an error */
-            g_clear_error (error);
-            /* return an empty list */
-            g_ptr_array_add (pvs, NULL);
-            return (BDLVMPVdata **) g_ptr_array_free (pvs, FALSE);
-        }
-        else {
-            /* the error is already populated from the call */
-            g_ptr_array_free (pvs, TRUE);
-            return NULL;
-        }
-    }
+    pvs = get_report_data (args, &pv_report, 14, TRUE, NULL, error);
+    if (!pvs)
+        /* the error is already populated from the call */
+        return NULL;
 
-    lines = g_strsplit (output, "\n", 0);
-    g_free (output);
+    /* returning NULL-terminated array of BDLVMPVdata */
+    g_ptr_array_add (pvs, NULL);
+    return (BDLVMPVdata **) g_ptr_array_free (pvs, FALSE);
+}
 
-    for (lines_p = lines; *lines_p; lines_p++) {
-        table = parse_lvm_vars ((*lines_p), &num_items);
-        if (table && (num_items == 14)) {
-            /* valid line, try to parse and record it */
-            pvdata = get_pv_data_from_table (table, TRUE);
-            if (pvdata)
-                g_ptr_array_add (pvs, pvdata);
-        } else
-            if (table)
-                g_hash_table_destroy (table);
+/**
+ * bd_lvm_pvs_select:
+ * @selection: (allow-none): LVM selection criteria for the PVs (see the
+ *                           '--select' option in lvmreport(7)) or %NULL to
+ *                           get all PVs
+ * @fields: a combination of (ORed) #BDLVMPVField specifying which fields of
+ *          the returned structs should be filled, 0 means all of them
+ * @error: (out): place to store error (if any)
+ *
+ * Both the selection and the field projection are done by LVM so asking for
+ * a few fields of a few PVs is much cheaper than bd_lvm_pvs(). Fields not
+ * requested by @fields are left %NULL or 0 in the returned structs.
+ *
+ * Returns: (array zero-terminated=1): information about PVs matching the
+ * @selection
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMPVdata** bd_lvm_pvs_select (const gchar *selection, BDLVMPVField fields, GError **error) {
+    const gchar *args[9] = {"pvs", "--unit=b", "--nosuffix", "--noheadings",
+                            "-o", NULL, NULL, NULL, NULL};
+    gchar *fields_str = NULL;
+    guint n_fields = 0;
+    GPtrArray *pvs = NULL;
+
+    /* the bits of BDLVMPVField are in the same order as the known fields */
+    fields_str = lvm_report_fields_str (lvm_report_pv_fields, fields ? fields : BD_LVM_PV_FIELD_ALL, &n_fields);
+    if (n_fields == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "No valid fields requested");
+        g_free (fields_str);
+        return NULL;
     }
+    args[5] = fields_str;
 
-    g_strfreev (lines);
+    if (selection) {
+        args[6] = "--select";
+        args[7] = selection;
+    }
 
-    if (pvs->len == 0) {
-        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
-                     "Failed to parse information about PVs");
-        g_ptr_array_free (pvs, TRUE);
+    pvs = get_report_data (args, &pv_report, n_fields, TRUE, NULL, error);
+    g_free (fields_str);
+    if (!pvs)
+        /* the error is already populated from the call */
         return NULL;
-    }
 
     /* returning NULL-terminated array of BDLVMPVdata */
     g_ptr_array_add (pvs, NULL);
@@ -1286,7 +2349,7 @@ gboolean bd_lvm_vgcreate (const gchar *name, const gchar **pv_list, guint64 pe_s
     }
     argv[i] = NULL;
 
-    success = call_lvm_and_report_error (argv, extra, TRUE, error);
+    success = call_lvm_and_report_error (argv, extra, error);
     g_free ((gchar *) argv[2]);
     g_free (argv);
 
@@ -1307,7 +2370,7 @@ gboolean bd_lvm_vgcreate (const gchar *name, const gchar **pv_list, guint64 pe_s
 gboolean bd_lvm_vgremove (const gchar *vg_name, const BDExtraArg **extra, GError **error) {
     const gchar *args[4] = {"vgremove", "--force", vg_name, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, error);
 }
 
 /**
@@ -1325,7 +2388,7 @@ gboolean bd_lvm_vgremove (const gchar *vg_name, const BDExtraArg **extra, GError
 gboolean bd_lvm_vgrename (const gchar *old_vg_name, const gchar *new_vg_name, const BDExtraArg **extra, GError **error) {
     const gchar *args[4] = {"vgrename", old_vg_name, new_vg_name, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, error);
 }
 
 /**
@@ -1342,7 +2405,7 @@ gboolean bd_lvm_vgrename (const gchar *old_vg_name, const gchar *new_vg_name, co
 gboolean bd_lvm_vgactivate (const gchar *vg_name, const BDExtraArg **extra, GError **error) {
     const gchar *args[4] = {"vgchange", "-ay", vg_name, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, error);
 }
 
 /**
@@ -1359,7 +2422,7 @@ gboolean bd_lvm_vgactivate (const gchar *vg_name, const BDExtraArg **extra, GErr
 gboolean bd_lvm_vgdeactivate (const gchar *vg_name, const BDExtraArg **extra, GError **error) {
     const gchar *args[4] = {"vgchange", "-an", vg_name, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, error);
 }
 
 /**
@@ -1377,7 +2440,7 @@ gboolean bd_lvm_vgdeactivate (const gchar *vg_name, const BDExtraArg **extra, GE
 gboolean bd_lvm_vgextend (const gchar *vg_name, const gchar *device, const BDExtraArg **extra, GError **error) {
     const gchar *args[4] = {"vgextend", vg_name, device, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, error);
 }
 
 /**
@@ -1408,7 +2471,7 @@ gboolean bd_lvm_vgreduce (const gchar *vg_name, const gchar *device, const BDExt
         args[2] = device;
     }
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, error);
 }
 
 /**
@@ -1450,41 +2513,25 @@ gboolean bd_lvm_delete_vg_tags (const gchar *vg_name, const gchar **tags, GError
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
  */
 BDLVMVGdata* bd_lvm_vginfo (const gchar *vg_name, GError **error) {
-    const gchar *args[10] = {"vgs", "--noheadings", "--nosuffix", "--nameprefixes",
-                       "--unquoted", "--units=b",
+    const gchar *args[8] = {"vgs", "--noheadings", "--nosuffix", "--units=b",
                        "-o", "name,uuid,size,free,extent_size,extent_count,free_count,pv_count,vg_exported,vg_tags",
                        vg_name, NULL};
+    GPtrArray *vgs = NULL;
 
-    GHashTable *table = NULL;
-    gboolean success = FALSE;
-    gchar *output = NULL;
-    gchar **lines = NULL;
-    gchar **lines_p = NULL;
-    guint num_items;
-
-    success = call_lvm_and_capture_output (args, NULL, &output, error);
-    if (!success)
+    vgs = get_report_data (args, &vg_report, 10, FALSE, NULL, error);
+    if (!vgs)
         /* the error is already populated from the call */
         return NULL;
 
-    lines = g_strsplit (output, "\n", 0);
-    g_free (output);
-
-    for (lines_p = lines; *lines_p; lines_p++) {
-        table = parse_lvm_vars ((*lines_p), &num_items);
-        if (table && (num_items == 10)) {
-            g_strfreev (lines);
-            return get_vg_data_from_table (table, TRUE);
-        } else
-            if (table)
-                g_hash_table_destroy (table);
+    if (vgs->len == 0) {
+        g_ptr_array_free (vgs, TRUE);
+        /* getting here means no usable info was found */
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to parse information about the VG");
+        return NULL;
     }
-    g_strfreev (lines);
 
-    /* getting here means no usable info was found */
-    g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
-                 "Failed to parse information about the VG");
-    return NULL;
+    return (BDLVMVGdata *) take_first_record (vgs, &vg_report);
 }
 
 /**
@@ -1496,60 +2543,15 @@ BDLVMVGdata* bd_lvm_vginfo (const gchar *vg_name, GError **error) {
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
  */
 BDLVMVGdata** bd_lvm_vgs (GError **error) {
-    const gchar *args[9] = {"vgs", "--noheadings", "--nosuffix", "--nameprefixes",
-                      "--unquoted", "--units=b",
+    const gchar *args[7] = {"vgs", "--noheadings", "--nosuffix", "--units=b",
                       "-o", "name,uuid,size,free,extent_size,extent_count,free_count,pv_count,vg_tags",
                       NULL};
-    GHashTable *table = NULL;
-    gboolean success = FALSE;
-    gchar *output = NULL;
-    gchar **lines = NULL;
-    gchar **lines_p = NULL;
-    guint num_items;
-    GPtrArray *vgs;
-    BDLVMVGdata *vgdata = NULL;
-
-    vgs = g_ptr_array_new ();
-
-    success = call_lvm_and_capture_output (args, NULL, &output, error);
-    if (!success) {
-        if (g_error_matches (*error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_NOOUT)) {
-            /* no output => no VGs, not an error */
-            g_clear_error (error);
-            /* return an empty list */
-            g_ptr_array_add (vgs, NULL);
-            return (BDLVMVGdata **) g_ptr_array_free (vgs, FALSE);
-        }
-        else {
-            /* the error is already populated from the call */
-            g_ptr_array_free (vgs, TRUE);
-            return NULL;
-       }
-    }
-
-    lines = g_strsplit (output, "\n", 0);
-    g_free (output);
-
-    for (lines_p = lines; *lines_p; lines_p++) {
-        table = parse_lvm_vars ((*lines_p), &num_items);
-        if (table && (num_items == 9)) {
-            /* valid line, try to parse and record it */
-            vgdata = get_vg_data_from_table (table, TRUE);
-            if (vgdata)
-                g_ptr_array_add (vgs, vgdata);
-        } else
-            if (table)
-                g_hash_table_destroy (table);
-    }
-
-    g_strfreev (lines);
+    GPtrArray *vgs = NULL;
 
-    if (vgs->len == 0) {
-        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
-                     "Failed to parse information about VGs");
-        g_ptr_array_free (vgs, TRUE);
+    vgs = get_report_data (args, &vg_report, 9, TRUE, NULL, error);
+    if (!vgs)
+        /* the error is already populated from the call */
         return NULL;
-    }
 
     /* returning NULL-terminated array of BDLVMVGdata */
     g_ptr_array_add (vgs, NULL);
@@ -1632,7 +2634,7 @@ gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 si
 
     args[i] = NULL;
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free (size_str);
     g_free (type_str);
     g_free (args);
@@ -1640,6 +2642,218 @@ gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 si
     return success;
 }
 
+/**
+ * bd_lvm_raid_create:
+ * @vg_name: name of the VG to create a new RAID LV in
+ * @lv_name: name of the to-be-created RAID LV
+ * @raid_type: RAID type of the new LV ("raid1", "raid5", "raid10",..., see lvmraid (7))
+ * @size: requested size of the new LV
+ * @stripes: number of stripes (data devices) or 0 for default
+ * @stripe_size: stripe size (in bytes) or 0 for default
+ * @mirrors: number of additional mirror images or 0 for default
+ * @pv_list: (allow-none) (array zero-terminated=1): list of PVs the new LV should be allocated from
+ *                                                   or %NULL if not specified
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the LV creation
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the given @vg_name/@lv_name RAID LV was successfully created or not
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_CREATE
+ */
+gboolean bd_lvm_raid_create (const gchar *vg_name, const gchar *lv_name, const gchar *raid_type, guint64 size, guint stripes, guint64 stripe_size, guint mirrors, const gchar **pv_list, const BDExtraArg **extra, GError **error) {
+    guint pv_list_len = pv_list ? g_strv_length ((gchar **) pv_list) : 0;
+    const gchar **args = NULL;
+    gboolean success = FALSE;
+    guint i = 0;
+    guint j = 0;
+    gchar *size_str = NULL;
+    gchar *stripes_str = NULL;
+    gchar *stripe_size_str = NULL;
+    gchar *mirrors_str = NULL;
+
+    if (!raid_type || !g_str_has_prefix (raid_type, "raid")) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "Invalid RAID type '%s'", raid_type ? raid_type : "");
+        return FALSE;
+    }
+
+    args = g_new0 (const gchar*, pv_list_len + 16);
+    args[i++] = "lvcreate";
+    args[i++] = "--type";
+    args[i++] = raid_type;
+    args[i++] = "-n";
+    args[i++] = lv_name;
+    args[i++] = "-L";
+    size_str = g_strdup_printf ("%"G_GUINT64_FORMAT"K", size / 1024);
+    args[i++] = size_str;
+    args[i++] = "-y";
+    if (stripes > 0) {
+        args[i++] = "--stripes";
+        stripes_str = g_strdup_printf ("%u", stripes);
+        args[i++] = stripes_str;
+    }
+    if (stripe_size > 0) {
+        args[i++] = "--stripesize";
+        stripe_size_str = g_strdup_printf ("%"G_GUINT64_FORMAT"K", stripe_size / 1024);
+        args[i++] = stripe_size_str;
+    }
+    if (mirrors > 0) {
+        args[i++] = "--mirrors";
+        mirrors_str = g_strdup_printf ("%u", mirrors);
+        args[i++] = mirrors_str;
+    }
+    args[i++] = vg_name;
+
+    for (j=0; j < pv_list_len; j++)
+        args[i++] = pv_list[j];
+
+    args[i] = NULL;
+
+    success = call_lvm_and_report_error (args, extra, error);
+    g_free (size_str);
+    g_free (stripes_str);
+    g_free (stripe_size_str);
+    g_free (mirrors_str);
+    g_free (args);
+
+    return success;
+}
+
+/**
+ * bd_lvm_raid_set_recovery_rate:
+ * @vg_name: name of the VG containing the @lv_name RAID LV
+ * @lv_name: name of the RAID LV to set the recovery rate for
+ * @min_rate: minimum recovery rate (in bytes per second per device), 0 for no
+ *            limit or %BD_LVM_RAID_RATE_UNCHANGED to keep the current value
+ * @max_rate: maximum recovery rate (in bytes per second per device), 0 for no
+ *            limit or %BD_LVM_RAID_RATE_UNCHANGED to keep the current value
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the LV change
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Throttles the resynchronization/recovery of the @vg_name/@lv_name RAID LV so
+ * that it doesn't starve the regular I/O (@max_rate) or makes progress even
+ * under load (@min_rate). The rates can be changed while the LV is active. LVM
+ * takes the rates in KiB/s so they are rounded up to whole KiB/s. Negative
+ * rates other than %BD_LVM_RAID_RATE_UNCHANGED are rejected.
+ *
+ * Returns: whether the recovery rate of the @vg_name/@lv_name was successfully set or not
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_raid_set_recovery_rate (const gchar *vg_name, const gchar *lv_name, gint64 min_rate, gint64 max_rate, const BDExtraArg **extra, GError **error) {
+    const gchar *args[7] = {"lvchange", NULL, NULL, NULL, NULL, NULL, NULL};
+    gchar *min_str = NULL;
+    gchar *max_str = NULL;
+    gchar *lv_spec = NULL;
+    gboolean success = FALSE;
+    guint next_arg = 1;
+
+    if ((min_rate < 0 && min_rate != BD_LVM_RAID_RATE_UNCHANGED) ||
+        (max_rate < 0 && max_rate != BD_LVM_RAID_RATE_UNCHANGED)) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "Invalid recovery rate: must be non-negative or BD_LVM_RAID_RATE_UNCHANGED");
+        return FALSE;
+    }
+
+    if (min_rate == BD_LVM_RAID_RATE_UNCHANGED && max_rate == BD_LVM_RAID_RATE_UNCHANGED)
+        /* nothing to change */
+        return TRUE;
+
+    if (min_rate != BD_LVM_RAID_RATE_UNCHANGED) {
+        args[next_arg++] = "--minrecoveryrate";
+        /* round up, "0K" would mean no limit */
+        min_str = g_strdup_printf ("%"G_GINT64_FORMAT"K", (min_rate + 1023) / 1024);
+        args[next_arg++] = min_str;
+    }
+    if (max_rate != BD_LVM_RAID_RATE_UNCHANGED) {
+        args[next_arg++] = "--maxrecoveryrate";
+        max_str = g_strdup_printf ("%"G_GINT64_FORMAT"K", (max_rate + 1023) / 1024);
+        args[next_arg++] = max_str;
+    }
+    lv_spec = g_strdup_printf ("%s/%s", vg_name, lv_name);
+    args[next_arg++] = lv_spec;
+
+    success = call_lvm_and_report_error (args, extra, error);
+
+    g_free (min_str);
+    g_free (max_str);
+    g_free (lv_spec);
+    return success;
+}
+
+/**
+ * bd_lvm_raid_stats:
+ * @vg_name: name of the VG containing the @lv_name RAID LV
+ * @lv_name: name of the RAID LV to get stats for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: sync progress and health of the @lv_name RAID LV or %NULL in case of error
+ *
+ * The stats are gathered from the status of the LV's 'raid' DM map, no LVM
+ * commands are run.
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMRaidStats* bd_lvm_raid_stats (const gchar *vg_name, const gchar *lv_name, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
+        return NULL;
+    }
+
+    return lvm_dm_raid_stats (vg_name, lv_name, error);
+}
+
+/**
+ * bd_lvm_plan_placement:
+ * @vg_name: name of the VG to plan the placement of a new LV in
+ * @size: requested size of the new LV
+ * @max_stripes: maximum number of stripes or 0 for no limit
+ * @error: (out): place to store error (if any)
+ *
+ * Picks PVs, number of stripes and stripe size for a new LV of @size in the
+ * @vg_name VG based on the free space of the PVs and the properties of the
+ * disks the PVs are stored on:
+ *
+ * - as many stripes as possible (up to @max_stripes) are used,
+ * - PVs stored on the same disk (partitions, stacked devices) are never used
+ *   as stripes of the same LV,
+ * - non-rotational PVs are preferred and rotational and non-rotational PVs
+ *   are not mixed unless the LV doesn't fit otherwise,
+ * - the stripe size is based on the optimal I/O size and physical block size
+ *   of the devices (64 KiB by default).
+ *
+ * If the LV cannot be striped, a linear placement over as few PVs as possible
+ * is returned. Use the resulting PVs with bd_lvm_lvcreate() with the "striped"
+ * type if #BDLVMPlacement.stripes is greater than 1 or with %NULL type
+ * otherwise. The number of stripes is given by the number of PVs passed as
+ * @pv_list to bd_lvm_lvcreate() so only "--stripesize" (set to
+ * #BDLVMPlacement.stripe_size) needs to be given as an extra argument.
+ *
+ * Returns: (transfer full): the suggested placement of the new LV or %NULL in
+ *                           case of error (e.g. not enough free space in the VG)
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMPlacement* bd_lvm_plan_placement (const gchar *vg_name, guint64 size, guint max_stripes, GError **error) {
+    BDLVMPVdata **pvs = NULL;
+    BDLVMPlacement *ret = NULL;
+
+    pvs = bd_lvm_pvs (error);
+    if (!pvs)
+        return NULL;
+
+    ret = lvm_plan_placement (pvs, vg_name, size, max_stripes, error);
+
+    for (BDLVMPVdata **pv = pvs; *pv; pv++)
+        bd_lvm_pvdata_free (*pv);
+    g_free (pvs);
+
+    return ret;
+}
+
 /**
  * bd_lvm_lvremove:
  * @vg_name: name of the VG containing the to-be-removed LV
@@ -1666,7 +2880,7 @@ gboolean bd_lvm_lvremove (const gchar *vg_name, const gchar *lv_name, gboolean f
 
     args[next_arg] = g_strdup_printf ("%s/%s", vg_name, lv_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[next_arg]);
 
     return success;
@@ -1688,7 +2902,7 @@ gboolean bd_lvm_lvremove (const gchar *vg_name, const gchar *lv_name, gboolean f
  */
 gboolean bd_lvm_lvrename (const gchar *vg_name, const gchar *lv_name, const gchar *new_name, const BDExtraArg **extra, GError **error) {
     const gchar *args[5] = {"lvrename", vg_name, lv_name, new_name, NULL};
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, error);
 }
 
 
@@ -1712,7 +2926,7 @@ gboolean bd_lvm_lvresize (const gchar *vg_name, const gchar *lv_name, guint64 si
     args[3] = g_strdup_printf ("%"G_GUINT64_FORMAT"K", size/1024);
     args[4] = g_strdup_printf ("%s/%s", vg_name, lv_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[3]);
     g_free ((gchar *) args[4]);
 
@@ -1743,7 +2957,7 @@ gboolean bd_lvm_lvactivate (const gchar *vg_name, const gchar *lv_name, gboolean
     }
     args[next_arg] = g_strdup_printf ("%s/%s", vg_name, lv_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[next_arg]);
 
     return success;
@@ -1767,7 +2981,7 @@ gboolean bd_lvm_lvdeactivate (const gchar *vg_name, const gchar *lv_name, const
 
     args[2] = g_strdup_printf ("%s/%s", vg_name, lv_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[2]);
 
     return success;
@@ -1795,7 +3009,7 @@ gboolean bd_lvm_lvsnapshotcreate (const gchar *vg_name, const gchar *origin_name
     args[3] = g_strdup_printf ("%"G_GUINT64_FORMAT"K", size / 1024);
     args[6] = g_strdup_printf ("%s/%s", vg_name, origin_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[3]);
     g_free ((gchar *) args[6]);
 
@@ -1820,7 +3034,7 @@ gboolean bd_lvm_lvsnapshotmerge (const gchar *vg_name, const gchar *snapshot_nam
 
     args[2] = g_strdup_printf ("%s/%s", vg_name, snapshot_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[2]);
 
     return success;
@@ -1870,45 +3084,26 @@ gboolean bd_lvm_delete_lv_tags (const gchar *vg_name, const gchar *lv_name, cons
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
  */
 BDLVMLVdata* bd_lvm_lvinfo (const gchar *vg_name, const gchar *lv_name, GError **error) {
-    const gchar *args[11] = {"lvs", "--noheadings", "--nosuffix", "--nameprefixes",
-                       "--unquoted", "--units=b", "-a",
-                       "-o", "vg_name,lv_name,lv_uuid,lv_size,lv_attr,segtype,origin,pool_lv,data_lv,metadata_lv,role,move_pv,data_percent,metadata_percent,copy_percent,lv_tags",
-                       NULL, NULL};
-
-    GHashTable *table = NULL;
-    gboolean success = FALSE;
-    gchar *output = NULL;
-    gchar **lines = NULL;
-    gchar **lines_p = NULL;
-    guint num_items;
-
-    args[9] = g_strdup_printf ("%s/%s", vg_name, lv_name);
+    const gchar *args[9] = {"lvs", "--noheadings", "--nosuffix", "--units=b", "-a",
+                       "-o", LVS_FIELDS, NULL, NULL};
+    GPtrArray *lvs = NULL;
 
-    success = call_lvm_and_capture_output (args, NULL, &output, error);
-    g_free ((gchar *) args[9]);
-
-    if (!success)
+    args[7] = g_strdup_printf ("%s/%s", vg_name, lv_name);
+    lvs = get_report_data (args, &lv_report, 16, FALSE, NULL, error);
+    g_free ((gchar *) args[7]);
+    if (!lvs)
         /* the error is already populated from the call */
         return NULL;
 
-    lines = g_strsplit (output, "\n", 0);
-    g_free (output);
-
-    for (lines_p = lines; *lines_p; lines_p++) {
-        table = parse_lvm_vars ((*lines_p), &num_items);
-        if (table && (num_items == 16)) {
-            g_strfreev (lines);
-            return get_lv_data_from_table (table, TRUE);
-        } else
-            if (table)
-                g_hash_table_destroy (table);
+    if (lvs->len == 0) {
+        g_ptr_array_free (lvs, TRUE);
+        /* getting here means no usable info was found */
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to parse information about the LV");
+        return NULL;
     }
-    g_strfreev (lines);
 
-    /* getting here means no usable info was found */
-    g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
-                 "Failed to parse information about the LV");
-    return NULL;
+    return (BDLVMLVdata *) take_first_record (lvs, &lv_report);
 }
 
 /**
@@ -1919,71 +3114,278 @@ BDLVMLVdata* bd_lvm_lvinfo (const gchar *vg_name, const gchar *lv_name, GError *
  * Returns: (array zero-terminated=1): information about LVs found in the given
  * @vg_name VG or in system if @vg_name is %NULL
  *
+ * Note: With LVM supporting JSON reports (2.02.158 and newer) the whole report
+ * is kept in memory while it's parsed. Only the name-prefixed reports of the
+ * older versions are processed line by line as they arrive.
+ *
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
  */
 BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error) {
-    const gchar *args[11] = {"lvs", "--noheadings", "--nosuffix", "--nameprefixes",
-                       "--unquoted", "--units=b", "-a",
-                       "-o", "vg_name,lv_name,lv_uuid,lv_size,lv_attr,segtype,origin,pool_lv,data_lv,metadata_lv,role,move_pv,data_percent,metadata_percent,copy_percent,lv_tags",
-                       NULL, NULL};
+    const gchar *args[9] = {"lvs", "--noheadings", "--nosuffix", "--units=b", "-a",
+                       "-o", LVS_FIELDS, NULL, NULL};
+    GPtrArray *lvs = NULL;
 
-    GHashTable *table = NULL;
-    gboolean success = FALSE;
-    gchar *output = NULL;
-    gchar **lines = NULL;
-    gchar **lines_p = NULL;
-    guint num_items;
-    GPtrArray *lvs;
-    BDLVMLVdata *lvdata = NULL;
+    if (vg_name)
+        args[7] = vg_name;
 
-    lvs = g_ptr_array_new ();
+    lvs = get_report_data (args, &lv_report, 16, TRUE, NULL, error);
+    if (!lvs)
+        /* the error is already populated from the call */
+        return NULL;
 
-    if (vg_name)
-        args[9] = vg_name;
+    /* returning NULL-terminated array of BDLVMLVdata */
+    g_ptr_array_add (lvs, NULL);
+    return (BDLVMLVdata **) g_ptr_array_free (lvs, FALSE);
+}
 
-    success = call_lvm_and_capture_output (args, NULL, &output, error);
-    if (!success) {
+/**
+ * bd_lvm_lvs_select:
+ * @selection: (allow-none): LVM selection criteria for the LVs (see the
+ *                           '--select' option in lvmreport(7), e.g.
+ *                           "vg_name=x && segtype=thin && lv_tags=y") or %NULL
+ *                           to get all LVs
+ * @fields: a combination of (ORed) #BDLVMLVField specifying which fields of
+ *          the returned structs should be filled, 0 means all of them
+ * @error: (out): place to store error (if any)
+ *
+ * Both the selection and the field projection are done by LVM so asking for
+ * a few fields of a few LVs is much cheaper than bd_lvm_lvs(). Fields not
+ * requested by @fields are left %NULL or 0 in the returned structs. Internal
+ * LVs are included (same as with bd_lvm_lvs()).
+ *
+ * Returns: (array zero-terminated=1): information about LVs matching the
+ * @selection
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMLVdata** bd_lvm_lvs_select (const gchar *selection, BDLVMLVField fields, GError **error) {
+    const gchar *args[10] = {"lvs", "--noheadings", "--nosuffix", "--units=b", "-a",
+                             "-o", NULL, NULL, NULL, NULL};
+    gchar *fields_str = NULL;
+    guint n_fields = 0;
+    GPtrArray *lvs = NULL;
+
+    /* the bits of BDLVMLVField are in the same order as the known fields */
+    fields_str = lvm_report_fields_str (lvm_report_lv_fields, fields ? fields : BD_LVM_LV_FIELD_ALL, &n_fields);
+    if (n_fields == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "No valid fields requested");
+        g_free (fields_str);
+        return NULL;
+    }
+    args[6] = fields_str;
+
+    if (selection) {
+        args[7] = "--select";
+        args[8] = selection;
+    }
+
+    lvs = get_report_data (args, &lv_report, n_fields, TRUE, NULL, error);
+    g_free (fields_str);
+    if (!lvs)
+        /* the error is already populated from the call */
+        return NULL;
+
+    /* returning NULL-terminated array of BDLVMLVdata */
+    g_ptr_array_add (lvs, NULL);
+    return (BDLVMLVdata **) g_ptr_array_free (lvs, FALSE);
+}
+
+/* takes over the records of the @section as a NULL-terminated array */
+static gpointer* steal_section_records (LVMReportSection *section, guint *n_records) {
+    g_ptr_array_set_free_func (section->records, NULL);
+    *n_records = section->records->len;
+    g_ptr_array_add (section->records, NULL);
+    return g_ptr_array_free (section->records, FALSE);
+}
+
+/* builds a hash table mapping the strings to (index + 1) so that lookups of
+   unknown keys give -1 when decremented */
+static GHashTable* index_strings (gchar **strings, guint n_strings) {
+    GHashTable *table = g_hash_table_new (g_str_hash, g_str_equal);
+    guint i = 0;
+
+    for (i=0; i < n_strings; i++)
+        if (strings[i] && *strings[i])
+            g_hash_table_insert (table, strings[i], GINT_TO_POINTER (i + 1));
+
+    return table;
+}
+
+static gint lookup_index (GHashTable *table, const gchar *key) {
+    if (!key || !*key)
+        return -1;
+    return GPOINTER_TO_INT (g_hash_table_lookup (table, key)) - 1;
+}
+
+/**
+ * bd_lvm_get_inventory:
+ * @error: (out): place to store error (if any)
+ *
+ * Gets information about all VGs, PVs, LVs and PV segments in the system with
+ * a single 'lvm fullreport' call, i.e. with a single scan of the devices. The
+ * relations between the objects are already resolved in the result (see
+ * #BDLVMInventory).
+ *
+ * Returns: (transfer full): the LVM inventory of the system or %NULL in case
+ * of error (the @error) gets populated in those cases)
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMInventory* bd_lvm_get_inventory (GError **error) {
+    const gchar *args[23] = {"fullreport", "--reportformat", "json", "--units=b", "--nosuffix", "-a",
+                             "--configreport", "vg", "-o", VGS_FIELDS,
+                             "--configreport", "pv", "-o", PVS_FIELDS,
+                             "--configreport", "lv", "-o", LVS_FIELDS,
+                             "--configreport", "pvseg", "-o", PVSEGS_FIELDS, NULL};
+    LVMReportSection sections[5] = {
+        {"vg", lvm_report_vg_fields, 10, sizeof (BDLVMVGdata), (GDestroyNotify) bd_lvm_vgdata_free, NULL, NULL},
+        {"pv", lvm_report_pv_fields, 14, sizeof (BDLVMPVdata), (GDestroyNotify) bd_lvm_pvdata_free, NULL, NULL},
+        {"lv", lvm_report_lv_fields, 16, sizeof (BDLVMLVdata), (GDestroyNotify) bd_lvm_lvdata_free, NULL, NULL},
+        {"pvseg", lvm_report_pvseg_fields, 4, sizeof (BDLVMPVSEGdata), (GDestroyNotify) bd_lvm_pvsegdata_free, NULL, NULL},
+        {NULL, NULL, 0, 0, NULL, NULL, NULL}};
+    BDLVMInventory *ret = NULL;
+    gchar *output = NULL;
+    gchar **names = NULL;
+    GHashTable *vg_uuids = NULL;
+    GHashTable *vg_names = NULL;
+    GHashTable *pv_uuids = NULL;
+    GHashTable *lv_uuids = NULL;
+    BDLVMPVSEGdata *pvseg = NULL;
+    guint i = 0;
+
+    if (!have_json_report ()) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_TECH_UNAVAIL,
+                     "LVM >= %s is required for getting the inventory", LVM_JSON_REPORT_VERSION);
+        return NULL;
+    }
+
+    if (!call_lvm_and_capture_output (args, NULL, &output, error)) {
         if (g_error_matches (*error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_NOOUT)) {
-            /* no output => no LVs, not an error */
+            /* no output => nothing to report, not an error */
             g_clear_error (error);
-            /* return an empty list */
-            g_ptr_array_add (lvs, NULL);
-            return (BDLVMLVdata **) g_ptr_array_free (lvs, FALSE);
-        }
-        else {
+            output = g_strdup ("{}");
+        } else
             /* the error is already populated from the call */
-            g_ptr_array_free (lvs, TRUE);
             return NULL;
-        }
     }
 
-    lines = g_strsplit (output, "\n", 0);
+    if (!lvm_json_report_parse_sections (output, sections, error)) {
+        g_free (output);
+        return NULL;
+    }
     g_free (output);
 
-    for (lines_p = lines; *lines_p; lines_p++) {
-        table = parse_lvm_vars ((*lines_p), &num_items);
-        if (table && (num_items == 16)) {
-            /* valid line, try to parse and record it */
-            lvdata = get_lv_data_from_table (table, TRUE);
-            if (lvdata)
-                g_ptr_array_add (lvs, lvdata);
-        } else
-            if (table)
-                g_hash_table_destroy (table);
+    ret = g_new0 (BDLVMInventory, 1);
+    ret->vgs = (BDLVMVGdata **) steal_section_records (&(sections[0]), &(ret->n_vgs));
+    ret->pvs = (BDLVMPVdata **) steal_section_records (&(sections[1]), &(ret->n_pvs));
+    ret->lvs = (BDLVMLVdata **) steal_section_records (&(sections[2]), &(ret->n_lvs));
+    ret->pvsegs = (BDLVMPVSEGdata **) steal_section_records (&(sections[3]), &(ret->n_pvsegs));
+
+    /* now resolve the relations between the objects */
+    names = g_new0 (gchar*, MAX (MAX (ret->n_vgs, ret->n_pvs), ret->n_lvs) + 1);
+    for (i=0; i < ret->n_vgs; i++)
+        names[i] = ret->vgs[i]->uuid;
+    vg_uuids = index_strings (names, ret->n_vgs);
+    for (i=0; i < ret->n_vgs; i++)
+        names[i] = ret->vgs[i]->name;
+    vg_names = index_strings (names, ret->n_vgs);
+    for (i=0; i < ret->n_pvs; i++)
+        names[i] = ret->pvs[i]->pv_uuid;
+    pv_uuids = index_strings (names, ret->n_pvs);
+    for (i=0; i < ret->n_lvs; i++)
+        names[i] = ret->lvs[i]->uuid;
+    lv_uuids = index_strings (names, ret->n_lvs);
+    g_free (names);
+
+    ret->pv_vgs = g_new0 (gint, ret->n_pvs);
+    for (i=0; i < ret->n_pvs; i++)
+        ret->pv_vgs[i] = lookup_index (vg_uuids, ret->pvs[i]->vg_uuid);
+
+    ret->lv_vgs = g_new0 (gint, ret->n_lvs);
+    for (i=0; i < ret->n_lvs; i++)
+        ret->lv_vgs[i] = lookup_index (vg_names, ret->lvs[i]->vg_name);
+
+    for (i=0; i < ret->n_pvsegs; i++) {
+        pvseg = ret->pvsegs[i];
+        if (pvseg->lv_uuid && !*pvseg->lv_uuid) {
+            /* free space */
+            g_free (pvseg->lv_uuid);
+            pvseg->lv_uuid = NULL;
+        }
+        pvseg->pv_index = lookup_index (pv_uuids, pvseg->pv_uuid);
+        pvseg->lv_index = lookup_index (lv_uuids, pvseg->lv_uuid);
     }
 
-    g_strfreev (lines);
+    g_hash_table_destroy (vg_uuids);
+    g_hash_table_destroy (vg_names);
+    g_hash_table_destroy (pv_uuids);
+    g_hash_table_destroy (lv_uuids);
 
-    if (lvs->len == 0) {
-        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
-                     "Failed to parse information about LVs");
-        g_ptr_array_free (lvs, TRUE);
-        return NULL;
-    }
+    return ret;
+}
 
-    /* returning NULL-terminated array of BDLVMLVdata */
-    g_ptr_array_add (lvs, NULL);
-    return (BDLVMLVdata **) g_ptr_array_free (lvs, FALSE);
+/**
+ * bd_lvm_pvs_result_set:
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_pvs(), but with all the results allocated in a single
+ * #BDLVMResultSet which makes a big difference for systems with many PVs.
+ *
+ * Returns: (transfer full): information about PVs found in the system or %NULL
+ * in case of error (the @error) gets populated in those cases)
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMResultSet* bd_lvm_pvs_result_set (GError **error) {
+    const gchar *args[7] = {"pvs", "--unit=b", "--nosuffix", "--noheadings",
+                            "-o", PVS_FIELDS, NULL};
+
+    return get_report_result_set (args, &pv_report, 14, BD_LVM_RESULT_SET_PVS, error);
+}
+
+/**
+ * bd_lvm_vgs_result_set:
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_vgs(), but with all the results allocated in a single
+ * #BDLVMResultSet which makes a big difference for systems with many VGs.
+ *
+ * Returns: (transfer full): information about VGs found in the system or %NULL
+ * in case of error (the @error) gets populated in those cases)
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMResultSet* bd_lvm_vgs_result_set (GError **error) {
+    const gchar *args[7] = {"vgs", "--noheadings", "--nosuffix", "--units=b",
+                            "-o", "name,uuid,size,free,extent_size,extent_count,free_count,pv_count,vg_tags",
+                            NULL};
+
+    return get_report_result_set (args, &vg_report, 9, BD_LVM_RESULT_SET_VGS, error);
+}
+
+/**
+ * bd_lvm_lvs_result_set:
+ * @vg_name: (allow-none): name of the VG to get information about LVs from
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_lvs(), but with all the results allocated in a single
+ * #BDLVMResultSet which makes a big difference for systems with many LVs.
+ *
+ * Returns: (transfer full): information about LVs found in the given
+ * @vg_name VG or in system if @vg_name is %NULL or %NULL in case of error
+ * (the @error) gets populated in those cases)
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMResultSet* bd_lvm_lvs_result_set (const gchar *vg_name, GError **error) {
+    const gchar *args[9] = {"lvs", "--noheadings", "--nosuffix", "--units=b", "-a",
+                            "-o", LVS_FIELDS, NULL, NULL};
+
+    if (vg_name)
+        args[7] = vg_name;
+
+    return get_report_result_set (args, &lv_report, 16, BD_LVM_RESULT_SET_LVS, error);
 }
 
 /**
@@ -2027,7 +3429,7 @@ gboolean bd_lvm_thpoolcreate (const gchar *vg_name, const gchar *lv_name, guint6
 
     args[next_arg] = g_strdup_printf ("%s/%s", vg_name, lv_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[3]);
     g_free ((gchar *) args[4]);
     g_free ((gchar *) args[5]);
@@ -2058,7 +3460,7 @@ gboolean bd_lvm_thlvcreate (const gchar *vg_name, const gchar *pool_name, const
     args[2] = g_strdup_printf ("%s/%s", vg_name, pool_name);
     args[4] = g_strdup_printf ("%"G_GUINT64_FORMAT"K", size / 1024);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[2]);
     g_free ((gchar *) args[4]);
 
@@ -2121,56 +3523,225 @@ gboolean bd_lvm_thsnapshotcreate (const gchar *vg_name, const gchar *origin_name
 
     args[next_arg] = g_strdup_printf ("%s/%s", vg_name, origin_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[next_arg]);
 
-    return success;
+    return success;
+}
+
+/**
+ * bd_lvm_thpool_stats:
+ * @vg_name: name of the VG containing the @pool_name thin pool
+ * @pool_name: name of the thin pool to get stats for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: stats for the @pool_name thin pool or %NULL in case of error
+ *
+ * The stats are gathered from the status and table of the pool's 'thin-pool'
+ * DM map, no LVM commands are run so this is cheap enough to be polled often.
+ *
+ * Tech category: %BD_LVM_TECH_THIN-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMThPoolStats* bd_lvm_thpool_stats (const gchar *vg_name, const gchar *pool_name, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
+        return NULL;
+    }
+
+    return lvm_dm_thpool_stats (vg_name, pool_name, error);
+}
+
+/**
+ * bd_lvm_thlv_stats:
+ * @vg_name: name of the VG containing the @lv_name thin LV
+ * @lv_name: name of the thin LV to get stats for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: stats for the @lv_name thin LV or %NULL in case of error
+ *
+ * The stats are gathered from the status of the LV's 'thin' DM map, no LVM
+ * commands are run.
+ *
+ * Tech category: %BD_LVM_TECH_THIN-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMThLVStats* bd_lvm_thlv_stats (const gchar *vg_name, const gchar *lv_name, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
+        return NULL;
+    }
+
+    return lvm_dm_thlv_stats (vg_name, lv_name, error);
+}
+
+/**
+ * bd_lvm_set_global_config:
+ * @new_config: (allow-none): string representation of the new global LVM
+ *                            configuration to set or %NULL to reset to default
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the new requested global config @new_config was successfully
+ *          set or not
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_set_global_config (const gchar *new_config, GError **error UNUSED) {
+    /* XXX: the error attribute will likely be used in the future when
+       some validation comes into the game */
+
+    GlobalConfig *old_config = NULL;
+
+    g_mutex_lock (&global_config_lock);
+    old_config = global_config;
+    global_config = global_config_new (new_config, old_config ? (const gchar * const *) old_config->devices : NULL);
+    g_mutex_unlock (&global_config_lock);
+
+    /* commands already running keep their own references to the old config */
+    global_config_unref (old_config);
+
+    return TRUE;
+}
+
+/**
+ * bd_lvm_get_global_config:
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): a copy of a string representation of the currently
+ *                           set LVM global configuration
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gchar* bd_lvm_get_global_config (GError **error UNUSED) {
+    GlobalConfig *config = NULL;
+    gchar *ret = NULL;
+
+    config = global_config_ref ();
+    ret = g_strdup (config && config->str ? config->str : "");
+    global_config_unref (config);
+
+    return ret;
+}
+
+/**
+ * bd_lvm_set_devices_filter:
+ * @devices: (allow-none) (array zero-terminated=1): list of devices for LVM
+ *                                                   commands to work with or
+ *                                                   %NULL (or empty list) to
+ *                                                   remove the filter
+ * @error: (out): place to store error (if any)
+ *
+ * Limits all the LVM commands run by the plugin to the @devices, i.e. only the
+ * @devices are scanned instead of all block devices in the system. This can
+ * be also done just for the calls from the current thread, see
+ * bd_lvm_set_thread_devices_filter().
+ *
+ * With LVM versions supporting it, the '--devices' option is used, a global
+ * filter in the LVM config is used otherwise. In the latter case, the LVM
+ * commands fail if the global config (see bd_lvm_set_global_config()) sets
+ * 'devices/global_filter' too because the two filters cannot be combined.
+ *
+ * Returns: whether the devices filter was successfully set or not
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_set_devices_filter (const gchar **devices, GError **error UNUSED) {
+    GlobalConfig *old_config = NULL;
+
+    g_mutex_lock (&global_config_lock);
+    old_config = global_config;
+    global_config = global_config_new (old_config ? old_config->str : NULL, devices);
+    g_mutex_unlock (&global_config_lock);
+
+    global_config_unref (old_config);
+
+    return TRUE;
+}
+
+/**
+ * bd_lvm_get_devices_filter:
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full) (array zero-terminated=1): a copy of the currently
+ *                                                     set global devices filter
+ *                                                     (or %NULL if not set)
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gchar** bd_lvm_get_devices_filter (GError **error UNUSED) {
+    GlobalConfig *config = NULL;
+    gchar **ret = NULL;
+
+    config = global_config_ref ();
+    ret = config ? g_strdupv (config->devices) : NULL;
+    global_config_unref (config);
+
+    return ret;
+}
+
+/**
+ * bd_lvm_set_thread_devices_filter:
+ * @devices: (allow-none) (array zero-terminated=1): list of devices for LVM
+ *                                                   commands run from the
+ *                                                   current thread to work with
+ *                                                   or %NULL (or empty list) to
+ *                                                   use the global filter
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_set_devices_filter() but only for the LVM commands run from
+ * the current thread (overriding the global filter, if any). This allows e.g.
+ * limiting the scanning to the PVs of a particular VG when working with it.
+ *
+ * Returns: whether the devices filter was successfully set or not
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_set_thread_devices_filter (const gchar **devices, GError **error UNUSED) {
+    /* the previous value is freed by the GPrivate's destroy function */
+    if (devices && *devices)
+        g_private_replace (&thread_devices, g_strdupv ((gchar **) devices));
+    else
+        g_private_replace (&thread_devices, NULL);
+
+    return TRUE;
 }
 
 /**
- * bd_lvm_set_global_config:
- * @new_config: (allow-none): string representation of the new global LVM
- *                            configuration to set or %NULL to reset to default
+ * bd_lvm_set_persistent_shell:
+ * @enabled: whether to run LVM commands in persistent 'lvm shell' processes or not
  * @error: (out): place to store error (if any)
  *
- * Returns: whether the new requested global config @new_config was successfully
- *          set or not
+ * Returns: whether the persistent shell mode was successfully set or not
+ *
+ * With the persistent shell mode enabled, LVM commands are passed to a small
+ * pool of long-running 'lvm shell' processes instead of spawning a new 'lvm'
+ * process (and initializing LVM) for every call. Shells that crash are
+ * restarted and if no shell can be used (or a command cannot be passed to it),
+ * 'lvm' is run directly as usual. The mode is disabled by default.
+ *
+ * Prompts are answered with 'no' the same way as when 'lvm' is run directly and
+ * the cancellable and deadline set with bd_utils_set_thread_cancellable() are
+ * respected. A shell that is cancelled, times out or doesn't produce any output
+ * for 5 minutes is killed and replaced with a new one.
  *
  * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
  */
-gboolean bd_lvm_set_global_config (const gchar *new_config, GError **error UNUSED) {
-    /* XXX: the error attribute will likely be used in the future when
-       some validation comes into the game */
-
-    g_mutex_lock (&global_config_lock);
-
-    /* first free the old value */
-    g_free (global_config_str);
-
-    /* now store the new one */
-    global_config_str = g_strdup (new_config);
-
-    g_mutex_unlock (&global_config_lock);
+gboolean bd_lvm_set_persistent_shell (gboolean enabled, GError **error UNUSED) {
+    lvm_shell_set_enabled (enabled);
     return TRUE;
 }
 
 /**
- * bd_lvm_get_global_config:
+ * bd_lvm_get_persistent_shell:
  * @error: (out): place to store error (if any)
  *
- * Returns: (transfer full): a copy of a string representation of the currently
- *                           set LVM global configuration
+ * Returns: whether the persistent shell mode is enabled or not (see
+ *          bd_lvm_set_persistent_shell())
  *
  * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
  */
-gchar* bd_lvm_get_global_config (GError **error UNUSED) {
-    gchar *ret = NULL;
-
-    g_mutex_lock (&global_config_lock);
-    ret = g_strdup (global_config_str ? global_config_str : "");
-    g_mutex_unlock (&global_config_lock);
-
-    return ret;
+gboolean bd_lvm_get_persistent_shell (GError **error UNUSED) {
+    return lvm_shell_get_enabled ();
 }
 
 /**
@@ -2343,7 +3914,7 @@ gboolean bd_lvm_cache_create_pool (const gchar *vg_name, const gchar *pool_name,
     }
     name = g_strdup_printf ("%s/%s", vg_name, pool_name);
     args[8] = name;
-    success = call_lvm_and_report_error (args, NULL, TRUE, error);
+    success = call_lvm_and_report_error (args, NULL, error);
     g_free ((gchar *) args[5]);
     g_free ((gchar *) args[8]);
 
@@ -2377,7 +3948,7 @@ gboolean bd_lvm_cache_attach (const gchar *vg_name, const gchar *data_lv, const
 
     args[5] = g_strdup_printf ("%s/%s", vg_name, cache_pool_lv);
     args[6] = g_strdup_printf ("%s/%s", vg_name, data_lv);
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
 
     g_free ((gchar *) args[5]);
     g_free ((gchar *) args[6]);
@@ -2407,7 +3978,7 @@ gboolean bd_lvm_cache_detach (const gchar *vg_name, const gchar *cached_lv, gboo
 
     args[3] = destroy ? "--uncache" : "--splitcache";
     args[4] = g_strdup_printf ("%s/%s", vg_name, cached_lv);
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
 
     g_free ((gchar *) args[4]);
     return success;
@@ -2491,7 +4062,28 @@ gboolean bd_lvm_cache_create_cached_lv (const gchar *vg_name, const gchar *lv_na
  * Tech category: %BD_LVM_TECH_WRITECACHE-%BD_LVM_TECH_MODE_MODIFY
  */
 gboolean bd_lvm_writecache_attach (const gchar *vg_name, const gchar *data_lv, const gchar *cache_lv, const BDExtraArg **extra, GError **error) {
-    const gchar *args[8] = {"lvconvert", "-y", "--type", "writecache", "--cachevol", NULL, NULL, NULL};
+    return bd_lvm_writecache_attach_with_settings (vg_name, data_lv, cache_lv, NULL, extra, error);
+}
+
+/**
+ * bd_lvm_writecache_attach_with_settings:
+ * @vg_name: name of the VG containing the @data_lv and the @cache_pool_lv LVs
+ * @data_lv: data LV to attach the @cache_lv to
+ * @cache_lv: cache (fast) LV to attach to the @data_lv
+ * @settings: (allow-none): writecache settings to use or %NULL for the defaults
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the cache attachment
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the @cache_lv was successfully attached to the @data_lv or not
+ *
+ * Tech category: %BD_LVM_TECH_WRITECACHE-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_writecache_attach_with_settings (const gchar *vg_name, const gchar *data_lv, const gchar *cache_lv,
+                                                 const BDLVMWritecacheSettings *settings, const BDExtraArg **extra, GError **error) {
+    const gchar *args[10] = {"lvconvert", "-y", "--type", "writecache", "--cachevol", NULL, NULL, NULL, NULL, NULL};
+    gchar *settings_str = NULL;
+    guint next_arg = 5;
     gboolean success = FALSE;
 
     /* both LVs need to be inactive for the writecache convert to work */
@@ -2503,15 +4095,86 @@ gboolean bd_lvm_writecache_attach (const gchar *vg_name, const gchar *data_lv, c
     if (!success)
         return FALSE;
 
-    args[5] = g_strdup_printf ("%s/%s", vg_name, cache_lv);
-    args[6] = g_strdup_printf ("%s/%s", vg_name, data_lv);
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    args[next_arg++] = g_strdup_printf ("%s/%s", vg_name, cache_lv);
+    settings_str = lvm_dm_writecache_settings_str (settings);
+    if (settings_str) {
+        args[next_arg++] = "--cachesettings";
+        args[next_arg++] = settings_str;
+    }
+    args[next_arg] = g_strdup_printf ("%s/%s", vg_name, data_lv);
+    success = call_lvm_and_report_error (args, extra, error);
 
     g_free ((gchar *) args[5]);
-    g_free ((gchar *) args[6]);
+    g_free ((gchar *) args[next_arg]);
+    g_free (settings_str);
+    return success;
+}
+
+/**
+ * bd_lvm_writecache_set_settings:
+ * @vg_name: name of the VG containing the @cached_lv
+ * @cached_lv: name of the writecache LV to change the settings of
+ * @settings: new writecache settings (fields set to %BD_LVM_WRITECACHE_SETTING_DEFAULT are left unchanged)
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the settings change
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the settings of the @cached_lv were successfully changed or not
+ *
+ * The settings are changed online, the block size of an existing writecache
+ * cannot be changed.
+ *
+ * Tech category: %BD_LVM_TECH_WRITECACHE-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_writecache_set_settings (const gchar *vg_name, const gchar *cached_lv, const BDLVMWritecacheSettings *settings,
+                                         const BDExtraArg **extra, GError **error) {
+    const gchar *args[5] = {"lvchange", "--cachesettings", NULL, NULL, NULL};
+    gchar *settings_str = NULL;
+    gboolean success = FALSE;
+
+    if (settings->block_size != BD_LVM_WRITECACHE_SETTING_DEFAULT) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
+                     "Block size of an existing writecache cannot be changed");
+        return FALSE;
+    }
+
+    settings_str = lvm_dm_writecache_settings_str (settings);
+    if (!settings_str)
+        /* nothing to change */
+        return TRUE;
+
+    args[2] = settings_str;
+    args[3] = g_strdup_printf ("%s/%s", vg_name, cached_lv);
+    success = call_lvm_and_report_error (args, extra, error);
+
+    g_free (settings_str);
+    g_free ((gchar *) args[3]);
     return success;
 }
 
+/**
+ * bd_lvm_writecache_stats:
+ * @vg_name: name of the VG containing the @cached_lv
+ * @cached_lv: writecache LV to get stats for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: stats for the @cached_lv or %NULL in case of error
+ *
+ * The stats are gathered from the status of the LV's 'writecache' DM map, no
+ * LVM commands are run.
+ *
+ * Tech category: %BD_LVM_TECH_WRITECACHE-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMWritecacheStats* bd_lvm_writecache_stats (const gchar *vg_name, const gchar *cached_lv, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
+        return NULL;
+    }
+
+    return lvm_dm_writecache_stats (vg_name, cached_lv, error);
+}
+
 /**
  * bd_lvm_writecache_detach:
  * @vg_name: name of the VG containing the @cached_lv
@@ -2650,7 +4313,6 @@ BDLVMCacheStats* bd_lvm_cache_stats (const gchar *vg_name, const gchar *cached_l
     struct dm_pool *pool = NULL;
     struct dm_task *task = NULL;
     struct dm_info info;
-    struct dm_status_cache *status = NULL;
     gchar *map_name = NULL;
     guint64 start = 0;
     guint64 length = 0;
@@ -2721,46 +4383,103 @@ BDLVMCacheStats* bd_lvm_cache_stats (const gchar *vg_name, const gchar *cached_l
 
     dm_get_next_target(task, NULL, &start, &length, &type, &params);
 
-    if (dm_get_status_cache (pool, params, &status) == 0) {
-        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
-                     "Failed to get status of the cache map '%s': ", map_name);
-        dm_task_destroy (task);
-        dm_pool_destroy (pool);
+    ret = lvm_dm_cache_stats_from_status (pool, params, map_name, error);
+
+    dm_task_destroy (task);
+    dm_pool_destroy (pool);
+
+    return ret;
+}
+
+/**
+ * bd_lvm_cache_stats_all:
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): stats for all the cached LVs in the
+ * system or %NULL in case of error
+ *
+ * The stats are gathered from the status of the 'cache' DM maps created by
+ * LVM, no LVM commands are run so this is much cheaper than calling
+ * bd_lvm_cache_stats() for every cached LV.
+ *
+ * Tech category: %BD_LVM_TECH_CACHE-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMCachedLVStats** bd_lvm_cache_stats_all (GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
         return NULL;
     }
 
-    ret = g_new0 (BDLVMCacheStats, 1);
-    ret->block_size = status->block_size * SECTOR_SIZE;
-    ret->cache_size = status->total_blocks * ret->block_size;
-    ret->cache_used = status->used_blocks * ret->block_size;
+    return lvm_dm_cache_stats_all (error);
+}
 
-    ret->md_block_size = status->metadata_block_size * SECTOR_SIZE;
-    ret->md_size = status->metadata_total_blocks * ret->md_block_size;
-    ret->md_used = status->metadata_used_blocks * ret->md_block_size;
+/**
+ * bd_lvm_cache_set_settings:
+ * @vg_name: name of the VG containing the @cached_lv
+ * @cached_lv: cached LV (or cached thin pool) to change the cache settings of
+ * @settings: new cache policy and settings (fields set to %NULL or
+ *            %BD_LVM_CACHE_SETTING_DEFAULT are left unchanged)
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the settings change
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: whether the cache settings of the @cached_lv were successfully changed or not
+ *
+ * Tech category: %BD_LVM_TECH_CACHE-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_cache_set_settings (const gchar *vg_name, const gchar *cached_lv, const BDLVMCacheSettings *settings,
+                                    const BDExtraArg **extra, GError **error) {
+    const gchar *args[7] = {"lvchange", NULL, NULL, NULL, NULL, NULL, NULL};
+    gchar *settings_str = NULL;
+    guint next_arg = 1;
+    gboolean success = FALSE;
 
-    ret->read_hits = status->read_hits;
-    ret->read_misses = status->read_misses;
-    ret->write_hits = status->write_hits;
-    ret->write_misses = status->write_misses;
+    if (settings->policy) {
+        args[next_arg++] = "--cachepolicy";
+        args[next_arg++] = settings->policy;
+    }
 
-    if (status->feature_flags & DM_CACHE_FEATURE_WRITETHROUGH)
-        ret->mode = BD_LVM_CACHE_MODE_WRITETHROUGH;
-    else if (status->feature_flags & DM_CACHE_FEATURE_WRITEBACK)
-        ret->mode = BD_LVM_CACHE_MODE_WRITEBACK;
-    else {
-        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
-                      "Failed to determine status of the cache from '%"G_GUINT64_FORMAT"': ",
-                      status->feature_flags);
-        dm_task_destroy (task);
-        dm_pool_destroy (pool);
-        bd_lvm_cache_stats_free (ret);
-        return NULL;
+    settings_str = lvm_dm_cache_settings_str (settings);
+    if (settings_str) {
+        args[next_arg++] = "--cachesettings";
+        args[next_arg++] = settings_str;
     }
 
-    dm_task_destroy (task);
-    dm_pool_destroy (pool);
+    if (next_arg == 1)
+        /* nothing to change */
+        return TRUE;
 
-    return ret;
+    args[next_arg] = g_strdup_printf ("%s/%s", vg_name, cached_lv);
+    success = call_lvm_and_report_error (args, extra, error);
+
+    g_free (settings_str);
+    g_free ((gchar *) args[next_arg]);
+    return success;
+}
+
+/**
+ * bd_lvm_cache_get_settings:
+ * @vg_name: name of the VG containing the @cached_lv
+ * @cached_lv: cached LV (or cached thin pool) to get the cache settings of
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): the policy and settings the cache of @cached_lv is
+ *                           currently using or %NULL in case of error
+ *
+ * The settings are read from the status of the LV's 'cache' DM map, no LVM
+ * commands are run.
+ *
+ * Tech category: %BD_LVM_TECH_CACHE-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMCacheSettings* bd_lvm_cache_get_settings (const gchar *vg_name, const gchar *cached_lv, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
+        return NULL;
+    }
+
+    return lvm_dm_cache_get_settings (vg_name, cached_lv, error);
 }
 
 /**
@@ -2787,7 +4506,7 @@ gboolean bd_lvm_thpool_convert (const gchar *vg_name, const gchar *data_lv, cons
 
     args[6] = g_strdup_printf ("%s/%s", vg_name, data_lv);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[6]);
 
     if (success && name)
@@ -2820,7 +4539,7 @@ gboolean bd_lvm_cache_pool_convert (const gchar *vg_name, const gchar *data_lv,
 
     args[6] = g_strdup_printf ("%s/%s", vg_name, data_lv);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[6]);
 
     if (success && name)
@@ -2829,6 +4548,22 @@ gboolean bd_lvm_cache_pool_convert (const gchar *vg_name, const gchar *data_lv,
     return success;
 }
 
+/* global config extended with the VDO settings that can't be specified
+   on the command line */
+static gchar* get_vdo_config (GlobalConfig *config, guint64 index_memory, const gchar *write_policy_str) {
+    gchar *ret = NULL;
+
+    if (index_memory != 0)
+        ret = g_strdup_printf ("%s allocation {vdo_index_memory_size_mb=%"G_GUINT64_FORMAT" vdo_write_policy=\"%s\"}", config && config->str ? config->str : "",
+                                                                                                                       index_memory / (1024 * 1024),
+                                                                                                                       write_policy_str);
+    else
+        ret = g_strdup_printf ("%s allocation {vdo_write_policy=\"%s\"}", config && config->str ? config->str : "",
+                                                                          write_policy_str);
+
+    return ret;
+}
+
 /**
  * bd_lvm_vdo_pool_create:
  * @vg_name: name of the VG to create a new LV in
@@ -2849,42 +4584,75 @@ gboolean bd_lvm_cache_pool_convert (const gchar *vg_name, const gchar *data_lv,
  * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_CREATE
  */
 gboolean bd_lvm_vdo_pool_create (const gchar *vg_name, const gchar *lv_name, const gchar *pool_name, guint64 data_size, guint64 virtual_size, guint64 index_memory, gboolean compression, gboolean deduplication, BDLVMVDOWritePolicy write_policy, const BDExtraArg **extra, GError **error) {
-    const gchar *args[16] = {"lvcreate", "--type", "vdo", "-n", lv_name, "-L", NULL, "-V", NULL,
+    return bd_lvm_vdo_pool_create_with_tuning (vg_name, lv_name, pool_name, data_size, virtual_size, index_memory,
+                                               compression, deduplication, write_policy, NULL, extra, error);
+}
+
+/**
+ * bd_lvm_vdo_pool_create_with_tuning:
+ * @vg_name: name of the VG to create a new LV in
+ * @lv_name: name of the to-be-created VDO LV
+ * @pool_name: name of the to-be-created VDO pool LV
+ * @data_size: requested size of the data VDO LV (physical size of the @pool_name VDO pool LV)
+ * @virtual_size: requested virtual_size of the @lv_name VDO LV
+ * @index_memory: amount of index memory (in bytes) or 0 for default
+ * @compression: whether to enable compression or not
+ * @deduplication: whether to enable deduplication or not
+ * @write_policy: write policy for the volume
+ * @tuning: (allow-none): performance tuning parameters for the new VDO pool or
+ *                        %NULL to use the defaults from the LVM configuration
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the VDO LV creation
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_vdo_pool_create() but allows setting the number of the VDO
+ * worker threads, size of the block map cache and the bio rotation interval.
+ * Setting any of them requires LVM 2.03.17 or newer.
+ *
+ * Returns: whether the given @vg_name/@lv_name VDO LV was successfully created or not
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_CREATE
+ */
+gboolean bd_lvm_vdo_pool_create_with_tuning (const gchar *vg_name, const gchar *lv_name, const gchar *pool_name, guint64 data_size, guint64 virtual_size, guint64 index_memory, gboolean compression, gboolean deduplication, BDLVMVDOWritePolicy write_policy, const BDLVMVDOTuning *tuning, const BDExtraArg **extra, GError **error) {
+    const gchar *args[18] = {"lvcreate", "--type", "vdo", "-n", lv_name, "-L", NULL, "-V", NULL,
                              "--compression", compression ? "y" : "n",
                              "--deduplication", deduplication ? "y" : "n",
-                             "-y", NULL, NULL};
+                             "-y", NULL, NULL, NULL, NULL};
     gboolean success = FALSE;
-    gchar *old_config = NULL;
+    GlobalConfig *config = NULL;
+    gchar *vdo_config = NULL;
+    gchar *settings_str = NULL;
     const gchar *write_policy_str = NULL;
+    guint next_arg = 14;
 
     write_policy_str = bd_lvm_get_vdo_write_policy_str (write_policy, error);
     if (*error)
         return FALSE;
 
+    settings_str = get_vdo_settings_str (tuning, error);
+    if (*error)
+        return FALSE;
+
     args[6] = g_strdup_printf ("%"G_GUINT64_FORMAT"K", data_size / 1024);
     args[8] = g_strdup_printf ("%"G_GUINT64_FORMAT"K", virtual_size / 1024);
-    args[14] = g_strdup_printf ("%s/%s", vg_name, pool_name);
-
-    /* index_memory and write_policy can be specified only using the config */
-    g_mutex_lock (&global_config_lock);
-    old_config = global_config_str;
-    if (index_memory != 0)
-        global_config_str = g_strdup_printf ("%s allocation {vdo_index_memory_size_mb=%"G_GUINT64_FORMAT" vdo_write_policy=\"%s\"}", old_config ? old_config : "",
-                                                                                                                                     index_memory / (1024 * 1024),
-                                                                                                                                     write_policy_str);
-    else
-        global_config_str = g_strdup_printf ("%s allocation {vdo_write_policy=\"%s\"}", old_config ? old_config : "",
-                                                                                        write_policy_str);
 
-    success = call_lvm_and_report_error (args, extra, FALSE, error);
+    if (settings_str) {
+        args[next_arg++] = "--vdosettings";
+        args[next_arg++] = settings_str;
+    }
+    args[next_arg] = g_strdup_printf ("%s/%s", vg_name, pool_name);
 
-    g_free (global_config_str);
-    global_config_str = old_config;
-    g_mutex_unlock (&global_config_lock);
+    /* index_memory and write_policy can be specified only using the config */
+    config = global_config_ref ();
+    vdo_config = get_vdo_config (config, index_memory, write_policy_str);
+    success = call_lvm_with_config (args, extra, vdo_config, get_devices_filter (config), NULL, NULL, NULL, error);
+    global_config_unref (config);
+    g_free (vdo_config);
 
     g_free ((gchar *) args[6]);
     g_free ((gchar *) args[8]);
-    g_free ((gchar *) args[14]);
+    g_free ((gchar *) args[next_arg]);
+    g_free (settings_str);
 
     return success;
 }
@@ -2895,7 +4663,7 @@ static gboolean _vdo_set_compression_deduplication (const gchar *vg_name, const
 
     args[3] = g_strdup_printf ("%s/%s", vg_name, pool_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, error);
     g_free ((gchar *) args[3]);
 
     return success;
@@ -3095,21 +4863,58 @@ gboolean bd_lvm_vdo_pool_resize (const gchar *vg_name, const gchar *pool_name, g
  * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_CREATE&%BD_LVM_TECH_MODE_MODIFY
  */
 gboolean bd_lvm_vdo_pool_convert (const gchar *vg_name, const gchar *pool_lv, const gchar *name, guint64 virtual_size, guint64 index_memory, gboolean compression, gboolean deduplication, BDLVMVDOWritePolicy write_policy, const BDExtraArg **extra, GError **error) {
-    const gchar *args[14] = {"lvconvert", "--yes", "--type", "vdo-pool",
+    return bd_lvm_vdo_pool_convert_with_tuning (vg_name, pool_lv, name, virtual_size, index_memory,
+                                                compression, deduplication, write_policy, NULL, extra, error);
+}
+
+/**
+ * bd_lvm_vdo_pool_convert_with_tuning:
+ * @vg_name: name of the VG that contains @pool_lv
+ * @pool_lv: name of the LV that should become the new VDO pool LV
+ * @name: (allow-none): name for the VDO LV or %NULL for default name
+ * @virtual_size: virtual size for the new VDO LV
+ * @index_memory: amount of index memory (in bytes) or 0 for default
+ * @compression: whether to enable compression or not
+ * @deduplication: whether to enable deduplication or not
+ * @write_policy: write policy for the volume
+ * @tuning: (allow-none): performance tuning parameters for the new VDO pool or
+ *                        %NULL to use the defaults from the LVM configuration
+ * @extra: (allow-none) (array zero-terminated=1): extra options for the VDO pool creation
+ *                                                 (just passed to LVM as is)
+ * @error: (out): place to store error (if any)
+ *
+ * Same as bd_lvm_vdo_pool_convert() but allows setting the number of the VDO
+ * worker threads, size of the block map cache and the bio rotation interval.
+ * Setting any of them requires LVM 2.03.17 or newer.
+ *
+ * Note: All data on @pool_lv will be irreversibly destroyed.
+ *
+ * Returns: whether the new VDO pool LV was successfully created from @pool_lv and or not
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_CREATE&%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_vdo_pool_convert_with_tuning (const gchar *vg_name, const gchar *pool_lv, const gchar *name, guint64 virtual_size, guint64 index_memory, gboolean compression, gboolean deduplication, BDLVMVDOWritePolicy write_policy, const BDLVMVDOTuning *tuning, const BDExtraArg **extra, GError **error) {
+    const gchar *args[16] = {"lvconvert", "--yes", "--type", "vdo-pool",
                              "--compression", compression ? "y" : "n",
                              "--deduplication", deduplication ? "y" : "n",
-                             NULL, NULL, NULL, NULL, NULL, NULL};
+                             NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
     gboolean success = FALSE;
-    guint next_arg = 4;
+    guint next_arg = 8;
     gchar *size_str = NULL;
     gchar *lv_spec = NULL;
-    gchar *old_config = NULL;
+    gchar *settings_str = NULL;
+    GlobalConfig *config = NULL;
+    gchar *vdo_config = NULL;
     const gchar *write_policy_str = NULL;
 
     write_policy_str = bd_lvm_get_vdo_write_policy_str (write_policy, error);
     if (*error)
         return FALSE;
 
+    settings_str = get_vdo_settings_str (tuning, error);
+    if (*error)
+        return FALSE;
+
     if (name) {
         args[next_arg++] = "-n";
         args[next_arg++] = name;
@@ -3118,28 +4923,25 @@ gboolean bd_lvm_vdo_pool_convert (const gchar *vg_name, const gchar *pool_lv, co
     args[next_arg++] = "-V";
     size_str = g_strdup_printf ("%"G_GUINT64_FORMAT"K", virtual_size / 1024);
     args[next_arg++] = size_str;
+
+    if (settings_str) {
+        args[next_arg++] = "--vdosettings";
+        args[next_arg++] = settings_str;
+    }
+
     lv_spec = g_strdup_printf ("%s/%s", vg_name, pool_lv);
     args[next_arg++] = lv_spec;
 
     /* index_memory and write_policy can be specified only using the config */
-    g_mutex_lock (&global_config_lock);
-    old_config = global_config_str;
-    if (index_memory != 0)
-        global_config_str = g_strdup_printf ("%s allocation {vdo_index_memory_size_mb=%"G_GUINT64_FORMAT" vdo_write_policy=\"%s\"}", old_config ? old_config : "",
-                                                                                                                                     index_memory / (1024 * 1024),
-                                                                                                                                     write_policy_str);
-    else
-        global_config_str = g_strdup_printf ("%s allocation {vdo_write_policy=\"%s\"}", old_config ? old_config : "",
-                                                                                        write_policy_str);
-
-    success = call_lvm_and_report_error (args, extra, FALSE, error);
-
-    g_free (global_config_str);
-    global_config_str = old_config;
-    g_mutex_unlock (&global_config_lock);
+    config = global_config_ref ();
+    vdo_config = get_vdo_config (config, index_memory, write_policy_str);
+    success = call_lvm_with_config (args, extra, vdo_config, get_devices_filter (config), NULL, NULL, NULL, error);
+    global_config_unref (config);
+    g_free (vdo_config);
 
     g_free (size_str);
     g_free (lv_spec);
+    g_free (settings_str);
 
     return success;
 }
@@ -3340,26 +5142,67 @@ GHashTable* bd_lvm_vdo_get_stats_full (const gchar *vg_name, const gchar *pool_n
  * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_QUERY
  */
 BDLVMVDOStats* bd_lvm_vdo_get_stats (const gchar *vg_name, const gchar *pool_name, GError **error) {
-    GHashTable *full_stats = NULL;
-    BDLVMVDOStats *stats = NULL;
+    g_autofree gchar *kvdo_name = g_strdup_printf ("%s-%s-%s", vg_name, pool_name, VDO_POOL_SUFFIX);
+    return vdo_stats_get (kvdo_name, error);
+}
 
-    full_stats = bd_lvm_vdo_get_stats_full (vg_name, pool_name, error);
-    if (!full_stats)
-        return NULL;
+/**
+ * bd_lvm_vdo_get_counters:
+ * @vg_name: name of the VG that contains @pool_name VDO pool
+ * @pool_name: name of the VDO pool to get the counters for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): a snapshot of the VDO counters or %NULL in case of error
+ *                           (@error gets populated in those cases)
+ *
+ * Only the statistics needed for the counters are read. The statistics files
+ * are kept open between the calls so this function is cheap enough to be
+ * called periodically, use bd_lvm_vdo_get_rates() to compute rates between
+ * two snapshots.
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVDOCounters* bd_lvm_vdo_get_counters (const gchar *vg_name, const gchar *pool_name, GError **error) {
+    g_autofree gchar *kvdo_name = g_strdup_printf ("%s-%s-%s", vg_name, pool_name, VDO_POOL_SUFFIX);
+    return vdo_stats_get_counters (kvdo_name, error);
+}
 
-    stats = g_new0 (BDLVMVDOStats, 1);
-    get_stat_val64_default (full_stats, "block_size", &stats->block_size, -1);
-    get_stat_val64_default (full_stats, "logical_block_size", &stats->logical_block_size, -1);
-    get_stat_val64_default (full_stats, "physical_blocks", &stats->physical_blocks, -1);
-    get_stat_val64_default (full_stats, "data_blocks_used", &stats->data_blocks_used, -1);
-    get_stat_val64_default (full_stats, "overhead_blocks_used", &stats->overhead_blocks_used, -1);
-    get_stat_val64_default (full_stats, "logical_blocks_used", &stats->logical_blocks_used, -1);
-    get_stat_val64_default (full_stats, "usedPercent", &stats->used_percent, -1);
-    get_stat_val64_default (full_stats, "savingPercent", &stats->saving_percent, -1);
-    if (!get_stat_val_double (full_stats, "writeAmplificationRatio", &stats->write_amplification_ratio))
-        stats->write_amplification_ratio = -1;
+/**
+ * bd_lvm_vdo_get_rates:
+ * @prev: the older snapshot of the counters
+ * @cur: the newer snapshot of the counters (of the same VDO pool)
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): rates of the VDO counters between @prev and @cur or
+ *                           %NULL in case of error (@error gets populated in those cases)
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVDORates* bd_lvm_vdo_get_rates (const BDLVMVDOCounters *prev, const BDLVMVDOCounters *cur, GError **error) {
+    return vdo_stats_get_rates (prev, cur, error);
+}
 
-    g_hash_table_destroy (full_stats);
+/**
+ * bd_lvm_vdo_get_tuning:
+ * @vg_name: name of the VG that contains @pool_name VDO pool
+ * @pool_name: name of the VDO pool to get the tuning parameters for
+ * @error: (out): place to store error (if any)
+ *
+ * Returns: (transfer full): tuning parameters the active @vg_name/@pool_name VDO
+ *                           pool is running with or %NULL in case of error
+ *                           (@error gets populated in those cases)
+ *
+ * The values are taken from the device-mapper table of the VDO pool so they
+ * reflect the running configuration, not the LVM metadata. Requires root.
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVDOTuning* bd_lvm_vdo_get_tuning (const gchar *vg_name, const gchar *pool_name, GError **error) {
+    if (geteuid () != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_ROOT,
+                     "Not running as root, cannot query DM maps");
+        return NULL;
+    }
 
-    return stats;
+    return lvm_dm_vdo_get_tuning (vg_name, pool_name, error);
 }
@@ -60,6 +60,13 @@ typedef enum {
     BD_LVM_CACHE_MODE_UNKNOWN,
 } BDLVMCacheMode;
 
+typedef enum {
+    BD_LVM_THPOOL_MODE_READ_WRITE,
+    BD_LVM_THPOOL_MODE_READ_ONLY,
+    BD_LVM_THPOOL_MODE_OUT_OF_DATA_SPACE,
+    BD_LVM_THPOOL_MODE_FAILED,
+} BDLVMThPoolMode;
+
 typedef enum {
     BD_LVM_VDO_MODE_RECOVERING = 0,
     BD_LVM_VDO_MODE_READ_ONLY,
@@ -90,6 +97,44 @@ typedef enum {
     BD_LVM_VDO_WRITE_POLICY_UNKNOWN = 255
 } BDLVMVDOWritePolicy;
 
+typedef enum {
+    BD_LVM_PV_FIELD_NAME =            1 << 0,
+    BD_LVM_PV_FIELD_UUID =            1 << 1,
+    BD_LVM_PV_FIELD_FREE =            1 << 2,
+    BD_LVM_PV_FIELD_SIZE =            1 << 3,
+    BD_LVM_PV_FIELD_PE_START =        1 << 4,
+    BD_LVM_PV_FIELD_VG_NAME =         1 << 5,
+    BD_LVM_PV_FIELD_VG_UUID =         1 << 6,
+    BD_LVM_PV_FIELD_VG_SIZE =         1 << 7,
+    BD_LVM_PV_FIELD_VG_FREE =         1 << 8,
+    BD_LVM_PV_FIELD_VG_EXTENT_SIZE =  1 << 9,
+    BD_LVM_PV_FIELD_VG_EXTENT_COUNT = 1 << 10,
+    BD_LVM_PV_FIELD_VG_FREE_COUNT =   1 << 11,
+    BD_LVM_PV_FIELD_VG_PV_COUNT =     1 << 12,
+    BD_LVM_PV_FIELD_TAGS =            1 << 13,
+    BD_LVM_PV_FIELD_ALL =             (1 << 14) - 1,
+} BDLVMPVField;
+
+typedef enum {
+    BD_LVM_LV_FIELD_VG_NAME =          1 << 0,
+    BD_LVM_LV_FIELD_NAME =             1 << 1,
+    BD_LVM_LV_FIELD_UUID =             1 << 2,
+    BD_LVM_LV_FIELD_SIZE =             1 << 3,
+    BD_LVM_LV_FIELD_ATTR =             1 << 4,
+    BD_LVM_LV_FIELD_SEGTYPE =          1 << 5,
+    BD_LVM_LV_FIELD_ORIGIN =           1 << 6,
+    BD_LVM_LV_FIELD_POOL_LV =          1 << 7,
+    BD_LVM_LV_FIELD_DATA_LV =          1 << 8,
+    BD_LVM_LV_FIELD_METADATA_LV =      1 << 9,
+    BD_LVM_LV_FIELD_ROLES =            1 << 10,
+    BD_LVM_LV_FIELD_MOVE_PV =          1 << 11,
+    BD_LVM_LV_FIELD_DATA_PERCENT =     1 << 12,
+    BD_LVM_LV_FIELD_METADATA_PERCENT = 1 << 13,
+    BD_LVM_LV_FIELD_COPY_PERCENT =     1 << 14,
+    BD_LVM_LV_FIELD_TAGS =             1 << 15,
+    BD_LVM_LV_FIELD_ALL =              (1 << 16) - 1,
+} BDLVMLVField;
+
 typedef struct BDLVMPVdata {
     gchar *pv_name;
     gchar *pv_uuid;
@@ -178,6 +223,55 @@ typedef struct BDLVMVDOStats {
 void bd_lvm_vdo_stats_free (BDLVMVDOStats *stats);
 BDLVMVDOStats* bd_lvm_vdo_stats_copy (BDLVMVDOStats *stats);
 
+typedef struct BDLVMVDOCounters {
+    gint64 timestamp;
+    gint64 bios_in_write;
+    gint64 bios_out_write;
+    gint64 bios_meta_write;
+    gint64 dedupe_advice_valid;
+    gint64 dedupe_advice_stale;
+    gint64 journal_blocks_written;
+    gint64 journal_blocks_committed;
+    gint64 data_blocks_used;
+    gint64 logical_blocks_used;
+} BDLVMVDOCounters;
+
+void bd_lvm_vdo_counters_free (BDLVMVDOCounters *counters);
+BDLVMVDOCounters* bd_lvm_vdo_counters_copy (BDLVMVDOCounters *counters);
+
+typedef struct BDLVMVDORates {
+    gdouble interval;
+    gdouble write_rate;
+    gdouble dedupe_advice_rate;
+    gdouble stale_advice_rate;
+    gdouble write_amplification_ratio;
+    gdouble journal_blocks_rate;
+    gint64 data_blocks_used_delta;
+    gint64 logical_blocks_used_delta;
+} BDLVMVDORates;
+
+void bd_lvm_vdo_rates_free (BDLVMVDORates *rates);
+BDLVMVDORates* bd_lvm_vdo_rates_copy (BDLVMVDORates *rates);
+
+#define BD_LVM_VDO_TUNING_DEFAULT (-1)
+
+typedef struct BDLVMVDOTuning {
+    gint64 cpu_threads;
+    gint64 bio_threads;
+    gint64 ack_threads;
+    gint64 hash_zone_threads;
+    gint64 logical_threads;
+    gint64 physical_threads;
+    gint64 block_map_cache_size;
+    gint64 bio_rotation;
+} BDLVMVDOTuning;
+
+BDLVMVDOTuning* bd_lvm_vdo_tuning_new (gint64 cpu_threads, gint64 bio_threads, gint64 ack_threads, gint64 hash_zone_threads,
+                                       gint64 logical_threads, gint64 physical_threads, gint64 block_map_cache_size,
+                                       gint64 bio_rotation);
+void bd_lvm_vdo_tuning_free (BDLVMVDOTuning *tuning);
+BDLVMVDOTuning* bd_lvm_vdo_tuning_copy (BDLVMVDOTuning *tuning);
+
 typedef struct BDLVMCacheStats {
     guint64 block_size;
     guint64 cache_size;
@@ -190,11 +284,172 @@ typedef struct BDLVMCacheStats {
     guint64 write_hits;
     guint64 write_misses;
     BDLVMCacheMode mode;
+    guint64 promotions;
+    guint64 demotions;
+    guint64 cache_dirty;
 } BDLVMCacheStats;
 
 void bd_lvm_cache_stats_free (BDLVMCacheStats *data);
 BDLVMCacheStats* bd_lvm_cache_stats_copy (BDLVMCacheStats *data);
 
+#define BD_LVM_CACHE_SETTING_DEFAULT (-1)
+
+typedef struct BDLVMCacheSettings {
+    gchar *policy;
+    gint64 migration_threshold;
+    gint64 sequential_threshold;
+    gint64 random_threshold;
+} BDLVMCacheSettings;
+
+BDLVMCacheSettings* bd_lvm_cache_settings_new (const gchar *policy, gint64 migration_threshold, gint64 sequential_threshold,
+                                               gint64 random_threshold);
+void bd_lvm_cache_settings_free (BDLVMCacheSettings *data);
+BDLVMCacheSettings* bd_lvm_cache_settings_copy (BDLVMCacheSettings *data);
+
+typedef struct BDLVMPVSEGdata {
+    gchar *pv_uuid;
+    gchar *lv_uuid;
+    guint64 pv_start_pe;
+    guint64 size_pe;
+    gint pv_index;
+    gint lv_index;
+} BDLVMPVSEGdata;
+
+void bd_lvm_pvsegdata_free (BDLVMPVSEGdata *data);
+BDLVMPVSEGdata* bd_lvm_pvsegdata_copy (BDLVMPVSEGdata *data);
+
+typedef struct BDLVMInventory {
+    BDLVMVGdata **vgs;
+    guint n_vgs;
+    BDLVMPVdata **pvs;
+    guint n_pvs;
+    BDLVMLVdata **lvs;
+    guint n_lvs;
+    BDLVMPVSEGdata **pvsegs;
+    guint n_pvsegs;
+    gint *pv_vgs;
+    gint *lv_vgs;
+} BDLVMInventory;
+
+void bd_lvm_inventory_free (BDLVMInventory *data);
+BDLVMInventory* bd_lvm_inventory_copy (BDLVMInventory *data);
+
+typedef enum {
+    BD_LVM_RESULT_SET_PVS,
+    BD_LVM_RESULT_SET_VGS,
+    BD_LVM_RESULT_SET_LVS,
+} BDLVMResultSetType;
+
+typedef struct BDLVMResultSet {
+    BDLVMResultSetType item_type;
+    guint n_items;
+    gpointer *items;
+    gint ref_count;
+    GPtrArray *blocks;
+    GStringChunk *strings;
+} BDLVMResultSet;
+
+BDLVMResultSet* bd_lvm_result_set_ref (BDLVMResultSet *set);
+void bd_lvm_result_set_unref (BDLVMResultSet *set);
+BDLVMPVdata* bd_lvm_result_set_get_pv (BDLVMResultSet *set, guint index);
+BDLVMVGdata* bd_lvm_result_set_get_vg (BDLVMResultSet *set, guint index);
+BDLVMLVdata* bd_lvm_result_set_get_lv (BDLVMResultSet *set, guint index);
+
+typedef struct BDLVMCachedLVStats {
+    gchar *vg_name;
+    gchar *lv_name;
+    BDLVMCacheStats *stats;
+} BDLVMCachedLVStats;
+
+void bd_lvm_cached_lv_stats_free (BDLVMCachedLVStats *data);
+BDLVMCachedLVStats* bd_lvm_cached_lv_stats_copy (BDLVMCachedLVStats *data);
+
+typedef struct BDLVMThPoolStats {
+    guint64 transaction_id;
+    guint64 data_block_size;
+    guint64 data_size;
+    guint64 data_used;
+    guint64 md_block_size;
+    guint64 md_size;
+    guint64 md_used;
+    guint64 held_md_root;
+    BDLVMThPoolMode mode;
+    gboolean needs_check;
+    gboolean error_if_no_space;
+} BDLVMThPoolStats;
+
+void bd_lvm_thpool_stats_free (BDLVMThPoolStats *data);
+BDLVMThPoolStats* bd_lvm_thpool_stats_copy (BDLVMThPoolStats *data);
+
+typedef struct BDLVMThLVStats {
+    guint64 mapped;
+    guint64 highest_mapped;
+    gboolean failed;
+} BDLVMThLVStats;
+
+void bd_lvm_thlv_stats_free (BDLVMThLVStats *data);
+BDLVMThLVStats* bd_lvm_thlv_stats_copy (BDLVMThLVStats *data);
+
+#define BD_LVM_WRITECACHE_SETTING_DEFAULT (-1)
+
+typedef struct BDLVMWritecacheSettings {
+    gint64 high_watermark;
+    gint64 low_watermark;
+    gint64 writeback_jobs;
+    gint64 autocommit_blocks;
+    gint64 autocommit_time;
+    gint64 block_size;
+    gint64 cleaner;
+} BDLVMWritecacheSettings;
+
+BDLVMWritecacheSettings* bd_lvm_writecache_settings_new (gint64 high_watermark, gint64 low_watermark, gint64 writeback_jobs,
+                                                         gint64 autocommit_blocks, gint64 autocommit_time, gint64 block_size,
+                                                         gint64 cleaner);
+void bd_lvm_writecache_settings_free (BDLVMWritecacheSettings *data);
+BDLVMWritecacheSettings* bd_lvm_writecache_settings_copy (BDLVMWritecacheSettings *data);
+
+typedef struct BDLVMWritecacheStats {
+    guint64 block_size;
+    guint64 total_blocks;
+    guint64 free_blocks;
+    guint64 writeback_blocks;
+    guint64 read_blocks;
+    guint64 read_hits;
+    guint64 write_blocks;
+    guint64 write_hits;
+    gint64 error;
+} BDLVMWritecacheStats;
+
+void bd_lvm_writecache_stats_free (BDLVMWritecacheStats *data);
+BDLVMWritecacheStats* bd_lvm_writecache_stats_copy (BDLVMWritecacheStats *data);
+
+#define BD_LVM_RAID_RATE_UNCHANGED (-1)
+
+typedef struct BDLVMRaidStats {
+    gchar *raid_type;
+    guint64 dev_count;
+    gchar *dev_health;
+    guint64 failed_devs;
+    guint64 sync_size;
+    guint64 sync_done;
+    gdouble sync_percent;
+    gchar *sync_action;
+    guint64 mismatch_count;
+} BDLVMRaidStats;
+
+void bd_lvm_raid_stats_free (BDLVMRaidStats *data);
+BDLVMRaidStats* bd_lvm_raid_stats_copy (BDLVMRaidStats *data);
+
+typedef struct BDLVMPlacement {
+    gchar **pvs;
+    guint stripes;
+    guint64 stripe_size;
+    gboolean rotational;
+} BDLVMPlacement;
+
+void bd_lvm_placement_free (BDLVMPlacement *data);
+BDLVMPlacement* bd_lvm_placement_copy (BDLVMPlacement *data);
+
 typedef enum {
     BD_LVM_TECH_BASIC = 0,
     BD_LVM_TECH_BASIC_SNAP,
@@ -245,11 +500,13 @@ gboolean bd_lvm_pvcreate (const gchar *device, guint64 data_alignment, guint64 m
 gboolean bd_lvm_pvresize (const gchar *device, guint64 size, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_pvremove (const gchar *device, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_pvmove (const gchar *src, const gchar *dest, const BDExtraArg **extra, GError **error);
+gboolean bd_lvm_pvmove_with_rate (const gchar *src, const gchar *dest, guint64 max_rate, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_pvscan (const gchar *device, gboolean update_cache, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_add_pv_tags (const gchar *device, const gchar **tags, GError **error);
 gboolean bd_lvm_delete_pv_tags (const gchar *device, const gchar **tags, GError **error);
 BDLVMPVdata* bd_lvm_pvinfo (const gchar *device, GError **error);
 BDLVMPVdata** bd_lvm_pvs (GError **error);
+BDLVMPVdata** bd_lvm_pvs_select (const gchar *selection, BDLVMPVField fields, GError **error);
 
 gboolean bd_lvm_vgcreate (const gchar *name, const gchar **pv_list, guint64 pe_size, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_vgremove (const gchar *vg_name, const BDExtraArg **extra, GError **error);
@@ -276,14 +533,31 @@ gboolean bd_lvm_add_lv_tags (const gchar *vg_name, const gchar *lv_name, const g
 gboolean bd_lvm_delete_lv_tags (const gchar *vg_name, const gchar *lv_name, const gchar **tags, GError **error);
 BDLVMLVdata* bd_lvm_lvinfo (const gchar *vg_name, const gchar *lv_name, GError **error);
 BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error);
+BDLVMLVdata** bd_lvm_lvs_select (const gchar *selection, BDLVMLVField fields, GError **error);
+BDLVMInventory* bd_lvm_get_inventory (GError **error);
+BDLVMResultSet* bd_lvm_pvs_result_set (GError **error);
+BDLVMResultSet* bd_lvm_vgs_result_set (GError **error);
+BDLVMResultSet* bd_lvm_lvs_result_set (const gchar *vg_name, GError **error);
+
+gboolean bd_lvm_raid_create (const gchar *vg_name, const gchar *lv_name, const gchar *raid_type, guint64 size, guint stripes, guint64 stripe_size, guint mirrors, const gchar **pv_list, const BDExtraArg **extra, GError **error);
+gboolean bd_lvm_raid_set_recovery_rate (const gchar *vg_name, const gchar *lv_name, gint64 min_rate, gint64 max_rate, const BDExtraArg **extra, GError **error);
+BDLVMRaidStats* bd_lvm_raid_stats (const gchar *vg_name, const gchar *lv_name, GError **error);
+BDLVMPlacement* bd_lvm_plan_placement (const gchar *vg_name, guint64 size, guint max_stripes, GError **error);
 
 gboolean bd_lvm_thpoolcreate (const gchar *vg_name, const gchar *lv_name, guint64 size, guint64 md_size, guint64 chunk_size, const gchar *profile, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_thlvcreate (const gchar *vg_name, const gchar *pool_name, const gchar *lv_name, guint64 size, const BDExtraArg **extra, GError **error);
 gchar* bd_lvm_thlvpoolname (const gchar *vg_name, const gchar *lv_name, GError **error);
 gboolean bd_lvm_thsnapshotcreate (const gchar *vg_name, const gchar *origin_name, const gchar *snapshot_name, const gchar *pool_name, const BDExtraArg **extra, GError **error);
+BDLVMThPoolStats* bd_lvm_thpool_stats (const gchar *vg_name, const gchar *pool_name, GError **error);
+BDLVMThLVStats* bd_lvm_thlv_stats (const gchar *vg_name, const gchar *lv_name, GError **error);
 
 gboolean bd_lvm_set_global_config (const gchar *new_config, GError **error);
 gchar* bd_lvm_get_global_config (GError **error);
+gboolean bd_lvm_set_devices_filter (const gchar **devices, GError **error);
+gchar** bd_lvm_get_devices_filter (GError **error);
+gboolean bd_lvm_set_thread_devices_filter (const gchar **devices, GError **error);
+gboolean bd_lvm_set_persistent_shell (gboolean enabled, GError **error);
+gboolean bd_lvm_get_persistent_shell (GError **error);
 
 guint64 bd_lvm_cache_get_default_md_size (guint64 cache_size, GError **error);
 const gchar* bd_lvm_cache_get_mode_str (BDLVMCacheMode mode, GError **error);
@@ -295,12 +569,19 @@ gboolean bd_lvm_cache_create_cached_lv (const gchar *vg_name, const gchar *lv_na
                                         const gchar **slow_pvs, const gchar **fast_pvs, GError **error);
 gchar* bd_lvm_cache_pool_name (const gchar *vg_name, const gchar *cached_lv, GError **error);
 BDLVMCacheStats* bd_lvm_cache_stats (const gchar *vg_name, const gchar *cached_lv, GError **error);
+BDLVMCachedLVStats** bd_lvm_cache_stats_all (GError **error);
+gboolean bd_lvm_cache_set_settings (const gchar *vg_name, const gchar *cached_lv, const BDLVMCacheSettings *settings, const BDExtraArg **extra, GError **error);
+BDLVMCacheSettings* bd_lvm_cache_get_settings (const gchar *vg_name, const gchar *cached_lv, GError **error);
 
 gboolean bd_lvm_writecache_attach (const gchar *vg_name, const gchar *data_lv, const gchar *cache_lv, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_writecache_detach (const gchar *vg_name, const gchar *cached_lv, gboolean destroy, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_writecache_create_cached_lv (const gchar *vg_name, const gchar *lv_name, guint64 data_size, guint64 cache_size, const gchar **slow_pvs, const gchar **fast_pvs, GError **error);
+gboolean bd_lvm_writecache_attach_with_settings (const gchar *vg_name, const gchar *data_lv, const gchar *cache_lv, const BDLVMWritecacheSettings *settings, const BDExtraArg **extra, GError **error);
+gboolean bd_lvm_writecache_set_settings (const gchar *vg_name, const gchar *cached_lv, const BDLVMWritecacheSettings *settings, const BDExtraArg **extra, GError **error);
+BDLVMWritecacheStats* bd_lvm_writecache_stats (const gchar *vg_name, const gchar *cached_lv, GError **error);
 
 gboolean bd_lvm_vdo_pool_create (const gchar *vg_name, const gchar *lv_name, const gchar *pool_name, guint64 data_size, guint64 virtual_size, guint64 index_memory, gboolean compression, gboolean deduplication, BDLVMVDOWritePolicy write_policy, const BDExtraArg **extra, GError **error);
+gboolean bd_lvm_vdo_pool_create_with_tuning (const gchar *vg_name, const gchar *lv_name, const gchar *pool_name, guint64 data_size, guint64 virtual_size, guint64 index_memory, gboolean compression, gboolean deduplication, BDLVMVDOWritePolicy write_policy, const BDLVMVDOTuning *tuning, const BDExtraArg **extra, GError **error);
 BDLVMVDOPooldata *bd_lvm_vdo_info (const gchar *vg_name, const gchar *lv_name, GError **error);
 
 gboolean bd_lvm_vdo_resize (const gchar *vg_name, const gchar *lv_name, guint64 size, const BDExtraArg **extra, GError **error);
@@ -314,6 +595,7 @@ gboolean bd_lvm_vdo_disable_deduplication (const gchar *vg_name, const gchar *po
 gboolean bd_lvm_thpool_convert (const gchar *vg_name, const gchar *data_lv, const gchar *metadata_lv, const gchar *name, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_cache_pool_convert (const gchar *vg_name, const gchar *data_lv, const gchar *metadata_lv, const gchar *name, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_vdo_pool_convert (const gchar *vg_name, const gchar *pool_lv, const gchar *name, guint64 virtual_size, guint64 index_memory, gboolean compression, gboolean deduplication, BDLVMVDOWritePolicy write_policy, const BDExtraArg **extra, GError **error);
+gboolean bd_lvm_vdo_pool_convert_with_tuning (const gchar *vg_name, const gchar *pool_lv, const gchar *name, guint64 virtual_size, guint64 index_memory, gboolean compression, gboolean deduplication, BDLVMVDOWritePolicy write_policy, const BDLVMVDOTuning *tuning, const BDExtraArg **extra, GError **error);
 gchar* bd_lvm_thlvpoolname (const gchar *vg_name, const gchar *lv_name, GError **error);
 
 const gchar* bd_lvm_get_vdo_operating_mode_str (BDLVMVDOOperatingMode mode, GError **error);
@@ -325,5 +607,8 @@ BDLVMVDOWritePolicy bd_lvm_get_vdo_write_policy_from_str (const gchar *policy_st
 
 BDLVMVDOStats* bd_lvm_vdo_get_stats (const gchar *vg_name, const gchar *pool_name, GError **error);
 GHashTable* bd_lvm_vdo_get_stats_full (const gchar *vg_name, const gchar *pool_name, GError **error);
+BDLVMVDOCounters* bd_lvm_vdo_get_counters (const gchar *vg_name, const gchar *pool_name, GError **error);
+BDLVMVDORates* bd_lvm_vdo_get_rates (const BDLVMVDOCounters *prev, const BDLVMVDOCounters *cur, GError **error);
+BDLVMVDOTuning* bd_lvm_vdo_get_tuning (const gchar *vg_name, const gchar *pool_name, GError **error);
 
 #endif /* BD_LVM */
@@ -0,0 +1,890 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/sysmacros.h>
+#include <libdevmapper.h>
+
+#include "lvm.h"
+#include "lvm_dm.h"
+
+#define SECTOR_SIZE 512
+#define LVM_DM_UUID_PREFIX "LVM-"
+#define THPOOL_DATA_SUFFIX "_tdata"
+#define THPOOL_MD_BLOCK_SIZE 4096 /* fixed in the kernel */
+#define VDO_POOL_LAYER "vpool"
+
+/**
+ * lvm_dm_foreach_map: (skip)
+ *
+ * Calls @func for every DM map created by LVM with the first target of the
+ * @target_type type. Only the status of the maps is queried (one ioctl per
+ * map), no LVM commands are run. Maps disappearing while being iterated over
+ * are silently skipped, maps with names that cannot be split into VG and LV
+ * names are skipped with a warning.
+ */
+gboolean __attribute__ ((visibility ("hidden")))
+lvm_dm_foreach_map (const gchar *target_type, LVMDMMapFunc func, gpointer user_data, GError **error) {
+    struct dm_task *task_list = NULL;
+    struct dm_task *task = NULL;
+    struct dm_names *names = NULL;
+    struct dm_info info;
+    struct dm_pool *pool = NULL;
+    const char *uuid = NULL;
+    guint64 start = 0;
+    guint64 length = 0;
+    gchar *type = NULL;
+    gchar *params = NULL;
+    gchar *vg_name = NULL;
+    gchar *lv_name = NULL;
+    gchar *layer = NULL;
+    guint next = 0;
+    gboolean ret = TRUE;
+
+    task_list = dm_task_create (DM_DEVICE_LIST);
+    if (!task_list) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                     "Failed to create DM task to list the DM maps");
+        return FALSE;
+    }
+
+    if (dm_task_run (task_list) == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                     "Failed to run the DM task to list the DM maps");
+        dm_task_destroy (task_list);
+        return FALSE;
+    }
+
+    names = dm_task_get_names (task_list);
+    if (!names || !names->dev) {
+        /* no DM maps */
+        dm_task_destroy (task_list);
+        return TRUE;
+    }
+
+    pool = dm_pool_create ("bd-pool", 256);
+    do {
+        names = (struct dm_names *) (((char *) names) + next);
+        next = names->next;
+
+        task = dm_task_create (DM_DEVICE_STATUS);
+        if (!task) {
+            g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                         "Failed to create DM task for the map '%s'", names->name);
+            ret = FALSE;
+            break;
+        }
+
+        if (dm_task_set_name (task, names->name) == 0 || dm_task_run (task) == 0 ||
+            dm_task_get_info (task, &info) == 0 || !info.exists) {
+            /* removed in the meantime */
+            dm_task_destroy (task);
+            continue;
+        }
+
+        uuid = dm_task_get_uuid (task);
+        if (!uuid || !g_str_has_prefix (uuid, LVM_DM_UUID_PREFIX)) {
+            dm_task_destroy (task);
+            continue;
+        }
+
+        type = NULL;
+        params = NULL;
+        dm_get_next_target (task, NULL, &start, &length, &type, &params);
+        if (g_strcmp0 (type, target_type) != 0 || !params) {
+            dm_task_destroy (task);
+            continue;
+        }
+
+        if (dm_split_lvm_name (pool, names->name, &vg_name, &lv_name, &layer) == 0) {
+            /* one weird map shouldn't break listing of all the other ones */
+            bd_utils_log_format (BD_UTILS_LOG_WARNING,
+                                 "Failed to get VG and LV name from the DM map name '%s', skipping it",
+                                 names->name);
+            dm_task_destroy (task);
+            continue;
+        }
+
+        ret = func (pool, names->name, vg_name, lv_name, params, user_data, error);
+        dm_task_destroy (task);
+        if (!ret)
+            break;
+    } while (next);
+
+    dm_pool_destroy (pool);
+    dm_task_destroy (task_list);
+
+    return ret;
+}
+
+/**
+ * lvm_dm_cache_stats_from_status: (skip)
+ *
+ * Creates new #BDLVMCacheStats from the @params status line of the 'cache' DM
+ * target of the @map_name map.
+ */
+BDLVMCacheStats __attribute__ ((visibility ("hidden")))
+*lvm_dm_cache_stats_from_status (struct dm_pool *pool, char *params, const gchar *map_name, GError **error) {
+    struct dm_status_cache *status = NULL;
+    BDLVMCacheStats *ret = NULL;
+
+    if (dm_get_status_cache (pool, params, &status) == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
+                     "Failed to get status of the cache map '%s': ", map_name);
+        return NULL;
+    }
+
+    ret = g_new0 (BDLVMCacheStats, 1);
+    ret->block_size = status->block_size * SECTOR_SIZE;
+    ret->cache_size = status->total_blocks * ret->block_size;
+    ret->cache_used = status->used_blocks * ret->block_size;
+
+    ret->md_block_size = status->metadata_block_size * SECTOR_SIZE;
+    ret->md_size = status->metadata_total_blocks * ret->md_block_size;
+    ret->md_used = status->metadata_used_blocks * ret->md_block_size;
+
+    ret->read_hits = status->read_hits;
+    ret->read_misses = status->read_misses;
+    ret->write_hits = status->write_hits;
+    ret->write_misses = status->write_misses;
+
+    ret->promotions = status->promotions;
+    ret->demotions = status->demotions;
+    ret->cache_dirty = status->dirty_blocks * ret->block_size;
+
+    if (status->feature_flags & DM_CACHE_FEATURE_WRITETHROUGH)
+        ret->mode = BD_LVM_CACHE_MODE_WRITETHROUGH;
+    else if (status->feature_flags & DM_CACHE_FEATURE_WRITEBACK)
+        ret->mode = BD_LVM_CACHE_MODE_WRITEBACK;
+    else {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
+                      "Failed to determine status of the cache from '%"G_GUINT64_FORMAT"': ",
+                      status->feature_flags);
+        bd_lvm_cache_stats_free (ret);
+        dm_pool_free (pool, status);
+        return NULL;
+    }
+
+    dm_pool_free (pool, status);
+
+    return ret;
+}
+
+/**
+ * lvm_dm_cache_settings_str: (skip)
+ *
+ * Returns: (transfer full): the set thresholds of @settings formatted as
+ *                           "key=value" pairs for the LVM '--cachesettings'
+ *                           option or %NULL if no threshold is set
+ */
+gchar __attribute__ ((visibility ("hidden")))
+*lvm_dm_cache_settings_str (const BDLVMCacheSettings *settings) {
+    GString *str = NULL;
+
+    if (!settings)
+        return NULL;
+
+    str = g_string_new (NULL);
+
+#define ADD_SETTING(field)                                              \
+    if (settings->field != BD_LVM_CACHE_SETTING_DEFAULT)                \
+        g_string_append_printf (str, "%s%s=%"G_GINT64_FORMAT,           \
+                                str->len > 0 ? " " : "", #field, settings->field)
+
+    ADD_SETTING (migration_threshold);
+    ADD_SETTING (sequential_threshold);
+    ADD_SETTING (random_threshold);
+
+#undef ADD_SETTING
+
+    if (str->len == 0) {
+        g_string_free (str, TRUE);
+        return NULL;
+    }
+
+    return g_string_free (str, FALSE);
+}
+
+/* sets the threshold fields of @settings from the @argc "key value" @argv pairs */
+static void set_cache_settings_from_args (BDLVMCacheSettings *settings, int argc, char **argv) {
+    gint64 value = 0;
+    gchar *end = NULL;
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        value = g_ascii_strtoll (argv[i + 1], &end, 10);
+        if (!end || *end != '\0')
+            continue;
+
+        if (g_strcmp0 (argv[i], "migration_threshold") == 0)
+            settings->migration_threshold = value;
+        else if (g_strcmp0 (argv[i], "sequential_threshold") == 0)
+            settings->sequential_threshold = value;
+        else if (g_strcmp0 (argv[i], "random_threshold") == 0)
+            settings->random_threshold = value;
+    }
+}
+
+/**
+ * lvm_dm_cache_get_settings: (skip)
+ *
+ * Gets the policy and settings of the @vg_name/@lv_name cached LV (or cached
+ * thin pool) from the status of its 'cache' DM map.
+ */
+BDLVMCacheSettings __attribute__ ((visibility ("hidden")))
+*lvm_dm_cache_get_settings (const gchar *vg_name, const gchar *lv_name, GError **error) {
+    struct dm_pool *pool = NULL;
+    struct dm_status_cache *status = NULL;
+    gchar *map_name = NULL;
+    gchar *data_lv_name = NULL;
+    char *params = NULL;
+    BDLVMCacheSettings *ret = NULL;
+    GError *l_error = NULL;
+
+    pool = dm_pool_create ("bd-pool", 256);
+
+    map_name = dm_build_dm_name (pool, vg_name, lv_name, NULL);
+    params = lvm_dm_get_target_params (pool, map_name, DM_DEVICE_STATUS, "cache", &l_error);
+    if (!params) {
+        /* cached thin pools have the cache on top of their data LV */
+        data_lv_name = g_strdup_printf ("%s%s", lv_name, THPOOL_DATA_SUFFIX);
+        map_name = dm_build_dm_name (pool, vg_name, data_lv_name, NULL);
+        g_free (data_lv_name);
+        params = lvm_dm_get_target_params (pool, map_name, DM_DEVICE_STATUS, "cache", NULL);
+    }
+    if (!params) {
+        g_propagate_error (error, l_error);
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+    g_clear_error (&l_error);
+
+    if (dm_get_status_cache (pool, params, &status) == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
+                     "Failed to get status of the cache map '%s'", map_name);
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    ret = bd_lvm_cache_settings_new (status->policy_name, BD_LVM_CACHE_SETTING_DEFAULT,
+                                     BD_LVM_CACHE_SETTING_DEFAULT, BD_LVM_CACHE_SETTING_DEFAULT);
+    set_cache_settings_from_args (ret, status->core_argc, status->core_argv);
+    set_cache_settings_from_args (ret, status->policy_argc, status->policy_argv);
+
+    dm_pool_destroy (pool);
+
+    return ret;
+}
+
+static gboolean add_cache_stats (struct dm_pool *pool, const gchar *map_name, const gchar *vg_name,
+                                 const gchar *lv_name, char *params, gpointer user_data, GError **error) {
+    GPtrArray *all_stats = (GPtrArray *) user_data;
+    BDLVMCachedLVStats *lv_stats = NULL;
+    BDLVMCacheStats *stats = NULL;
+
+    stats = lvm_dm_cache_stats_from_status (pool, params, map_name, error);
+    if (!stats)
+        return FALSE;
+
+    lv_stats = g_new0 (BDLVMCachedLVStats, 1);
+    lv_stats->vg_name = g_strdup (vg_name);
+    /* cached thin pools have the cache on top of their data LV, report it
+       the same way bd_lvm_cache_stats() does -- as stats of the pool */
+    if (g_str_has_suffix (lv_name, THPOOL_DATA_SUFFIX))
+        lv_stats->lv_name = g_strndup (lv_name, strlen (lv_name) - strlen (THPOOL_DATA_SUFFIX));
+    else
+        lv_stats->lv_name = g_strdup (lv_name);
+    lv_stats->stats = stats;
+    g_ptr_array_add (all_stats, lv_stats);
+
+    return TRUE;
+}
+
+/**
+ * lvm_dm_cache_stats_all: (skip)
+ *
+ * Returns: (transfer full) (array zero-terminated=1): stats of all the cached
+ *          LVs based on the status of their DM maps
+ */
+BDLVMCachedLVStats __attribute__ ((visibility ("hidden")))
+**lvm_dm_cache_stats_all (GError **error) {
+    GPtrArray *all_stats = g_ptr_array_new ();
+
+    if (!lvm_dm_foreach_map ("cache", add_cache_stats, all_stats, error)) {
+        g_ptr_array_set_free_func (all_stats, (GDestroyNotify) bd_lvm_cached_lv_stats_free);
+        g_ptr_array_free (all_stats, TRUE);
+        return NULL;
+    }
+
+    g_ptr_array_add (all_stats, NULL);
+    return (BDLVMCachedLVStats **) g_ptr_array_free (all_stats, FALSE);
+}
+
+/* runs the @task_type DM task for the @map_name map, returns %NULL with
+   %BD_LVM_ERROR_NOEXIST if the map doesn't exist */
+static struct dm_task* run_map_task (const gchar *map_name, int task_type, GError **error) {
+    struct dm_task *task = NULL;
+    struct dm_info info;
+
+    task = dm_task_create (task_type);
+    if (!task) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                     "Failed to create DM task for the map '%s'", map_name);
+        return NULL;
+    }
+
+    if (dm_task_set_name (task, map_name) == 0 || dm_task_run (task) == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                     "Failed to run the DM task for the map '%s'", map_name);
+        dm_task_destroy (task);
+        return NULL;
+    }
+
+    if (dm_task_get_info (task, &info) == 0 || !info.exists) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOEXIST,
+                     "The DM map '%s' doesn't exist", map_name);
+        dm_task_destroy (task);
+        return NULL;
+    }
+
+    return task;
+}
+
+/**
+ * lvm_dm_get_target_params: (skip)
+ *
+ * Runs the @task_type (%DM_DEVICE_STATUS or %DM_DEVICE_TABLE) DM task for the
+ * @map_name map and returns the params of its first target which has to be of
+ * the @target_type type. The params are copied to the @pool.
+ */
+char __attribute__ ((visibility ("hidden")))
+*lvm_dm_get_target_params (struct dm_pool *pool, const gchar *map_name, int task_type, const gchar *target_type, GError **error) {
+    struct dm_task *task = NULL;
+    guint64 start = 0;
+    guint64 length = 0;
+    gchar *type = NULL;
+    gchar *params = NULL;
+    char *ret = NULL;
+
+    task = run_map_task (map_name, task_type, error);
+    if (!task)
+        return NULL;
+
+    dm_get_next_target (task, NULL, &start, &length, &type, &params);
+    if (g_strcmp0 (type, target_type) != 0 || !params) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                     "The DM map '%s' is not a '%s' map", map_name, target_type);
+        dm_task_destroy (task);
+        return NULL;
+    }
+
+    ret = dm_pool_strdup (pool, params);
+    dm_task_destroy (task);
+
+    return ret;
+}
+
+/**
+ * lvm_dm_thpool_stats: (skip)
+ *
+ * Gets the stats of the @vg_name/@pool_name thin pool from the status and
+ * table of its 'thin-pool' DM map.
+ */
+BDLVMThPoolStats __attribute__ ((visibility ("hidden")))
+*lvm_dm_thpool_stats (const gchar *vg_name, const gchar *pool_name, GError **error) {
+    struct dm_pool *pool = NULL;
+    struct dm_status_thin_pool *status = NULL;
+    gchar *map_name = NULL;
+    char *status_params = NULL;
+    char *table_params = NULL;
+    guint64 data_block_size = 0;
+    BDLVMThPoolStats *ret = NULL;
+    GError *l_error = NULL;
+
+    pool = dm_pool_create ("bd-pool", 256);
+
+    /* with thin LVs active, the thin-pool target is in the '-tpool' layer and
+       the top-level map is just a linear mapping on top of it */
+    map_name = dm_build_dm_name (pool, vg_name, pool_name, "tpool");
+    status_params = lvm_dm_get_target_params (pool, map_name, DM_DEVICE_STATUS, "thin-pool", &l_error);
+    if (!status_params && g_error_matches (l_error, BD_LVM_ERROR, BD_LVM_ERROR_NOEXIST)) {
+        g_clear_error (&l_error);
+        map_name = dm_build_dm_name (pool, vg_name, pool_name, NULL);
+        status_params = lvm_dm_get_target_params (pool, map_name, DM_DEVICE_STATUS, "thin-pool", &l_error);
+    }
+    if (!status_params) {
+        g_propagate_error (error, l_error);
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    /* the data block size is only part of the table:
+       <metadata dev> <data dev> <data block size> <low water mark> ... */
+    table_params = lvm_dm_get_target_params (pool, map_name, DM_DEVICE_TABLE, "thin-pool", error);
+    if (!table_params) {
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+    if (sscanf (table_params, "%*s %*s %"G_GUINT64_FORMAT, &data_block_size) != 1) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to get data block size from the table of the thin pool map '%s'", map_name);
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    if (dm_get_status_thin_pool (pool, status_params, &status) == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to get status of the thin pool map '%s'", map_name);
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    ret = g_new0 (BDLVMThPoolStats, 1);
+    ret->transaction_id = status->transaction_id;
+    ret->data_block_size = data_block_size * SECTOR_SIZE;
+    ret->data_size = status->total_data_blocks * ret->data_block_size;
+    ret->data_used = status->used_data_blocks * ret->data_block_size;
+    ret->md_block_size = THPOOL_MD_BLOCK_SIZE;
+    ret->md_size = status->total_metadata_blocks * ret->md_block_size;
+    ret->md_used = status->used_metadata_blocks * ret->md_block_size;
+    ret->held_md_root = status->held_metadata_root;
+    ret->needs_check = status->needs_check;
+    ret->error_if_no_space = status->error_if_no_space;
+
+    if (status->fail)
+        ret->mode = BD_LVM_THPOOL_MODE_FAILED;
+    else if (status->out_of_data_space)
+        ret->mode = BD_LVM_THPOOL_MODE_OUT_OF_DATA_SPACE;
+    else if (status->read_only)
+        ret->mode = BD_LVM_THPOOL_MODE_READ_ONLY;
+    else
+        ret->mode = BD_LVM_THPOOL_MODE_READ_WRITE;
+
+    dm_pool_destroy (pool);
+
+    return ret;
+}
+
+/**
+ * lvm_dm_thlv_stats: (skip)
+ *
+ * Gets the stats of the @vg_name/@lv_name thin LV from the status of its
+ * 'thin' DM map.
+ */
+BDLVMThLVStats __attribute__ ((visibility ("hidden")))
+*lvm_dm_thlv_stats (const gchar *vg_name, const gchar *lv_name, GError **error) {
+    struct dm_pool *pool = NULL;
+    struct dm_status_thin *status = NULL;
+    gchar *map_name = NULL;
+    char *status_params = NULL;
+    BDLVMThLVStats *ret = NULL;
+
+    pool = dm_pool_create ("bd-pool", 256);
+
+    map_name = dm_build_dm_name (pool, vg_name, lv_name, NULL);
+    status_params = lvm_dm_get_target_params (pool, map_name, DM_DEVICE_STATUS, "thin", error);
+    if (!status_params) {
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    if (dm_get_status_thin (pool, status_params, &status) == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to get status of the thin LV map '%s'", map_name);
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    ret = g_new0 (BDLVMThLVStats, 1);
+    ret->mapped = status->mapped_sectors * SECTOR_SIZE;
+    /* the kernel reports the last mapped sector, not the one after it */
+    ret->highest_mapped = status->mapped_sectors > 0 ? (status->highest_mapped_sector + 1) * SECTOR_SIZE : 0;
+    ret->failed = status->fail;
+
+    dm_pool_destroy (pool);
+
+    return ret;
+}
+
+/**
+ * lvm_dm_writecache_settings_str: (skip)
+ *
+ * Returns: (transfer full): the set fields of @settings formatted as
+ *                           "key=value" pairs for the LVM '--cachesettings'
+ *                           option or %NULL if no field is set
+ */
+gchar __attribute__ ((visibility ("hidden")))
+*lvm_dm_writecache_settings_str (const BDLVMWritecacheSettings *settings) {
+    GString *str = NULL;
+
+    if (!settings)
+        return NULL;
+
+    str = g_string_new (NULL);
+
+#define ADD_SETTING(field)                                              \
+    if (settings->field != BD_LVM_WRITECACHE_SETTING_DEFAULT)           \
+        g_string_append_printf (str, "%s%s=%"G_GINT64_FORMAT,           \
+                                str->len > 0 ? " " : "", #field, settings->field)
+
+    ADD_SETTING (high_watermark);
+    ADD_SETTING (low_watermark);
+    ADD_SETTING (writeback_jobs);
+    ADD_SETTING (autocommit_blocks);
+    ADD_SETTING (autocommit_time);
+    ADD_SETTING (block_size);
+    ADD_SETTING (cleaner);
+
+#undef ADD_SETTING
+
+    if (str->len == 0) {
+        g_string_free (str, TRUE);
+        return NULL;
+    }
+
+    return g_string_free (str, FALSE);
+}
+
+/**
+ * lvm_dm_writecache_stats: (skip)
+ *
+ * Gets the stats of the @vg_name/@lv_name writecache LV from the status and
+ * table of its 'writecache' DM map.
+ */
+BDLVMWritecacheStats __attribute__ ((visibility ("hidden")))
+*lvm_dm_writecache_stats (const gchar *vg_name, const gchar *lv_name, GError **error) {
+    struct dm_pool *pool = NULL;
+    gchar *map_name = NULL;
+    char *status_params = NULL;
+    char *table_params = NULL;
+    BDLVMWritecacheStats *ret = NULL;
+    gint n_items = 0;
+
+    pool = dm_pool_create ("bd-pool", 256);
+
+    map_name = dm_build_dm_name (pool, vg_name, lv_name, NULL);
+    status_params = lvm_dm_get_target_params (pool, map_name, DM_DEVICE_STATUS, "writecache", error);
+    if (!status_params) {
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    /* the block size is only part of the table:
+       <p|s> <origin dev> <cache dev> <block size> ... */
+    table_params = lvm_dm_get_target_params (pool, map_name, DM_DEVICE_TABLE, "writecache", error);
+    if (!table_params) {
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    ret = g_new0 (BDLVMWritecacheStats, 1);
+    if (sscanf (table_params, "%*s %*s %*s %"G_GUINT64_FORMAT, &(ret->block_size)) != 1) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to get block size from the table of the writecache map '%s'", map_name);
+        bd_lvm_writecache_stats_free (ret);
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    /* <error> <total blocks> <free blocks> <blocks under writeback> and (since
+       kernel 5.15) <read blocks> <read hits> <write blocks> <write hits> ... */
+    n_items = sscanf (status_params, "%"G_GINT64_FORMAT" %"G_GUINT64_FORMAT" %"G_GUINT64_FORMAT" %"G_GUINT64_FORMAT
+                      " %"G_GUINT64_FORMAT" %"G_GUINT64_FORMAT" %"G_GUINT64_FORMAT" %"G_GUINT64_FORMAT,
+                      &(ret->error), &(ret->total_blocks), &(ret->free_blocks), &(ret->writeback_blocks),
+                      &(ret->read_blocks), &(ret->read_hits), &(ret->write_blocks), &(ret->write_hits));
+    if (n_items < 4) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to get status of the writecache map '%s'", map_name);
+        bd_lvm_writecache_stats_free (ret);
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    dm_pool_destroy (pool);
+
+    return ret;
+}
+
+/**
+ * lvm_dm_vdo_settings_str: (skip)
+ *
+ * Returns: (transfer full): the set fields of @tuning formatted as
+ *                           "key=value" pairs for the LVM '--vdosettings'
+ *                           option or %NULL if no field is set or if @tuning
+ *                           is invalid (with @error set)
+ */
+gchar __attribute__ ((visibility ("hidden")))
+*lvm_dm_vdo_settings_str (const BDLVMVDOTuning *tuning, GError **error) {
+    GString *str = NULL;
+
+    if (!tuning)
+        return NULL;
+
+    /* LVM only takes the size in MiB */
+    if (tuning->block_map_cache_size != BD_LVM_VDO_TUNING_DEFAULT &&
+        (tuning->block_map_cache_size <= 0 || tuning->block_map_cache_size % (1024 * 1024) != 0)) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "Invalid block map cache size %"G_GINT64_FORMAT": must be a positive multiple of 1 MiB",
+                     tuning->block_map_cache_size);
+        return NULL;
+    }
+
+    str = g_string_new (NULL);
+
+#define ADD_SETTING(field, key, div)                                    \
+    if (tuning->field != BD_LVM_VDO_TUNING_DEFAULT)                     \
+        g_string_append_printf (str, "%s%s=%"G_GINT64_FORMAT,           \
+                                str->len > 0 ? " " : "", key, tuning->field / (div))
+
+    ADD_SETTING (cpu_threads, "vdo_cpu_threads", 1);
+    ADD_SETTING (bio_threads, "vdo_bio_threads", 1);
+    ADD_SETTING (ack_threads, "vdo_ack_threads", 1);
+    ADD_SETTING (hash_zone_threads, "vdo_hash_zone_threads", 1);
+    ADD_SETTING (logical_threads, "vdo_logical_threads", 1);
+    ADD_SETTING (physical_threads, "vdo_physical_threads", 1);
+    ADD_SETTING (block_map_cache_size, "vdo_block_map_cache_size_mb", 1024 * 1024);
+    ADD_SETTING (bio_rotation, "vdo_bio_rotation", 1);
+
+#undef ADD_SETTING
+
+    if (str->len == 0) {
+        g_string_free (str, TRUE);
+        return NULL;
+    }
+
+    return g_string_free (str, FALSE);
+}
+
+/**
+ * lvm_dm_vdo_get_tuning: (skip)
+ *
+ * Gets the tuning parameters the @vg_name/@pool_name VDO pool is running with
+ * from the table of its 'vdo' DM map.
+ */
+BDLVMVDOTuning __attribute__ ((visibility ("hidden")))
+*lvm_dm_vdo_get_tuning (const gchar *vg_name, const gchar *pool_name, GError **error) {
+    struct dm_pool *pool = NULL;
+    gchar *map_name = NULL;
+    char *table_params = NULL;
+    gchar **items = NULL;
+    guint n_items = 0;
+    gint64 value = 0;
+    gchar *end = NULL;
+    BDLVMVDOTuning *ret = NULL;
+
+    pool = dm_pool_create ("bd-pool", 256);
+
+    map_name = dm_build_dm_name (pool, vg_name, pool_name, VDO_POOL_LAYER);
+    table_params = lvm_dm_get_target_params (pool, map_name, DM_DEVICE_TABLE, "vdo", error);
+    if (!table_params) {
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    /* V2 and newer tables:
+       <version> <storage dev> <storage size> <minimum IO size> <block map cache size> <block map era length>
+       followed by the optional "key value" pairs (e.g. "cpu 2") */
+    items = g_strsplit_set (table_params, " \t", -1);
+    n_items = g_strv_length (items);
+    if (n_items < 6 || items[0][0] != 'V' || g_ascii_strtoll (items[0] + 1, NULL, 10) < 2) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Unsupported table format of the VDO map '%s'", map_name);
+        g_strfreev (items);
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    ret = bd_lvm_vdo_tuning_new (BD_LVM_VDO_TUNING_DEFAULT, BD_LVM_VDO_TUNING_DEFAULT, BD_LVM_VDO_TUNING_DEFAULT,
+                                 BD_LVM_VDO_TUNING_DEFAULT, BD_LVM_VDO_TUNING_DEFAULT, BD_LVM_VDO_TUNING_DEFAULT,
+                                 BD_LVM_VDO_TUNING_DEFAULT, BD_LVM_VDO_TUNING_DEFAULT);
+
+    /* block map cache size is in 4 KiB blocks */
+    value = g_ascii_strtoll (items[4], &end, 10);
+    if (end && *end == '\0')
+        ret->block_map_cache_size = value * 4096;
+
+    for (guint i = 6; i + 1 < n_items; i += 2) {
+        value = g_ascii_strtoll (items[i + 1], &end, 10);
+        if (!end || *end != '\0')
+            /* e.g. "compression on" */
+            continue;
+
+        if (g_strcmp0 (items[i], "cpu") == 0)
+            ret->cpu_threads = value;
+        else if (g_strcmp0 (items[i], "bio") == 0)
+            ret->bio_threads = value;
+        else if (g_strcmp0 (items[i], "ack") == 0)
+            ret->ack_threads = value;
+        else if (g_strcmp0 (items[i], "hash") == 0)
+            ret->hash_zone_threads = value;
+        else if (g_strcmp0 (items[i], "logical") == 0)
+            ret->logical_threads = value;
+        else if (g_strcmp0 (items[i], "physical") == 0)
+            ret->physical_threads = value;
+        else if (g_strcmp0 (items[i], "bioRotationInterval") == 0)
+            ret->bio_rotation = value;
+    }
+
+    g_strfreev (items);
+    dm_pool_destroy (pool);
+
+    return ret;
+}
+
+/**
+ * lvm_dm_raid_stats: (skip)
+ *
+ * Gets the sync progress and health of the @vg_name/@lv_name RAID LV from the
+ * status of its 'raid' DM map.
+ */
+BDLVMRaidStats __attribute__ ((visibility ("hidden")))
+*lvm_dm_raid_stats (const gchar *vg_name, const gchar *lv_name, GError **error) {
+    struct dm_pool *pool = NULL;
+    struct dm_status_raid *status = NULL;
+    gchar *map_name = NULL;
+    char *status_params = NULL;
+    BDLVMRaidStats *ret = NULL;
+
+    pool = dm_pool_create ("bd-pool", 256);
+
+    map_name = dm_build_dm_name (pool, vg_name, lv_name, NULL);
+    status_params = lvm_dm_get_target_params (pool, map_name, DM_DEVICE_STATUS, "raid", error);
+    if (!status_params) {
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    if (dm_get_status_raid (pool, status_params, &status) == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to get status of the RAID LV map '%s'", map_name);
+        dm_pool_destroy (pool);
+        return NULL;
+    }
+
+    ret = g_new0 (BDLVMRaidStats, 1);
+    ret->raid_type = g_strdup (status->raid_type);
+    ret->dev_count = status->dev_count;
+    ret->dev_health = g_strdup (status->dev_health);
+    for (const gchar *c = status->dev_health; c && *c; c++)
+        if (*c == 'D')
+            ret->failed_devs++;
+    /* the "regions" reported by the kernel are actually sectors */
+    ret->sync_size = status->total_regions * SECTOR_SIZE;
+    ret->sync_done = status->insync_regions * SECTOR_SIZE;
+    if (status->total_regions > 0)
+        ret->sync_percent = 100.0 * status->insync_regions / status->total_regions;
+    else
+        ret->sync_percent = 100.0;
+    ret->sync_action = g_strdup (status->sync_action);
+    ret->mismatch_count = status->mismatch_count;
+
+    dm_pool_destroy (pool);
+
+    return ret;
+}
+
+/* whether the @table_params of a 'linear' target point to the @dev device */
+static gboolean linear_maps_dev (const char *table_params, dev_t dev) {
+    guint dev_major = 0;
+    guint dev_minor = 0;
+
+    if (!table_params || sscanf (table_params, "%u:%u", &dev_major, &dev_minor) != 2)
+        return FALSE;
+    return makedev (dev_major, dev_minor) == dev;
+}
+
+/**
+ * lvm_dm_pvmove_progress: (skip)
+ *
+ * Gets the number of bytes of the @vg_name/@lv_name pvmove LV already moved
+ * off of the @src_dev PV. Segments being moved are 'mirror' targets (their
+ * sync progress is used), segments not moved yet are 'linear' targets on the
+ * @src_dev device and all the other segments are already moved.
+ *
+ * Fails with %BD_LVM_ERROR_NOEXIST if the pvmove LV's map doesn't exist
+ * (anymore).
+ */
+gboolean __attribute__ ((visibility ("hidden")))
+lvm_dm_pvmove_progress (const gchar *vg_name, const gchar *lv_name, dev_t src_dev,
+                        guint64 *moved, guint64 *total, GError **error) {
+    struct dm_pool *pool = NULL;
+    struct dm_task *status_task = NULL;
+    struct dm_task *table_task = NULL;
+    struct dm_status_mirror *status = NULL;
+    gchar *map_name = NULL;
+    void *next_status = NULL;
+    void *next_table = NULL;
+    guint64 start = 0;
+    guint64 length = 0;
+    gchar *type = NULL;
+    gchar *params = NULL;
+    gchar *table_type = NULL;
+    gchar *table_params = NULL;
+    gboolean ret = TRUE;
+
+    pool = dm_pool_create ("bd-pool", 256);
+    map_name = dm_build_dm_name (pool, vg_name, lv_name, NULL);
+
+    /* status of 'linear' targets is empty, the table is needed to find out
+       where they point to */
+    table_task = run_map_task (map_name, DM_DEVICE_TABLE, error);
+    if (!table_task) {
+        dm_pool_destroy (pool);
+        return FALSE;
+    }
+    status_task = run_map_task (map_name, DM_DEVICE_STATUS, error);
+    if (!status_task) {
+        dm_task_destroy (table_task);
+        dm_pool_destroy (pool);
+        return FALSE;
+    }
+
+    *moved = 0;
+    *total = 0;
+    do {
+        next_status = dm_get_next_target (status_task, next_status, &start, &length, &type, &params);
+        next_table = dm_get_next_target (table_task, next_table, &start, &length, &table_type, &table_params);
+        if (!type || g_strcmp0 (type, table_type) != 0) {
+            /* the table was reloaded between the two tasks (next segment
+               being moved), the caller can just try again */
+            g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                         "The DM map '%s' changed while being queried", map_name);
+            ret = FALSE;
+            break;
+        }
+
+        *total += length * SECTOR_SIZE;
+        if (g_strcmp0 (type, "mirror") == 0) {
+            if (dm_get_status_mirror (pool, params, &status) == 0) {
+                g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                             "Failed to get status of the pvmove map '%s'", map_name);
+                ret = FALSE;
+                break;
+            }
+            if (status->total_regions > 0)
+                *moved += (guint64) ((gdouble) length * status->insync_regions / status->total_regions) * SECTOR_SIZE;
+        } else if (g_strcmp0 (type, "linear") != 0 || !linear_maps_dev (table_params, src_dev))
+            *moved += length * SECTOR_SIZE;
+    } while (next_status && next_table);
+
+    dm_task_destroy (status_task);
+    dm_task_destroy (table_task);
+    dm_pool_destroy (pool);
+
+    return ret;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <sys/types.h>
+#include <libdevmapper.h>
+
+#include "lvm.h"
+
+/* called for every LVM DM map with a target of the requested type, @params is
+   the status line of the target (can be parsed in place) */
+typedef gboolean (*LVMDMMapFunc) (struct dm_pool *pool, const gchar *map_name, const gchar *vg_name,
+                                  const gchar *lv_name, char *params, gpointer user_data, GError **error);
+
+gboolean lvm_dm_foreach_map (const gchar *target_type, LVMDMMapFunc func, gpointer user_data, GError **error);
+
+BDLVMCacheStats* lvm_dm_cache_stats_from_status (struct dm_pool *pool, char *params, const gchar *map_name, GError **error);
+BDLVMCachedLVStats** lvm_dm_cache_stats_all (GError **error);
+
+char* lvm_dm_get_target_params (struct dm_pool *pool, const gchar *map_name, int task_type, const gchar *target_type, GError **error);
+
+BDLVMThPoolStats* lvm_dm_thpool_stats (const gchar *vg_name, const gchar *pool_name, GError **error);
+BDLVMThLVStats* lvm_dm_thlv_stats (const gchar *vg_name, const gchar *lv_name, GError **error);
+
+gchar* lvm_dm_writecache_settings_str (const BDLVMWritecacheSettings *settings);
+BDLVMWritecacheStats* lvm_dm_writecache_stats (const gchar *vg_name, const gchar *lv_name, GError **error);
+
+gchar* lvm_dm_cache_settings_str (const BDLVMCacheSettings *settings);
+BDLVMCacheSettings* lvm_dm_cache_get_settings (const gchar *vg_name, const gchar *lv_name, GError **error);
+
+gchar* lvm_dm_vdo_settings_str (const BDLVMVDOTuning *tuning, GError **error);
+BDLVMVDOTuning* lvm_dm_vdo_get_tuning (const gchar *vg_name, const gchar *pool_name, GError **error);
+BDLVMRaidStats* lvm_dm_raid_stats (const gchar *vg_name, const gchar *lv_name, GError **error);
+gboolean lvm_dm_pvmove_progress (const gchar *vg_name, const gchar *lv_name, dev_t src_dev,
+                                 guint64 *moved, guint64 *total, GError **error);
@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <blockdev/utils.h>
+
+#include "lvm.h"
+#include "lvm_placement.h"
+
+#define SYSFS_BLOCK_DIR "/sys/class/block"
+#define DEFAULT_STRIPE_SIZE (64 KiB)
+#define MIN_STRIPE_SIZE (4 KiB)
+#define MAX_SLAVES_DEPTH 16
+
+typedef struct PVDevInfo {
+    const BDLVMPVdata *pv;
+    GHashTable *disks;          /* whole disks the PV is (possibly indirectly) stored on */
+    gboolean rotational;
+    guint64 optimal_io_size;
+    guint64 physical_block_size;
+} PVDevInfo;
+
+static void pv_dev_info_free (PVDevInfo *info) {
+    if (!info)
+        return;
+    g_hash_table_destroy (info->disks);
+    g_free (info);
+}
+
+static guint64 read_sysfs_uint64 (const gchar *kname, const gchar *attr) {
+    gchar *path = NULL;
+    gchar *contents = NULL;
+    guint64 ret = 0;
+
+    path = g_strdup_printf (SYSFS_BLOCK_DIR "/%s/%s", kname, attr);
+    if (g_file_get_contents (path, &contents, NULL, NULL))
+        ret = g_ascii_strtoull (contents, NULL, 10);
+
+    g_free (contents);
+    g_free (path);
+    return ret;
+}
+
+/* name of the whole disk @kname is a partition of or @kname itself */
+static gchar* get_whole_disk (const gchar *kname) {
+    gchar *path = NULL;
+    gchar *link = NULL;
+    gchar *parent = NULL;
+    gchar *ret = NULL;
+
+    path = g_strdup_printf (SYSFS_BLOCK_DIR "/%s/partition", kname);
+    if (!g_file_test (path, G_FILE_TEST_EXISTS)) {
+        g_free (path);
+        return g_strdup (kname);
+    }
+    g_free (path);
+
+    /* /sys/class/block/sda1 -> ../../devices/.../block/sda/sda1 */
+    path = g_strdup_printf (SYSFS_BLOCK_DIR "/%s", kname);
+    link = g_file_read_link (path, NULL);
+    g_free (path);
+    if (!link)
+        return g_strdup (kname);
+
+    parent = g_path_get_dirname (link);
+    ret = g_path_get_basename (parent);
+    g_free (parent);
+    g_free (link);
+
+    return ret;
+}
+
+/* adds the whole disks @kname is stored on (walking through the stacked
+   devices like DM or MD) to @disks */
+static void add_underlying_disks (const gchar *kname, GHashTable *disks, guint depth) {
+    gchar *path = NULL;
+    GDir *dir = NULL;
+    const gchar *slave = NULL;
+    gboolean has_slaves = FALSE;
+
+    if (depth < MAX_SLAVES_DEPTH) {
+        path = g_strdup_printf (SYSFS_BLOCK_DIR "/%s/slaves", kname);
+        dir = g_dir_open (path, 0, NULL);
+        g_free (path);
+        if (dir) {
+            while ((slave = g_dir_read_name (dir))) {
+                has_slaves = TRUE;
+                add_underlying_disks (slave, disks, depth + 1);
+            }
+            g_dir_close (dir);
+        }
+    }
+
+    if (!has_slaves)
+        g_hash_table_add (disks, get_whole_disk (kname));
+}
+
+static PVDevInfo* get_pv_dev_info (const BDLVMPVdata *pv) {
+    PVDevInfo *info = g_new0 (PVDevInfo, 1);
+    gchar *dev_path = NULL;
+    gchar *kname = NULL;
+    gchar *queue_dev = NULL;
+    gchar *path = NULL;
+    GHashTableIter iter;
+    gpointer disk = NULL;
+
+    info->pv = pv;
+    info->disks = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    dev_path = bd_utils_resolve_device (pv->pv_name, NULL);
+    if (!dev_path) {
+        /* cannot say anything about the device, treat it as a standalone disk */
+        g_hash_table_add (info->disks, g_strdup (pv->pv_name));
+        return info;
+    }
+    kname = g_path_get_basename (dev_path);
+    g_free (dev_path);
+
+    add_underlying_disks (kname, info->disks, 0);
+
+    /* the device is rotational if any of the disks it is stored on is */
+    g_hash_table_iter_init (&iter, info->disks);
+    while (g_hash_table_iter_next (&iter, &disk, NULL))
+        if (read_sysfs_uint64 (disk, "queue/rotational") == 1)
+            info->rotational = TRUE;
+
+    /* stacked devices (DM, MD) have their own (combined) queue limits,
+       partitions use the limits of their disk */
+    path = g_strdup_printf (SYSFS_BLOCK_DIR "/%s/queue", kname);
+    if (g_file_test (path, G_FILE_TEST_IS_DIR))
+        queue_dev = g_strdup (kname);
+    else
+        queue_dev = get_whole_disk (kname);
+    g_free (path);
+
+    info->optimal_io_size = read_sysfs_uint64 (queue_dev, "queue/optimal_io_size");
+    info->physical_block_size = read_sysfs_uint64 (queue_dev, "queue/physical_block_size");
+
+    g_free (queue_dev);
+    g_free (kname);
+    return info;
+}
+
+static gint cmp_pv_free_desc (gconstpointer a, gconstpointer b) {
+    const PVDevInfo *info_a = *((PVDevInfo **) a);
+    const PVDevInfo *info_b = *((PVDevInfo **) b);
+
+    if (info_a->pv->pv_free > info_b->pv->pv_free)
+        return -1;
+    else if (info_a->pv->pv_free < info_b->pv->pv_free)
+        return 1;
+    else
+        return g_strcmp0 (info_a->pv->pv_name, info_b->pv->pv_name);
+}
+
+static gboolean shares_disk (const PVDevInfo *info, GHashTable *used_disks) {
+    GHashTableIter iter;
+    gpointer disk = NULL;
+
+    g_hash_table_iter_init (&iter, info->disks);
+    while (g_hash_table_iter_next (&iter, &disk, NULL))
+        if (g_hash_table_contains (used_disks, disk))
+            return TRUE;
+
+    return FALSE;
+}
+
+static guint64 pick_stripe_size (PVDevInfo **chosen, guint n_chosen, guint64 extent_size) {
+    guint64 stripe_size = DEFAULT_STRIPE_SIZE;
+    guint64 opt = 0;
+    guint64 pbs = 0;
+
+    for (guint i = 0; i < n_chosen; i++) {
+        opt = MAX (opt, chosen[i]->optimal_io_size);
+        pbs = MAX (pbs, chosen[i]->physical_block_size);
+    }
+
+    /* LVM requires the stripe size to be a power of 2 */
+    if (opt > stripe_size && (opt & (opt - 1)) == 0)
+        stripe_size = opt;
+    while (stripe_size < pbs)
+        stripe_size *= 2;
+    if (extent_size > 0)
+        while (stripe_size > extent_size && stripe_size > MIN_STRIPE_SIZE)
+            stripe_size /= 2;
+
+    return stripe_size;
+}
+
+static BDLVMPlacement* new_placement (PVDevInfo **chosen, guint n_chosen, guint stripes, guint64 extent_size) {
+    BDLVMPlacement *ret = g_new0 (BDLVMPlacement, 1);
+
+    ret->pvs = g_new0 (gchar *, n_chosen + 1);
+    for (guint i = 0; i < n_chosen; i++) {
+        ret->pvs[i] = g_strdup (chosen[i]->pv->pv_name);
+        ret->rotational = ret->rotational || chosen[i]->rotational;
+    }
+    ret->stripes = stripes;
+    ret->stripe_size = stripes > 1 ? pick_stripe_size (chosen, n_chosen, extent_size) : 0;
+
+    return ret;
+}
+
+/* tries to find a striped placement (or a single PV) on the PVs from @infos
+   sorted by their free space */
+static BDLVMPlacement* plan_striped (GPtrArray *infos, guint64 n_extents, guint64 extent_size, guint max_stripes) {
+    GHashTable *used_disks = NULL;
+    GPtrArray *candidates = NULL;
+    PVDevInfo *info = NULL;
+    GHashTableIter iter;
+    gpointer disk = NULL;
+    guint64 stripe_extents = 0;
+    BDLVMPlacement *ret = NULL;
+
+    /* the PV with the most free space from every group of PVs sharing a disk */
+    used_disks = g_hash_table_new (g_str_hash, g_str_equal);
+    candidates = g_ptr_array_new ();
+    for (guint i = 0; i < infos->len && (max_stripes == 0 || candidates->len < max_stripes); i++) {
+        info = g_ptr_array_index (infos, i);
+        if (shares_disk (info, used_disks))
+            continue;
+        g_ptr_array_add (candidates, info);
+        g_hash_table_iter_init (&iter, info->disks);
+        while (g_hash_table_iter_next (&iter, &disk, NULL))
+            g_hash_table_add (used_disks, disk);
+    }
+
+    /* as many stripes as possible, the number of extents of the LV has to be
+       divisible by the number of stripes */
+    for (guint n = candidates->len; n > 0 && !ret; n--) {
+        stripe_extents = (n_extents + n - 1) / n;
+        info = g_ptr_array_index (candidates, n - 1);
+        if (info->pv->pv_free / extent_size >= stripe_extents)
+            ret = new_placement ((PVDevInfo **) candidates->pdata, n, n, extent_size);
+    }
+
+    g_ptr_array_free (candidates, TRUE);
+    g_hash_table_destroy (used_disks);
+    return ret;
+}
+
+/* linear placement over as few PVs (from @infos sorted by their free space) as possible */
+static BDLVMPlacement* plan_linear (GPtrArray *infos, guint64 n_extents, guint64 extent_size) {
+    guint64 free_extents = 0;
+    guint n = 0;
+
+    while (n < infos->len && free_extents < n_extents) {
+        free_extents += ((PVDevInfo *) g_ptr_array_index (infos, n))->pv->pv_free / extent_size;
+        n++;
+    }
+    if (free_extents < n_extents)
+        return NULL;
+
+    return new_placement ((PVDevInfo **) infos->pdata, n, 1, extent_size);
+}
+
+/**
+ * lvm_plan_placement: (skip)
+ *
+ * Picks PVs (from @pvs) of the @vg_name VG for a new LV of @size together with
+ * the number of stripes and stripe size. Non-rotational and rotational PVs are
+ * never mixed if the LV fits on either of the two groups (a stripe is only as
+ * fast as its slowest leg), non-rotational PVs are preferred. PVs stored on the
+ * same disk are never used as two stripes of the LV.
+ */
+BDLVMPlacement __attribute__ ((visibility ("hidden")))
+*lvm_plan_placement (BDLVMPVdata **pvs, const gchar *vg_name, guint64 size, guint max_stripes, GError **error) {
+    GPtrArray *all = NULL;
+    GPtrArray *classes[2] = {NULL, NULL};
+    guint64 extent_size = 0;
+    guint64 n_extents = 0;
+    gboolean vg_found = FALSE;
+    PVDevInfo *info = NULL;
+    BDLVMPlacement *ret = NULL;
+
+    all = g_ptr_array_new_with_free_func ((GDestroyNotify) pv_dev_info_free);
+    for (BDLVMPVdata **pv = pvs; pv && *pv; pv++) {
+        if (g_strcmp0 ((*pv)->vg_name, vg_name) != 0)
+            continue;
+        vg_found = TRUE;
+        extent_size = (*pv)->vg_extent_size;
+        if ((*pv)->pv_free == 0)
+            continue;
+        g_ptr_array_add (all, get_pv_dev_info (*pv));
+    }
+
+    if (!vg_found) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOEXIST,
+                     "VG '%s' not found", vg_name);
+        g_ptr_array_free (all, TRUE);
+        return NULL;
+    }
+    if (extent_size == 0 || size == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "Invalid size or extent size for placement in the VG '%s'", vg_name);
+        g_ptr_array_free (all, TRUE);
+        return NULL;
+    }
+    n_extents = (size + extent_size - 1) / extent_size;
+
+    g_ptr_array_sort (all, cmp_pv_free_desc);
+
+    /* [0] non-rotational, [1] rotational */
+    classes[0] = g_ptr_array_new ();
+    classes[1] = g_ptr_array_new ();
+    for (guint i = 0; i < all->len; i++) {
+        info = g_ptr_array_index (all, i);
+        g_ptr_array_add (classes[info->rotational ? 1 : 0], info);
+    }
+
+    for (guint i = 0; i < 2 && !ret; i++)
+        ret = plan_striped (classes[i], n_extents, extent_size, max_stripes);
+    for (guint i = 0; i < 2 && !ret; i++)
+        ret = plan_linear (classes[i], n_extents, extent_size);
+    if (!ret)
+        ret = plan_linear (all, n_extents, extent_size);
+
+    if (!ret)
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "Not enough free space in the VG '%s' for %"G_GUINT64_FORMAT" bytes", vg_name, size);
+
+    g_ptr_array_free (classes[0], TRUE);
+    g_ptr_array_free (classes[1], TRUE);
+    g_ptr_array_free (all, TRUE);
+
+    return ret;
+}
@@ -0,0 +1,738 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <string.h>
+#include <blockdev/utils.h>
+
+#include "lvm.h"
+#include "lvm_report.h"
+
+#define PV_FIELD(name, type, member) {name, type, G_STRUCT_OFFSET (BDLVMPVdata, member)}
+#define VG_FIELD(name, type, member) {name, type, G_STRUCT_OFFSET (BDLVMVGdata, member)}
+#define LV_FIELD(name, type, member) {name, type, G_STRUCT_OFFSET (BDLVMLVdata, member)}
+#define PVSEG_FIELD(name, type, member) {name, type, G_STRUCT_OFFSET (BDLVMPVSEGdata, member)}
+
+const LVMReportField __attribute__ ((visibility ("hidden"))) lvm_report_pv_fields[] = {
+    PV_FIELD ("pv_name", LVM_REPORT_FIELD_STR, pv_name),
+    PV_FIELD ("pv_uuid", LVM_REPORT_FIELD_STR, pv_uuid),
+    PV_FIELD ("pv_free", LVM_REPORT_FIELD_UINT64, pv_free),
+    PV_FIELD ("pv_size", LVM_REPORT_FIELD_UINT64, pv_size),
+    PV_FIELD ("pe_start", LVM_REPORT_FIELD_UINT64, pe_start),
+    PV_FIELD ("vg_name", LVM_REPORT_FIELD_SHARED_STR, vg_name),
+    PV_FIELD ("vg_uuid", LVM_REPORT_FIELD_SHARED_STR, vg_uuid),
+    PV_FIELD ("vg_size", LVM_REPORT_FIELD_UINT64, vg_size),
+    PV_FIELD ("vg_free", LVM_REPORT_FIELD_UINT64, vg_free),
+    PV_FIELD ("vg_extent_size", LVM_REPORT_FIELD_UINT64, vg_extent_size),
+    PV_FIELD ("vg_extent_count", LVM_REPORT_FIELD_UINT64, vg_extent_count),
+    PV_FIELD ("vg_free_count", LVM_REPORT_FIELD_UINT64, vg_free_count),
+    PV_FIELD ("pv_count", LVM_REPORT_FIELD_UINT64, vg_pv_count),
+    PV_FIELD ("pv_tags", LVM_REPORT_FIELD_TAGS, pv_tags),
+    {NULL, 0, 0}
+};
+
+const LVMReportField __attribute__ ((visibility ("hidden"))) lvm_report_vg_fields[] = {
+    VG_FIELD ("vg_name", LVM_REPORT_FIELD_STR, name),
+    VG_FIELD ("vg_uuid", LVM_REPORT_FIELD_STR, uuid),
+    VG_FIELD ("vg_size", LVM_REPORT_FIELD_UINT64, size),
+    VG_FIELD ("vg_free", LVM_REPORT_FIELD_UINT64, free),
+    VG_FIELD ("vg_extent_size", LVM_REPORT_FIELD_UINT64, extent_size),
+    VG_FIELD ("vg_extent_count", LVM_REPORT_FIELD_UINT64, extent_count),
+    VG_FIELD ("vg_free_count", LVM_REPORT_FIELD_UINT64, free_count),
+    VG_FIELD ("pv_count", LVM_REPORT_FIELD_UINT64, pv_count),
+    VG_FIELD ("vg_exported", LVM_REPORT_FIELD_EXPORTED, exported),
+    VG_FIELD ("vg_tags", LVM_REPORT_FIELD_TAGS, vg_tags),
+    {NULL, 0, 0}
+};
+
+const LVMReportField __attribute__ ((visibility ("hidden"))) lvm_report_lv_fields[] = {
+    LV_FIELD ("vg_name", LVM_REPORT_FIELD_SHARED_STR, vg_name),
+    LV_FIELD ("lv_name", LVM_REPORT_FIELD_STR, lv_name),
+    LV_FIELD ("lv_uuid", LVM_REPORT_FIELD_STR, uuid),
+    LV_FIELD ("lv_size", LVM_REPORT_FIELD_UINT64, size),
+    LV_FIELD ("lv_attr", LVM_REPORT_FIELD_STR, attr),
+    LV_FIELD ("segtype", LVM_REPORT_FIELD_STR, segtype),
+    LV_FIELD ("origin", LVM_REPORT_FIELD_STR, origin),
+    LV_FIELD ("pool_lv", LVM_REPORT_FIELD_SUB_LV, pool_lv),
+    LV_FIELD ("data_lv", LVM_REPORT_FIELD_SUB_LV, data_lv),
+    LV_FIELD ("metadata_lv", LVM_REPORT_FIELD_SUB_LV, metadata_lv),
+    LV_FIELD ("lv_role", LVM_REPORT_FIELD_STR, roles),
+    LV_FIELD ("move_pv", LVM_REPORT_FIELD_STR, move_pv),
+    LV_FIELD ("data_percent", LVM_REPORT_FIELD_UINT64, data_percent),
+    LV_FIELD ("metadata_percent", LVM_REPORT_FIELD_UINT64, metadata_percent),
+    LV_FIELD ("copy_percent", LVM_REPORT_FIELD_UINT64, copy_percent),
+    LV_FIELD ("lv_tags", LVM_REPORT_FIELD_TAGS, lv_tags),
+    {NULL, 0, 0}
+};
+
+const LVMReportField __attribute__ ((visibility ("hidden"))) lvm_report_pvseg_fields[] = {
+    PVSEG_FIELD ("pv_uuid", LVM_REPORT_FIELD_STR, pv_uuid),
+    PVSEG_FIELD ("lv_uuid", LVM_REPORT_FIELD_STR, lv_uuid),
+    PVSEG_FIELD ("pvseg_start", LVM_REPORT_FIELD_UINT64, pv_start_pe),
+    PVSEG_FIELD ("pvseg_size", LVM_REPORT_FIELD_UINT64, size_pe),
+    {NULL, 0, 0}
+};
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGN 8
+
+/**
+ * lvm_report_arena_init: (skip)
+ *
+ * Initializes the (caller-allocated) @arena. The arena has to be cleared with
+ * lvm_report_arena_clear() unless turned into a result set with
+ * lvm_report_arena_to_result_set().
+ */
+void __attribute__ ((visibility ("hidden")))
+lvm_report_arena_init (LVMReportArena *arena) {
+    arena->blocks = g_ptr_array_new_with_free_func (g_free);
+    arena->strings = g_string_chunk_new (ARENA_BLOCK_SIZE);
+    arena->pos = NULL;
+    arena->left = 0;
+}
+
+/**
+ * lvm_report_arena_clear: (skip)
+ *
+ * Frees all the memory allocated in the @arena.
+ */
+void __attribute__ ((visibility ("hidden")))
+lvm_report_arena_clear (LVMReportArena *arena) {
+    if (arena->blocks)
+        g_ptr_array_unref (arena->blocks);
+    if (arena->strings)
+        g_string_chunk_free (arena->strings);
+    arena->blocks = NULL;
+    arena->strings = NULL;
+    arena->pos = NULL;
+    arena->left = 0;
+}
+
+/**
+ * lvm_report_arena_alloc0: (skip)
+ *
+ * Returns: (transfer none): @size bytes of zeroed memory owned by the @arena
+ */
+gpointer __attribute__ ((visibility ("hidden")))
+lvm_report_arena_alloc0 (LVMReportArena *arena, gsize size) {
+    gpointer ret = NULL;
+
+    size = (size + ARENA_ALIGN - 1) & ~((gsize) ARENA_ALIGN - 1);
+    if (size > ARENA_BLOCK_SIZE / 4) {
+        /* big allocations get their own block so that the rest of the
+           current block is not wasted */
+        ret = g_malloc0 (size);
+        g_ptr_array_add (arena->blocks, ret);
+        return ret;
+    }
+
+    if (size > arena->left) {
+        arena->pos = g_malloc0 (ARENA_BLOCK_SIZE);
+        arena->left = ARENA_BLOCK_SIZE;
+        g_ptr_array_add (arena->blocks, arena->pos);
+    }
+
+    ret = arena->pos;
+    arena->pos += size;
+    arena->left -= size;
+
+    return ret;
+}
+
+static gchar* arena_strdup (LVMReportArena *arena, const gchar *str) {
+    return str ? g_string_chunk_insert (arena->strings, str) : NULL;
+}
+
+/* same as g_strsplit (@value, ",", -1) with a single string for all the items */
+static gchar** arena_split_tags (LVMReportArena *arena, const gchar *value) {
+    gchar **ret = NULL;
+    gchar *tags = NULL;
+    guint n_tags = 0;
+    guint i = 0;
+    const gchar *c = NULL;
+
+    if (!value)
+        return NULL;
+
+    if (*value != '\0') {
+        n_tags = 1;
+        for (c=value; *c; c++)
+            if (*c == ',')
+                n_tags++;
+    }
+
+    ret = lvm_report_arena_alloc0 (arena, (n_tags + 1) * sizeof (gchar *));
+    if (n_tags == 0)
+        return ret;
+
+    tags = arena_strdup (arena, value);
+    ret[0] = tags;
+    for (i=1; *tags; tags++)
+        if (*tags == ',') {
+            *tags = '\0';
+            ret[i++] = tags + 1;
+        }
+
+    return ret;
+}
+
+/**
+ * lvm_report_arena_copy_record: (skip)
+ *
+ * Copies the @data struct (with all the @fields) into the @arena.
+ *
+ * Returns: (transfer none): the copy owned by the @arena
+ */
+gpointer __attribute__ ((visibility ("hidden")))
+lvm_report_arena_copy_record (LVMReportArena *arena, gconstpointer data, const LVMReportField *fields, gsize data_size) {
+    gpointer ret = lvm_report_arena_alloc0 (arena, data_size);
+    const LVMReportField *field = NULL;
+    gpointer member = NULL;
+    gchar **tags = NULL;
+
+    memcpy (ret, data, data_size);
+    for (field=fields; field->name; field++) {
+        member = G_STRUCT_MEMBER_P (ret, field->offset);
+        switch (field->type) {
+        case LVM_REPORT_FIELD_STR:
+        case LVM_REPORT_FIELD_SUB_LV:
+            *(gchar **) member = arena_strdup (arena, *(gchar **) member);
+            break;
+        case LVM_REPORT_FIELD_SHARED_STR:
+            if (*(gchar **) member)
+                *(const gchar **) member = g_string_chunk_insert_const (arena->strings, *(gchar **) member);
+            break;
+        case LVM_REPORT_FIELD_TAGS:
+            tags = *(gchar ***) member;
+            if (tags) {
+                *(gchar ***) member = lvm_report_arena_alloc0 (arena, (g_strv_length (tags) + 1) * sizeof (gchar *));
+                for (guint i=0; tags[i]; i++)
+                    (*(gchar ***) member)[i] = arena_strdup (arena, tags[i]);
+            }
+            break;
+        case LVM_REPORT_FIELD_UINT64:
+        case LVM_REPORT_FIELD_EXPORTED:
+            break;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * lvm_report_arena_to_result_set: (skip)
+ * @records: (transfer full): records allocated in the @arena
+ *
+ * Turns the @arena into a new #BDLVMResultSet with the @records as its items.
+ * The @arena is left empty (as if cleared).
+ */
+BDLVMResultSet __attribute__ ((visibility ("hidden")))
+*lvm_report_arena_to_result_set (LVMReportArena *arena, BDLVMResultSetType item_type, GPtrArray *records) {
+    BDLVMResultSet *ret = g_new0 (BDLVMResultSet, 1);
+    guint i = 0;
+
+    ret->item_type = item_type;
+    ret->n_items = records->len;
+    ret->items = lvm_report_arena_alloc0 (arena, (records->len + 1) * sizeof (gpointer));
+    for (i=0; i < records->len; i++)
+        ret->items[i] = g_ptr_array_index (records, i);
+    g_ptr_array_free (records, TRUE);
+
+    ret->ref_count = 1;
+    ret->blocks = arena->blocks;
+    ret->strings = arena->strings;
+
+    arena->blocks = NULL;
+    arena->strings = NULL;
+    lvm_report_arena_clear (arena);
+
+    return ret;
+}
+
+/**
+ * lvm_report_set_field: (skip)
+ *
+ * Sets the @field of the @data struct from the @value string the same way
+ * the get_*_data_from_table() functions in lvm.c do. If @arena is not %NULL,
+ * the strings are allocated in it (and the previous values are not freed).
+ */
+void __attribute__ ((visibility ("hidden")))
+lvm_report_set_field (gpointer data, const LVMReportField *field, const gchar *value, LVMReportArena *arena) {
+    gpointer member = G_STRUCT_MEMBER_P (data, field->offset);
+
+    switch (field->type) {
+    case LVM_REPORT_FIELD_STR:
+        if (arena)
+            *(gchar **) member = arena_strdup (arena, value);
+        else {
+            g_free (*(gchar **) member);
+            *(gchar **) member = g_strdup (value);
+        }
+        break;
+    case LVM_REPORT_FIELD_SHARED_STR:
+        if (arena)
+            *(const gchar **) member = value ? g_string_chunk_insert_const (arena->strings, value) : NULL;
+        else {
+            g_free (*(gchar **) member);
+            *(gchar **) member = g_strdup (value);
+        }
+        break;
+    case LVM_REPORT_FIELD_SUB_LV:
+        if (!arena)
+            g_free (*(gchar **) member);
+        /* replace '[' and ']' (marking LVs as internal) with spaces and then
+           remove all the leading and trailing whitespace */
+        *(gchar **) member = g_strstrip (g_strdelimit (arena ? arena_strdup (arena, value) : g_strdup (value), "[]", ' '));
+        break;
+    case LVM_REPORT_FIELD_UINT64:
+        *(guint64 *) member = g_ascii_strtoull (value, NULL, 0);
+        break;
+    case LVM_REPORT_FIELD_TAGS:
+        if (arena)
+            *(gchar ***) member = arena_split_tags (arena, value);
+        else {
+            g_strfreev (*(gchar ***) member);
+            *(gchar ***) member = g_strsplit (value, ",", -1);
+        }
+        break;
+    case LVM_REPORT_FIELD_EXPORTED:
+        *(gboolean *) member = (g_strcmp0 (value, "exported") == 0);
+        break;
+    }
+}
+
+/**
+ * lvm_report_fields_str: (skip)
+ * @fields: (array zero-terminated=1): known fields of the records
+ * @mask: bit mask of the @fields to include, (1 << i) for the i-th field
+ * @n_fields: (out): number of fields included
+ *
+ * Returns: (transfer full): comma-separated list of the fields to request from
+ *                           LVM (with the '-o' option)
+ */
+gchar __attribute__ ((visibility ("hidden")))
+*lvm_report_fields_str (const LVMReportField *fields, guint64 mask, guint *n_fields) {
+    GString *ret = g_string_new (NULL);
+    guint i = 0;
+
+    *n_fields = 0;
+    for (i=0; fields[i].name && i < 64; i++) {
+        if (!(mask & (G_GUINT64_CONSTANT (1) << i)))
+            continue;
+        if (ret->len > 0)
+            g_string_append_c (ret, ',');
+        g_string_append (ret, fields[i].name);
+        (*n_fields)++;
+    }
+
+    return g_string_free (ret, FALSE);
+}
+
+static inline void skip_ws (gchar **pos) {
+    while (**pos == ' ' || **pos == '\t' || **pos == '\n' || **pos == '\r')
+        (*pos)++;
+}
+
+static gboolean expect_char (gchar **pos, gchar c) {
+    skip_ws (pos);
+    if (**pos != c)
+        return FALSE;
+    (*pos)++;
+    return TRUE;
+}
+
+/**
+ * parse_string: (skip)
+ *
+ * Parses the JSON string starting at *@pos (pointing to the opening quote)
+ * decoding it in place (the result is never longer than the encoded string).
+ *
+ * Returns: (transfer none): the decoded string (pointing into the parsed buffer)
+ *                           or %NULL in case of error
+ */
+static gchar* parse_string (gchar **pos) {
+    gchar *read = *pos + 1;
+    gchar *write = read;
+    gchar *start = read;
+    gchar hex[5] = {0};
+    gunichar uc = 0;
+
+    while (*read != '"') {
+        if (*read == '\0')
+            return NULL;
+        if (*read != '\\') {
+            *write++ = *read++;
+            continue;
+        }
+        read++;
+        switch (*read) {
+        case '"':
+        case '\\':
+        case '/':
+            *write++ = *read++;
+            break;
+        case 'b':
+            *write++ = '\b';
+            read++;
+            break;
+        case 'f':
+            *write++ = '\f';
+            read++;
+            break;
+        case 'n':
+            *write++ = '\n';
+            read++;
+            break;
+        case 'r':
+            *write++ = '\r';
+            read++;
+            break;
+        case 't':
+            *write++ = '\t';
+            read++;
+            break;
+        case 'u':
+            if (!g_ascii_isxdigit (read[1]) || !g_ascii_isxdigit (read[2]) ||
+                !g_ascii_isxdigit (read[3]) || !g_ascii_isxdigit (read[4]))
+                return NULL;
+            memcpy (hex, read + 1, 4);
+            uc = (gunichar) g_ascii_strtoull (hex, NULL, 16);
+            /* at most 3 bytes for a BMP character, the escape sequence has 6 */
+            write += g_unichar_to_utf8 (uc, write);
+            read += 5;
+            break;
+        default:
+            return NULL;
+        }
+    }
+
+    *write = '\0';
+    *pos = read + 1;
+    return start;
+}
+
+/* numbers, true, false, null */
+static gchar* parse_bare_value (gchar **pos) {
+    gchar *start = *pos;
+
+    while (g_ascii_isalnum (**pos) || **pos == '.' || **pos == '-' || **pos == '+')
+        (*pos)++;
+
+    if (*pos == start)
+        return NULL;
+
+    return g_strndup (start, *pos - start);
+}
+
+static gboolean skip_value (gchar **pos) {
+    gchar *value = NULL;
+    gchar closing = '\0';
+
+    skip_ws (pos);
+    if (**pos == '"')
+        return parse_string (pos) != NULL;
+
+    if (**pos == '{' || **pos == '[') {
+        closing = (**pos == '{') ? '}' : ']';
+        (*pos)++;
+        skip_ws (pos);
+        if (**pos == closing) {
+            (*pos)++;
+            return TRUE;
+        }
+        while (TRUE) {
+            if (closing == '}') {
+                skip_ws (pos);
+                if (**pos != '"' || !parse_string (pos) || !expect_char (pos, ':'))
+                    return FALSE;
+            }
+            if (!skip_value (pos))
+                return FALSE;
+            skip_ws (pos);
+            if (**pos == ',') {
+                (*pos)++;
+                continue;
+            }
+            return expect_char (pos, closing);
+        }
+    }
+
+    value = parse_bare_value (pos);
+    g_free (value);
+    return value != NULL;
+}
+
+static const LVMReportField* find_field (const LVMReportField *fields, const gchar *name) {
+    const LVMReportField *field = NULL;
+
+    for (field=fields; field->name; field++)
+        if (strcmp (field->name, name) == 0)
+            return field;
+
+    return NULL;
+}
+
+/* parses one {"field": "value", ...} record into @data, @n_set is set to the
+   number of known fields found in the record */
+static gboolean parse_record (gchar **pos, gpointer data, const LVMReportField *fields, LVMReportArena *arena, guint *n_set) {
+    const LVMReportField *field = NULL;
+    gchar *key = NULL;
+    gchar *value = NULL;
+
+    *n_set = 0;
+    if (!expect_char (pos, '{'))
+        return FALSE;
+
+    skip_ws (pos);
+    if (**pos == '}') {
+        (*pos)++;
+        return TRUE;
+    }
+
+    while (TRUE) {
+        skip_ws (pos);
+        if (**pos != '"' || !(key = parse_string (pos)) || !expect_char (pos, ':'))
+            return FALSE;
+
+        field = find_field (fields, key);
+        skip_ws (pos);
+        if (!field) {
+            if (!skip_value (pos))
+                return FALSE;
+        } else if (**pos == '"') {
+            if (!(value = parse_string (pos)))
+                return FALSE;
+            lvm_report_set_field (data, field, value, arena);
+            (*n_set)++;
+        } else {
+            /* values are always strings with --reportformat=json, but be
+               tolerant to json_std with numbers */
+            if (!(value = parse_bare_value (pos)))
+                return FALSE;
+            lvm_report_set_field (data, field, value, arena);
+            g_free (value);
+            (*n_set)++;
+        }
+
+        skip_ws (pos);
+        if (**pos == ',') {
+            (*pos)++;
+            continue;
+        }
+        return expect_char (pos, '}');
+    }
+}
+
+/* parses the [{record}, ...] array of the @section */
+static gboolean parse_section (gchar **pos, LVMReportSection *section) {
+    gpointer data = NULL;
+    guint n_set = 0;
+
+    if (!expect_char (pos, '['))
+        return FALSE;
+
+    skip_ws (pos);
+    if (**pos == ']') {
+        (*pos)++;
+        return TRUE;
+    }
+
+    while (TRUE) {
+        if (section->arena)
+            data = lvm_report_arena_alloc0 (section->arena, section->data_size);
+        else
+            data = g_malloc0 (section->data_size);
+        if (!parse_record (pos, data, section->fields, section->arena, &n_set)) {
+            if (!section->arena)
+                section->free_func (data);
+            return FALSE;
+        }
+        if (n_set >= section->n_required)
+            g_ptr_array_add (section->records, data);
+        else if (!section->arena)
+            /* incomplete record, ignore it the same way incomplete lines are
+               ignored (records in an arena are freed with the arena) */
+            section->free_func (data);
+
+        skip_ws (pos);
+        if (**pos == ',') {
+            (*pos)++;
+            continue;
+        }
+        return expect_char (pos, ']');
+    }
+}
+
+static LVMReportSection* find_section (LVMReportSection *sections, const gchar *name) {
+    LVMReportSection *section = NULL;
+
+    for (section=sections; section->name; section++)
+        if (strcmp (section->name, name) == 0)
+            return section;
+
+    return NULL;
+}
+
+/* parses the "report": [{"section": [...]}, ...] array, there is one item per
+   VG for 'lvm fullreport' */
+static gboolean parse_report_array (gchar **pos, LVMReportSection *sections) {
+    LVMReportSection *section = NULL;
+    gchar *key = NULL;
+
+    if (!expect_char (pos, '['))
+        return FALSE;
+
+    skip_ws (pos);
+    if (**pos == ']') {
+        (*pos)++;
+        return TRUE;
+    }
+
+    while (TRUE) {
+        if (!expect_char (pos, '{'))
+            return FALSE;
+        skip_ws (pos);
+        if (**pos != '}') {
+            while (TRUE) {
+                skip_ws (pos);
+                if (**pos != '"' || !(key = parse_string (pos)) || !expect_char (pos, ':'))
+                    return FALSE;
+                section = find_section (sections, key);
+                if (section) {
+                    if (!parse_section (pos, section))
+                        return FALSE;
+                } else if (!skip_value (pos))
+                    return FALSE;
+                skip_ws (pos);
+                if (**pos == ',') {
+                    (*pos)++;
+                    continue;
+                }
+                break;
+            }
+        }
+        if (!expect_char (pos, '}'))
+            return FALSE;
+
+        skip_ws (pos);
+        if (**pos == ',') {
+            (*pos)++;
+            continue;
+        }
+        return expect_char (pos, ']');
+    }
+}
+
+/**
+ * lvm_json_report_parse_sections: (skip)
+ * @report: output of an LVM reporting command run with '--reportformat json'
+ *          (modified during the parsing)
+ * @sections: (array zero-terminated=1): the report sections to get records from
+ * @error: (out): place to store error (if any)
+ *
+ * Parses the report in a single pass filling the structs directly, no
+ * intermediate (per-record or per-field) data structures are created. Records
+ * missing some of the required fields are skipped, sections not listed in
+ * @sections are skipped completely.
+ *
+ * The @records arrays of the @sections are created by this function (with the
+ * @free_func of the section as the free function unless the records are
+ * allocated in the @arena of the section) and are left %NULL in case of error.
+ *
+ * Returns: whether the report was successfully parsed or not
+ */
+gboolean __attribute__ ((visibility ("hidden")))
+lvm_json_report_parse_sections (gchar *report, LVMReportSection *sections, GError **error) {
+    LVMReportSection *section = NULL;
+    gchar *pos = report;
+    gchar *key = NULL;
+    gboolean success = FALSE;
+
+    for (section=sections; section->name; section++)
+        section->records = g_ptr_array_new_with_free_func (section->arena ? NULL : section->free_func);
+
+    success = expect_char (&pos, '{');
+    skip_ws (&pos);
+    if (success && *pos == '}')
+        pos++;
+    else {
+        while (success) {
+            skip_ws (&pos);
+            if (*pos != '"' || !(key = parse_string (&pos)) || !expect_char (&pos, ':')) {
+                success = FALSE;
+                break;
+            }
+            if (g_strcmp0 (key, "report") == 0)
+                success = parse_report_array (&pos, sections);
+            else
+                /* "log" and whatever else there may be */
+                success = skip_value (&pos);
+
+            skip_ws (&pos);
+            if (success && *pos == ',') {
+                pos++;
+                continue;
+            }
+            success = success && expect_char (&pos, '}');
+            break;
+        }
+    }
+
+    if (!success) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to parse the JSON report at position %"G_GSIZE_FORMAT,
+                     (gsize) (pos - report));
+        for (section=sections; section->name; section++) {
+            g_ptr_array_free (section->records, TRUE);
+            section->records = NULL;
+        }
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * lvm_json_report_parse: (skip)
+ * @report: output of an LVM reporting command run with '--reportformat json'
+ *          (modified during the parsing)
+ * @section: the report section to get records from ("pv", "vg", "lv",...)
+ * @fields: (array zero-terminated=1): known fields of the records
+ * @n_required: minimum number of known fields a valid record needs to have
+ * @data_size: size of the struct a record is parsed into
+ * @free_func: function to free the struct
+ * @arena: (allow-none): arena to allocate the records in or %NULL
+ * @error: (out): place to store error (if any)
+ *
+ * Single-section variant of lvm_json_report_parse_sections().
+ *
+ * Returns: (transfer full): array of the parsed records (with @free_func as the
+ *                           free function, no free function for records in
+ *                           the @arena) or %NULL in case of error
+ */
+GPtrArray __attribute__ ((visibility ("hidden")))
+*lvm_json_report_parse (gchar *report, const gchar *section, const LVMReportField *fields,
+                        guint n_required, gsize data_size, GDestroyNotify free_func,
+                        LVMReportArena *arena, GError **error) {
+    LVMReportSection sections[2] = {{section, fields, n_required, data_size, free_func, NULL, arena},
+                                    {NULL, NULL, 0, 0, NULL, NULL, NULL}};
+
+    if (!lvm_json_report_parse_sections (report, sections, error))
+        return NULL;
+
+    return sections[0].records;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+#include "lvm.h"
+
+typedef enum {
+    LVM_REPORT_FIELD_STR,
+    LVM_REPORT_FIELD_SHARED_STR, /* string shared by many records, interned in arenas */
+    LVM_REPORT_FIELD_UINT64,
+    LVM_REPORT_FIELD_TAGS,      /* comma-separated list -> gchar** */
+    LVM_REPORT_FIELD_EXPORTED,  /* "exported" -> gboolean */
+    LVM_REPORT_FIELD_SUB_LV,    /* LV name with the '[]' marking internal LVs removed */
+} LVMReportFieldType;
+
+typedef struct LVMReportField {
+    const gchar *name;
+    LVMReportFieldType type;
+    gsize offset;
+} LVMReportField;
+
+/* fields of BDLVMPVdata, BDLVMVGdata, BDLVMLVdata and BDLVMPVSEGdata (NULL-terminated) */
+extern const LVMReportField lvm_report_pv_fields[];
+extern const LVMReportField lvm_report_vg_fields[];
+extern const LVMReportField lvm_report_lv_fields[];
+extern const LVMReportField lvm_report_pvseg_fields[];
+
+/* bump allocator for records and GStringChunk for their strings, all freed at
+   once (by the BDLVMResultSet the arena is turned into) */
+typedef struct LVMReportArena {
+    GPtrArray *blocks;
+    GStringChunk *strings;
+    gchar *pos;                 /* free space in the current block */
+    gsize left;
+} LVMReportArena;
+
+void lvm_report_arena_init (LVMReportArena *arena);
+void lvm_report_arena_clear (LVMReportArena *arena);
+gpointer lvm_report_arena_alloc0 (LVMReportArena *arena, gsize size);
+gpointer lvm_report_arena_copy_record (LVMReportArena *arena, gconstpointer data, const LVMReportField *fields, gsize data_size);
+BDLVMResultSet* lvm_report_arena_to_result_set (LVMReportArena *arena, BDLVMResultSetType item_type, GPtrArray *records);
+
+typedef struct LVMReportSection {
+    const gchar *name;
+    const LVMReportField *fields;
+    guint n_required;
+    gsize data_size;
+    GDestroyNotify free_func;
+    GPtrArray *records;         /* filled in by the parser */
+    LVMReportArena *arena;      /* records allocated in the arena if not %NULL */
+} LVMReportSection;
+
+void lvm_report_set_field (gpointer data, const LVMReportField *field, const gchar *value, LVMReportArena *arena);
+gchar* lvm_report_fields_str (const LVMReportField *fields, guint64 mask, guint *n_fields);
+
+GPtrArray* lvm_json_report_parse (gchar *report, const gchar *section, const LVMReportField *fields,
+                                  guint n_required, gsize data_size, GDestroyNotify free_func,
+                                  LVMReportArena *arena, GError **error);
+gboolean lvm_json_report_parse_sections (gchar *report, LVMReportSection *sections, GError **error);
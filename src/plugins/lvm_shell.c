@@ -0,0 +1,742 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-unix.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <blockdev/utils.h>
+
+#include "lvm_shell.h"
+
+#define LVM_SHELL_PROMPT "lvm> "
+
+/* maximum number of 'lvm shell' processes running at the same time */
+#define LVM_SHELL_POOL_MAX 4
+
+/* 'lvm shell' splits the command line into at most 64 words */
+#define LVM_SHELL_MAX_ARGS 64
+
+/* return code of a successfully processed LVM command (ECMD_PROCESSED) */
+#define LVM_ECMD_PROCESSED 1
+
+/* how long to wait for an idle shell to exit after closing its stdin (in microseconds) */
+#define LVM_SHELL_EXIT_TIMEOUT (1000 * 1000)
+
+/* how long a command may run without any output before the shell is
+   considered stuck and killed (in microseconds) */
+#define LVM_SHELL_IDLE_TIMEOUT (300 * G_USEC_PER_SEC)
+
+#define LVM_SHELL_BUF_SIZE 64*1024
+
+/* makes LVM print the command's return code as a (one-column) log report
+   right after the command's own report */
+#define LVM_SHELL_LOG_CONFIG "log {report_command_log=1 command_log_selection=\"log_type=status\" command_log_cols=\"log_ret_code\"}"
+#define LVM_SHELL_RET_CODE_PREFIX "LVM2_LOG_RET_CODE="
+#define LVM_SHELL_RET_CODE_HEADING "RetCode"
+#define LVM_SHELL_RET_CODE_JSON_KEY "\"log_ret_code\""
+
+typedef struct LVMShell {
+    GPid pid;
+    gint in_fd;
+    gint out_fd;
+    gint err_fd;
+    gint report_fd;
+} LVMShell;
+
+static GMutex pool_lock;
+static GCond pool_cond;
+static gboolean pool_enabled = FALSE;
+static gboolean shell_unsupported = FALSE;
+static GSList *idle_shells = NULL;
+static guint num_shells = 0;
+
+static gboolean shell_read_reply (LVMShell *shell, GString *report, GString *errors,
+                                  GCancellable *cancellable, gint64 deadline, GError **error);
+static gboolean shell_write (LVMShell *shell, const gchar *data);
+static gboolean pop_ret_code (GString *report, gint *ret_code);
+
+static void shell_child_setup (gpointer user_data) {
+    gint fd = GPOINTER_TO_INT (user_data);
+
+    /* GLib marks all the descriptors above stderr as close-on-exec, but the
+       report pipe needs to survive the exec */
+    fcntl (fd, F_SETFD, 0);
+}
+
+static void shell_free (LVMShell *shell) {
+    gint status = 0;
+    gint64 deadline = 0;
+
+    if (!shell)
+        return;
+
+    /* EOF on stdin makes the shell exit */
+    close (shell->in_fd);
+    close (shell->out_fd);
+    close (shell->err_fd);
+    close (shell->report_fd);
+
+    deadline = g_get_monotonic_time () + LVM_SHELL_EXIT_TIMEOUT;
+    while (waitpid (shell->pid, &status, WNOHANG) == 0) {
+        if (g_get_monotonic_time () > deadline) {
+            kill (shell->pid, SIGKILL);
+            waitpid (shell->pid, &status, 0);
+            break;
+        }
+        g_usleep (10 * 1000);
+    }
+    g_spawn_close_pid (shell->pid);
+
+    g_free (shell);
+}
+
+static LVMShell* shell_new (GError **error) {
+    LVMShell *shell = NULL;
+    const gchar *argv[2] = {"lvm", NULL};
+    gchar **env = NULL;
+    gchar *fd_str = NULL;
+    gint report_pipe[2] = {-1, -1};
+    GString *report = NULL;
+    gint ret_code = 0;
+    gboolean success = FALSE;
+    GCancellable *cancellable = NULL;
+    gint64 deadline = 0;
+
+    cancellable = bd_utils_get_thread_cancellable (&deadline);
+
+    if (!g_unix_open_pipe (report_pipe, FD_CLOEXEC, error)) {
+        g_prefix_error (error, "Failed to create the report pipe for lvm shell: ");
+        return NULL;
+    }
+
+    fd_str = g_strdup_printf ("%d", report_pipe[1]);
+    env = g_get_environ ();
+    env = g_environ_setenv (env, "LC_ALL", "C", TRUE);
+    env = g_environ_setenv (env, "LVM_REPORT_FD", fd_str, TRUE);
+    env = g_environ_setenv (env, "LVM_SUPPRESS_FD_WARNINGS", "1", TRUE);
+    g_free (fd_str);
+
+    shell = g_new0 (LVMShell, 1);
+    success = g_spawn_async_with_pipes (NULL, (gchar **) argv, env, G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
+                                        shell_child_setup, GINT_TO_POINTER (report_pipe[1]), &(shell->pid),
+                                        &(shell->in_fd), &(shell->out_fd), &(shell->err_fd), error);
+    g_strfreev (env);
+    close (report_pipe[1]);
+    if (!success) {
+        g_prefix_error (error, "Failed to start lvm shell: ");
+        close (report_pipe[0]);
+        g_free (shell);
+        return NULL;
+    }
+    shell->report_fd = report_pipe[0];
+
+    if (!g_unix_set_fd_nonblocking (shell->out_fd, TRUE, NULL) ||
+        !g_unix_set_fd_nonblocking (shell->err_fd, TRUE, NULL) ||
+        !g_unix_set_fd_nonblocking (shell->report_fd, TRUE, NULL)) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Failed to set up pipes for lvm shell: %m");
+        shell_free (shell);
+        return NULL;
+    }
+
+    /* wait for the first prompt */
+    if (!shell_read_reply (shell, NULL, NULL, cancellable, deadline, error)) {
+        shell_free (shell);
+        return NULL;
+    }
+
+    /* make sure this version of LVM reports the return codes the way we
+       expect, otherwise there's no way to tell failures from successes */
+    if (!shell_write (shell, "version '--config=" LVM_SHELL_LOG_CONFIG "'\n")) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Failed to write to lvm shell: %m");
+        shell_free (shell);
+        return NULL;
+    }
+    report = g_string_new (NULL);
+    if (!shell_read_reply (shell, report, NULL, cancellable, deadline, error)) {
+        g_string_free (report, TRUE);
+        shell_free (shell);
+        return NULL;
+    }
+    if (!pop_ret_code (report, &ret_code) || ret_code != LVM_ECMD_PROCESSED) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_UTIL_FEATURE_UNAVAILABLE,
+                     "lvm shell doesn't report command return codes");
+        g_mutex_lock (&pool_lock);
+        shell_unsupported = TRUE;
+        g_mutex_unlock (&pool_lock);
+        g_string_free (report, TRUE);
+        shell_free (shell);
+        return NULL;
+    }
+    g_string_free (report, TRUE);
+
+    return shell;
+}
+
+static gboolean shell_write (LVMShell *shell, const gchar *data) {
+    sigset_t pipe_set;
+    sigset_t old_set;
+    struct timespec no_wait = {0, 0};
+    gsize len = strlen (data);
+    gsize written = 0;
+    ssize_t ret = 0;
+    gint errno_saved = 0;
+
+    /* a dead shell would kill us with SIGPIPE, block it while writing */
+    sigemptyset (&pipe_set);
+    sigaddset (&pipe_set, SIGPIPE);
+    pthread_sigmask (SIG_BLOCK, &pipe_set, &old_set);
+
+    while (written < len) {
+        ret = write (shell->in_fd, data + written, len - written);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            errno_saved = errno;
+            break;
+        }
+        written += ret;
+    }
+
+    /* consume the pending SIGPIPE (if any) so that it's not delivered once unblocked */
+    if (errno_saved == EPIPE && !sigismember (&old_set, SIGPIPE))
+        while (sigtimedwait (&pipe_set, NULL, &no_wait) < 0 && errno == EINTR);
+
+    pthread_sigmask (SIG_SETMASK, &old_set, NULL);
+
+    errno = errno_saved;
+    return written == len;
+}
+
+/* reads all data available on @fd, returns -1 for errors, 0 for EOF and 1 otherwise */
+static gint read_available (gint fd, GString *buf) {
+    gchar data[LVM_SHELL_BUF_SIZE];
+    ssize_t num_read = 0;
+
+    while ((num_read = read (fd, data, LVM_SHELL_BUF_SIZE)) != 0) {
+        if (num_read < 0) {
+            if (errno == EINTR)
+                continue;
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 1 : -1;
+        }
+        if (buf)
+            g_string_append_len (buf, data, num_read);
+    }
+
+    return 0;
+}
+
+/**
+ * shell_read_reply: (skip)
+ *
+ * Reads everything the shell outputs until it prints the prompt again. Report
+ * data (written to the LVM_REPORT_FD pipe) are stored in @report and error
+ * output in @errors, both can be %NULL if not interesting. The rest of the
+ * standard output is thrown away.
+ *
+ * Gives up if @cancellable is cancelled, @deadline (if not 0) is reached or if
+ * the shell doesn't output anything for %LVM_SHELL_IDLE_TIMEOUT. The shell is
+ * in an unknown state then and must not be used anymore.
+ */
+static gboolean shell_read_reply (LVMShell *shell, GString *report, GString *errors,
+                                  GCancellable *cancellable, gint64 deadline, GError **error) {
+    struct pollfd fds[4];
+    GString *bufs[3];
+    GString *out = g_string_new (NULL);
+    gboolean done = FALSE;
+    gint64 now = 0;
+    gint64 idle_deadline = 0;
+    gint64 wake_time = 0;
+    gint timeout = 0;
+    gint ret = 0;
+    guint i = 0;
+
+    fds[0].fd = shell->out_fd;
+    fds[1].fd = shell->err_fd;
+    fds[2].fd = shell->report_fd;
+    fds[3].fd = cancellable ? g_cancellable_get_fd (cancellable) : -1;
+    bufs[0] = out;
+    bufs[1] = errors;
+    bufs[2] = report;
+    for (i=0; i < 4; i++) {
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+
+    idle_deadline = g_get_monotonic_time () + LVM_SHELL_IDLE_TIMEOUT;
+    while (!done) {
+        if (g_cancellable_set_error_if_cancelled (cancellable, error))
+            break;
+
+        now = g_get_monotonic_time ();
+        wake_time = (deadline > 0) ? MIN (deadline, idle_deadline) : idle_deadline;
+        if (now >= wake_time) {
+            if (deadline > 0 && now >= deadline)
+                g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_TIMED_OUT,
+                             "Process didn't finish in time");
+            else
+                g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_TIMED_OUT,
+                             "lvm shell didn't respond in %d seconds",
+                             (gint) (LVM_SHELL_IDLE_TIMEOUT / G_USEC_PER_SEC));
+            break;
+        }
+        /* round up so that we don't wake up right before the deadline */
+        timeout = (gint) MIN ((wake_time - now + 999) / 1000, G_MAXINT);
+
+        ret = poll (fds, 4, timeout);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Failed to poll lvm shell output: %m");
+            break;
+        } else if (ret == 0)
+            continue;
+
+        for (i=0; i < 3; i++) {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            idle_deadline = g_get_monotonic_time () + LVM_SHELL_IDLE_TIMEOUT;
+            ret = read_available (fds[i].fd, bufs[i]);
+            if (ret < 0) {
+                g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                             "Error reading from lvm shell: %m");
+                break;
+            } else if (ret == 0) {
+                if (i == 0) {
+                    g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                                 "lvm shell exited unexpectedly%s%s", errors ? ": " : "",
+                                 errors ? errors->str : "");
+                    break;
+                }
+                /* ignore the descriptor from now on */
+                fds[i].fd = -1;
+            }
+        }
+        if (i < 3)
+            /* error set above */
+            break;
+
+        /* only keep the tail, the rest of the standard output is not interesting */
+        if (out->len > strlen (LVM_SHELL_PROMPT))
+            g_string_erase (out, 0, out->len - strlen (LVM_SHELL_PROMPT));
+        done = g_str_has_suffix (out->str, LVM_SHELL_PROMPT);
+    }
+    g_string_free (out, TRUE);
+    if (cancellable)
+        g_cancellable_release_fd (cancellable);
+
+    if (!done)
+        return FALSE;
+
+    /* everything the command printed is written before the prompt */
+    if (fds[1].fd >= 0)
+        read_available (fds[1].fd, errors);
+    if (fds[2].fd >= 0)
+        read_available (fds[2].fd, report);
+
+    return TRUE;
+}
+
+/**
+ * get_json_ret_code: (skip)
+ *
+ * Extracts the return code from the "log" section of a JSON report. The report
+ * itself is left untouched, the "log" section is ignored by the JSON parser.
+ */
+static gboolean get_json_ret_code (const gchar *report, gint *ret_code) {
+    const gchar *key = NULL;
+    const gchar *next = NULL;
+    gchar *endptr = NULL;
+
+    /* the status record is the last one in the log */
+    for (next=strstr (report, LVM_SHELL_RET_CODE_JSON_KEY); next; next=strstr (key + 1, LVM_SHELL_RET_CODE_JSON_KEY))
+        key = next;
+    if (!key)
+        return FALSE;
+
+    key += strlen (LVM_SHELL_RET_CODE_JSON_KEY);
+    while (*key == ' ' || *key == ':' || *key == '"')
+        key++;
+
+    *ret_code = (gint) g_ascii_strtoll (key, &endptr, 10);
+    return endptr != key;
+}
+
+/**
+ * pop_ret_code: (skip)
+ *
+ * Extracts the return code from the log report at the end of @report and
+ * removes the log report from @report.
+ */
+static gboolean pop_ret_code (GString *report, gint *ret_code) {
+    gchar *line = NULL;
+    gchar *val = NULL;
+    gchar *endptr = NULL;
+    gsize line_start = 0;
+
+    while (report->len > 0 && g_ascii_isspace (report->str[report->len - 1]))
+        g_string_truncate (report, report->len - 1);
+    if (report->len == 0)
+        return FALSE;
+
+    /* with '--reportformat json' the log is a part of the JSON object */
+    if (report->str[report->len - 1] == '}') {
+        g_string_append_c (report, '\n');
+        return get_json_ret_code (report->str, ret_code);
+    }
+
+    line = strrchr (report->str, '\n');
+    line_start = line ? (gsize) (line - report->str) + 1 : 0;
+    val = g_strstrip (g_strdup (report->str + line_start));
+    if (g_str_has_prefix (val, LVM_SHELL_RET_CODE_PREFIX))
+        memmove (val, val + strlen (LVM_SHELL_RET_CODE_PREFIX), strlen (val) - strlen (LVM_SHELL_RET_CODE_PREFIX) + 1);
+    g_strdelimit (val, "'\"", ' ');
+    g_strstrip (val);
+
+    *ret_code = (gint) g_ascii_strtoll (val, &endptr, 10);
+    if (*val == '\0' || !endptr || *endptr != '\0') {
+        g_free (val);
+        return FALSE;
+    }
+    g_free (val);
+
+    g_string_truncate (report, line_start);
+    while (report->len > 0 && g_ascii_isspace (report->str[report->len - 1]))
+        g_string_truncate (report, report->len - 1);
+
+    /* the log report may have a heading line */
+    line = strrchr (report->str, '\n');
+    line_start = line ? (gsize) (line - report->str) + 1 : 0;
+    val = g_strstrip (g_strdup (report->str + line_start));
+    if (g_strcmp0 (val, LVM_SHELL_RET_CODE_HEADING) == 0)
+        g_string_truncate (report, line_start);
+    g_free (val);
+
+    if (report->len > 0 && report->str[report->len - 1] != '\n')
+        g_string_append_c (report, '\n');
+
+    return TRUE;
+}
+
+/* whether @argv contains the '-y'/'--yes' option */
+static gboolean has_yes_arg (GPtrArray *argv) {
+    const gchar *arg = NULL;
+    guint i = 0;
+
+    for (i=0; i < argv->len; i++) {
+        arg = g_ptr_array_index (argv, i);
+        if (g_strcmp0 (arg, "-y") == 0 || g_strcmp0 (arg, "--yes") == 0)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* returns %NULL if @arg cannot be passed through 'lvm shell' */
+static gchar* quote_arg (const gchar *arg) {
+    if (strchr (arg, '\n'))
+        return NULL;
+    if (*arg != '\0' && !strpbrk (arg, " \t\v\f\r'\"#"))
+        return g_strdup (arg);
+    /* 'lvm shell' supports quoting (but no escaping) */
+    if (!strchr (arg, '\''))
+        return g_strdup_printf ("'%s'", arg);
+    if (!strchr (arg, '"'))
+        return g_strdup_printf ("\"%s\"", arg);
+    return NULL;
+}
+
+static LVMShell* pool_acquire (void) {
+    LVMShell *shell = NULL;
+    GError *l_error = NULL;
+
+    g_mutex_lock (&pool_lock);
+    while (pool_enabled && !shell_unsupported && !idle_shells && num_shells >= LVM_SHELL_POOL_MAX)
+        g_cond_wait (&pool_cond, &pool_lock);
+
+    if (!pool_enabled || shell_unsupported) {
+        g_mutex_unlock (&pool_lock);
+        return NULL;
+    }
+
+    if (idle_shells) {
+        shell = idle_shells->data;
+        idle_shells = g_slist_delete_link (idle_shells, idle_shells);
+        g_mutex_unlock (&pool_lock);
+        return shell;
+    }
+
+    /* reserve a slot for the new shell */
+    num_shells++;
+    g_mutex_unlock (&pool_lock);
+
+    shell = shell_new (&l_error);
+    if (!shell) {
+        bd_utils_log_format (BD_UTILS_LOG_WARNING, "Cannot use lvm shell, running lvm directly: %s",
+                             l_error->message);
+        g_clear_error (&l_error);
+        g_mutex_lock (&pool_lock);
+        num_shells--;
+        g_cond_signal (&pool_cond);
+        g_mutex_unlock (&pool_lock);
+    }
+
+    return shell;
+}
+
+static void pool_release (LVMShell *shell, gboolean reuse) {
+    g_mutex_lock (&pool_lock);
+    if (reuse && pool_enabled) {
+        idle_shells = g_slist_prepend (idle_shells, shell);
+        shell = NULL;
+    } else
+        num_shells--;
+    g_cond_signal (&pool_cond);
+    g_mutex_unlock (&pool_lock);
+
+    /* broken or not wanted anymore */
+    shell_free (shell);
+}
+
+/**
+ * lvm_shell_set_enabled: (skip)
+ *
+ * Enables or disables running LVM commands in persistent 'lvm shell'
+ * processes. Disabling terminates all idle shells, busy shells are terminated
+ * once they finish their current command.
+ */
+void __attribute__ ((visibility ("hidden")))
+lvm_shell_set_enabled (gboolean enabled) {
+    GSList *to_free = NULL;
+
+    g_mutex_lock (&pool_lock);
+    pool_enabled = enabled;
+    if (enabled)
+        /* give it another try (LVM may have been updated in the meantime) */
+        shell_unsupported = FALSE;
+    else {
+        to_free = idle_shells;
+        idle_shells = NULL;
+        num_shells -= g_slist_length (to_free);
+    }
+    g_cond_broadcast (&pool_cond);
+    g_mutex_unlock (&pool_lock);
+
+    g_slist_free_full (to_free, (GDestroyNotify) shell_free);
+}
+
+gboolean __attribute__ ((visibility ("hidden")))
+lvm_shell_get_enabled (void) {
+    gboolean ret = FALSE;
+
+    g_mutex_lock (&pool_lock);
+    ret = pool_enabled;
+    g_mutex_unlock (&pool_lock);
+
+    return ret;
+}
+
+/**
+ * lvm_shell_run: (skip)
+ * @args: (array zero-terminated=1): LVM command and its arguments (without "lvm")
+ * @extra: (allow-none) (array zero-terminated=1): extra arguments
+ * @config: (allow-none): LVM config string to pass to the command
+ * @output: (out) (allow-none): place to store the report output of the command
+ * @error: (out): place to store error (if any)
+ *
+ * Runs the LVM command in one of the persistent 'lvm shell' processes. The
+ * errors reported mimic the ones from bd_utils_exec_and_report_error() and
+ * bd_utils_exec_and_capture_output() so that the callers don't need to
+ * distinguish between the two ways of running LVM commands.
+ *
+ * Returns: %LVM_SHELL_UNAVAILABLE if the command wasn't run because the
+ *          persistent shell is disabled or cannot be used (the caller should
+ *          spawn lvm itself), %LVM_SHELL_OK on success and %LVM_SHELL_FAILED
+ *          (with @error set) on failure
+ */
+LVMShellStatus __attribute__ ((visibility ("hidden")))
+lvm_shell_run (const gchar **args, const BDExtraArg **extra, const gchar *config, gchar **output, GError **error) {
+    GPtrArray *argv = NULL;
+    gchar **quoted = NULL;
+    gchar *config_arg = NULL;
+    gchar *cmd_line = NULL;
+    gchar *args_str = NULL;
+    gchar *msg = NULL;
+    const gchar **arg_p = NULL;
+    const BDExtraArg **extra_p = NULL;
+    LVMShell *shell = NULL;
+    GString *report = NULL;
+    GString *errors = NULL;
+    GError *l_error = NULL;
+    GCancellable *cancellable = NULL;
+    gint64 deadline = 0;
+    guint64 task_id = 0;
+    guint64 progress_id = 0;
+    gint ret_code = 0;
+    gint status = 0;
+    guint attempt = 0;
+    guint i = 0;
+
+    if (!lvm_shell_get_enabled ())
+        return LVM_SHELL_UNAVAILABLE;
+
+    /* the thread's settings apply to the commands run in the shell too */
+    cancellable = bd_utils_get_thread_cancellable (&deadline);
+    if (g_cancellable_set_error_if_cancelled (cancellable, error))
+        return LVM_SHELL_FAILED;
+
+    config_arg = g_strdup_printf ("--config=%s %s", config ? config : "", LVM_SHELL_LOG_CONFIG);
+    argv = g_ptr_array_new ();
+    for (arg_p=args; *arg_p; arg_p++)
+        g_ptr_array_add (argv, (gpointer) *arg_p);
+    for (extra_p=extra; extra_p && *extra_p; extra_p++) {
+        if ((*extra_p)->opt && (g_strcmp0 ((*extra_p)->opt, "") != 0))
+            g_ptr_array_add (argv, (*extra_p)->opt);
+        if ((*extra_p)->val && (g_strcmp0 ((*extra_p)->val, "") != 0))
+            g_ptr_array_add (argv, (*extra_p)->val);
+    }
+    /* the shell's stdin is the pipe we send the commands through, make LVM
+       answer all prompts with 'no' instead of waiting for an answer (the same
+       as when lvm is run directly with stdin connected to /dev/null) unless
+       the prompts are already answered with 'yes' ('-qq' and '-y' cannot be
+       combined) */
+    if (!has_yes_arg (argv))
+        g_ptr_array_add (argv, "-qq");
+    g_ptr_array_add (argv, config_arg);
+    g_ptr_array_add (argv, NULL);
+
+    if (argv->len > LVM_SHELL_MAX_ARGS) {
+        g_ptr_array_free (argv, TRUE);
+        g_free (config_arg);
+        return LVM_SHELL_UNAVAILABLE;
+    }
+
+    quoted = g_new0 (gchar*, argv->len);
+    for (i=0; i < argv->len - 1; i++) {
+        quoted[i] = quote_arg (g_ptr_array_index (argv, i));
+        if (!quoted[i]) {
+            bd_utils_log_format (BD_UTILS_LOG_DEBUG, "Cannot pass '%s' to lvm shell, running lvm directly",
+                                 (gchar *) g_ptr_array_index (argv, i));
+            g_strfreev (quoted);
+            g_ptr_array_free (argv, TRUE);
+            g_free (config_arg);
+            return LVM_SHELL_UNAVAILABLE;
+        }
+    }
+    cmd_line = g_strjoinv (" ", quoted);
+    g_strfreev (quoted);
+    args_str = g_strjoinv (" ", (gchar **) argv->pdata);
+    g_ptr_array_free (argv, TRUE);
+    g_free (config_arg);
+
+    /* a shell that died while idle is only detected when writing to it, in
+       which case the command was not run and it's safe to try again with a
+       new one */
+    for (attempt=0; attempt < 2 && !shell; attempt++) {
+        shell = pool_acquire ();
+        if (!shell)
+            break;
+        if (!shell_write (shell, cmd_line) || !shell_write (shell, "\n")) {
+            bd_utils_log_format (BD_UTILS_LOG_INFO, "lvm shell [%d] died, restarting it", shell->pid);
+            pool_release (shell, FALSE);
+            shell = NULL;
+        }
+    }
+    g_free (cmd_line);
+    if (!shell) {
+        g_free (args_str);
+        return LVM_SHELL_UNAVAILABLE;
+    }
+
+    task_id = bd_utils_get_next_task_id ();
+    bd_utils_log_format (BD_UTILS_LOG_INFO, "Running [%"G_GUINT64_FORMAT"] lvm %s (in lvm shell [%d]) ...",
+                         task_id, args_str, shell->pid);
+    msg = g_strdup_printf ("Started 'lvm %s'", args_str);
+    progress_id = bd_utils_report_started (msg);
+    g_free (msg);
+    g_free (args_str);
+
+    report = g_string_new (NULL);
+    errors = g_string_new (NULL);
+    if (!shell_read_reply (shell, report, errors, cancellable, deadline, &l_error)) {
+        /* the command may or may not have been run, nothing to retry here, the
+           next command will get a new shell (this one may still be running the
+           command so stop it the same way as a directly run process) */
+        kill (shell->pid, SIGTERM);
+        pool_release (shell, FALSE);
+        bd_utils_report_finished (progress_id, l_error->message);
+        g_propagate_error (error, l_error);
+        g_string_free (report, TRUE);
+        g_string_free (errors, TRUE);
+        return LVM_SHELL_FAILED;
+    }
+
+    if (!pop_ret_code (report, &ret_code)) {
+        /* we can no longer be sure what the shell is doing */
+        pool_release (shell, FALSE);
+        g_set_error (&l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Failed to get the command's return code from lvm shell: %s", errors->str);
+        bd_utils_report_finished (progress_id, l_error->message);
+        g_propagate_error (error, l_error);
+        g_string_free (report, TRUE);
+        g_string_free (errors, TRUE);
+        return LVM_SHELL_FAILED;
+    }
+    pool_release (shell, TRUE);
+
+    /* lvm exits with 0 for processed commands and with the return code otherwise */
+    status = (ret_code == LVM_ECMD_PROCESSED) ? 0 : ret_code;
+
+    bd_utils_log_format (BD_UTILS_LOG_INFO, "stdout[%"G_GUINT64_FORMAT"]: %s", task_id, report->str);
+    bd_utils_log_format (BD_UTILS_LOG_INFO, "stderr[%"G_GUINT64_FORMAT"]: %s", task_id, errors->str);
+    bd_utils_log_format (BD_UTILS_LOG_INFO, "...done [%"G_GUINT64_FORMAT"] (exit code: %d)", task_id, status);
+
+    if (status != 0)
+        g_set_error (&l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Process reported exit code %d: %s%s", status, report->str, errors->str);
+    else if (output && report->len == 0)
+        g_set_error (&l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_NOOUT,
+                     "Process didn't provide any data on standard output. "
+                     "Error output: %s", errors->str);
+
+    g_string_free (errors, TRUE);
+    if (l_error) {
+        bd_utils_report_finished (progress_id, l_error->message);
+        g_propagate_error (error, l_error);
+        g_string_free (report, TRUE);
+        return LVM_SHELL_FAILED;
+    }
+
+    bd_utils_report_finished (progress_id, "Completed");
+    if (output)
+        *output = g_string_free (report, FALSE);
+    else
+        g_string_free (report, TRUE);
+
+    return LVM_SHELL_OK;
+}
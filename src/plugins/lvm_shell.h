@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2024 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <blockdev/utils.h>
+
+typedef enum {
+    LVM_SHELL_UNAVAILABLE,  /* command not run, caller should spawn lvm itself */
+    LVM_SHELL_OK,
+    LVM_SHELL_FAILED,       /* command run (or at least sent) and failed, error set */
+} LVMShellStatus;
+
+void lvm_shell_set_enabled (gboolean enabled);
+gboolean lvm_shell_get_enabled (void);
+
+LVMShellStatus lvm_shell_run (const gchar **args, const BDExtraArg **extra, const gchar *config, gchar **output, GError **error);
@@ -18,6 +18,10 @@
  */
 
 #include <glib.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 #include <parted/parted.h>
 #include <blockdev/utils.h>
 
@@ -173,3 +177,296 @@ GHashTable __attribute__ ((visibility ("hidden")))
 
     return stats;
 }
+
+
+/* names of the files in the statistics directory, indexed by VDOStat */
+static const gchar* const vdo_stat_files[VDO_STAT_LAST] = {
+    [VDO_STAT_BLOCK_SIZE] = "block_size",
+    [VDO_STAT_LOGICAL_BLOCK_SIZE] = "logical_block_size",
+    [VDO_STAT_PHYSICAL_BLOCKS] = "physical_blocks",
+    [VDO_STAT_DATA_BLOCKS_USED] = "data_blocks_used",
+    [VDO_STAT_OVERHEAD_BLOCKS_USED] = "overhead_blocks_used",
+    [VDO_STAT_LOGICAL_BLOCKS_USED] = "logical_blocks_used",
+    [VDO_STAT_BIOS_IN_WRITE] = "bios_in_write",
+    [VDO_STAT_BIOS_OUT_WRITE] = "bios_out_write",
+    [VDO_STAT_BIOS_META_WRITE] = "bios_meta_write",
+    [VDO_STAT_DEDUPE_ADVICE_VALID] = "hash_lock_dedupe_advice_valid",
+    [VDO_STAT_DEDUPE_ADVICE_STALE] = "hash_lock_dedupe_advice_stale",
+    [VDO_STAT_JOURNAL_BLOCKS_WRITTEN] = "journal_blocks_written",
+    [VDO_STAT_JOURNAL_BLOCKS_COMMITTED] = "journal_blocks_committed",
+};
+
+/* the statistics files of a VDO, opened only once and then just re-read */
+typedef struct VDOStatsReader {
+    int fds[VDO_STAT_LAST];
+} VDOStatsReader;
+
+/* VDO name -> VDOStatsReader */
+static GHashTable *stats_readers = NULL;
+static GMutex stats_readers_lock;
+
+static void vdo_stats_reader_free (VDOStatsReader *reader) {
+    for (guint i = 0; i < VDO_STAT_LAST; i++)
+        if (reader->fds[i] >= 0)
+            close (reader->fds[i]);
+    g_free (reader);
+}
+
+static VDOStatsReader* vdo_stats_reader_new (const gchar *name, GError **error) {
+    VDOStatsReader *reader = NULL;
+    gchar *stats_dir = NULL;
+    gchar *path = NULL;
+
+    stats_dir = g_build_path (G_DIR_SEPARATOR_S, VDO_SYS_PATH, name, "statistics", NULL);
+    if (!g_file_test (stats_dir, G_FILE_TEST_IS_DIR)) {
+        g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT,
+                     "Error reading statistics from %s: No such directory", stats_dir);
+        g_free (stats_dir);
+        return NULL;
+    }
+
+    reader = g_new0 (VDOStatsReader, 1);
+    for (guint i = 0; i < VDO_STAT_LAST; i++) {
+        path = g_build_filename (stats_dir, vdo_stat_files[i], NULL);
+        /* not all statistics are available with all kvdo versions, missing
+           ones are just reported as -1 */
+        reader->fds[i] = open (path, O_RDONLY | O_CLOEXEC);
+        g_free (path);
+    }
+    g_free (stats_dir);
+
+    return reader;
+}
+
+static gboolean vdo_stats_reader_read (VDOStatsReader *reader, const gchar *name, guint64 mask, gint64 *values, GError **error) {
+    gchar buf[32];
+    gchar *endptr = NULL;
+    ssize_t len = 0;
+
+    for (guint i = 0; i < VDO_STAT_LAST; i++) {
+        if (!(mask & VDO_STAT_MASK (i)))
+            continue;
+
+        values[i] = -1;
+        if (reader->fds[i] < 0)
+            continue;
+
+        /* sysfs attributes are regenerated on every read from the offset 0 */
+        len = pread (reader->fds[i], buf, sizeof (buf) - 1, 0);
+        if (len < 0) {
+            g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno),
+                         "Error reading statistic '%s' of %s: %s", vdo_stat_files[i], name, g_strerror (errno));
+            return FALSE;
+        }
+        buf[len] = '\0';
+
+        values[i] = g_ascii_strtoll (g_strstrip (buf), &endptr, 0);
+        if (endptr == NULL || *endptr != '\0')
+            values[i] = -1;
+    }
+
+    return TRUE;
+}
+
+/**
+ * vdo_stats_read: (skip)
+ * @name: name of the VDO (kvdo device name)
+ * @mask: bit mask of the statistics to read (see VDO_STAT_MASK())
+ * @values: (array fixed-size=VDO_STAT_LAST): place to store the values to
+ *
+ * Reads the statistics selected by @mask into @values, statistics not
+ * available are set to -1. The statistics files are kept open between the
+ * calls so every call only costs one pread() per statistic.
+ */
+gboolean __attribute__ ((visibility ("hidden")))
+vdo_stats_read (const gchar *name, guint64 mask, gint64 *values, GError **error) {
+    VDOStatsReader *reader = NULL;
+    gboolean new_reader = FALSE;
+    gboolean ret = FALSE;
+
+    g_mutex_lock (&stats_readers_lock);
+    if (!stats_readers)
+        stats_readers = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) vdo_stats_reader_free);
+
+    reader = g_hash_table_lookup (stats_readers, name);
+    if (!reader) {
+        reader = vdo_stats_reader_new (name, error);
+        if (!reader) {
+            g_mutex_unlock (&stats_readers_lock);
+            return FALSE;
+        }
+        g_hash_table_insert (stats_readers, g_strdup (name), reader);
+        new_reader = TRUE;
+    }
+
+    ret = vdo_stats_reader_read (reader, name, mask, values, new_reader ? error : NULL);
+    if (!ret) {
+        g_hash_table_remove (stats_readers, name);
+        if (!new_reader) {
+            /* the VDO may have been stopped and started again since the
+               files were opened, try once more with freshly opened files */
+            reader = vdo_stats_reader_new (name, error);
+            if (reader) {
+                g_hash_table_insert (stats_readers, g_strdup (name), reader);
+                ret = vdo_stats_reader_read (reader, name, mask, values, error);
+                if (!ret)
+                    g_hash_table_remove (stats_readers, name);
+            }
+        }
+    }
+    g_mutex_unlock (&stats_readers_lock);
+
+    return ret;
+}
+
+/**
+ * vdo_stats_close_all: (skip)
+ *
+ * Closes all the statistics files kept open by vdo_stats_read().
+ */
+void __attribute__ ((visibility ("hidden")))
+vdo_stats_close_all (void) {
+    g_mutex_lock (&stats_readers_lock);
+    if (stats_readers) {
+        g_hash_table_destroy (stats_readers);
+        stats_readers = NULL;
+    }
+    g_mutex_unlock (&stats_readers_lock);
+}
+
+/**
+ * vdo_stats_get: (skip)
+ * @name: name of the VDO (kvdo device name)
+ *
+ * Implementation of bd_lvm_vdo_get_stats() shared by the LVM plugins.
+ */
+BDLVMVDOStats __attribute__ ((visibility ("hidden")))
+*vdo_stats_get (const gchar *name, GError **error) {
+    gint64 values[VDO_STAT_LAST];
+    BDLVMVDOStats *stats = NULL;
+    gint64 used_blocks = 0;
+
+    if (!vdo_stats_read (name,
+                         VDO_STAT_MASK (VDO_STAT_BLOCK_SIZE) | VDO_STAT_MASK (VDO_STAT_LOGICAL_BLOCK_SIZE) |
+                         VDO_STAT_MASK (VDO_STAT_PHYSICAL_BLOCKS) | VDO_STAT_MASK (VDO_STAT_DATA_BLOCKS_USED) |
+                         VDO_STAT_MASK (VDO_STAT_OVERHEAD_BLOCKS_USED) | VDO_STAT_MASK (VDO_STAT_LOGICAL_BLOCKS_USED) |
+                         VDO_STAT_MASK (VDO_STAT_BIOS_IN_WRITE) | VDO_STAT_MASK (VDO_STAT_BIOS_OUT_WRITE) |
+                         VDO_STAT_MASK (VDO_STAT_BIOS_META_WRITE),
+                         values, error))
+        return NULL;
+
+    stats = g_new0 (BDLVMVDOStats, 1);
+    stats->block_size = values[VDO_STAT_BLOCK_SIZE];
+    stats->logical_block_size = values[VDO_STAT_LOGICAL_BLOCK_SIZE];
+    stats->physical_blocks = values[VDO_STAT_PHYSICAL_BLOCKS];
+    stats->data_blocks_used = values[VDO_STAT_DATA_BLOCKS_USED];
+    stats->overhead_blocks_used = values[VDO_STAT_OVERHEAD_BLOCKS_USED];
+    stats->logical_blocks_used = values[VDO_STAT_LOGICAL_BLOCKS_USED];
+    stats->used_percent = -1;
+    stats->saving_percent = -1;
+    stats->write_amplification_ratio = -1;
+
+    /* computed the same way vdo_get_stats_full() does it */
+    if (stats->physical_blocks > 0 && stats->data_blocks_used >= 0 && stats->overhead_blocks_used >= 0 &&
+        stats->logical_blocks_used >= 0 && stats->block_size >= 0) {
+        used_blocks = stats->data_blocks_used + stats->overhead_blocks_used;
+        stats->used_percent = (gint64) rint (100.0 * (gfloat) used_blocks / (gfloat) stats->physical_blocks + 0.5);
+        if (stats->logical_blocks_used > 0)
+            stats->saving_percent = (gint64) (100.0 * (gfloat) (stats->logical_blocks_used - stats->data_blocks_used) /
+                                              (gfloat) stats->logical_blocks_used);
+        if (stats->saving_percent < 0)
+            stats->saving_percent = -1;
+    }
+
+    if (values[VDO_STAT_BIOS_IN_WRITE] >= 0 && values[VDO_STAT_BIOS_OUT_WRITE] >= 0 && values[VDO_STAT_BIOS_META_WRITE] >= 0) {
+        if (values[VDO_STAT_BIOS_IN_WRITE] == 0)
+            stats->write_amplification_ratio = 0;
+        else
+            stats->write_amplification_ratio = rint (100.0 * (gfloat) (values[VDO_STAT_BIOS_META_WRITE] + values[VDO_STAT_BIOS_OUT_WRITE]) /
+                                                     (gfloat) values[VDO_STAT_BIOS_IN_WRITE]) / 100.0;
+    }
+
+    return stats;
+}
+
+/**
+ * vdo_stats_get_counters: (skip)
+ * @name: name of the VDO (kvdo device name)
+ *
+ * Implementation of bd_lvm_vdo_get_counters() shared by the LVM plugins.
+ */
+BDLVMVDOCounters __attribute__ ((visibility ("hidden")))
+*vdo_stats_get_counters (const gchar *name, GError **error) {
+    gint64 values[VDO_STAT_LAST];
+    BDLVMVDOCounters *counters = NULL;
+
+    if (!vdo_stats_read (name,
+                         VDO_STAT_MASK (VDO_STAT_BIOS_IN_WRITE) | VDO_STAT_MASK (VDO_STAT_BIOS_OUT_WRITE) |
+                         VDO_STAT_MASK (VDO_STAT_BIOS_META_WRITE) | VDO_STAT_MASK (VDO_STAT_DEDUPE_ADVICE_VALID) |
+                         VDO_STAT_MASK (VDO_STAT_DEDUPE_ADVICE_STALE) | VDO_STAT_MASK (VDO_STAT_JOURNAL_BLOCKS_WRITTEN) |
+                         VDO_STAT_MASK (VDO_STAT_JOURNAL_BLOCKS_COMMITTED) | VDO_STAT_MASK (VDO_STAT_DATA_BLOCKS_USED) |
+                         VDO_STAT_MASK (VDO_STAT_LOGICAL_BLOCKS_USED),
+                         values, error))
+        return NULL;
+
+    counters = g_new0 (BDLVMVDOCounters, 1);
+    counters->timestamp = g_get_monotonic_time ();
+    counters->bios_in_write = values[VDO_STAT_BIOS_IN_WRITE];
+    counters->bios_out_write = values[VDO_STAT_BIOS_OUT_WRITE];
+    counters->bios_meta_write = values[VDO_STAT_BIOS_META_WRITE];
+    counters->dedupe_advice_valid = values[VDO_STAT_DEDUPE_ADVICE_VALID];
+    counters->dedupe_advice_stale = values[VDO_STAT_DEDUPE_ADVICE_STALE];
+    counters->journal_blocks_written = values[VDO_STAT_JOURNAL_BLOCKS_WRITTEN];
+    counters->journal_blocks_committed = values[VDO_STAT_JOURNAL_BLOCKS_COMMITTED];
+    counters->data_blocks_used = values[VDO_STAT_DATA_BLOCKS_USED];
+    counters->logical_blocks_used = values[VDO_STAT_LOGICAL_BLOCKS_USED];
+
+    return counters;
+}
+
+/* per-second rate of the change of a counter, -1 if not available */
+static gdouble counter_rate (gint64 prev, gint64 cur, gdouble interval) {
+    if (prev < 0 || cur < 0 || cur < prev)
+        return -1;
+    return (cur - prev) / interval;
+}
+
+/**
+ * vdo_stats_get_rates: (skip)
+ *
+ * Implementation of bd_lvm_vdo_get_rates() shared by the LVM plugins.
+ */
+BDLVMVDORates __attribute__ ((visibility ("hidden")))
+*vdo_stats_get_rates (const BDLVMVDOCounters *prev, const BDLVMVDOCounters *cur, GError **error) {
+    BDLVMVDORates *rates = NULL;
+    gint64 in_writes = 0;
+    gint64 out_writes = 0;
+
+    if (cur->timestamp <= prev->timestamp) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "The current snapshot of the VDO counters has to be newer than the previous one");
+        return NULL;
+    }
+
+    rates = g_new0 (BDLVMVDORates, 1);
+    rates->interval = (gdouble) (cur->timestamp - prev->timestamp) / G_USEC_PER_SEC;
+    rates->write_rate = counter_rate (prev->bios_in_write, cur->bios_in_write, rates->interval);
+    rates->dedupe_advice_rate = counter_rate (prev->dedupe_advice_valid, cur->dedupe_advice_valid, rates->interval);
+    rates->stale_advice_rate = counter_rate (prev->dedupe_advice_stale, cur->dedupe_advice_stale, rates->interval);
+    rates->journal_blocks_rate = counter_rate (prev->journal_blocks_written, cur->journal_blocks_written, rates->interval);
+
+    rates->write_amplification_ratio = -1;
+    if (rates->write_rate >= 0 && counter_rate (prev->bios_out_write, cur->bios_out_write, 1) >= 0 &&
+        counter_rate (prev->bios_meta_write, cur->bios_meta_write, 1) >= 0) {
+        in_writes = cur->bios_in_write - prev->bios_in_write;
+        out_writes = (cur->bios_out_write - prev->bios_out_write) + (cur->bios_meta_write - prev->bios_meta_write);
+        rates->write_amplification_ratio = in_writes > 0 ? (gdouble) out_writes / in_writes : 0;
+    }
+
+    if (prev->data_blocks_used >= 0 && cur->data_blocks_used >= 0)
+        rates->data_blocks_used_delta = cur->data_blocks_used - prev->data_blocks_used;
+    if (prev->logical_blocks_used >= 0 && cur->logical_blocks_used >= 0)
+        rates->logical_blocks_used_delta = cur->logical_blocks_used - prev->logical_blocks_used;
+
+    return rates;
+}
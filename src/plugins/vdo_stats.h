@@ -19,8 +19,36 @@
 
 #include <glib.h>
 
+#include "lvm.h"
+
 gboolean get_stat_val_double (GHashTable *stats, const gchar *key, gdouble *val);
 gboolean get_stat_val64 (GHashTable *stats, const gchar *key, gint64 *val);
 gboolean get_stat_val64_default (GHashTable *stats, const gchar *key, gint64 *val, gint64 def);
 
 GHashTable* vdo_get_stats_full (const gchar *name, GError **error);
+
+typedef enum {
+    VDO_STAT_BLOCK_SIZE = 0,
+    VDO_STAT_LOGICAL_BLOCK_SIZE,
+    VDO_STAT_PHYSICAL_BLOCKS,
+    VDO_STAT_DATA_BLOCKS_USED,
+    VDO_STAT_OVERHEAD_BLOCKS_USED,
+    VDO_STAT_LOGICAL_BLOCKS_USED,
+    VDO_STAT_BIOS_IN_WRITE,
+    VDO_STAT_BIOS_OUT_WRITE,
+    VDO_STAT_BIOS_META_WRITE,
+    VDO_STAT_DEDUPE_ADVICE_VALID,
+    VDO_STAT_DEDUPE_ADVICE_STALE,
+    VDO_STAT_JOURNAL_BLOCKS_WRITTEN,
+    VDO_STAT_JOURNAL_BLOCKS_COMMITTED,
+    VDO_STAT_LAST,
+} VDOStat;
+
+#define VDO_STAT_MASK(stat) (1 << (stat))
+
+gboolean vdo_stats_read (const gchar *name, guint64 mask, gint64 *values, GError **error);
+void vdo_stats_close_all (void);
+
+BDLVMVDOStats* vdo_stats_get (const gchar *name, GError **error);
+BDLVMVDOCounters* vdo_stats_get_counters (const gchar *name, GError **error);
+BDLVMVDORates* vdo_stats_get_rates (const BDLVMVDOCounters *prev, const BDLVMVDOCounters *cur, GError **error);
@@ -673,6 +673,13 @@ def lvm_pvmove(src, dest=None, extra=None, **kwargs):
     return _lvm_pvmove(src, dest, extra)
 __all__.append("lvm_pvmove")
 
+_lvm_pvmove_with_rate = BlockDev.lvm_pvmove_with_rate
+@override(BlockDev.lvm_pvmove_with_rate)
+def lvm_pvmove_with_rate(src, dest=None, max_rate=0, extra=None, **kwargs):
+    extra = _get_extra(extra, kwargs)
+    return _lvm_pvmove_with_rate(src, dest, max_rate, extra)
+__all__.append("lvm_pvmove_with_rate")
+
 _lvm_pvscan = BlockDev.lvm_pvscan
 @override(BlockDev.lvm_pvscan)
 def lvm_pvscan(device=None, update_cache=True, extra=None, **kwargs):
@@ -736,6 +743,26 @@ def lvm_lvcreate(vg_name, lv_name, size, type=None, pv_list=None, extra=None, **
     return _lvm_lvcreate(vg_name, lv_name, size, type, pv_list, extra)
 __all__.append("lvm_lvcreate")
 
+_lvm_raid_create = BlockDev.lvm_raid_create
+@override(BlockDev.lvm_raid_create)
+def lvm_raid_create(vg_name, lv_name, raid_type, size, stripes=0, stripe_size=0, mirrors=0, pv_list=None, extra=None, **kwargs):
+    extra = _get_extra(extra, kwargs)
+    return _lvm_raid_create(vg_name, lv_name, raid_type, size, stripes, stripe_size, mirrors, pv_list, extra)
+__all__.append("lvm_raid_create")
+
+_lvm_raid_set_recovery_rate = BlockDev.lvm_raid_set_recovery_rate
+@override(BlockDev.lvm_raid_set_recovery_rate)
+def lvm_raid_set_recovery_rate(vg_name, lv_name, min_rate=-1, max_rate=-1, extra=None, **kwargs):
+    extra = _get_extra(extra, kwargs)
+    return _lvm_raid_set_recovery_rate(vg_name, lv_name, min_rate, max_rate, extra)
+__all__.append("lvm_raid_set_recovery_rate")
+
+_lvm_plan_placement = BlockDev.lvm_plan_placement
+@override(BlockDev.lvm_plan_placement)
+def lvm_plan_placement(vg_name, size, max_stripes=0):
+    return _lvm_plan_placement(vg_name, size, max_stripes)
+__all__.append("lvm_plan_placement")
+
 _lvm_lvremove = BlockDev.lvm_lvremove
 @override(BlockDev.lvm_lvremove)
 def lvm_lvremove(vg_name, lv_name, force=False, extra=None, **kwargs):
@@ -791,6 +818,34 @@ def lvm_lvs(vg_name=None):
     return _lvm_lvs(vg_name)
 __all__.append("lvm_lvs")
 
+_lvm_lvs_result_set = BlockDev.lvm_lvs_result_set
+@override(BlockDev.lvm_lvs_result_set)
+def lvm_lvs_result_set(vg_name=None):
+    return _lvm_lvs_result_set(vg_name)
+__all__.append("lvm_lvs_result_set")
+
+class LVMResultSet(BlockDev.LVMResultSet):
+    def __len__(self):
+        return self.n_items
+
+    def __getitem__(self, index):
+        if index < 0:
+            index += self.n_items
+        if index < 0 or index >= self.n_items:
+            raise IndexError("LVMResultSet index out of range")
+        if self.item_type == BlockDev.LVMResultSetType.PVS:
+            return self.get_pv(index)
+        elif self.item_type == BlockDev.LVMResultSetType.VGS:
+            return self.get_vg(index)
+        else:
+            return self.get_lv(index)
+
+    def __iter__(self):
+        for i in range(self.n_items):
+            yield self[i]
+LVMResultSet = override(LVMResultSet)
+__all__.append("LVMResultSet")
+
 _lvm_thpoolcreate = BlockDev.lvm_thpoolcreate
 @override(BlockDev.lvm_thpoolcreate)
 def lvm_thpoolcreate(vg_name, lv_name, size, md_size=0, chunk_size=0, profile=None, extra=None, **kwargs):
@@ -819,6 +874,49 @@ def lvm_cache_detach(vg_name, cached_lv, destroy=True, extra=None, **kwargs):
     return _lvm_cache_detach(vg_name, cached_lv, destroy, extra)
 __all__.append("lvm_cache_detach")
 
+class LVMCacheSettings(BlockDev.LVMCacheSettings):
+    def __new__(cls, policy=None, migration_threshold=-1, sequential_threshold=-1, random_threshold=-1):
+        ret = BlockDev.LVMCacheSettings.new(policy, migration_threshold, sequential_threshold, random_threshold)
+        ret.__class__ = cls
+        return ret
+    def __init__(self, *args, **kwargs):   # pylint: disable=unused-argument
+        super(LVMCacheSettings, self).__init__()  #pylint: disable=bad-super-call
+LVMCacheSettings = override(LVMCacheSettings)
+__all__.append("LVMCacheSettings")
+
+_lvm_cache_set_settings = BlockDev.lvm_cache_set_settings
+@override(BlockDev.lvm_cache_set_settings)
+def lvm_cache_set_settings(vg_name, cached_lv, settings, extra=None, **kwargs):
+    extra = _get_extra(extra, kwargs)
+    return _lvm_cache_set_settings(vg_name, cached_lv, settings, extra)
+__all__.append("lvm_cache_set_settings")
+
+class LVMWritecacheSettings(BlockDev.LVMWritecacheSettings):
+    def __new__(cls, high_watermark=-1, low_watermark=-1, writeback_jobs=-1, autocommit_blocks=-1,
+                autocommit_time=-1, block_size=-1, cleaner=-1):
+        ret = BlockDev.LVMWritecacheSettings.new(high_watermark, low_watermark, writeback_jobs, autocommit_blocks,
+                                                 autocommit_time, block_size, cleaner)
+        ret.__class__ = cls
+        return ret
+    def __init__(self, *args, **kwargs):   # pylint: disable=unused-argument
+        super(LVMWritecacheSettings, self).__init__()  #pylint: disable=bad-super-call
+LVMWritecacheSettings = override(LVMWritecacheSettings)
+__all__.append("LVMWritecacheSettings")
+
+_lvm_writecache_attach_with_settings = BlockDev.lvm_writecache_attach_with_settings
+@override(BlockDev.lvm_writecache_attach_with_settings)
+def lvm_writecache_attach_with_settings(vg_name, data_lv, cache_lv, settings=None, extra=None, **kwargs):
+    extra = _get_extra(extra, kwargs)
+    return _lvm_writecache_attach_with_settings(vg_name, data_lv, cache_lv, settings, extra)
+__all__.append("lvm_writecache_attach_with_settings")
+
+_lvm_writecache_set_settings = BlockDev.lvm_writecache_set_settings
+@override(BlockDev.lvm_writecache_set_settings)
+def lvm_writecache_set_settings(vg_name, cached_lv, settings, extra=None, **kwargs):
+    extra = _get_extra(extra, kwargs)
+    return _lvm_writecache_set_settings(vg_name, cached_lv, settings, extra)
+__all__.append("lvm_writecache_set_settings")
+
 _lvm_is_valid_thpool_chunk_size = BlockDev.lvm_is_valid_thpool_chunk_size
 @override(BlockDev.lvm_is_valid_thpool_chunk_size)
 def lvm_is_valid_thpool_chunk_size(size, discard=False):
@@ -852,6 +950,25 @@ def lvm_vdo_pool_create(vg_name, lv_name, pool_name, data_size, virtual_size, in
     return _lvm_vdo_pool_create(vg_name, lv_name, pool_name, data_size,virtual_size, index_memory, compression, deduplication, write_policy, extra)
 __all__.append("lvm_vdo_pool_create")
 
+class LVMVDOTuning(BlockDev.LVMVDOTuning):
+    def __new__(cls, cpu_threads=-1, bio_threads=-1, ack_threads=-1, hash_zone_threads=-1, logical_threads=-1,
+                physical_threads=-1, block_map_cache_size=-1, bio_rotation=-1):
+        ret = BlockDev.LVMVDOTuning.new(cpu_threads, bio_threads, ack_threads, hash_zone_threads, logical_threads,
+                                        physical_threads, block_map_cache_size, bio_rotation)
+        ret.__class__ = cls
+        return ret
+    def __init__(self, *args, **kwargs):   # pylint: disable=unused-argument
+        super(LVMVDOTuning, self).__init__()  #pylint: disable=bad-super-call
+LVMVDOTuning = override(LVMVDOTuning)
+__all__.append("LVMVDOTuning")
+
+_lvm_vdo_pool_create_with_tuning = BlockDev.lvm_vdo_pool_create_with_tuning
+@override(BlockDev.lvm_vdo_pool_create_with_tuning)
+def lvm_vdo_pool_create_with_tuning(vg_name, lv_name, pool_name, data_size, virtual_size, index_memory=0, compression=True, deduplication=True, write_policy=BlockDev.LVMVDOWritePolicy.AUTO, tuning=None, extra=None, **kwargs):
+    extra = _get_extra(extra, kwargs)
+    return _lvm_vdo_pool_create_with_tuning(vg_name, lv_name, pool_name, data_size, virtual_size, index_memory, compression, deduplication, write_policy, tuning, extra)
+__all__.append("lvm_vdo_pool_create_with_tuning")
+
 _lvm_vdo_resize = BlockDev.lvm_vdo_resize
 @override(BlockDev.lvm_vdo_resize)
 def lvm_vdo_resize(vg_name, lv_name, size, extra=None, **kwargs):
@@ -901,6 +1018,13 @@ def lvm_vdo_pool_convert(vg_name, lv_name, pool_name, virtual_size, index_memory
     return _lvm_vdo_pool_convert(vg_name, lv_name, pool_name, virtual_size, index_memory, compression, deduplication, write_policy, extra)
 __all__.append("lvm_vdo_pool_convert")
 
+_lvm_vdo_pool_convert_with_tuning = BlockDev.lvm_vdo_pool_convert_with_tuning
+@override(BlockDev.lvm_vdo_pool_convert_with_tuning)
+def lvm_vdo_pool_convert_with_tuning(vg_name, lv_name, pool_name, virtual_size, index_memory=0, compression=True, deduplication=True, write_policy=BlockDev.LVMVDOWritePolicy.AUTO, tuning=None, extra=None, **kwargs):
+    extra = _get_extra(extra, kwargs)
+    return _lvm_vdo_pool_convert_with_tuning(vg_name, lv_name, pool_name, virtual_size, index_memory, compression, deduplication, write_policy, tuning, extra)
+__all__.append("lvm_vdo_pool_convert_with_tuning")
+
 _md_get_superblock_size = BlockDev.md_get_superblock_size
 @override(BlockDev.md_get_superblock_size)
 def md_get_superblock_size(size, version=None):
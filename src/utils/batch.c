@@ -0,0 +1,477 @@
+/*
+ * Copyright (C) 2024  Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include "batch.h"
+#include "exec.h"
+
+/* maximum depth of stacked devices (DM over MD over partitions,...) */
+#define MAX_STACK_DEPTH 16
+
+typedef struct BatchItem {
+    gchar **argv;
+    BDExtraArg **extra;
+    BDUtilsBatchFunc func;
+    gpointer user_data;
+    GDestroyNotify notify;
+    gchar *device;
+    GPtrArray *disks;           /* whole disks the item works with ("major:minor") */
+    gboolean started;
+    gboolean success;
+    GError *error;
+} BatchItem;
+
+struct BDUtilsBatch {
+    gint ref_count;
+    GPtrArray *items;
+    gboolean ran;
+
+    /* cancellable and deadline of the thread that created the batch, passed
+       on to the worker threads */
+    GCancellable *cancellable;
+    gint64 deadline;
+
+    /* scheduling state, protected by @lock */
+    GMutex lock;
+    GCond cond;
+    GHashTable *busy_disks;
+    guint n_running;
+    guint n_done;
+};
+
+static void batch_item_free (BatchItem *item) {
+    BDExtraArg **extra_p = NULL;
+
+    if (item->notify)
+        item->notify (item->user_data);
+    g_strfreev (item->argv);
+    if (item->extra) {
+        for (extra_p=item->extra; *extra_p; extra_p++)
+            bd_extra_arg_free (*extra_p);
+        g_free (item->extra);
+    }
+    g_free (item->device);
+    g_ptr_array_unref (item->disks);
+    g_clear_error (&(item->error));
+    g_free (item);
+}
+
+/**
+ * bd_utils_batch_new: (constructor)
+ *
+ * The #GCancellable and deadline set for the current thread with
+ * bd_utils_set_thread_cancellable() (if any) are used for all the items of the
+ * new batch.
+ *
+ * Returns: (transfer full): a new empty batch
+ */
+BDUtilsBatch* bd_utils_batch_new (void) {
+    BDUtilsBatch *batch = g_new0 (BDUtilsBatch, 1);
+    GCancellable *cancellable = NULL;
+
+    batch->ref_count = 1;
+    batch->items = g_ptr_array_new_with_free_func ((GDestroyNotify) batch_item_free);
+    g_mutex_init (&(batch->lock));
+    g_cond_init (&(batch->cond));
+    batch->busy_disks = g_hash_table_new (g_str_hash, g_str_equal);
+
+    cancellable = bd_utils_get_thread_cancellable (&(batch->deadline));
+    if (cancellable)
+        batch->cancellable = g_object_ref (cancellable);
+
+    return batch;
+}
+
+/**
+ * bd_utils_batch_ref: (skip)
+ * @batch: a batch to ref
+ *
+ * Returns: @batch
+ */
+BDUtilsBatch* bd_utils_batch_ref (BDUtilsBatch *batch) {
+    g_atomic_int_inc (&(batch->ref_count));
+    return batch;
+}
+
+/**
+ * bd_utils_batch_unref: (skip)
+ * @batch: (allow-none): a batch to unref
+ *
+ * Frees @batch (and all its items) when the last reference is dropped.
+ */
+void bd_utils_batch_unref (BDUtilsBatch *batch) {
+    if (!batch || !g_atomic_int_dec_and_test (&(batch->ref_count)))
+        return;
+
+    g_ptr_array_unref (batch->items);
+    g_hash_table_destroy (batch->busy_disks);
+    g_clear_object (&(batch->cancellable));
+    g_mutex_clear (&(batch->lock));
+    g_cond_clear (&(batch->cond));
+    g_free (batch);
+}
+
+GType bd_utils_batch_get_type (void) {
+    static GType type = 0;
+
+    if (G_UNLIKELY (!type))
+        type = g_boxed_type_register_static ("BDUtilsBatch",
+                                             (GBoxedCopyFunc) bd_utils_batch_ref,
+                                             (GBoxedFreeFunc) bd_utils_batch_unref);
+
+    return type;
+}
+
+static gboolean read_devno (const gchar *dev_file, dev_t *devno) {
+    gchar *contents = NULL;
+    guint maj = 0;
+    guint min = 0;
+    gboolean ret = FALSE;
+
+    if (!g_file_get_contents (dev_file, &contents, NULL, NULL))
+        return FALSE;
+
+    ret = (sscanf (contents, "%u:%u", &maj, &min) == 2);
+    if (ret)
+        *devno = makedev (maj, min);
+    g_free (contents);
+
+    return ret;
+}
+
+static void add_disk (GPtrArray *disks, dev_t devno) {
+    gchar *disk = g_strdup_printf ("%u:%u", major (devno), minor (devno));
+    guint i = 0;
+
+    for (i=0; i < disks->len; i++)
+        if (g_strcmp0 (g_ptr_array_index (disks, i), disk) == 0) {
+            g_free (disk);
+            return;
+        }
+    g_ptr_array_add (disks, disk);
+}
+
+/* adds the whole disks backing the block device @devno to @disks -- the parent
+   disk of a partition, the disks under stacked (DM, MD,...) devices */
+static void add_backing_disks (GPtrArray *disks, dev_t devno, guint depth) {
+    gchar *sys_path = NULL;
+    gchar *path = NULL;
+    GDir *dir = NULL;
+    const gchar *name = NULL;
+    dev_t slave_devno = 0;
+    gboolean have_slaves = FALSE;
+
+    sys_path = g_strdup_printf ("/sys/dev/block/%u:%u", major (devno), minor (devno));
+
+    path = g_build_filename (sys_path, "partition", NULL);
+    if (g_file_test (path, G_FILE_TEST_EXISTS)) {
+        g_free (path);
+        path = g_build_filename (sys_path, "..", "dev", NULL);
+        if (read_devno (path, &slave_devno))
+            add_disk (disks, slave_devno);
+        else
+            add_disk (disks, devno);
+        g_free (path);
+        g_free (sys_path);
+        return;
+    }
+    g_free (path);
+
+    path = g_build_filename (sys_path, "slaves", NULL);
+    dir = depth < MAX_STACK_DEPTH ? g_dir_open (path, 0, NULL) : NULL;
+    g_free (path);
+    if (dir) {
+        while ((name = g_dir_read_name (dir))) {
+            path = g_build_filename (sys_path, "slaves", name, "dev", NULL);
+            if (read_devno (path, &slave_devno)) {
+                add_backing_disks (disks, slave_devno, depth + 1);
+                have_slaves = TRUE;
+            }
+            g_free (path);
+        }
+        g_dir_close (dir);
+    }
+
+    if (!have_slaves)
+        add_disk (disks, devno);
+
+    g_free (sys_path);
+}
+
+static GPtrArray* get_item_disks (const gchar *device) {
+    GPtrArray *disks = g_ptr_array_new_with_free_func (g_free);
+    struct stat st;
+
+    if (!device)
+        return disks;
+
+    if (stat (device, &st) == 0 && S_ISBLK (st.st_mode))
+        add_backing_disks (disks, st.st_rdev, 0);
+    else
+        /* not (yet) a block device, at least serialize items using the same path */
+        g_ptr_array_add (disks, g_strdup (device));
+
+    return disks;
+}
+
+static guint add_item (BDUtilsBatch *batch, BatchItem *item, const gchar *device) {
+    item->device = g_strdup (device);
+    item->disks = get_item_disks (device);
+    g_ptr_array_add (batch->items, item);
+
+    return batch->items->len - 1;
+}
+
+/**
+ * bd_utils_batch_add_command:
+ * @batch: a batch to add the command to
+ * @argv: (array zero-terminated=1): the argv array for the command
+ * @extra: (allow-none) (array zero-terminated=1): extra arguments
+ * @device: (allow-none): device the command works with or %NULL
+ *
+ * Adds a command to @batch. Items working with devices on the same physical
+ * disk (e.g. partitions of one disk or LVs of a VG on it) are never run at
+ * the same time.
+ *
+ * Returns: index of the added item (for bd_utils_batch_get_result())
+ */
+guint bd_utils_batch_add_command (BDUtilsBatch *batch, const gchar **argv, const BDExtraArg **extra, const gchar *device) {
+    BatchItem *item = g_new0 (BatchItem, 1);
+    guint n_extra = 0;
+    guint i = 0;
+
+    item->argv = g_strdupv ((gchar **) argv);
+    if (extra) {
+        while (extra[n_extra])
+            n_extra++;
+        item->extra = g_new0 (BDExtraArg*, n_extra + 1);
+        for (i=0; i < n_extra; i++)
+            item->extra[i] = bd_extra_arg_copy ((BDExtraArg *) extra[i]);
+    }
+
+    return add_item (batch, item, device);
+}
+
+/**
+ * bd_utils_batch_add_func:
+ * @batch: a batch to add the function to
+ * @func: (scope notified): function to run
+ * @user_data: (closure): data for @func
+ * @notify: (destroy user_data) (allow-none): function to free @user_data with
+ * @device: (allow-none): device the function works with or %NULL
+ *
+ * Adds a function (e.g. a wrapper of a plugin call) to @batch, see
+ * bd_utils_batch_add_command() for details. Progress reporting is muted in
+ * the threads the items run in, the progress of the whole batch is reported
+ * instead.
+ *
+ * Returns: index of the added item (for bd_utils_batch_get_result())
+ */
+guint bd_utils_batch_add_func (BDUtilsBatch *batch, BDUtilsBatchFunc func, gpointer user_data, GDestroyNotify notify, const gchar *device) {
+    BatchItem *item = g_new0 (BatchItem, 1);
+
+    item->func = func;
+    item->user_data = user_data;
+    item->notify = notify;
+
+    return add_item (batch, item, device);
+}
+
+/**
+ * bd_utils_batch_get_result:
+ * @batch: a batch run with bd_utils_exec_batch()
+ * @index: index of the item to get the result of
+ * @error: (out) (allow-none): place to store the error of the item (if any)
+ *
+ * Returns: whether the item was successfully run or not
+ */
+gboolean bd_utils_batch_get_result (BDUtilsBatch *batch, guint index, GError **error) {
+    BatchItem *item = NULL;
+
+    if (index >= batch->items->len) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Invalid batch item index: %u", index);
+        return FALSE;
+    }
+    if (!batch->ran) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "The batch hasn't been run yet");
+        return FALSE;
+    }
+
+    item = g_ptr_array_index (batch->items, index);
+    if (!item->success) {
+        if (item->error)
+            g_propagate_error (error, g_error_copy (item->error));
+        else
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Batch item %u failed", index);
+    }
+
+    return item->success;
+}
+
+/* must be called with the batch lock held */
+static gboolean disks_busy (BDUtilsBatch *batch, BatchItem *item) {
+    guint i = 0;
+
+    for (i=0; i < item->disks->len; i++)
+        if (g_hash_table_contains (batch->busy_disks, g_ptr_array_index (item->disks, i)))
+            return TRUE;
+
+    return FALSE;
+}
+
+/* must be called with the batch lock held */
+static void set_disks_busy (BDUtilsBatch *batch, BatchItem *item, gboolean busy) {
+    guint i = 0;
+
+    for (i=0; i < item->disks->len; i++) {
+        if (busy)
+            g_hash_table_add (batch->busy_disks, g_ptr_array_index (item->disks, i));
+        else
+            g_hash_table_remove (batch->busy_disks, g_ptr_array_index (item->disks, i));
+    }
+}
+
+static void run_batch_item (gpointer data, gpointer user_data) {
+    BatchItem *item = (BatchItem *) data;
+    BDUtilsBatch *batch = (BDUtilsBatch *) user_data;
+    gboolean success = FALSE;
+    GError *l_error = NULL;
+
+    /* the threads belong to the batch's pool, progress of the whole batch is
+       reported instead of the progress of the individual items */
+    bd_utils_mute_prog_reporting_thread (NULL);
+
+    /* the pool's threads are reused, always (re)set the batch's ones */
+    bd_utils_set_thread_cancellable (batch->cancellable, batch->deadline);
+
+    if (item->argv)
+        success = bd_utils_exec_and_report_error ((const gchar **) item->argv, (const BDExtraArg **) item->extra, &l_error);
+    else
+        success = item->func (item->user_data, &l_error);
+
+    bd_utils_set_thread_cancellable (NULL, 0);
+
+    g_mutex_lock (&(batch->lock));
+    item->success = success;
+    item->error = l_error;
+    set_disks_busy (batch, item, FALSE);
+    batch->n_running--;
+    batch->n_done++;
+    g_cond_signal (&(batch->cond));
+    g_mutex_unlock (&(batch->lock));
+}
+
+/**
+ * bd_utils_exec_batch:
+ * @batch: a batch to run
+ * @max_parallel: maximum number of items to run at the same time or 0 to use
+ *                the number of CPUs
+ * @error: (out) (allow-none): place to store error (if any)
+ *
+ * Runs all the items of @batch (in the order they were added as far as the
+ * @max_parallel limit and the per-disk serialization allow) and waits for
+ * them to finish. Progress of the batch (percentage of finished items) is
+ * reported with the progress reporting functions. Use
+ * bd_utils_batch_get_result() to get the results of the individual items.
+ *
+ * A batch can only be run once.
+ *
+ * Returns: whether all the items were successfully run or not
+ */
+gboolean bd_utils_exec_batch (BDUtilsBatch *batch, guint max_parallel, GError **error) {
+    GThreadPool *pool = NULL;
+    BatchItem *item = NULL;
+    guint n_items = batch->items->len;
+    guint n_done = 0;
+    guint n_failed = 0;
+    guint64 progress_id = 0;
+    gchar *msg = NULL;
+    guint i = 0;
+    GError *l_error = NULL;
+
+    if (batch->ran) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "The batch has already been run");
+        return FALSE;
+    }
+
+    if (max_parallel == 0)
+        max_parallel = g_get_num_processors ();
+
+    pool = g_thread_pool_new (run_batch_item, batch, (gint) max_parallel, TRUE, error);
+    if (!pool) {
+        g_prefix_error (error, "Failed to create threads for the batch: ");
+        return FALSE;
+    }
+    batch->ran = TRUE;
+
+    msg = g_strdup_printf ("Started batch of %u items", n_items);
+    progress_id = bd_utils_report_started (msg);
+    g_free (msg);
+
+    g_mutex_lock (&(batch->lock));
+    while (batch->n_done < n_items) {
+        /* start everything that can be started now */
+        for (i=0; i < n_items && batch->n_running < max_parallel; i++) {
+            item = g_ptr_array_index (batch->items, i);
+            if (item->started || disks_busy (batch, item))
+                continue;
+            item->started = TRUE;
+            set_disks_busy (batch, item, TRUE);
+            batch->n_running++;
+            g_thread_pool_push (pool, item, NULL);
+        }
+
+        g_cond_wait (&(batch->cond), &(batch->lock));
+
+        if (batch->n_done != n_done) {
+            n_done = batch->n_done;
+            /* don't block the workers while reporting */
+            g_mutex_unlock (&(batch->lock));
+            msg = g_strdup_printf ("%u of %u items done", n_done, n_items);
+            bd_utils_report_progress (progress_id, (guint64) n_done * 100 / n_items, msg);
+            g_free (msg);
+            g_mutex_lock (&(batch->lock));
+        }
+    }
+    g_mutex_unlock (&(batch->lock));
+
+    g_thread_pool_free (pool, FALSE, TRUE);
+
+    for (i=0; i < n_items; i++)
+        if (!((BatchItem *) g_ptr_array_index (batch->items, i))->success)
+            n_failed++;
+
+    if (n_failed > 0) {
+        g_set_error (&l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "%u of %u items of the batch failed", n_failed, n_items);
+        bd_utils_report_finished (progress_id, l_error->message);
+        g_propagate_error (error, l_error);
+        return FALSE;
+    }
+
+    bd_utils_report_finished (progress_id, "Completed");
+    return TRUE;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2024  Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "extra_arg.h"
+
+#ifndef BD_UTILS_BATCH
+#define BD_UTILS_BATCH
+
+/**
+ * BDUtilsBatchFunc:
+ * @user_data: (closure): user data passed to bd_utils_batch_add_func()
+ * @error: (out) (allow-none): place to store error (if any)
+ *
+ * Function run as an item of a batch, typically wrapping a plugin call (e.g.
+ * bd_fs_mkfs() for one of the devices).
+ *
+ * Returns: whether the item was successfully processed or not
+ */
+typedef gboolean (*BDUtilsBatchFunc) (gpointer user_data, GError **error);
+
+/**
+ * BDUtilsBatch:
+ *
+ * A set of commands and functions run in parallel by bd_utils_exec_batch().
+ */
+typedef struct BDUtilsBatch BDUtilsBatch;
+
+#define BD_UTILS_TYPE_BATCH (bd_utils_batch_get_type ())
+GType bd_utils_batch_get_type (void);
+
+BDUtilsBatch* bd_utils_batch_new (void);
+BDUtilsBatch* bd_utils_batch_ref (BDUtilsBatch *batch);
+void bd_utils_batch_unref (BDUtilsBatch *batch);
+guint bd_utils_batch_add_command (BDUtilsBatch *batch, const gchar **argv, const BDExtraArg **extra, const gchar *device);
+guint bd_utils_batch_add_func (BDUtilsBatch *batch, BDUtilsBatchFunc func, gpointer user_data, GDestroyNotify notify, const gchar *device);
+gboolean bd_utils_batch_get_result (BDUtilsBatch *batch, guint index, GError **error);
+
+gboolean bd_utils_exec_batch (BDUtilsBatch *batch, guint max_parallel, GError **error);
+
+#endif  /* BD_UTILS_BATCH */
@@ -28,6 +28,10 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <spawn.h>
+#include <glib-unix.h>
 
 #ifdef __clang__
 #define ZERO_INIT {}
@@ -44,6 +48,8 @@ static GMutex task_id_counter_lock;
 static guint64 task_id_counter = 0;
 static BDUtilsProgFunc prog_func = NULL;
 static __thread BDUtilsProgFunc thread_prog_func = NULL;
+static __thread GCancellable *thread_cancellable = NULL;
+static __thread gint64 thread_deadline = 0;
 
 /**
  * bd_utils_exec_error_quark: (skip)
@@ -134,6 +140,677 @@ static void log_done (guint64 task_id, gint exit_code) {
     return;
 }
 
+/* upper bounds (in microseconds) of the buckets of the run time histograms,
+   the last bucket has no upper bound */
+#define _EXEC_STATS_N_BUCKETS 16
+static const guint64 exec_stats_bounds[_EXEC_STATS_N_BUCKETS - 1] = {
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+    1000000, 2500000, 5000000, 10000000, 30000000, 60000000,
+};
+
+typedef struct ExecStatsEntry {
+    BDUtilsExecStats stats;
+    guint64 buckets[_EXEC_STATS_N_BUCKETS];
+} ExecStatsEntry;
+
+static gint exec_stats_enabled = 0;
+static GMutex exec_stats_lock;
+static GHashTable *exec_stats = NULL;
+
+/**
+ * bd_utils_exec_stats_copy: (skip)
+ * @stats: (allow-none): %BDUtilsExecStats to copy
+ *
+ * Creates a new copy of @stats.
+ */
+BDUtilsExecStats* bd_utils_exec_stats_copy (BDUtilsExecStats *stats) {
+    BDUtilsExecStats *ret = NULL;
+
+    if (stats == NULL)
+        return NULL;
+
+    ret = g_new0 (BDUtilsExecStats, 1);
+    *ret = *stats;
+    ret->util = g_strdup (stats->util);
+
+    return ret;
+}
+
+/**
+ * bd_utils_exec_stats_free: (skip)
+ * @stats: (allow-none): %BDUtilsExecStats to free
+ *
+ * Frees @stats.
+ */
+void bd_utils_exec_stats_free (BDUtilsExecStats *stats) {
+    if (stats == NULL)
+        return;
+
+    g_free (stats->util);
+    g_free (stats);
+}
+
+GType bd_utils_exec_stats_get_type (void) {
+    static GType type = 0;
+
+    if (G_UNLIKELY (!type))
+        type = g_boxed_type_register_static ("BDUtilsExecStats",
+                                             (GBoxedCopyFunc) bd_utils_exec_stats_copy,
+                                             (GBoxedFreeFunc) bd_utils_exec_stats_free);
+
+    return type;
+}
+
+static void exec_stats_entry_free (ExecStatsEntry *entry) {
+    g_free (entry->stats.util);
+    g_free (entry);
+}
+
+/**
+ * bd_utils_set_exec_stats_enabled:
+ * @enabled: whether to collect the statistics or not
+ *
+ * Enables or disables collecting the statistics about the executed utilities
+ * (disabled by default). The already collected statistics are kept, use
+ * bd_utils_reset_exec_stats() to drop them.
+ */
+void bd_utils_set_exec_stats_enabled (gboolean enabled) {
+    g_atomic_int_set (&exec_stats_enabled, enabled ? 1 : 0);
+}
+
+/**
+ * bd_utils_reset_exec_stats:
+ *
+ * Drops all the collected statistics about the executed utilities.
+ */
+void bd_utils_reset_exec_stats (void) {
+    g_mutex_lock (&exec_stats_lock);
+    if (exec_stats)
+        g_hash_table_remove_all (exec_stats);
+    g_mutex_unlock (&exec_stats_lock);
+}
+
+/**
+ * exec_stats_start: (skip)
+ *
+ * Returns: current monotonic time if the statistics are enabled, 0 otherwise
+ */
+static gint64 exec_stats_start (void) {
+    return g_atomic_int_get (&exec_stats_enabled) ? g_get_monotonic_time () : 0;
+}
+
+/**
+ * exec_stats_record: (skip)
+ * @start: value returned by exec_stats_start() (nothing is recorded if 0)
+ * @spawned: monotonic time the process was started at or 0 if it failed to start
+ *
+ * Records one run of @argv (finished now).
+ */
+static void exec_stats_record (const gchar **argv, gint64 start, gint64 spawned, guint64 stdout_bytes, guint64 stderr_bytes, gboolean success) {
+    ExecStatsEntry *entry = NULL;
+    gchar *util = NULL;
+    guint64 run_time = 0;
+    guint i = 0;
+
+    if (start == 0)
+        return;
+
+    run_time = g_get_monotonic_time () - start;
+    util = g_path_get_basename (argv[0]);
+
+    g_mutex_lock (&exec_stats_lock);
+    if (!exec_stats)
+        exec_stats = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) exec_stats_entry_free);
+
+    entry = g_hash_table_lookup (exec_stats, util);
+    if (!entry) {
+        entry = g_new0 (ExecStatsEntry, 1);
+        entry->stats.util = util;
+        g_hash_table_insert (exec_stats, util, entry);
+    } else
+        g_free (util);
+
+    entry->stats.calls++;
+    if (!success)
+        entry->stats.failures++;
+    entry->stats.total_time += run_time;
+    entry->stats.max_time = MAX (entry->stats.max_time, run_time);
+    if (spawned > 0)
+        entry->stats.total_spawn_time += spawned - start;
+    entry->stats.stdout_bytes += stdout_bytes;
+    entry->stats.stderr_bytes += stderr_bytes;
+
+    while (i < _EXEC_STATS_N_BUCKETS - 1 && run_time > exec_stats_bounds[i])
+        i++;
+    entry->buckets[i]++;
+    g_mutex_unlock (&exec_stats_lock);
+}
+
+/* estimates the @quantile of the run times from the histogram (interpolating
+   linearly within the bucket the quantile falls into) */
+static guint64 exec_stats_quantile (const ExecStatsEntry *entry, gdouble quantile) {
+    guint64 rank = (guint64) (quantile * entry->stats.calls + 0.5);
+    guint64 below = 0;
+    guint64 lower = 0;
+    guint64 upper = 0;
+    guint64 ret = 0;
+    guint i = 0;
+
+    if (entry->stats.calls == 0)
+        return 0;
+    rank = CLAMP (rank, 1, entry->stats.calls);
+
+    for (i=0; i < _EXEC_STATS_N_BUCKETS; i++) {
+        if (below + entry->buckets[i] >= rank)
+            break;
+        below += entry->buckets[i];
+    }
+
+    lower = i > 0 ? exec_stats_bounds[i - 1] : 0;
+    upper = i < _EXEC_STATS_N_BUCKETS - 1 ? exec_stats_bounds[i] : MAX (entry->stats.max_time, lower);
+    ret = lower + (upper - lower) * (rank - below) / entry->buckets[i];
+
+    return MIN (ret, entry->stats.max_time);
+}
+
+static gint exec_stats_cmp (gconstpointer a, gconstpointer b) {
+    const ExecStatsEntry *entry_a = *((const ExecStatsEntry **) a);
+    const ExecStatsEntry *entry_b = *((const ExecStatsEntry **) b);
+
+    /* most time consuming utilities first */
+    if (entry_a->stats.total_time != entry_b->stats.total_time)
+        return entry_a->stats.total_time > entry_b->stats.total_time ? -1 : 1;
+    return g_strcmp0 (entry_a->stats.util, entry_b->stats.util);
+}
+
+/* must be called with the exec_stats_lock held */
+static GPtrArray* get_sorted_exec_stats (void) {
+    GPtrArray *entries = g_ptr_array_new ();
+    GHashTableIter iter;
+    gpointer value = NULL;
+
+    if (exec_stats) {
+        g_hash_table_iter_init (&iter, exec_stats);
+        while (g_hash_table_iter_next (&iter, NULL, &value))
+            g_ptr_array_add (entries, value);
+    }
+    g_ptr_array_sort (entries, exec_stats_cmp);
+
+    return entries;
+}
+
+/**
+ * bd_utils_get_exec_stats:
+ *
+ * Returns: (transfer full) (array zero-terminated=1): statistics about the
+ *          utilities executed since the statistics were enabled (or reset),
+ *          sorted by the total run time (most time consuming first)
+ */
+BDUtilsExecStats** bd_utils_get_exec_stats (void) {
+    GPtrArray *entries = NULL;
+    ExecStatsEntry *entry = NULL;
+    BDUtilsExecStats **ret = NULL;
+    guint i = 0;
+
+    g_mutex_lock (&exec_stats_lock);
+    entries = get_sorted_exec_stats ();
+    ret = g_new0 (BDUtilsExecStats*, entries->len + 1);
+    for (i=0; i < entries->len; i++) {
+        entry = g_ptr_array_index (entries, i);
+        entry->stats.time_p50 = exec_stats_quantile (entry, 0.5);
+        entry->stats.time_p90 = exec_stats_quantile (entry, 0.9);
+        entry->stats.time_p99 = exec_stats_quantile (entry, 0.99);
+        ret[i] = bd_utils_exec_stats_copy (&(entry->stats));
+    }
+    g_mutex_unlock (&exec_stats_lock);
+    g_ptr_array_free (entries, TRUE);
+
+    return ret;
+}
+
+static void append_seconds (GString *str, guint64 usecs) {
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+    g_string_append (str, g_ascii_dtostr (buf, G_ASCII_DTOSTR_BUF_SIZE, (gdouble) usecs / G_USEC_PER_SEC));
+}
+
+static gchar* escape_label (const gchar *value) {
+    GString *ret = g_string_new (NULL);
+    const gchar *c = NULL;
+
+    for (c=value; *c; c++) {
+        if (*c == '\\' || *c == '"')
+            g_string_append_c (ret, '\\');
+        if (*c == '\n')
+            g_string_append (ret, "\\n");
+        else
+            g_string_append_c (ret, *c);
+    }
+
+    return g_string_free (ret, FALSE);
+}
+
+/**
+ * bd_utils_get_exec_stats_prometheus:
+ *
+ * Returns: (transfer full): statistics about the executed utilities (see
+ *          bd_utils_get_exec_stats()) in the Prometheus text exposition format
+ */
+gchar* bd_utils_get_exec_stats_prometheus (void) {
+    static const struct {
+        const gchar *name;
+        const gchar *help;
+        gsize offset;
+        gboolean seconds;
+    } counters[] = {
+        {"bd_utils_exec_calls_total", "Number of executions of the utility", G_STRUCT_OFFSET (BDUtilsExecStats, calls), FALSE},
+        {"bd_utils_exec_failures_total", "Number of failed executions of the utility", G_STRUCT_OFFSET (BDUtilsExecStats, failures), FALSE},
+        {"bd_utils_exec_spawn_seconds_total", "Time spent starting the utility", G_STRUCT_OFFSET (BDUtilsExecStats, total_spawn_time), TRUE},
+        {"bd_utils_exec_stdout_bytes_total", "Bytes of standard output read from the utility", G_STRUCT_OFFSET (BDUtilsExecStats, stdout_bytes), FALSE},
+        {"bd_utils_exec_stderr_bytes_total", "Bytes of standard error output read from the utility", G_STRUCT_OFFSET (BDUtilsExecStats, stderr_bytes), FALSE},
+    };
+    GString *ret = g_string_new (NULL);
+    GPtrArray *entries = NULL;
+    ExecStatsEntry *entry = NULL;
+    gchar **labels = NULL;
+    guint64 value = 0;
+    guint64 cumulative = 0;
+    guint i = 0;
+    guint j = 0;
+    guint k = 0;
+
+    g_mutex_lock (&exec_stats_lock);
+    entries = get_sorted_exec_stats ();
+    labels = g_new0 (gchar*, entries->len + 1);
+    for (i=0; i < entries->len; i++)
+        labels[i] = escape_label (((ExecStatsEntry *) g_ptr_array_index (entries, i))->stats.util);
+
+    for (j=0; j < G_N_ELEMENTS (counters); j++) {
+        g_string_append_printf (ret, "# HELP %s %s\n# TYPE %s counter\n", counters[j].name, counters[j].help, counters[j].name);
+        for (i=0; i < entries->len; i++) {
+            entry = g_ptr_array_index (entries, i);
+            value = G_STRUCT_MEMBER (guint64, &(entry->stats), counters[j].offset);
+            g_string_append_printf (ret, "%s{util=\"%s\"} ", counters[j].name, labels[i]);
+            if (counters[j].seconds)
+                append_seconds (ret, value);
+            else
+                g_string_append_printf (ret, "%"G_GUINT64_FORMAT, value);
+            g_string_append_c (ret, '\n');
+        }
+    }
+
+    g_string_append (ret, "# HELP bd_utils_exec_duration_seconds Run time of the utility\n"
+                          "# TYPE bd_utils_exec_duration_seconds histogram\n");
+    for (i=0; i < entries->len; i++) {
+        entry = g_ptr_array_index (entries, i);
+        cumulative = 0;
+        for (k=0; k < _EXEC_STATS_N_BUCKETS; k++) {
+            cumulative += entry->buckets[k];
+            g_string_append_printf (ret, "bd_utils_exec_duration_seconds_bucket{util=\"%s\",le=\"", labels[i]);
+            if (k < _EXEC_STATS_N_BUCKETS - 1)
+                append_seconds (ret, exec_stats_bounds[k]);
+            else
+                g_string_append (ret, "+Inf");
+            g_string_append_printf (ret, "\"} %"G_GUINT64_FORMAT"\n", cumulative);
+        }
+        g_string_append_printf (ret, "bd_utils_exec_duration_seconds_sum{util=\"%s\"} ", labels[i]);
+        append_seconds (ret, entry->stats.total_time);
+        g_string_append_printf (ret, "\nbd_utils_exec_duration_seconds_count{util=\"%s\"} %"G_GUINT64_FORMAT"\n",
+                                labels[i], entry->stats.calls);
+    }
+    g_mutex_unlock (&exec_stats_lock);
+
+    g_strfreev (labels);
+    g_ptr_array_free (entries, TRUE);
+
+    return g_string_free (ret, FALSE);
+}
+
+/* buffer size in bytes used to read from stdout and stderr */
+#define _EXEC_BUF_SIZE 64*1024
+
+/* time a cancelled process gets to exit after SIGTERM before it gets SIGKILL */
+#define _EXEC_KILL_TIMEOUT (5 * G_USEC_PER_SEC)
+
+/**
+ * terminate_child: (skip)
+ *
+ * Sends SIGTERM to @pid, followed by SIGKILL if it doesn't exit in time, and
+ * reaps it.
+ */
+static void terminate_child (GPid pid, gint *status) {
+    gint64 kill_time = g_get_monotonic_time () + _EXEC_KILL_TIMEOUT;
+    pid_t ret = 0;
+
+    kill (pid, SIGTERM);
+    while ((ret = waitpid (pid, status, WNOHANG)) == 0 && g_get_monotonic_time () < kill_time)
+        g_usleep (10 * 1000);
+
+    if (ret == 0) {
+        kill (pid, SIGKILL);
+        do
+            ret = waitpid (pid, status, 0);
+        while (ret < 0 && errno == EINTR);
+    }
+}
+
+/**
+ * poll_with_deadline: (skip)
+ * @fds: FDs to poll, the last one being the FD of @cancellable (or -1)
+ * @deadline: monotonic time to give up at or 0 for no deadline
+ *
+ * Returns: the same as poll() except that 0 is also returned in case of EINTR
+ *          and -1 (with @error set) also if @cancellable is cancelled or
+ *          @deadline is reached
+ */
+static gint poll_with_deadline (struct pollfd *fds, nfds_t n_fds, GCancellable *cancellable, gint64 deadline, GError **error) {
+    gint timeout = -1;
+    gint64 now = 0;
+    gint ret = 0;
+
+    if (g_cancellable_set_error_if_cancelled (cancellable, error))
+        return -1;
+
+    if (deadline > 0) {
+        now = g_get_monotonic_time ();
+        if (now >= deadline) {
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_TIMED_OUT,
+                         "Process didn't finish in time");
+            return -1;
+        }
+        /* round up so that we don't wake up right before the deadline */
+        timeout = (gint) MIN ((deadline - now + 999) / 1000, G_MAXINT);
+    }
+
+    ret = poll (fds, n_fds, timeout);
+    if (ret < 0) {
+        if (errno == EAGAIN || errno == EINTR)
+            return 0;
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Failed to poll output FDs: %m");
+    }
+
+    return ret;
+}
+
+/* environment for the executed processes (the current environment with
+   LC_ALL=C), rebuilt only when the process' environment changes */
+typedef struct ExecEnv {
+    gint ref_count;
+    gchar **env;
+    gchar **source;     /* snapshot of the environ pointers @env was built from */
+} ExecEnv;
+
+static GMutex exec_env_lock;
+static ExecEnv *exec_env = NULL;
+
+static void exec_env_unref (ExecEnv *env) {
+    if (!g_atomic_int_dec_and_test (&(env->ref_count)))
+        return;
+    g_strfreev (env->env);
+    g_free (env->source);
+    g_free (env);
+}
+
+/* setenv() and friends either replace the environ array or its items so
+   comparing the pointers is enough to detect changes */
+static gboolean exec_env_current (ExecEnv *env) {
+    guint i = 0;
+
+    if (!environ)
+        return env->source[0] == NULL;
+
+    for (i=0; environ[i] && env->source[i]; i++)
+        if (environ[i] != env->source[i])
+            return FALSE;
+
+    return environ[i] == NULL && env->source[i] == NULL;
+}
+
+/**
+ * exec_env_get: (skip)
+ *
+ * Returns: (transfer full): environment for the executed processes, unref with exec_env_unref()
+ */
+static ExecEnv* exec_env_get (void) {
+    ExecEnv *env = NULL;
+    guint n_vars = 0;
+
+    g_mutex_lock (&exec_env_lock);
+    if (!exec_env || !exec_env_current (exec_env)) {
+        if (exec_env)
+            exec_env_unref (exec_env);
+
+        n_vars = environ ? g_strv_length (environ) : 0;
+        exec_env = g_new0 (ExecEnv, 1);
+        exec_env->ref_count = 1;
+        exec_env->source = g_new0 (gchar*, n_vars + 1);
+        if (n_vars > 0)
+            memcpy (exec_env->source, environ, n_vars * sizeof (gchar*));
+        exec_env->env = g_environ_setenv (g_get_environ (), "LC_ALL", "C", TRUE);
+    }
+    env = exec_env;
+    g_atomic_int_inc (&(env->ref_count));
+    g_mutex_unlock (&exec_env_lock);
+
+    return env;
+}
+
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+/**
+ * spawn_with_pipes: (skip)
+ *
+ * Starts @argv with posix_spawnp() (which uses vfork-like clone() and is thus
+ * not slowed down by the size of our address space) with stdout and stderr
+ * connected to pipes, stdin connected to a pipe if @in_fd is not %NULL or to
+ * /dev/null otherwise and all the other file descriptors closed. The signal
+ * mask and the dispositions of the signals used to stop processes are reset
+ * so that the child doesn't inherit them from the calling process.
+ */
+static gboolean spawn_with_pipes (const gchar **argv, GPid *pid, gint *in_fd, gint *out_fd, gint *err_fd, GError **error) {
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t sigmask;
+    sigset_t sigdefault;
+    gint in_pipe[2] = {-1, -1};
+    gint out_pipe[2] = {-1, -1};
+    gint err_pipe[2] = {-1, -1};
+    ExecEnv *env = NULL;
+    gint ret = 0;
+    guint i = 0;
+
+    if ((in_fd && !g_unix_open_pipe (in_pipe, FD_CLOEXEC, error)) ||
+        !g_unix_open_pipe (out_pipe, FD_CLOEXEC, error) ||
+        !g_unix_open_pipe (err_pipe, FD_CLOEXEC, error)) {
+        g_prefix_error (error, "Failed to create pipes for the child process: ");
+        for (i=0; i < 2; i++) {
+            if (in_pipe[i] >= 0)
+                close (in_pipe[i]);
+            if (out_pipe[i] >= 0)
+                close (out_pipe[i]);
+        }
+        return FALSE;
+    }
+
+    posix_spawn_file_actions_init (&actions);
+    if (in_fd)
+        posix_spawn_file_actions_adddup2 (&actions, in_pipe[0], STDIN_FILENO);
+    else
+        /* never let the child read from (or block on) our stdin */
+        posix_spawn_file_actions_addopen (&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2 (&actions, out_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2 (&actions, err_pipe[1], STDERR_FILENO);
+    /* tools like LVM complain about leaked file descriptors */
+    posix_spawn_file_actions_addclosefrom_np (&actions, STDERR_FILENO + 1);
+
+    /* blocked or ignored SIGTERM would make terminate_child() always wait for
+       the SIGKILL timeout */
+    sigemptyset (&sigmask);
+    sigemptyset (&sigdefault);
+    sigaddset (&sigdefault, SIGPIPE);
+    sigaddset (&sigdefault, SIGTERM);
+    sigaddset (&sigdefault, SIGINT);
+    sigaddset (&sigdefault, SIGHUP);
+    posix_spawnattr_init (&attr);
+    posix_spawnattr_setsigmask (&attr, &sigmask);
+    posix_spawnattr_setsigdefault (&attr, &sigdefault);
+    posix_spawnattr_setflags (&attr, POSIX_SPAWN_SETSIGMASK|POSIX_SPAWN_SETSIGDEF);
+
+    env = exec_env_get ();
+    ret = posix_spawnp (pid, argv[0], &actions, &attr, (gchar **) argv, env->env);
+    exec_env_unref (env);
+    posix_spawnattr_destroy (&attr);
+    posix_spawn_file_actions_destroy (&actions);
+
+    /* close the child's ends of the pipes */
+    if (in_fd)
+        close (in_pipe[0]);
+    close (out_pipe[1]);
+    close (err_pipe[1]);
+
+    if (ret != 0) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Failed to execute child process '%s': %s", argv[0], g_strerror (ret));
+        if (in_fd)
+            close (in_pipe[1]);
+        close (out_pipe[0]);
+        close (err_pipe[0]);
+        return FALSE;
+    }
+
+    if (in_fd)
+        *in_fd = in_pipe[1];
+    *out_fd = out_pipe[0];
+    *err_fd = err_pipe[0];
+
+    return TRUE;
+}
+#else
+/**
+ * spawn_with_pipes: (skip)
+ *
+ * Fallback for systems without posix_spawn_file_actions_addclosefrom_np()
+ * (glibc < 2.34), GLib takes care of closing the file descriptors.
+ */
+static gboolean spawn_with_pipes (const gchar **argv, GPid *pid, gint *in_fd, gint *out_fd, gint *err_fd, GError **error) {
+    ExecEnv *env = NULL;
+    gboolean ret = FALSE;
+
+    env = exec_env_get ();
+    ret = g_spawn_async_with_pipes (NULL, (gchar **) argv, env->env,
+                                    G_SPAWN_DEFAULT|G_SPAWN_SEARCH_PATH|G_SPAWN_DO_NOT_REAP_CHILD,
+                                    NULL, NULL, pid, in_fd, out_fd, err_fd, error);
+    exec_env_unref (env);
+
+    return ret;
+}
+#endif
+
+/**
+ * read_pipes: (skip)
+ *
+ * Reads everything from @out_fd and @err_fd until EOF (or until @cancellable
+ * is cancelled or @deadline is reached) and closes them.
+ */
+static gboolean read_pipes (gint out_fd, gint err_fd, GCancellable *cancellable, gint64 deadline,
+                            gchar **stdout_data, gchar **stderr_data, GError **error) {
+    struct pollfd fds[3] = { ZERO_INIT, ZERO_INIT, ZERO_INIT };
+    GString *data[2] = { NULL, NULL };
+    gchar buf[_EXEC_BUF_SIZE];
+    ssize_t num_read = 0;
+    guint n_open = 2;
+    gboolean success = TRUE;
+    guint i = 0;
+
+    fds[0].fd = out_fd;
+    fds[1].fd = err_fd;
+    fds[2].fd = cancellable ? g_cancellable_get_fd (cancellable) : -1;
+    fds[0].events = POLLIN;
+    fds[1].events = POLLIN;
+    fds[2].events = POLLIN;
+    data[0] = g_string_new (NULL);
+    data[1] = g_string_new (NULL);
+
+    while (success && n_open > 0) {
+        if (poll_with_deadline (fds, 3, cancellable, deadline, error) < 0) {
+            success = FALSE;
+            break;
+        }
+
+        for (i=0; i < 2; i++) {
+            /* negative FDs are ignored by poll() */
+            if (fds[i].fd < 0 || fds[i].revents == 0)
+                continue;
+
+            num_read = read (fds[i].fd, buf, _EXEC_BUF_SIZE);
+            if (num_read > 0)
+                g_string_append_len (data[i], buf, num_read);
+            else if (num_read == 0) {
+                close (fds[i].fd);
+                fds[i].fd = -1;
+                n_open--;
+            } else if (errno != EAGAIN && errno != EINTR) {
+                g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                             "Error reading from pipe: %m");
+                success = FALSE;
+                break;
+            }
+        }
+    }
+
+    for (i=0; i < 2; i++)
+        if (fds[i].fd >= 0)
+            close (fds[i].fd);
+    if (cancellable)
+        g_cancellable_release_fd (cancellable);
+
+    *stdout_data = g_string_free (data[0], !success);
+    *stderr_data = g_string_free (data[1], !success);
+
+    return success;
+}
+
+/**
+ * build_args: (skip)
+ *
+ * Returns: (transfer container): @argv with @extra appended or %NULL if there
+ *                                are no @extra arguments
+ */
+static const gchar** build_args (const gchar **argv, const BDExtraArg **extra) {
+    const gchar **args = NULL;
+    guint args_len = 0;
+    const gchar **arg_p = NULL;
+    const BDExtraArg **extra_p = NULL;
+    guint i = 0;
+
+    if (!extra)
+        return NULL;
+
+    args_len = g_strv_length ((gchar **) argv);
+    for (extra_p=extra; *extra_p; extra_p++) {
+        if ((*extra_p)->opt && (g_strcmp0 ((*extra_p)->opt, "") != 0))
+            args_len++;
+        if ((*extra_p)->val && (g_strcmp0 ((*extra_p)->val, "") != 0))
+            args_len++;
+    }
+    args = g_new0 (const gchar*, args_len + 1);
+    for (arg_p=argv; *arg_p; arg_p++, i++)
+        args[i] = *arg_p;
+    for (extra_p=extra; *extra_p; extra_p++) {
+        if ((*extra_p)->opt && (g_strcmp0 ((*extra_p)->opt, "") != 0)) {
+            args[i] = (*extra_p)->opt;
+            i++;
+        }
+        if ((*extra_p)->val && (g_strcmp0 ((*extra_p)->val, "") != 0)) {
+            args[i] = (*extra_p)->val;
+            i++;
+        }
+    }
+    args[i] = NULL;
+
+    return args;
+}
+
 /**
  * bd_utils_exec_and_report_error:
  * @argv: (array zero-terminated=1): the argv array for the call
@@ -178,56 +855,48 @@ gboolean bd_utils_exec_and_report_status_error (const gchar **argv, const BDExtr
     gchar *stderr_data = NULL;
     guint64 task_id = 0;
     const gchar **args = NULL;
-    guint args_len = 0;
-    const gchar **arg_p = NULL;
-    const BDExtraArg **extra_p = NULL;
     gint exit_status = 0;
-    guint i = 0;
-    gchar **old_env = NULL;
-    gchar **new_env = NULL;
+    GPid pid = 0;
+    gint out_fd = -1;
+    gint err_fd = -1;
+    pid_t child_ret = 0;
+    gint64 stats_start = 0;
+    gint64 spawned = 0;
     GError *l_error = NULL;
 
-    if (extra) {
-        args_len = g_strv_length ((gchar **) argv);
-        for (extra_p=extra; *extra_p; extra_p++) {
-            if ((*extra_p)->opt && (g_strcmp0 ((*extra_p)->opt, "") != 0))
-                args_len++;
-            if ((*extra_p)->val && (g_strcmp0 ((*extra_p)->val, "") != 0))
-                args_len++;
-        }
-        args = g_new0 (const gchar*, args_len + 1);
-        for (arg_p=argv; *arg_p; arg_p++, i++)
-            args[i] = *arg_p;
-        for (extra_p=extra; *extra_p; extra_p++) {
-            if ((*extra_p)->opt && (g_strcmp0 ((*extra_p)->opt, "") != 0)) {
-                args[i] = (*extra_p)->opt;
-                i++;
-            }
-            if ((*extra_p)->val && (g_strcmp0 ((*extra_p)->val, "") != 0)) {
-                args[i] = (*extra_p)->val;
-                i++;
-            }
-        }
-        args[i] = NULL;
-    }
-
-    old_env = g_get_environ ();
-    new_env = g_environ_setenv (old_env, "LC_ALL", "C", TRUE);
+    args = build_args (argv, extra);
 
     task_id = log_running (args ? args : argv);
-    success = g_spawn_sync (NULL, args ? (gchar **) args : (gchar **) argv, new_env, G_SPAWN_SEARCH_PATH,
-                            NULL, NULL, &stdout_data, &stderr_data, &exit_status, error);
+    stats_start = exec_stats_start ();
+    if (!spawn_with_pipes (args ? args : argv, &pid, NULL, &out_fd, &err_fd, error)) {
+        /* error is already populated */
+        exec_stats_record (args ? args : argv, stats_start, 0, 0, 0, FALSE);
+        g_free (args);
+        return FALSE;
+    }
+    spawned = g_get_monotonic_time ();
+
+    success = read_pipes (out_fd, err_fd, thread_cancellable, thread_deadline, &stdout_data, &stderr_data, error);
     if (!success) {
-        /* error is already populated from the call */
-        g_strfreev (new_env);
-        g_free (stdout_data);
-        g_free (stderr_data);
+        /* error is already populated, don't leave the (possibly hanging) child behind */
+        terminate_child (pid, &exit_status);
+        exec_stats_record (args ? args : argv, stats_start, spawned, 0, 0, FALSE);
+        g_free (args);
         return FALSE;
     }
-    g_strfreev (new_env);
 
-    /* g_spawn_sync set the status in the same way waitpid() does, we need
-       to get the process exit code manually (this is similar to calling
+    do
+        child_ret = waitpid (pid, &exit_status, 0);
+    while (child_ret < 0 && errno == EINTR);
+    if (child_ret < 0 && errno == ECHILD) {
+        /* no such process (somebody else reaped the child) */
+        errno = 0;
+        exit_status = 0;
+    }
+    exec_stats_record (args ? args : argv, stats_start, spawned, strlen (stdout_data), strlen (stderr_data),
+                       WIFEXITED (exit_status) && WEXITSTATUS (exit_status) == 0);
+
+    /* we need to get the process exit code from the waitpid() status manually (this is similar to calling
        WEXITSTATUS but also sets the error for terminated processes */
 
     #if !GLIB_CHECK_VERSION(2, 69, 0)
@@ -273,9 +942,6 @@ gboolean bd_utils_exec_and_report_status_error (const gchar **argv, const BDExtr
 }
 
 
-/* buffer size in bytes used to read from stdout and stderr */
-#define _EXEC_BUF_SIZE 64*1024
-
 /* similar to g_strstr_len() yet treats 'null' byte as @needle. */
 static gchar *bd_strchr_len_null (const gchar *haystack, gssize haystack_len, const gchar needle) {
     gchar *ret;
@@ -354,12 +1020,10 @@ _process_fd_event (gint fd, struct pollfd *poll_fd, GString *read_buffer, GStrin
     return TRUE;
 }
 
-static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, const gchar *input, gint *proc_status, gchar **stdout, gchar **stderr, GError **error) {
+static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, const gchar *input,
+                                                 GCancellable *cancellable, gint64 deadline, gint *proc_status, gchar **stdout, gchar **stderr, GError **error) {
     const gchar **args = NULL;
-    guint args_len = 0;
-    const gchar **arg_p = NULL;
     gchar *args_str = NULL;
-    const BDExtraArg **extra_p = NULL;
     guint64 task_id = 0;
     guint64 progress_id = 0;
     gchar *msg = NULL;
@@ -371,9 +1035,8 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
     gint status = 0;
     gboolean ret = FALSE;
     gint poll_status = 0;
-    guint i = 0;
     guint8 completion = 0;
-    struct pollfd fds[2] = { ZERO_INIT, ZERO_INIT };
+    struct pollfd fds[3] = { ZERO_INIT, ZERO_INIT, ZERO_INIT };
     int flags;
     gboolean out_done = FALSE;
     gboolean err_done = FALSE;
@@ -383,52 +1046,30 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
     GString *stderr_buffer;
     gsize stdout_buffer_pos = 0;
     gsize stderr_buffer_pos = 0;
-    gchar **old_env = NULL;
-    gchar **new_env = NULL;
     gboolean success = TRUE;
+    gint64 stats_start = 0;
+    gint64 spawned = 0;
     GError *l_error = NULL;
 
-    /* TODO: share this code between functions */
-    if (extra) {
-        args_len = g_strv_length ((gchar **) argv);
-        for (extra_p=extra; *extra_p; extra_p++) {
-            if ((*extra_p)->opt && (g_strcmp0 ((*extra_p)->opt, "") != 0))
-                args_len++;
-            if ((*extra_p)->val && (g_strcmp0 ((*extra_p)->val, "") != 0))
-                args_len++;
-        }
-        args = g_new0 (const gchar*, args_len + 1);
-        for (arg_p=argv; *arg_p; arg_p++, i++)
-            args[i] = *arg_p;
-        for (extra_p=extra; *extra_p; extra_p++) {
-            if ((*extra_p)->opt && (g_strcmp0 ((*extra_p)->opt, "") != 0)) {
-                args[i] = (*extra_p)->opt;
-                i++;
-            }
-            if ((*extra_p)->val && (g_strcmp0 ((*extra_p)->val, "") != 0)) {
-                args[i] = (*extra_p)->val;
-                i++;
-            }
-        }
-        args[i] = NULL;
-    }
-
-    task_id = log_running (args ? args : argv);
+    args = build_args (argv, extra);
 
-    old_env = g_get_environ ();
-    new_env = g_environ_setenv (old_env, "LC_ALL", "C", TRUE);
+    /* utilities run by the plugins are limited by the thread's settings */
+    if (!cancellable)
+        cancellable = thread_cancellable;
+    if (deadline == 0)
+        deadline = thread_deadline;
 
-    ret = g_spawn_async_with_pipes (NULL, args ? (gchar**) args : (gchar**) argv, new_env,
-                                    G_SPAWN_DEFAULT|G_SPAWN_SEARCH_PATH|G_SPAWN_DO_NOT_REAP_CHILD,
-                                    NULL, NULL, &pid, input ? &in_fd : NULL, &out_fd, &err_fd, error);
-
-    g_strfreev (new_env);
+    task_id = log_running (args ? args : argv);
 
+    stats_start = exec_stats_start ();
+    ret = spawn_with_pipes (args ? args : argv, &pid, input ? &in_fd : NULL, &out_fd, &err_fd, error);
     if (!ret) {
         /* error is already populated */
+        exec_stats_record (argv, stats_start, 0, 0, 0, FALSE);
         g_free (args);
         return FALSE;
     }
+    spawned = g_get_monotonic_time ();
 
     args_str = g_strjoinv (" ", args ? (gchar **) args : (gchar **) argv);
     msg = g_strdup_printf ("Started '%s'", args_str);
@@ -460,6 +1101,7 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
                          "Failed to write to stdin of the process: %m");
             bd_utils_report_finished (progress_id, l_error->message);
             g_propagate_error (error, l_error);
+            exec_stats_record (argv, stats_start, spawned, 0, 0, FALSE);
             /* would overwrite errno, need to close as a last step */
             close (in_fd);
             return FALSE;
@@ -475,16 +1117,15 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
 
     fds[0].fd = out_fd;
     fds[1].fd = err_fd;
+    fds[2].fd = cancellable ? g_cancellable_get_fd (cancellable) : -1;
     fds[0].events = POLLIN | POLLHUP | POLLERR;
     fds[1].events = POLLIN | POLLHUP | POLLERR;
+    fds[2].events = POLLIN;
     while (! (out_done && err_done)) {
-        poll_status = poll (fds, 2, -1 /* timeout */);
-        g_warn_if_fail (poll_status != 0);  /* no timeout specified, zero should never be returned */
+        poll_status = poll_with_deadline (fds, 3, cancellable, deadline, &l_error);
+        if (poll_status == 0)
+            continue;
         if (poll_status < 0) {
-            if (errno == EAGAIN || errno == EINTR)
-                continue;
-            g_set_error (&l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
-                         "Failed to poll output FDs: %m");
             bd_utils_report_finished (progress_id, l_error->message);
             g_propagate_error (error, l_error);
             success = FALSE;
@@ -514,8 +1155,14 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
     g_string_free (stderr_buffer, TRUE);
     close (out_fd);
     close (err_fd);
+    if (cancellable)
+        g_cancellable_release_fd (cancellable);
 
-    child_ret = waitpid (pid, &status, 0);
+    if (success)
+        child_ret = waitpid (pid, &status, 0);
+    else
+        /* don't leave the (possibly hanging) child behind */
+        terminate_child (pid, &status);
     *proc_status = WEXITSTATUS (status);
     if (success) {
         if (child_ret > 0) {
@@ -549,6 +1196,7 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
         if (success)
             bd_utils_report_finished (progress_id, "Completed");
     }
+    exec_stats_record (argv, stats_start, spawned, stdout_data->len, stderr_data->len, success);
     log_out (task_id, stdout_data->str, stderr_data->str);
     log_done (task_id, *proc_status);
 
@@ -579,7 +1227,7 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
  * Returns: whether the @argv was successfully executed (no error and exit code 0) or not
  */
 gboolean bd_utils_exec_and_report_progress (const gchar **argv, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, gint *proc_status, GError **error) {
-    return _utils_exec_and_report_progress (argv, extra, prog_extract, NULL, proc_status, NULL, NULL, error);
+    return _utils_exec_and_report_progress (argv, extra, prog_extract, NULL, NULL, 0, proc_status, NULL, NULL, error);
 }
 
 /**
@@ -595,28 +1243,16 @@ gboolean bd_utils_exec_with_input (const gchar **argv, const gchar *input, const
     gint status = 0;
     /* just use the "stronger" function providing dumb progress reporting (just
        'started' and 'finished') and throw away the returned status */
-    return _utils_exec_and_report_progress (argv, extra, NULL, input, &status, NULL, NULL, error);
+    return _utils_exec_and_report_progress (argv, extra, NULL, input, NULL, 0, &status, NULL, NULL, error);
 }
 
-/**
- * bd_utils_exec_and_capture_output:
- * @argv: (array zero-terminated=1): the argv array for the call
- * @extra: (allow-none) (array zero-terminated=1): extra arguments
- * @output: (out): variable to store output to
- * @error: (out) (allow-none): place to store error (if any)
- *
- * Note that any NULL bytes read from standard output and standard error
- * output will be discarded.
- *
- * Returns: whether the @argv was successfully executed capturing the output or not
- */
-gboolean bd_utils_exec_and_capture_output (const gchar **argv, const BDExtraArg **extra, gchar **output, GError **error) {
+static gboolean _utils_exec_and_capture_output (const gchar **argv, const BDExtraArg **extra, GCancellable *cancellable, gint64 deadline, gchar **output, GError **error) {
     gint status = 0;
     gchar *stdout = NULL;
     gchar *stderr = NULL;
     gboolean ret = FALSE;
 
-    ret = _utils_exec_and_report_progress (argv, extra, NULL, NULL, &status, &stdout, &stderr, error);
+    ret = _utils_exec_and_report_progress (argv, extra, NULL, NULL, cancellable, deadline, &status, &stdout, &stderr, error);
     if (!ret)
         return ret;
 
@@ -640,6 +1276,432 @@ gboolean bd_utils_exec_and_capture_output (const gchar **argv, const BDExtraArg
     }
 }
 
+/**
+ * bd_utils_exec_and_capture_output:
+ * @argv: (array zero-terminated=1): the argv array for the call
+ * @extra: (allow-none) (array zero-terminated=1): extra arguments
+ * @output: (out): variable to store output to
+ * @error: (out) (allow-none): place to store error (if any)
+ *
+ * Note that any NULL bytes read from standard output and standard error
+ * output will be discarded.
+ *
+ * Returns: whether the @argv was successfully executed capturing the output or not
+ */
+gboolean bd_utils_exec_and_capture_output (const gchar **argv, const BDExtraArg **extra, gchar **output, GError **error) {
+    return _utils_exec_and_capture_output (argv, extra, NULL, 0, output, error);
+}
+
+/**
+ * bd_utils_exec_and_report_error_cancellable:
+ * @argv: (array zero-terminated=1): the argv array for the call
+ * @extra: (allow-none) (array zero-terminated=1): extra arguments
+ * @cancellable: (allow-none): a #GCancellable to stop the process with or %NULL
+ * @deadline: monotonic time (see g_get_monotonic_time()) by which the process
+ *            has to finish or 0 for no deadline
+ * @error: (out) (allow-none): place to store error (if any)
+ *
+ * The same as bd_utils_exec_and_report_error() except that if @cancellable is
+ * cancelled or @deadline is reached, the process is terminated (with %SIGTERM
+ * and %SIGKILL if that doesn't help) and %G_IO_ERROR_CANCELLED or
+ * %BD_UTILS_EXEC_ERROR_TIMED_OUT is reported.
+ *
+ * Returns: whether the @argv was successfully executed (no error and exit code 0) or not
+ */
+gboolean bd_utils_exec_and_report_error_cancellable (const gchar **argv, const BDExtraArg **extra, GCancellable *cancellable, gint64 deadline, GError **error) {
+    gint status = 0;
+    return _utils_exec_and_report_progress (argv, extra, NULL, NULL, cancellable, deadline, &status, NULL, NULL, error);
+}
+
+/**
+ * bd_utils_exec_and_capture_output_cancellable:
+ * @argv: (array zero-terminated=1): the argv array for the call
+ * @extra: (allow-none) (array zero-terminated=1): extra arguments
+ * @cancellable: (allow-none): a #GCancellable to stop the process with or %NULL
+ * @deadline: monotonic time (see g_get_monotonic_time()) by which the process
+ *            has to finish or 0 for no deadline
+ * @output: (out): variable to store output to
+ * @error: (out) (allow-none): place to store error (if any)
+ *
+ * The same as bd_utils_exec_and_capture_output() except that the process can
+ * be stopped with @cancellable or by @deadline, see
+ * bd_utils_exec_and_report_error_cancellable().
+ *
+ * Returns: whether the @argv was successfully executed capturing the output or not
+ */
+gboolean bd_utils_exec_and_capture_output_cancellable (const gchar **argv, const BDExtraArg **extra, GCancellable *cancellable, gint64 deadline, gchar **output, GError **error) {
+    return _utils_exec_and_capture_output (argv, extra, cancellable, deadline, output, error);
+}
+
+/**
+ * read_lines: (skip)
+ *
+ * Reads one chunk of data from @fd and passes all the complete lines (without
+ * the trailing newline) to @line_func, the rest is kept in @buffer for the
+ * next call. The remaining incomplete line is passed to @line_func at EOF.
+ * The number of bytes read is added to @n_read.
+ */
+static gboolean read_lines (gint fd, GString *buffer, BDUtilsLineFunc line_func, gpointer user_data, guint64 *n_read, gboolean *done, GError **error) {
+    gchar buf[_EXEC_BUF_SIZE];
+    ssize_t num_read = 0;
+    gchar *line = NULL;
+    gchar *newline = NULL;
+
+    num_read = read (fd, buf, _EXEC_BUF_SIZE);
+    if (num_read < 0) {
+        if (errno == EAGAIN || errno == EINTR)
+            return TRUE;
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Error reading from pipe: %m");
+        return FALSE;
+    }
+
+    if (num_read == 0) {
+        *done = TRUE;
+        if (buffer->len > 0 && !line_func (buffer->str, user_data)) {
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Processing of the output stopped");
+            return FALSE;
+        }
+        g_string_truncate (buffer, 0);
+        return TRUE;
+    }
+
+    *n_read += num_read;
+    g_string_append_len (buffer, buf, num_read);
+    line = buffer->str;
+    while ((newline = memchr (line, '\n', buffer->len - (line - buffer->str)))) {
+        *newline = '\0';
+        if (!line_func (line, user_data)) {
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Processing of the output stopped");
+            return FALSE;
+        }
+        line = newline + 1;
+    }
+    g_string_erase (buffer, 0, line - buffer->str);
+
+    return TRUE;
+}
+
+/**
+ * read_capped: (skip)
+ *
+ * Reads one chunk of data from @fd into @buffer keeping only the last
+ * @max_size bytes (unless @max_size is 0). The number of bytes read is added
+ * to @n_read.
+ */
+static gboolean read_capped (gint fd, GString *buffer, gsize max_size, guint64 *n_read, gboolean *done, GError **error) {
+    gchar buf[_EXEC_BUF_SIZE];
+    ssize_t num_read = 0;
+
+    num_read = read (fd, buf, _EXEC_BUF_SIZE);
+    if (num_read < 0) {
+        if (errno == EAGAIN || errno == EINTR)
+            return TRUE;
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Error reading from pipe: %m");
+        return FALSE;
+    }
+
+    if (num_read == 0) {
+        *done = TRUE;
+        return TRUE;
+    }
+
+    *n_read += num_read;
+    g_string_append_len (buffer, buf, num_read);
+    if (max_size > 0 && buffer->len > max_size)
+        g_string_erase (buffer, 0, buffer->len - max_size);
+
+    return TRUE;
+}
+
+/**
+ * bd_utils_exec_and_process_lines:
+ * @argv: (array zero-terminated=1): the argv array for the call
+ * @extra: (allow-none) (array zero-terminated=1): extra arguments
+ * @line_func: (scope call): function to call for every line of the standard output
+ * @user_data: (closure): data for @line_func
+ * @max_stderr: maximum number of bytes of the standard error output to keep
+ *              (the last ones are kept) or 0 for no limit
+ * @error: (out) (allow-none): place to store error (if any)
+ *
+ * Runs @argv and passes the lines of its standard output to @line_func as
+ * they arrive instead of collecting the whole output in memory. The standard
+ * error output is collected (up to @max_stderr bytes) and used in the error
+ * message in case the process fails. If @line_func returns %FALSE, the process
+ * is terminated and an error is reported (callers that need details should
+ * store them in @user_data).
+ *
+ * Returns: whether the @argv was successfully executed (no error and exit code 0)
+ *          and all its output was processed or not
+ */
+gboolean bd_utils_exec_and_process_lines (const gchar **argv, const BDExtraArg **extra, BDUtilsLineFunc line_func, gpointer user_data,
+                                          gsize max_stderr, GError **error) {
+    const gchar **args = NULL;
+    gchar *args_str = NULL;
+    gchar *msg = NULL;
+    guint64 task_id = 0;
+    guint64 progress_id = 0;
+    GPid pid = 0;
+    gint out_fd = -1;
+    gint err_fd = -1;
+    struct pollfd fds[3] = { ZERO_INIT, ZERO_INIT, ZERO_INIT };
+    gboolean out_done = FALSE;
+    gboolean err_done = FALSE;
+    GString *stdout_buffer = NULL;
+    GString *stderr_data = NULL;
+    gint poll_status = 0;
+    gint status = 0;
+    gint exit_code = 0;
+    pid_t child_ret = 0;
+    gboolean success = TRUE;
+    gint64 stats_start = 0;
+    gint64 spawned = 0;
+    guint64 stdout_bytes = 0;
+    guint64 stderr_bytes = 0;
+    GError *l_error = NULL;
+
+    args = build_args (argv, extra);
+    task_id = log_running (args ? args : argv);
+
+    stats_start = exec_stats_start ();
+    if (!spawn_with_pipes (args ? args : argv, &pid, NULL, &out_fd, &err_fd, error)) {
+        /* error is already populated */
+        exec_stats_record (argv, stats_start, 0, 0, 0, FALSE);
+        g_free (args);
+        return FALSE;
+    }
+    spawned = g_get_monotonic_time ();
+
+    args_str = g_strjoinv (" ", args ? (gchar **) args : (gchar **) argv);
+    msg = g_strdup_printf ("Started '%s'", args_str);
+    progress_id = bd_utils_report_started (msg);
+    g_free (args_str);
+    g_free (args);
+    g_free (msg);
+
+    stdout_buffer = g_string_new (NULL);
+    stderr_data = g_string_new (NULL);
+
+    fds[0].fd = out_fd;
+    fds[1].fd = err_fd;
+    fds[2].fd = thread_cancellable ? g_cancellable_get_fd (thread_cancellable) : -1;
+    fds[0].events = POLLIN;
+    fds[1].events = POLLIN;
+    fds[2].events = POLLIN;
+    while (!(out_done && err_done)) {
+        poll_status = poll_with_deadline (fds, 3, thread_cancellable, thread_deadline, &l_error);
+        if (poll_status == 0)
+            continue;
+        if (poll_status < 0) {
+            success = FALSE;
+            break;
+        }
+
+        if (!out_done && fds[0].revents) {
+            if (!read_lines (out_fd, stdout_buffer, line_func, user_data, &stdout_bytes, &out_done, &l_error)) {
+                success = FALSE;
+                break;
+            }
+            /* stop polling the closed pipe */
+            if (out_done)
+                fds[0].fd = -1;
+        }
+
+        if (!err_done && fds[1].revents) {
+            if (!read_capped (err_fd, stderr_data, max_stderr, &stderr_bytes, &err_done, &l_error)) {
+                success = FALSE;
+                break;
+            }
+            if (err_done)
+                fds[1].fd = -1;
+        }
+    }
+
+    g_string_free (stdout_buffer, TRUE);
+    close (out_fd);
+    close (err_fd);
+    if (thread_cancellable)
+        g_cancellable_release_fd (thread_cancellable);
+
+    if (success) {
+        do
+            child_ret = waitpid (pid, &status, 0);
+        while (child_ret < 0 && errno == EINTR);
+        if (child_ret < 0 && errno == ECHILD) {
+            /* no such process (somebody else reaped the child) */
+            errno = 0;
+            status = 0;
+        }
+    } else
+        /* don't leave the (possibly still running) child behind */
+        terminate_child (pid, &status);
+
+    exit_code = WIFEXITED (status) ? WEXITSTATUS (status) : -1;
+    if (success) {
+        if (WIFSIGNALED (status)) {
+            g_set_error (&l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Process killed with a signal");
+            success = FALSE;
+        } else if (exit_code != 0) {
+            g_set_error (&l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Process reported exit code %d: %s", exit_code, stderr_data->str);
+            success = FALSE;
+        }
+    }
+
+    exec_stats_record (argv, stats_start, spawned, stdout_bytes, stderr_bytes, success);
+    log_out (task_id, "<processed line by line>", stderr_data->str);
+    log_done (task_id, exit_code);
+    g_string_free (stderr_data, TRUE);
+
+    if (success)
+        bd_utils_report_finished (progress_id, "Completed");
+    else {
+        bd_utils_report_finished (progress_id, l_error->message);
+        g_propagate_error (error, l_error);
+    }
+
+    return success;
+}
+
+typedef struct ExecAsyncData {
+    gchar **argv;
+    BDExtraArg **extra;
+    gint64 deadline;
+} ExecAsyncData;
+
+static void exec_async_data_free (ExecAsyncData *data) {
+    BDExtraArg **extra_p = NULL;
+
+    g_strfreev (data->argv);
+    if (data->extra) {
+        for (extra_p=data->extra; *extra_p; extra_p++)
+            bd_extra_arg_free (*extra_p);
+        g_free (data->extra);
+    }
+    g_free (data);
+}
+
+static void exec_async_thread (GTask *task, gpointer source_object __attribute__((unused)), gpointer task_data, GCancellable *cancellable) {
+    ExecAsyncData *data = task_data;
+    gint status = 0;
+    gchar *stdout = NULL;
+    gchar *stderr = NULL;
+    GError *l_error = NULL;
+
+    if (!_utils_exec_and_report_progress ((const gchar **) data->argv, (const BDExtraArg **) data->extra, NULL, NULL,
+                                          cancellable, data->deadline, &status, &stdout, &stderr, &l_error)) {
+        g_task_return_error (task, l_error);
+        return;
+    }
+
+    g_free (stderr);
+    g_task_return_pointer (task, stdout, g_free);
+}
+
+/**
+ * bd_utils_exec_async:
+ * @argv: (array zero-terminated=1): the argv array for the call
+ * @extra: (allow-none) (array zero-terminated=1): extra arguments
+ * @deadline: monotonic time (see g_get_monotonic_time()) by which the process
+ *            has to finish or 0 for no deadline
+ * @cancellable: (allow-none): a #GCancellable to stop the process with or %NULL
+ * @callback: (scope async): callback to call when the process finishes
+ * @user_data: (closure): data for @callback
+ *
+ * Runs @argv in a worker thread without blocking the caller. @callback is
+ * called in the thread-default main context of the caller once the process
+ * finishes, use bd_utils_exec_finish() in it to get the result. See
+ * bd_utils_exec_and_report_error_cancellable() for @cancellable and @deadline.
+ */
+void bd_utils_exec_async (const gchar **argv, const BDExtraArg **extra, gint64 deadline, GCancellable *cancellable,
+                          GAsyncReadyCallback callback, gpointer user_data) {
+    GTask *task = NULL;
+    ExecAsyncData *data = NULL;
+    const BDExtraArg **extra_p = NULL;
+    guint n_extra = 0;
+    guint i = 0;
+
+    data = g_new0 (ExecAsyncData, 1);
+    data->argv = g_strdupv ((gchar **) argv);
+    if (extra) {
+        for (extra_p=extra; *extra_p; extra_p++)
+            n_extra++;
+        data->extra = g_new0 (BDExtraArg*, n_extra + 1);
+        for (i=0; i < n_extra; i++)
+            data->extra[i] = bd_extra_arg_copy ((BDExtraArg *) extra[i]);
+    }
+    data->deadline = deadline;
+
+    task = g_task_new (NULL, cancellable, callback, user_data);
+    g_task_set_source_tag (task, bd_utils_exec_async);
+    g_task_set_task_data (task, data, (GDestroyNotify) exec_async_data_free);
+    g_task_run_in_thread (task, exec_async_thread);
+    g_object_unref (task);
+}
+
+/**
+ * bd_utils_exec_finish:
+ * @result: a #GAsyncResult passed to the callback of bd_utils_exec_async()
+ * @output: (out) (optional) (transfer full): place to store the standard output of the process
+ * @error: (out) (allow-none): place to store error (if any)
+ *
+ * Returns: whether the process started by bd_utils_exec_async() was successfully
+ *          executed (no error and exit code 0) or not
+ */
+gboolean bd_utils_exec_finish (GAsyncResult *result, gchar **output, GError **error) {
+    gchar *stdout = NULL;
+
+    g_return_val_if_fail (g_task_is_valid (result, NULL), FALSE);
+
+    stdout = g_task_propagate_pointer (G_TASK (result), error);
+    if (!stdout)
+        return FALSE;
+
+    if (output)
+        *output = stdout;
+    else
+        g_free (stdout);
+
+    return TRUE;
+}
+
+/**
+ * bd_utils_set_thread_cancellable:
+ * @cancellable: (allow-none): a #GCancellable to stop the utilities with or %NULL
+ * @deadline: monotonic time (see g_get_monotonic_time()) by which the utilities
+ *            have to finish or 0 for no deadline
+ *
+ * Sets @cancellable and @deadline for all the utilities executed in the current
+ * thread, including the ones run by the plugins for their (potentially
+ * long-running) operations. Use %NULL and 0 to reset.
+ */
+void bd_utils_set_thread_cancellable (GCancellable *cancellable, gint64 deadline) {
+    g_clear_object (&thread_cancellable);
+    if (cancellable)
+        thread_cancellable = g_object_ref (cancellable);
+    thread_deadline = deadline;
+}
+
+/**
+ * bd_utils_get_thread_cancellable: (skip)
+ * @deadline: (out) (allow-none): place to store the deadline set for the current thread
+ *
+ * Returns: (transfer none) (nullable): the #GCancellable set for the current
+ *          thread with bd_utils_set_thread_cancellable() (if any)
+ *
+ * For the plugins that run the utilities in other ways than with the
+ * bd_utils_exec_* functions.
+ */
+GCancellable* bd_utils_get_thread_cancellable (gint64 *deadline) {
+    if (deadline)
+        *deadline = thread_deadline;
+    return thread_cancellable;
+}
+
 /**
  * bd_utils_version_cmp:
  * @ver_string1: first version string
@@ -1,4 +1,5 @@
 #include <glib.h>
+#include <gio/gio.h>
 #include "extra_arg.h"
 
 #ifndef BD_UTILS_EXEC
@@ -48,6 +49,22 @@ typedef void (*BDUtilsProgFunc) (guint64 task_id, BDUtilsProgStatus status, guin
  */
 typedef gboolean (*BDUtilsProgExtract) (const gchar *line, guint8 *completion);
 
+/**
+ * BDUtilsLineFunc:
+ * @line: line of the standard output of the executed process (without the newline character)
+ * @user_data: (closure): user data passed to bd_utils_exec_and_process_lines()
+ *
+ * Callback function used to process the standard output of a spawned command
+ * line by line as it arrives. The @line is only valid during the call.
+ *
+ * Returns: whether to continue processing the output or not (in which case
+ *          the command is terminated)
+ */
+typedef gboolean (*BDUtilsLineFunc) (const gchar *line, gpointer user_data);
+
+/* default limit for the standard error output kept by bd_utils_exec_and_process_lines() */
+#define BD_UTILS_EXEC_DEFAULT_MAX_STDERR (64 * 1024)
+
 GQuark bd_utils_exec_error_quark (void);
 #define BD_UTILS_EXEC_ERROR bd_utils_exec_error_quark ()
 typedef enum {
@@ -60,6 +77,7 @@ typedef enum {
     BD_UTILS_EXEC_ERROR_UTIL_CHECK_ERROR,
     BD_UTILS_EXEC_ERROR_UTIL_FEATURE_CHECK_ERROR,
     BD_UTILS_EXEC_ERROR_UTIL_FEATURE_UNAVAILABLE,
+    BD_UTILS_EXEC_ERROR_TIMED_OUT,
 } BDUtilsExecError;
 
 gboolean bd_utils_exec_and_report_error (const gchar **argv, const BDExtraArg **extra, GError **error);
@@ -68,6 +86,15 @@ gboolean bd_utils_exec_and_report_status_error (const gchar **argv, const BDExtr
 gboolean bd_utils_exec_and_capture_output (const gchar **argv, const BDExtraArg **extra, gchar **output, GError **error);
 gboolean bd_utils_exec_and_report_progress (const gchar **argv, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, gint *proc_status, GError **error);
 gboolean bd_utils_exec_with_input (const gchar **argv, const gchar *input, const BDExtraArg **extra, GError **error);
+gboolean bd_utils_exec_and_report_error_cancellable (const gchar **argv, const BDExtraArg **extra, GCancellable *cancellable, gint64 deadline, GError **error);
+gboolean bd_utils_exec_and_capture_output_cancellable (const gchar **argv, const BDExtraArg **extra, GCancellable *cancellable, gint64 deadline, gchar **output, GError **error);
+gboolean bd_utils_exec_and_process_lines (const gchar **argv, const BDExtraArg **extra, BDUtilsLineFunc line_func, gpointer user_data,
+                                          gsize max_stderr, GError **error);
+void bd_utils_exec_async (const gchar **argv, const BDExtraArg **extra, gint64 deadline, GCancellable *cancellable,
+                          GAsyncReadyCallback callback, gpointer user_data);
+gboolean bd_utils_exec_finish (GAsyncResult *result, gchar **output, GError **error);
+void bd_utils_set_thread_cancellable (GCancellable *cancellable, gint64 deadline);
+GCancellable* bd_utils_get_thread_cancellable (gint64 *deadline);
 gint bd_utils_version_cmp (const gchar *ver_string1, const gchar *ver_string2, GError **error);
 gboolean bd_utils_check_util_version (const gchar *util, const gchar *version, const gchar *version_arg, const gchar *version_regexp, GError **error);
 
@@ -82,6 +109,45 @@ void bd_utils_report_finished (guint64 task_id, const gchar *msg);
 guint64 bd_utils_get_next_task_id (void);
 void bd_utils_log_task_status (guint64 task_id, const gchar *msg);
 
+/**
+ * BDUtilsExecStats:
+ * @util: name of the utility (basename of the executable)
+ * @calls: number of executions
+ * @failures: number of failed executions (including failures to start the utility)
+ * @total_time: total run time (in microseconds)
+ * @max_time: maximum run time (in microseconds)
+ * @time_p50: median of the run time (in microseconds, estimated)
+ * @time_p90: 90th percentile of the run time (in microseconds, estimated)
+ * @time_p99: 99th percentile of the run time (in microseconds, estimated)
+ * @total_spawn_time: total time spent starting the utility (in microseconds)
+ * @stdout_bytes: total number of bytes read from the standard output
+ * @stderr_bytes: total number of bytes read from the standard error output
+ */
+typedef struct BDUtilsExecStats {
+    gchar *util;
+    guint64 calls;
+    guint64 failures;
+    guint64 total_time;
+    guint64 max_time;
+    guint64 time_p50;
+    guint64 time_p90;
+    guint64 time_p99;
+    guint64 total_spawn_time;
+    guint64 stdout_bytes;
+    guint64 stderr_bytes;
+} BDUtilsExecStats;
+
+#define BD_UTILS_TYPE_EXEC_STATS (bd_utils_exec_stats_get_type ())
+GType bd_utils_exec_stats_get_type (void);
+
+BDUtilsExecStats* bd_utils_exec_stats_copy (BDUtilsExecStats *stats);
+void bd_utils_exec_stats_free (BDUtilsExecStats *stats);
+
+void bd_utils_set_exec_stats_enabled (gboolean enabled);
+void bd_utils_reset_exec_stats (void);
+BDUtilsExecStats** bd_utils_get_exec_stats (void);
+gchar* bd_utils_get_exec_stats_prometheus (void);
+
 gboolean bd_utils_echo_str_to_file (const gchar *str, const gchar *file_path, GError **error);
 
 #endif  /* BD_UTILS_EXEC */
@@ -8,6 +8,7 @@
 #include "module.h"
 #include "dbus.h"
 #include "logging.h"
+#include "batch.h"
 
 /**
  * SECTION: utils
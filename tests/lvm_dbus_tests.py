@@ -245,6 +245,36 @@ class LvmNoDevTestCase(LVMTestCase):
         succ = BlockDev.lvm_set_global_config(None)
         self.assertTrue(succ)
 
+    @tag_test(TestTags.NOSTORAGE)
+    def test_persistent_shell(self):
+        """Verify that the persistent lvm shell mode is not supported"""
+
+        self.assertFalse(BlockDev.lvm_get_persistent_shell())
+
+        with self.assertRaisesRegex(GLib.GError, "not supported"):
+            BlockDev.lvm_set_persistent_shell(True)
+        self.assertFalse(BlockDev.lvm_get_persistent_shell())
+
+        # disabling is a no-op
+        self.assertTrue(BlockDev.lvm_set_persistent_shell(False))
+
+    @tag_test(TestTags.NOSTORAGE)
+    def test_get_inventory(self):
+        """Verify that getting the inventory is not supported"""
+
+        with self.assertRaisesRegex(GLib.GError, "not supported"):
+            BlockDev.lvm_get_inventory()
+
+    @tag_test(TestTags.NOSTORAGE)
+    def test_select(self):
+        """Verify that LVM selection is not supported"""
+
+        with self.assertRaisesRegex(GLib.GError, "not supported"):
+            BlockDev.lvm_lvs_select("lv_name=test", BlockDev.LVMLVField.NAME)
+
+        with self.assertRaisesRegex(GLib.GError, "not supported"):
+            BlockDev.lvm_pvs_select("pv_name=test", BlockDev.LVMPVField.NAME)
+
     @tag_test(TestTags.NOSTORAGE)
     def test_cache_get_default_md_size(self):
         """Verify that default cache metadata size is calculated properly"""
@@ -886,6 +916,140 @@ class LvmTestLVcreateType(LvmPVVGLVTestCase):
         self.assertTrue(succ)
 
 
+@unittest.skipUnless(lvm_dbus_running, "LVM DBus not running")
+class LvmTestRaid(LvmPVVGLVTestCase):
+    def test_raid_create_stats(self):
+        """Verify it's possible to create a RAID LV and get its sync status"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        # not a RAID type
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_raid_create("testVG", "testLV", "striped", 512 * 1024**2)
+
+        succ = BlockDev.lvm_raid_create("testVG", "testLV", "raid1", 512 * 1024**2, mirrors=1,
+                                        pv_list=[self.loop_dev, self.loop_dev2])
+        self.assertTrue(succ)
+
+        info = BlockDev.lvm_lvinfo("testVG", "testLV")
+        self.assertEqual(info.segtype, "raid1")
+
+        stats = BlockDev.lvm_raid_stats("testVG", "testLV")
+        self.assertIsNotNone(stats)
+        self.assertEqual(stats.raid_type, "raid1")
+        self.assertEqual(stats.dev_count, 2)
+        self.assertEqual(len(stats.dev_health), 2)
+        self.assertEqual(stats.failed_devs, 0)
+        self.assertGreater(stats.sync_size, 0)
+        self.assertLessEqual(stats.sync_done, stats.sync_size)
+        self.assertTrue(0 <= stats.sync_percent <= 100)
+        self.assertIn(stats.sync_action, ("idle", "frozen", "resync", "recover", "check", "repair"))
+
+        # not a RAID LV
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV2", 64 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_raid_stats("testVG", "testLV2")
+
+        # not supported by the DBus API
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_raid_set_recovery_rate("testVG", "testLV", max_rate=10 * 1024**2)
+
+
+@unittest.skipUnless(lvm_dbus_running, "LVM DBus not running")
+class LvmTestPVmove(LvmPVVGLVTestCase):
+    @tag_test(TestTags.SLOW)
+    def test_pvmove(self):
+        """Verify it's possible to move extents between PVs and get the progress"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 256 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        progress = []
+        def progress_func(task, status, completion, msg):
+            progress.append((status, completion, msg))
+
+        succ = BlockDev.utils_init_prog_reporting(progress_func)
+        self.assertTrue(succ)
+        self.addCleanup(BlockDev.utils_init_prog_reporting, None)
+
+        succ = BlockDev.lvm_pvmove(self.loop_dev, self.loop_dev2)
+        self.assertTrue(succ)
+        self.assertTrue(progress)
+
+        ret, out, err = run_command("pvs --noheadings -o pv_pe_alloc_count %s" % self.loop_dev)
+        self.assertEqual(ret, 0, err)
+        self.assertEqual(out.strip(), "0")
+
+        # limiting the rate is not supported with LVM DBus
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_pvmove_with_rate(self.loop_dev2, self.loop_dev, max_rate=64 * 1024**2)
+
+
+@unittest.skipUnless(lvm_dbus_running, "LVM DBus not running")
+class LvmTestPlanPlacement(LvmPVVGLVTestCase):
+    def test_plan_placement(self):
+        """Verify it's possible to plan the placement of a new LV"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        # two PVs on two different disks -> two stripes
+        placement = BlockDev.lvm_plan_placement("testVG", 512 * 1024**2)
+        self.assertEqual(placement.stripes, 2)
+        self.assertEqual(set(placement.pvs), {self.loop_dev, self.loop_dev2})
+        self.assertGreaterEqual(placement.stripe_size, 4 * 1024)
+        self.assertEqual(placement.stripe_size & (placement.stripe_size - 1), 0)
+
+        # the number of stripes is given by the number of PVs
+        ea_size = BlockDev.ExtraArg.new("--stripesize", "%dk" % (placement.stripe_size // 1024))
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, "striped", placement.pvs, [ea_size])
+        self.assertTrue(succ)
+
+        info = BlockDev.lvm_lvinfo("testVG", "testLV")
+        self.assertEqual(info.segtype, "striped")
+
+        # only one stripe allowed
+        placement = BlockDev.lvm_plan_placement("testVG", 128 * 1024**2, max_stripes=1)
+        self.assertEqual(placement.stripes, 1)
+        self.assertEqual(len(placement.pvs), 1)
+        self.assertEqual(placement.stripe_size, 0)
+
+        # doesn't fit on a single PV anymore -> linear over both of them
+        placement = BlockDev.lvm_plan_placement("testVG", 1024**3, max_stripes=1)
+        self.assertEqual(placement.stripes, 1)
+        self.assertEqual(set(placement.pvs), {self.loop_dev, self.loop_dev2})
+
+        # not enough space in the VG
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_plan_placement("testVG", 4 * 1024**3)
+
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_plan_placement("nonexistingVG", 128 * 1024**2)
+
+
 @unittest.skipUnless(lvm_dbus_running, "LVM DBus not running")
 class LvmTestLVactivateDeactivate(LvmPVVGLVTestCase):
     def test_lvactivate_lvdeactivate(self):
@@ -1094,6 +1258,72 @@ class LvmTestLVs(LvmPVVGLVTestCase):
         lvs = BlockDev.lvm_lvs("testVG")
         self.assertEqual(len(lvs), 1)
 
+        # the listing must reflect changes done after the previous one
+        succ = BlockDev.lvm_lvrename("testVG", "testLV", "newTestLV", None)
+        self.assertTrue(succ)
+
+        lvs = BlockDev.lvm_lvs("testVG")
+        self.assertEqual([info.lv_name for info in lvs], ["newTestLV"])
+
+        succ = BlockDev.lvm_lvresize("testVG", "newTestLV", 768 * 1024**2, None)
+        self.assertTrue(succ)
+
+        lvs = BlockDev.lvm_lvs("testVG")
+        self.assertEqual(lvs[0].size, 768 * 1024**2)
+
+        succ = BlockDev.lvm_lvremove("testVG", "newTestLV", True, None)
+        self.assertTrue(succ)
+
+        lvs = BlockDev.lvm_lvs("testVG")
+        self.assertEqual(len(lvs), 0)
+
+@unittest.skipUnless(lvm_dbus_running, "LVM DBus not running")
+class LvmTestResultSets(LvmPVVGLVTestCase):
+    def test_result_sets(self):
+        """Verify that it's possible to gather info about PVs, VGs and LVs as result sets"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_add_lv_tags("testVG", "testLV", ["a", "b"])
+        self.assertTrue(succ)
+
+        pvs = BlockDev.lvm_pvs_result_set()
+        self.assertEqual(pvs.item_type, BlockDev.LVMResultSetType.PVS)
+        self.assertEqual(len(pvs), len(BlockDev.lvm_pvs()))
+        pv = next(pv for pv in pvs if pv.pv_name == self.loop_dev)
+        self.assertEqual(pv.vg_name, "testVG")
+        self.assertEqual(pvs[-1].pv_name, pvs[len(pvs) - 1].pv_name)
+        with self.assertRaises(IndexError):
+            pvs[len(pvs)]
+
+        vgs = BlockDev.lvm_vgs_result_set()
+        self.assertEqual(vgs.item_type, BlockDev.LVMResultSetType.VGS)
+        vg = next(vg for vg in vgs if vg.name == "testVG")
+        self.assertEqual(vg.uuid, pv.vg_uuid)
+
+        lvs = BlockDev.lvm_lvs_result_set("testVG")
+        self.assertEqual(lvs.item_type, BlockDev.LVMResultSetType.LVS)
+        self.assertEqual(len(lvs), 1)
+        info = BlockDev.lvm_lvinfo("testVG", "testLV")
+        self.assertEqual(lvs[0].lv_name, "testLV")
+        self.assertEqual(lvs[0].vg_name, "testVG")
+        self.assertEqual(lvs[0].uuid, info.uuid)
+        self.assertEqual(lvs[0].size, 512 * 1024**2)
+        self.assertEqual(sorted(lvs[0].lv_tags), ["a", "b"])
+
+        # wrong type of the items
+        self.assertIsNone(lvs.get_pv(0))
+
+        lvs = BlockDev.lvm_lvs_result_set(None)
+        self.assertEqual(len(lvs), len(BlockDev.lvm_lvs(None)))
+
 @unittest.skipUnless(lvm_dbus_running, "LVM DBus not running")
 class LvmPVVGthpoolTestCase(LvmPVVGTestCase):
     def _clean_up(self):
@@ -1253,6 +1483,61 @@ class LvmTestThLVcreate(LvmPVVGLVthLVTestCase):
         self.assertEqual(pool, "testPool")
         self.assertEqual(lvi.pool_lv, "testPool")
 
+@unittest.skipUnless(lvm_dbus_running, "LVM DBus not running")
+class LvmTestThpoolStats(LvmPVVGLVthLVTestCase):
+    @tag_test(TestTags.SLOW)
+    def test_thpool_thlv_stats(self):
+        """Verify that it is possible to get stats for a thin pool and a thin LV"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_thpoolcreate("testVG", "testPool", 512 * 1024**2, 4 * 1024**2, 512 * 1024, None, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_thlvcreate("testVG", "testPool", "testThLV", 1024**3, None)
+        self.assertTrue(succ)
+
+        stats = BlockDev.lvm_thpool_stats("testVG", "testPool")
+        self.assertTrue(stats)
+        self.assertEqual(stats.data_block_size, 512 * 1024)
+        self.assertEqual(stats.data_size, 512 * 1024**2)
+        self.assertEqual(stats.data_used, 0)
+        self.assertEqual(stats.md_block_size, 4096)
+        self.assertEqual(stats.md_size, 4 * 1024**2)
+        self.assertGreater(stats.md_used, 0)
+        self.assertEqual(stats.held_md_root, 0)
+        self.assertEqual(stats.mode, BlockDev.LVMThPoolMode.READ_WRITE)
+        self.assertFalse(stats.needs_check)
+
+        lv_stats = BlockDev.lvm_thlv_stats("testVG", "testThLV")
+        self.assertTrue(lv_stats)
+        self.assertEqual(lv_stats.mapped, 0)
+        self.assertFalse(lv_stats.failed)
+
+        # write some data and check it is reflected in the stats
+        ret, _out, _err = run_command("dd if=/dev/zero of=/dev/testVG/testThLV bs=1M count=4 oflag=direct")
+        self.assertEqual(ret, 0)
+
+        lv_stats = BlockDev.lvm_thlv_stats("testVG", "testThLV")
+        self.assertEqual(lv_stats.mapped, 4 * 1024**2)
+        self.assertEqual(lv_stats.highest_mapped, 4 * 1024**2)
+
+        stats = BlockDev.lvm_thpool_stats("testVG", "testPool")
+        self.assertEqual(stats.data_used, 4 * 1024**2)
+
+        # not a thin pool/thin LV
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_thpool_stats("testVG", "testThLV")
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_thlv_stats("testVG", "testPool")
+
 @unittest.skipUnless(lvm_dbus_running, "LVM DBus not running")
 class LvmPVVGLVthLVsnapshotTestCase(LvmPVVGLVthLVTestCase):
     def _clean_up(self):
@@ -1511,6 +1796,61 @@ class LvmPVVGLVWritecacheAttachDetachTestCase(LvmPVVGLVcachePoolTestCase):
         lvs = BlockDev.lvm_lvs("testVG")
         self.assertTrue(any(info.lv_name == "testCache" for info in lvs))
 
+    @tag_test(TestTags.SLOW)
+    def test_writecache_settings_stats(self):
+        """Verify that it is possible to attach a writecache with settings and get its stats"""
+
+        lvm_version = self._get_lvm_version()
+        if lvm_version < LooseVersion("2.03.10"):
+            self.skipTest("LVM writecache support in DBus API not available")
+
+        lvm_segtypes = self._get_lvm_segtypes()
+        if "writecache" not in lvm_segtypes:
+            self.skipTest("LVM writecache support not available")
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testCache", 256 * 1024**2, None, [self.loop_dev2], None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        settings = BlockDev.LVMWritecacheSettings(high_watermark=60, low_watermark=40, block_size=4096)
+        succ = BlockDev.lvm_writecache_attach_with_settings("testVG", "testLV", "testCache", settings)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvactivate("testVG", "testLV", True, None)
+        self.assertTrue(succ)
+
+        stats = BlockDev.lvm_writecache_stats("testVG", "testLV")
+        self.assertIsNotNone(stats)
+        self.assertEqual(stats.error, 0)
+        self.assertEqual(stats.block_size, 4096)
+        # part of the cache is used for metadata
+        self.assertGreater(stats.total_blocks, 0)
+        self.assertLess(stats.total_blocks * stats.block_size, 256 * 1024**2)
+        self.assertLessEqual(stats.free_blocks, stats.total_blocks)
+
+        # changing the settings online is not supported by the DBus API
+        settings = BlockDev.LVMWritecacheSettings(high_watermark=70)
+        with self.assertRaisesRegex(GLib.GError, "not supported"):
+            BlockDev.lvm_writecache_set_settings("testVG", "testLV", settings)
+
+        # not a writecache LV
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_writecache_stats("testVG", "testCache")
+
+        succ = BlockDev.lvm_writecache_detach("testVG", "testLV", True, None)
+        self.assertTrue(succ)
+
 @unittest.skipUnless(lvm_dbus_running, "LVM DBus not running")
 class LvmPVVGWritecachedLVTestCase(LvmPVVGLVTestCase):
     @tag_test(TestTags.SLOW)
@@ -1572,6 +1912,53 @@ class LvmPVVGcachedLVstatsTestCase(LvmPVVGLVTestCase):
         self.assertEqual(stats.md_size, 8 * 1024**2)
         self.assertEqual(stats.mode, BlockDev.LVMCacheMode.WRITETHROUGH)
 
+        all_stats = BlockDev.lvm_cache_stats_all()
+        lv_stats = [s for s in all_stats if s.vg_name == "testVG"]
+        self.assertEqual(len(lv_stats), 1)
+        self.assertEqual(lv_stats[0].lv_name, "testLV")
+        self.assertEqual(lv_stats[0].stats.cache_size, stats.cache_size)
+        self.assertEqual(lv_stats[0].stats.md_size, stats.md_size)
+        self.assertEqual(lv_stats[0].stats.mode, stats.mode)
+
+    @tag_test(TestTags.SLOW)
+    def test_cache_settings(self):
+        """Verify that it is possible to get and set cache policy and settings"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_cache_create_pool("testVG", "testCache", 512 * 1024**2, 0, BlockDev.LVMCacheMode.WRITEBACK, 0, [self.loop_dev2])
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_cache_attach("testVG", "testLV", "testCache", None)
+        self.assertTrue(succ)
+
+        stats = BlockDev.lvm_cache_stats("testVG", "testLV")
+        self.assertTrue(stats)
+        self.assertLessEqual(stats.cache_dirty, stats.cache_used)
+
+        settings = BlockDev.lvm_cache_get_settings("testVG", "testLV")
+        self.assertIsNotNone(settings)
+        self.assertEqual(settings.policy, "smq")
+        self.assertGreater(settings.migration_threshold, 0)
+
+        # changing the settings is not supported by the DBus API
+        settings = BlockDev.LVMCacheSettings(migration_threshold=4096)
+        with self.assertRaisesRegex(GLib.GError, "not supported"):
+            BlockDev.lvm_cache_set_settings("testVG", "testLV", settings)
+
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_cache_get_settings("testVG", "nonexistingLV")
+
 class LvmPVVGcachedThpoolstatsTestCase(LvmPVVGLVTestCase):
     @tag_test(TestTags.SLOW)
     def test_cache_get_stats(self):
@@ -1916,3 +2303,61 @@ class LVMVDOTest(LVMTestCase):
 
         full_stats = BlockDev.lvm_vdo_get_stats_full("testVDOVG", "vdoPool")
         self.assertIn("writeAmplificationRatio", full_stats.keys())
+
+    @tag_test(TestTags.SLOW)
+    def test_stats_rates(self):
+        succ = BlockDev.lvm_vdo_pool_create("testVDOVG", "vdoLV", "vdoPool", 7 * 1024**3, 35 * 1024**3)
+        self.assertTrue(succ)
+
+        prev = BlockDev.lvm_vdo_get_counters("testVDOVG", "vdoPool")
+        self.assertIsNotNone(prev)
+        self.assertNotEqual(prev.bios_in_write, -1)
+        self.assertNotEqual(prev.journal_blocks_written, -1)
+
+        # write some non-zero (zero blocks are not stored by VDO) data
+        ret, _out, err = run_command("dd if=/dev/urandom of=/dev/testVDOVG/vdoLV bs=1M count=4 oflag=direct")
+        self.assertEqual(ret, 0, err)
+
+        cur = BlockDev.lvm_vdo_get_counters("testVDOVG", "vdoPool")
+        self.assertIsNotNone(cur)
+        self.assertGreater(cur.bios_in_write, prev.bios_in_write)
+
+        rates = BlockDev.lvm_vdo_get_rates(prev, cur)
+        self.assertGreater(rates.interval, 0)
+        self.assertGreater(rates.write_rate, 0)
+        self.assertGreaterEqual(rates.journal_blocks_rate, 0)
+        self.assertGreaterEqual(rates.write_amplification_ratio, 0)
+
+        # snapshots in the wrong order
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_vdo_get_rates(cur, prev)
+
+    @tag_test(TestTags.SLOW)
+    def test_vdo_pool_create_tuning(self):
+        tuning = BlockDev.LVMVDOTuning(cpu_threads=2, bio_threads=2, hash_zone_threads=2,
+                                       logical_threads=2, physical_threads=1,
+                                       block_map_cache_size=256 * 1024**2)
+        succ = BlockDev.lvm_vdo_pool_create_with_tuning("testVDOVG", "vdoLV", "vdoPool", 7 * 1024**3, 35 * 1024**3,
+                                                        tuning=tuning)
+        self.assertTrue(succ)
+
+        lv_info = BlockDev.lvm_lvinfo("testVDOVG", "vdoLV")
+        self.assertIsNotNone(lv_info)
+        self.assertEqual(lv_info.segtype, "vdo")
+
+        active = BlockDev.lvm_vdo_get_tuning("testVDOVG", "vdoPool")
+        self.assertIsNotNone(active)
+        self.assertEqual(active.cpu_threads, 2)
+        self.assertEqual(active.bio_threads, 2)
+        self.assertEqual(active.hash_zone_threads, 2)
+        self.assertEqual(active.logical_threads, 2)
+        self.assertEqual(active.physical_threads, 1)
+        self.assertEqual(active.block_map_cache_size, 256 * 1024**2)
+
+        # not a VDO pool
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_vdo_get_tuning("testVDOVG", "vdoLV")
+
+    @tag_test(TestTags.SLOW)
+    def test_vdo_pool_convert_tuning(self):
+        self.skipTest("LVM VDO pool convert not implemented in LVM DBus API.")
@@ -1,15 +1,18 @@
 from __future__ import division
 import unittest
 import os
+import json
 import math
 import overrides_hack
 import re
 import shutil
 import subprocess
+import threading
+import time
 from distutils.version import LooseVersion
 
 from utils import create_sparse_tempfile, create_lio_device, delete_lio_device, fake_utils, fake_path, TestTags, tag_test, run_command
-from gi.repository import BlockDev, GLib
+from gi.repository import BlockDev, GLib, Gio
 
 
 class LVMTestCase(unittest.TestCase):
@@ -231,6 +234,47 @@ class LvmNoDevTestCase(LVMTestCase):
         succ = BlockDev.lvm_set_global_config(None)
         self.assertTrue(succ)
 
+    @tag_test(TestTags.NOSTORAGE)
+    def test_persistent_shell(self):
+        """Verify that the persistent lvm shell mode works as expected"""
+
+        # setup logging
+        self.assertTrue(BlockDev.reinit(self.requested_plugins, False, self._store_log))
+
+        # disabled by default
+        self.assertFalse(BlockDev.lvm_get_persistent_shell())
+
+        # make sure we don't leave the shells running
+        self.addCleanup(BlockDev.lvm_set_persistent_shell, False)
+
+        succ = BlockDev.lvm_set_persistent_shell(True)
+        self.assertTrue(succ)
+        self.assertTrue(BlockDev.lvm_get_persistent_shell())
+
+        # the second call should reuse the shell started for the first one,
+        # the results should be the same as when running lvm directly
+        BlockDev.lvm_lvs(None)
+        shell_lvs = BlockDev.lvm_lvs(None)
+        self.assertIn("in lvm shell", self._log)
+
+        # the thread's cancellable applies to the commands run in the shell too
+        cancellable = Gio.Cancellable()
+        cancellable.cancel()
+        BlockDev.utils_set_thread_cancellable(cancellable, 0)
+        try:
+            with self.assertRaises(GLib.GError):
+                BlockDev.lvm_lvs(None)
+        finally:
+            BlockDev.utils_set_thread_cancellable(None, 0)
+
+        succ = BlockDev.lvm_set_persistent_shell(False)
+        self.assertTrue(succ)
+        self.assertFalse(BlockDev.lvm_get_persistent_shell())
+
+        lvs = BlockDev.lvm_lvs(None)
+        self.assertEqual(sorted((lv.vg_name, lv.lv_name) for lv in shell_lvs),
+                         sorted((lv.vg_name, lv.lv_name) for lv in lvs))
+
     @tag_test(TestTags.NOSTORAGE)
     def test_cache_get_default_md_size(self):
         """Verify that default cache metadata size is calculated properly"""
@@ -389,6 +433,37 @@ class LvmTestPVs(LvmPVonlyTestCase):
 
         self.assertTrue(any(info.pv_uuid == all_info.pv_uuid for all_info in pvs))
 
+class LvmTestPVsSelect(LvmPVonlyTestCase):
+    def test_pvs_select(self):
+        """Verify that it's possible to gather selected info about selected PVs"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        pvs = BlockDev.lvm_pvs_select("pv_name=%s" % self.loop_dev,
+                                      BlockDev.LVMPVField.NAME | BlockDev.LVMPVField.SIZE)
+        self.assertEqual(len(pvs), 1)
+        self.assertEqual(pvs[0].pv_name, self.loop_dev)
+        self.assertGreater(pvs[0].pv_size, 0)
+
+        # fields not requested are not filled
+        self.assertIsNone(pvs[0].pv_uuid)
+        self.assertEqual(pvs[0].pe_start, 0)
+
+        # 0 means all fields
+        pvs = BlockDev.lvm_pvs_select("pv_name=%s" % self.loop_dev, 0)
+        self.assertEqual(len(pvs), 1)
+        info = BlockDev.lvm_pvinfo(self.loop_dev)
+        self.assertEqual(pvs[0].pv_uuid, info.pv_uuid)
+        self.assertEqual(pvs[0].pe_start, info.pe_start)
+
+        # nothing matching is not an error
+        pvs = BlockDev.lvm_pvs_select("pv_name=/dev/nonexisting", 0)
+        self.assertEqual(len(pvs), 0)
+
 class LvmPVVGTestCase(LvmPVonlyTestCase):
     def _clean_up(self):
         try:
@@ -707,6 +782,35 @@ class LvmTestLVcreateRemove(LvmPVVGLVTestCase):
         with self.assertRaises(GLib.GError):
             BlockDev.lvm_lvremove("testVG", "testLV", True, None)
 
+class LvmTestLVcreateRemoveShell(LvmPVVGLVTestCase):
+    @tag_test(TestTags.CORE)
+    def test_lvcreate_lvremove_shell(self):
+        """Verify that it's possible to create/destroy an LV with the persistent lvm shell"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev], 0, None)
+        self.assertTrue(succ)
+
+        self.addCleanup(BlockDev.lvm_set_persistent_shell, False)
+        succ = BlockDev.lvm_set_persistent_shell(True)
+        self.assertTrue(succ)
+
+        # lvcreate and lvremove answer the prompts with '-y'/'--yes' which
+        # cannot be combined with the '-qq' used in the shell otherwise
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        info = BlockDev.lvm_lvinfo("testVG", "testLV")
+        self.assertEqual(info.lv_name, "testLV")
+
+        succ = BlockDev.lvm_lvremove("testVG", "testLV", True, None)
+        self.assertTrue(succ)
+
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_lvinfo("testVG", "testLV")
+
 class LvmTestLVcreateWithExtra(LvmPVVGLVTestCase):
     def __init__(self, *args, **kwargs):
         LvmPVVGLVTestCase.__init__(self, *args, **kwargs)
@@ -816,6 +920,179 @@ class LvmTestLVcreateType(LvmPVVGLVTestCase):
         self.assertTrue(succ)
 
 
+class LvmTestRaid(LvmPVVGLVTestCase):
+    def test_raid_create_stats(self):
+        """Verify it's possible to create a RAID LV and get its sync status"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        # not a RAID type
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_raid_create("testVG", "testLV", "striped", 512 * 1024**2)
+
+        succ = BlockDev.lvm_raid_create("testVG", "testLV", "raid1", 512 * 1024**2, mirrors=1,
+                                        pv_list=[self.loop_dev, self.loop_dev2])
+        self.assertTrue(succ)
+
+        info = BlockDev.lvm_lvinfo("testVG", "testLV")
+        self.assertEqual(info.segtype, "raid1")
+
+        stats = BlockDev.lvm_raid_stats("testVG", "testLV")
+        self.assertIsNotNone(stats)
+        self.assertEqual(stats.raid_type, "raid1")
+        self.assertEqual(stats.dev_count, 2)
+        self.assertEqual(len(stats.dev_health), 2)
+        self.assertEqual(stats.failed_devs, 0)
+        self.assertGreater(stats.sync_size, 0)
+        self.assertLessEqual(stats.sync_done, stats.sync_size)
+        self.assertTrue(0 <= stats.sync_percent <= 100)
+        self.assertIn(stats.sync_action, ("idle", "frozen", "resync", "recover", "check", "repair"))
+
+        # not a RAID LV
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV2", 64 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_raid_stats("testVG", "testLV2")
+
+        succ = BlockDev.lvm_raid_set_recovery_rate("testVG", "testLV", max_rate=10 * 1024**2)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_raid_set_recovery_rate("testVG", "testLV", min_rate=1024**2)
+        self.assertTrue(succ)
+
+        ret, out, err = run_command("lvs --noheadings -o raid_min_recovery_rate,raid_max_recovery_rate testVG/testLV")
+        self.assertEqual(ret, 0, err)
+        self.assertEqual(out.split(), ["1024", "10240"])
+
+        # rates below 1 KiB/s are rounded up, not turned into "no limit"
+        succ = BlockDev.lvm_raid_set_recovery_rate("testVG", "testLV", min_rate=512)
+        self.assertTrue(succ)
+
+        ret, out, err = run_command("lvs --noheadings -o raid_min_recovery_rate testVG/testLV")
+        self.assertEqual(ret, 0, err)
+        self.assertEqual(out.strip(), "1")
+
+        # nothing to change
+        succ = BlockDev.lvm_raid_set_recovery_rate("testVG", "testLV")
+        self.assertTrue(succ)
+
+        # negative rates (other than BD_LVM_RAID_RATE_UNCHANGED) are invalid
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_raid_set_recovery_rate("testVG", "testLV", min_rate=-512)
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_raid_set_recovery_rate("testVG", "testLV", max_rate=-2 * 1024**2)
+
+class LvmTestPVmove(LvmPVVGLVTestCase):
+    @tag_test(TestTags.SLOW)
+    def test_pvmove(self):
+        """Verify it's possible to move extents between PVs and get the progress"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 256 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        progress = []
+        def progress_func(task, status, completion, msg):
+            progress.append((status, completion, msg))
+
+        succ = BlockDev.utils_init_prog_reporting(progress_func)
+        self.assertTrue(succ)
+        self.addCleanup(BlockDev.utils_init_prog_reporting, None)
+
+        succ = BlockDev.lvm_pvmove(self.loop_dev, self.loop_dev2)
+        self.assertTrue(succ)
+        self.assertTrue(progress)
+
+        ret, out, err = run_command("pvs --noheadings -o pv_pe_alloc_count %s" % self.loop_dev)
+        self.assertEqual(ret, 0, err)
+        self.assertEqual(out.strip(), "0")
+
+        # and back with a limited rate
+        throttle_file = "/sys/module/dm_mirror/parameters/raid1_resync_throttle"
+        orig_throttle = None
+        if os.path.exists(throttle_file):
+            with open(throttle_file, "r") as f:
+                orig_throttle = f.read().strip()
+
+        del progress[:]
+        succ = BlockDev.lvm_pvmove_with_rate(self.loop_dev2, self.loop_dev, max_rate=64 * 1024**2)
+        self.assertTrue(succ)
+        self.assertTrue(any(p[1] == 100 for p in progress))
+
+        # the global throttle is restored after the move
+        if orig_throttle is not None:
+            with open(throttle_file, "r") as f:
+                self.assertEqual(f.read().strip(), orig_throttle)
+
+        ret, out, err = run_command("pvs --noheadings -o pv_pe_alloc_count %s" % self.loop_dev2)
+        self.assertEqual(ret, 0, err)
+        self.assertEqual(out.strip(), "0")
+
+        # not a PV in a VG
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_pvmove_with_rate("/non/existing", None)
+
+class LvmTestPlanPlacement(LvmPVVGLVTestCase):
+    def test_plan_placement(self):
+        """Verify it's possible to plan the placement of a new LV"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        # two PVs on two different disks -> two stripes
+        placement = BlockDev.lvm_plan_placement("testVG", 512 * 1024**2)
+        self.assertEqual(placement.stripes, 2)
+        self.assertEqual(set(placement.pvs), {self.loop_dev, self.loop_dev2})
+        self.assertGreaterEqual(placement.stripe_size, 4 * 1024)
+        self.assertEqual(placement.stripe_size & (placement.stripe_size - 1), 0)
+
+        # the number of stripes is given by the number of PVs
+        ea_size = BlockDev.ExtraArg.new("--stripesize", "%dk" % (placement.stripe_size // 1024))
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, "striped", placement.pvs, [ea_size])
+        self.assertTrue(succ)
+
+        info = BlockDev.lvm_lvinfo("testVG", "testLV")
+        self.assertEqual(info.segtype, "striped")
+
+        # only one stripe allowed
+        placement = BlockDev.lvm_plan_placement("testVG", 128 * 1024**2, max_stripes=1)
+        self.assertEqual(placement.stripes, 1)
+        self.assertEqual(len(placement.pvs), 1)
+        self.assertEqual(placement.stripe_size, 0)
+
+        # doesn't fit on a single PV anymore -> linear over both of them
+        placement = BlockDev.lvm_plan_placement("testVG", 1024**3, max_stripes=1)
+        self.assertEqual(placement.stripes, 1)
+        self.assertEqual(set(placement.pvs), {self.loop_dev, self.loop_dev2})
+
+        # not enough space in the VG
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_plan_placement("testVG", 4 * 1024**3)
+
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_plan_placement("nonexistingVG", 128 * 1024**2)
+
 class LvmTestLVactivateDeactivate(LvmPVVGLVTestCase):
     def test_lvactivate_lvdeactivate(self):
         """Verify it's possible to (de)actiavate an LV"""
@@ -1018,6 +1295,145 @@ class LvmTestLVs(LvmPVVGLVTestCase):
         lvs = BlockDev.lvm_lvs("testVG")
         self.assertEqual(len(lvs), 1)
 
+class LvmTestResultSets(LvmPVVGLVTestCase):
+    def test_result_sets(self):
+        """Verify that it's possible to gather info about PVs, VGs and LVs as result sets"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_add_lv_tags("testVG", "testLV", ["a", "b"])
+        self.assertTrue(succ)
+
+        pvs = BlockDev.lvm_pvs_result_set()
+        self.assertEqual(pvs.item_type, BlockDev.LVMResultSetType.PVS)
+        self.assertEqual(len(pvs), len(BlockDev.lvm_pvs()))
+        pv = next(pv for pv in pvs if pv.pv_name == self.loop_dev)
+        self.assertEqual(pv.vg_name, "testVG")
+        self.assertEqual(pvs[-1].pv_name, pvs[len(pvs) - 1].pv_name)
+        with self.assertRaises(IndexError):
+            pvs[len(pvs)]
+
+        vgs = BlockDev.lvm_vgs_result_set()
+        self.assertEqual(vgs.item_type, BlockDev.LVMResultSetType.VGS)
+        vg = next(vg for vg in vgs if vg.name == "testVG")
+        self.assertEqual(vg.uuid, pv.vg_uuid)
+
+        lvs = BlockDev.lvm_lvs_result_set("testVG")
+        self.assertEqual(lvs.item_type, BlockDev.LVMResultSetType.LVS)
+        self.assertEqual(len(lvs), 1)
+        info = BlockDev.lvm_lvinfo("testVG", "testLV")
+        self.assertEqual(lvs[0].lv_name, "testLV")
+        self.assertEqual(lvs[0].vg_name, "testVG")
+        self.assertEqual(lvs[0].uuid, info.uuid)
+        self.assertEqual(lvs[0].size, 512 * 1024**2)
+        self.assertEqual(sorted(lvs[0].lv_tags), ["a", "b"])
+
+        # wrong type of the items
+        self.assertIsNone(lvs.get_pv(0))
+
+        lvs = BlockDev.lvm_lvs_result_set(None)
+        self.assertEqual(len(lvs), len(BlockDev.lvm_lvs(None)))
+
+class LvmTestLVsSelect(LvmPVVGLVTestCase):
+    def _clean_up(self):
+        try:
+            BlockDev.lvm_lvremove("testVG", "testLV2", True, None)
+        except:
+            pass
+
+        LvmPVVGLVTestCase._clean_up(self)
+
+    def test_lvs_select(self):
+        """Verify that it's possible to gather selected info about selected LVs"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV2", 256 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_add_lv_tags("testVG", "testLV2", ["selected"])
+        self.assertTrue(succ)
+
+        lvs = BlockDev.lvm_lvs_select("vg_name=testVG && lv_tags=selected",
+                                      BlockDev.LVMLVField.NAME | BlockDev.LVMLVField.SIZE)
+        self.assertEqual(len(lvs), 1)
+        self.assertEqual(lvs[0].lv_name, "testLV2")
+        self.assertEqual(lvs[0].size, 256 * 1024**2)
+
+        # fields not requested are not filled
+        self.assertIsNone(lvs[0].vg_name)
+        self.assertIsNone(lvs[0].uuid)
+        self.assertFalse(lvs[0].lv_tags)
+
+        lvs = BlockDev.lvm_lvs_select("vg_name=testVG", BlockDev.LVMLVField.NAME | BlockDev.LVMLVField.TAGS)
+        self.assertEqual(sorted((lv.lv_name, tuple(lv.lv_tags)) for lv in lvs),
+                         [("testLV", ()), ("testLV2", ("selected",))])
+
+        # no selection and 0 means the same as bd_lvm_lvs()
+        lvs = BlockDev.lvm_lvs_select(None, 0)
+        self.assertEqual(sorted(lv.uuid for lv in lvs), sorted(lv.uuid for lv in BlockDev.lvm_lvs(None)))
+
+        lvs = BlockDev.lvm_lvs_select("lv_name=nonexisting", 0)
+        self.assertEqual(len(lvs), 0)
+
+class LvmTestInventory(LvmPVVGLVTestCase):
+    def test_get_inventory(self):
+        """Verify that it's possible to get info about all LVM objects at once"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        inv = BlockDev.lvm_get_inventory()
+        self.assertTrue(inv)
+
+        # same objects as the individual functions report
+        self.assertEqual(sorted(vg.uuid for vg in inv.vgs), sorted(vg.uuid for vg in BlockDev.lvm_vgs()))
+        self.assertEqual(sorted(pv.pv_uuid for pv in inv.pvs), sorted(pv.pv_uuid for pv in BlockDev.lvm_pvs()))
+        self.assertEqual(sorted(lv.uuid for lv in inv.lvs), sorted(lv.uuid for lv in BlockDev.lvm_lvs(None)))
+
+        vg_idx = next(i for i, vg in enumerate(inv.vgs) if vg.name == "testVG")
+        pv_idx = next(i for i, pv in enumerate(inv.pvs) if pv.pv_name == self.loop_dev)
+        orphan_idx = next(i for i, pv in enumerate(inv.pvs) if pv.pv_name == self.loop_dev2)
+        lv_idx = next(i for i, lv in enumerate(inv.lvs) if lv.lv_name == "testLV" and lv.vg_name == "testVG")
+
+        self.assertEqual(inv.pv_vgs[pv_idx], vg_idx)
+        self.assertEqual(inv.pv_vgs[orphan_idx], -1)
+        self.assertEqual(inv.lv_vgs[lv_idx], vg_idx)
+
+        # the LV and the rest of the free space on the PV
+        segs = [seg for seg in inv.pvsegs if seg.pv_index == pv_idx]
+        self.assertEqual(len(segs), 2)
+        lv_seg = next(seg for seg in segs if seg.lv_index == lv_idx)
+        self.assertEqual(lv_seg.lv_uuid, inv.lvs[lv_idx].uuid)
+        self.assertEqual(lv_seg.size_pe * inv.vgs[vg_idx].extent_size, 512 * 1024**2)
+        free_seg = next(seg for seg in segs if seg.lv_index == -1)
+        self.assertIsNone(free_seg.lv_uuid)
+        self.assertEqual(lv_seg.pv_start_pe, 0)
+        self.assertEqual(free_seg.pv_start_pe, lv_seg.size_pe)
+
 class LvmPVVGthpoolTestCase(LvmPVVGTestCase):
     def _clean_up(self):
         try:
@@ -1171,6 +1587,60 @@ class LvmTestThLVcreate(LvmPVVGLVthLVTestCase):
         self.assertEqual(pool, "testPool")
         self.assertEqual(lvi.pool_lv, "testPool")
 
+class LvmTestThpoolStats(LvmPVVGLVthLVTestCase):
+    @tag_test(TestTags.SLOW)
+    def test_thpool_thlv_stats(self):
+        """Verify that it is possible to get stats for a thin pool and a thin LV"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_thpoolcreate("testVG", "testPool", 512 * 1024**2, 4 * 1024**2, 512 * 1024, None, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_thlvcreate("testVG", "testPool", "testThLV", 1024**3, None)
+        self.assertTrue(succ)
+
+        stats = BlockDev.lvm_thpool_stats("testVG", "testPool")
+        self.assertTrue(stats)
+        self.assertEqual(stats.data_block_size, 512 * 1024)
+        self.assertEqual(stats.data_size, 512 * 1024**2)
+        self.assertEqual(stats.data_used, 0)
+        self.assertEqual(stats.md_block_size, 4096)
+        self.assertEqual(stats.md_size, 4 * 1024**2)
+        self.assertGreater(stats.md_used, 0)
+        self.assertEqual(stats.held_md_root, 0)
+        self.assertEqual(stats.mode, BlockDev.LVMThPoolMode.READ_WRITE)
+        self.assertFalse(stats.needs_check)
+
+        lv_stats = BlockDev.lvm_thlv_stats("testVG", "testThLV")
+        self.assertTrue(lv_stats)
+        self.assertEqual(lv_stats.mapped, 0)
+        self.assertFalse(lv_stats.failed)
+
+        # write some data and check it is reflected in the stats
+        ret, _out, _err = run_command("dd if=/dev/zero of=/dev/testVG/testThLV bs=1M count=4 oflag=direct")
+        self.assertEqual(ret, 0)
+
+        lv_stats = BlockDev.lvm_thlv_stats("testVG", "testThLV")
+        self.assertEqual(lv_stats.mapped, 4 * 1024**2)
+        self.assertEqual(lv_stats.highest_mapped, 4 * 1024**2)
+
+        stats = BlockDev.lvm_thpool_stats("testVG", "testPool")
+        self.assertEqual(stats.data_used, 4 * 1024**2)
+
+        # not a thin pool/thin LV
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_thpool_stats("testVG", "testThLV")
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_thlv_stats("testVG", "testPool")
+
 class LvmPVVGLVthLVsnapshotTestCase(LvmPVVGLVthLVTestCase):
     def _clean_up(self):
         try:
@@ -1398,6 +1868,64 @@ class LvmPVVGcachedLVstatsTestCase(LvmPVVGLVTestCase):
         self.assertEqual(stats.md_size, 8 * 1024**2)
         self.assertEqual(stats.mode, BlockDev.LVMCacheMode.WRITETHROUGH)
 
+        all_stats = BlockDev.lvm_cache_stats_all()
+        lv_stats = [s for s in all_stats if s.vg_name == "testVG"]
+        self.assertEqual(len(lv_stats), 1)
+        self.assertEqual(lv_stats[0].lv_name, "testLV")
+        self.assertEqual(lv_stats[0].stats.cache_size, stats.cache_size)
+        self.assertEqual(lv_stats[0].stats.md_size, stats.md_size)
+        self.assertEqual(lv_stats[0].stats.mode, stats.mode)
+
+    @tag_test(TestTags.SLOW)
+    def test_cache_settings(self):
+        """Verify that it is possible to get and set cache policy and settings"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_cache_create_pool("testVG", "testCache", 512 * 1024**2, 0, BlockDev.LVMCacheMode.WRITEBACK, 0, [self.loop_dev2])
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_cache_attach("testVG", "testLV", "testCache", None)
+        self.assertTrue(succ)
+
+        stats = BlockDev.lvm_cache_stats("testVG", "testLV")
+        self.assertTrue(stats)
+        self.assertLessEqual(stats.cache_dirty, stats.cache_used)
+
+        settings = BlockDev.lvm_cache_get_settings("testVG", "testLV")
+        self.assertIsNotNone(settings)
+        self.assertEqual(settings.policy, "smq")
+        self.assertGreater(settings.migration_threshold, 0)
+
+        settings = BlockDev.LVMCacheSettings(migration_threshold=4096)
+        succ = BlockDev.lvm_cache_set_settings("testVG", "testLV", settings)
+        self.assertTrue(succ)
+
+        settings = BlockDev.lvm_cache_get_settings("testVG", "testLV")
+        self.assertEqual(settings.migration_threshold, 4096)
+
+        # switch to the cleaner policy to write back all dirty blocks
+        settings = BlockDev.LVMCacheSettings(policy="cleaner")
+        succ = BlockDev.lvm_cache_set_settings("testVG", "testLV", settings)
+        self.assertTrue(succ)
+
+        settings = BlockDev.lvm_cache_get_settings("testVG", "testLV")
+        self.assertEqual(settings.policy, "cleaner")
+        self.assertEqual(settings.migration_threshold, 4096)
+
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_cache_get_settings("testVG", "nonexistingLV")
+
 class LvmPVVGcachedThpoolstatsTestCase(LvmPVVGLVTestCase):
     @tag_test(TestTags.SLOW)
     def test_cache_get_stats(self):
@@ -1488,6 +2016,66 @@ class LvmPVVGLVWritecacheAttachDetachTestCase(LvmPVVGLVcachePoolTestCase):
         lvs = BlockDev.lvm_lvs("testVG")
         self.assertTrue(any(info.lv_name == "testCache" for info in lvs))
 
+    @tag_test(TestTags.SLOW)
+    def test_writecache_settings_stats(self):
+        """Verify that it is possible to attach a writecache with settings and get its stats"""
+
+        lvm_version = self._get_lvm_version()
+        if lvm_version < LooseVersion("2.03.02"):
+            self.skipTest("LVM writecache support not available")
+
+        lvm_segtypes = self._get_lvm_segtypes()
+        if "writecache" not in lvm_segtypes:
+            self.skipTest("LVM writecache support not available")
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev, self.loop_dev2], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testCache", 256 * 1024**2, None, [self.loop_dev2], None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 512 * 1024**2, None, [self.loop_dev], None)
+        self.assertTrue(succ)
+
+        settings = BlockDev.LVMWritecacheSettings(high_watermark=60, low_watermark=40, block_size=4096)
+        succ = BlockDev.lvm_writecache_attach_with_settings("testVG", "testLV", "testCache", settings)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvactivate("testVG", "testLV", True, None)
+        self.assertTrue(succ)
+
+        stats = BlockDev.lvm_writecache_stats("testVG", "testLV")
+        self.assertIsNotNone(stats)
+        self.assertEqual(stats.error, 0)
+        self.assertEqual(stats.block_size, 4096)
+        # part of the cache is used for metadata
+        self.assertGreater(stats.total_blocks, 0)
+        self.assertLess(stats.total_blocks * stats.block_size, 256 * 1024**2)
+        self.assertLessEqual(stats.free_blocks, stats.total_blocks)
+
+        # change some settings online
+        settings = BlockDev.LVMWritecacheSettings(high_watermark=70, writeback_jobs=32)
+        succ = BlockDev.lvm_writecache_set_settings("testVG", "testLV", settings)
+        self.assertTrue(succ)
+
+        # block size cannot be changed for an existing cache
+        settings = BlockDev.LVMWritecacheSettings(block_size=512)
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_writecache_set_settings("testVG", "testLV", settings)
+
+        # not a writecache LV
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_writecache_stats("testVG", "testCache")
+
+        succ = BlockDev.lvm_writecache_detach("testVG", "testLV", True, None)
+        self.assertTrue(succ)
+
 class LvmPVVGWritecachedLVTestCase(LvmPVVGLVTestCase):
     @tag_test(TestTags.SLOW)
     def test_create_cached_lv(self):
@@ -1633,6 +2221,246 @@ class LVMUnloadTest(LVMTestCase):
         self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
         self.assertIn("lvm", BlockDev.get_available_plugin_names())
 
+class LvmReportParsingTest(LVMTestCase):
+    # fake lvm reporting a lot of LVs, the version determines the report format
+    fake_lvm = "tests/fake_utils/lvm_many_lvs/"
+    num_lvs = 10000
+    rounds = 3
+
+    def setUp(self):
+        self.addCleanup(self._clean_up)
+        os.environ["FAKE_LVM_NUM_LVS"] = str(self.num_lvs)
+
+    def _clean_up(self):
+        os.environ.pop("FAKE_LVM_VERSION", None)
+        os.environ.pop("FAKE_LVM_NUM_LVS", None)
+
+        # make sure the library is initialized with the real lvm for other tests
+        BlockDev.reinit(self.requested_plugins, True, None)
+
+    def _time_lvs(self, version, report_args):
+        os.environ["FAKE_LVM_VERSION"] = version
+
+        with fake_utils(self.fake_lvm):
+            # reload the plugin to make it check the LVM version again
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+
+            # time spent just running the (fake) lvm
+            exec_time = float("inf")
+            for _i in range(self.rounds):
+                start = time.monotonic()
+                subprocess.check_output([self.fake_lvm + "lvm", "lvs"] + report_args)
+                exec_time = min(exec_time, time.monotonic() - start)
+
+            total_time = float("inf")
+            for _i in range(self.rounds):
+                start = time.monotonic()
+                lvs = BlockDev.lvm_lvs(None)
+                total_time = min(total_time, time.monotonic() - start)
+
+        return lvs, total_time, max(total_time - exec_time, 0)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.SLOW)
+    def test_report_parsers_benchmark(self):
+        """Compare parsing of JSON and name-prefixed LVM reports with many LVs"""
+
+        # 2.02.158 is the first version supporting '--reportformat json'
+        json_lvs, _json_total, json_parse = self._time_lvs("2.03.11", ["--reportformat", "json"])
+        vars_lvs, _vars_total, vars_parse = self._time_lvs("2.02.150", ["--nameprefixes", "--unquoted"])
+
+        # parsing the JSON report directly into the structs must not be slower
+        # than parsing the name-prefixed report, leave some room for noise
+        self.assertLess(json_parse, vars_parse * 2 + 0.05)
+
+        # both parsers must give the same results
+        self.assertEqual(len(json_lvs), self.num_lvs)
+        self.assertEqual(len(vars_lvs), self.num_lvs)
+        for json_lv, vars_lv in zip(json_lvs, vars_lvs):
+            self.assertEqual((json_lv.vg_name, json_lv.lv_name, json_lv.uuid, json_lv.size, json_lv.attr,
+                              json_lv.segtype, json_lv.origin, json_lv.pool_lv, json_lv.data_lv,
+                              json_lv.metadata_lv, json_lv.roles, json_lv.move_pv, json_lv.data_percent,
+                              json_lv.metadata_percent, json_lv.copy_percent, json_lv.lv_tags),
+                             (vars_lv.vg_name, vars_lv.lv_name, vars_lv.uuid, vars_lv.size, vars_lv.attr,
+                              vars_lv.segtype, vars_lv.origin, vars_lv.pool_lv, vars_lv.data_lv,
+                              vars_lv.metadata_lv, vars_lv.roles, vars_lv.move_pv, vars_lv.data_percent,
+                              vars_lv.metadata_percent, vars_lv.copy_percent, vars_lv.lv_tags))
+
+        self.assertEqual(json_lvs[0].pool_lv, "pool0")
+        self.assertEqual(json_lvs[0].data_percent, 12)
+        self.assertEqual(json_lvs[0].lv_tags, ["tag0", "other"])
+        self.assertEqual(json_lvs[1].lv_tags, [])
+
+class LvmConcurrentQueriesTest(LVMTestCase):
+    # fake lvm taking some time to report a single LV
+    fake_lvm = "tests/fake_utils/lvm_many_lvs/"
+    delay = 0.5
+    num_threads = 8
+
+    def setUp(self):
+        self.addCleanup(self._clean_up)
+        os.environ["FAKE_LVM_NUM_LVS"] = "1"
+        os.environ["FAKE_LVM_DELAY"] = str(self.delay)
+
+    def _clean_up(self):
+        os.environ.pop("FAKE_LVM_NUM_LVS", None)
+        os.environ.pop("FAKE_LVM_DELAY", None)
+        BlockDev.lvm_set_global_config(None)
+
+        # make sure the library is initialized with the real lvm for other tests
+        BlockDev.reinit(self.requested_plugins, True, None)
+
+    def _run_queries(self, num_threads):
+        """Run the queries in num_threads threads, return the duration and the errors"""
+
+        errors = []
+
+        def query():
+            # exceptions raised in the thread would be lost, collect them
+            try:
+                info = BlockDev.lvm_lvinfo("vg0", "lv00000")
+                if info.lv_name != "lv00000":
+                    errors.append("wrong LV returned: %s" % info.lv_name)
+            except Exception as e:
+                errors.append(str(e))
+
+        threads = [threading.Thread(target=query) for _i in range(num_threads)]
+        start = time.monotonic()
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        duration = time.monotonic() - start
+
+        return duration, errors
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.SLOW)
+    def test_concurrent_queries_benchmark(self):
+        """Verify that LVM queries from multiple threads run in parallel"""
+
+        with fake_utils(self.fake_lvm):
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+
+            # the global config must not serialize the calls
+            self.assertTrue(BlockDev.lvm_set_global_config("backup {backup=0}"))
+
+            durations = {}
+            for num_threads in (1, 2, 4, self.num_threads):
+                durations[num_threads], errors = self._run_queries(num_threads)
+                self.assertEqual(errors, [])
+
+            # with the calls serialized, it would take at least num_threads * delay
+            self.assertLess(durations[self.num_threads], self.num_threads * self.delay / 2)
+
+    @tag_test(TestTags.NOSTORAGE)
+    def test_global_config_change_during_query(self):
+        """Verify that changing the global config doesn't wait for running queries"""
+
+        with fake_utils(self.fake_lvm):
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+
+            results = []
+            thread = threading.Thread(target=lambda: results.append(self._run_queries(1)))
+            thread.start()
+
+            # give the query some time to start
+            time.sleep(self.delay / 5)
+
+            start = time.monotonic()
+            self.assertTrue(BlockDev.lvm_set_global_config("backup {backup=0}"))
+            self.assertEqual(BlockDev.lvm_get_global_config(), "backup {backup=0}")
+            self.assertTrue(BlockDev.lvm_set_global_config(None))
+            self.assertLess(time.monotonic() - start, self.delay / 2)
+
+            thread.join()
+            self.assertEqual(len(results), 1)
+            _duration, errors = results[0]
+            self.assertEqual(errors, [])
+
+class LvmDevicesFilterTest(LVMTestCase):
+    fake_lvm = "tests/fake_utils/lvm_many_lvs/"
+
+    def setUp(self):
+        self.addCleanup(self._clean_up)
+        self.args_log = create_sparse_tempfile("lvm_args_log", 0)
+        os.environ["FAKE_LVM_NUM_LVS"] = "1"
+        os.environ["FAKE_LVM_ARGS_LOG"] = self.args_log
+
+    def _clean_up(self):
+        for var in ("FAKE_LVM_NUM_LVS", "FAKE_LVM_ARGS_LOG", "FAKE_LVM_VERSION"):
+            os.environ.pop(var, None)
+        os.unlink(self.args_log)
+        BlockDev.lvm_set_thread_devices_filter(None)
+        BlockDev.lvm_set_devices_filter(None)
+        BlockDev.lvm_set_global_config(None)
+
+        # make sure the library is initialized with the real lvm for other tests
+        BlockDev.reinit(self.requested_plugins, True, None)
+
+    def _get_lvs_args(self):
+        """Run lvs and return the arguments the (fake) lvm got"""
+
+        with open(self.args_log, "w"):
+            pass
+        BlockDev.lvm_lvs(None)
+        with open(self.args_log, "r") as f:
+            return json.loads(f.readlines()[-1])
+
+    @tag_test(TestTags.NOSTORAGE)
+    def test_devices_option(self):
+        """Verify that the devices filter is passed to LVM as '--devices'"""
+
+        os.environ["FAKE_LVM_VERSION"] = "2.03.14"
+        with fake_utils(self.fake_lvm):
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+
+            self.assertIsNone(BlockDev.lvm_get_devices_filter())
+            self.assertFalse(any(arg.startswith("--devices") for arg in self._get_lvs_args()))
+
+            self.assertTrue(BlockDev.lvm_set_devices_filter(["/dev/sda", "/dev/sdb"]))
+            self.assertEqual(BlockDev.lvm_get_devices_filter(), ["/dev/sda", "/dev/sdb"])
+            self.assertIn("--devices=/dev/sda,/dev/sdb", self._get_lvs_args())
+
+            # the global config and the devices filter are independent
+            self.assertTrue(BlockDev.lvm_set_global_config("backup {backup=0}"))
+            args = self._get_lvs_args()
+            self.assertIn("--devices=/dev/sda,/dev/sdb", args)
+            self.assertIn("--config=backup {backup=0}", args)
+            self.assertTrue(BlockDev.lvm_set_global_config(None))
+            self.assertEqual(BlockDev.lvm_get_devices_filter(), ["/dev/sda", "/dev/sdb"])
+
+            # per-thread filter overrides the global one only in its thread
+            thread_args = []
+            def run_in_thread():
+                BlockDev.lvm_set_thread_devices_filter(["/dev/sdc"])
+                thread_args.extend(self._get_lvs_args())
+            thread = threading.Thread(target=run_in_thread)
+            thread.start()
+            thread.join()
+            self.assertIn("--devices=/dev/sdc", thread_args)
+            self.assertIn("--devices=/dev/sda,/dev/sdb", self._get_lvs_args())
+
+            self.assertTrue(BlockDev.lvm_set_devices_filter(None))
+            self.assertIsNone(BlockDev.lvm_get_devices_filter())
+            self.assertFalse(any(arg.startswith("--devices") for arg in self._get_lvs_args()))
+
+    @tag_test(TestTags.NOSTORAGE)
+    def test_devices_filter_config(self):
+        """Verify that a global filter is used for LVM without '--devices'"""
+
+        os.environ["FAKE_LVM_VERSION"] = "2.03.05"
+        with fake_utils(self.fake_lvm):
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+
+            self.assertTrue(BlockDev.lvm_set_thread_devices_filter(["/dev/sda", "/dev/disk/by-id/a.b"]))
+            args = self._get_lvs_args()
+            self.assertFalse(any(arg.startswith("--devices") for arg in args))
+            self.assertIn('--config= devices {global_filter=["a|^/dev/sda$|", "a|^/dev/disk/by-id/a\\\\.b$|", "r|.*|"]}', args)
+
+            # the filter would silently override the one from the global config
+            self.assertTrue(BlockDev.lvm_set_global_config('devices {global_filter=["r|/dev/sdc|"]}'))
+            with self.assertRaisesRegex(GLib.GError, "global_filter"):
+                BlockDev.lvm_lvs(None)
+
 class LVMTechTest(LVMTestCase):
 
     def setUp(self):
@@ -1890,3 +2718,82 @@ class LVMVDOTest(LVMTestCase):
 
         full_stats = BlockDev.lvm_vdo_get_stats_full("testVDOVG", "vdoPool")
         self.assertIn("writeAmplificationRatio", full_stats.keys())
+
+    @tag_test(TestTags.SLOW)
+    def test_stats_rates(self):
+        succ = BlockDev.lvm_vdo_pool_create("testVDOVG", "vdoLV", "vdoPool", 7 * 1024**3, 35 * 1024**3)
+        self.assertTrue(succ)
+
+        prev = BlockDev.lvm_vdo_get_counters("testVDOVG", "vdoPool")
+        self.assertIsNotNone(prev)
+        self.assertNotEqual(prev.bios_in_write, -1)
+        self.assertNotEqual(prev.journal_blocks_written, -1)
+
+        # write some non-zero (zero blocks are not stored by VDO) data
+        ret, _out, err = run_command("dd if=/dev/urandom of=/dev/testVDOVG/vdoLV bs=1M count=4 oflag=direct")
+        self.assertEqual(ret, 0, err)
+
+        cur = BlockDev.lvm_vdo_get_counters("testVDOVG", "vdoPool")
+        self.assertIsNotNone(cur)
+        self.assertGreater(cur.bios_in_write, prev.bios_in_write)
+
+        rates = BlockDev.lvm_vdo_get_rates(prev, cur)
+        self.assertGreater(rates.interval, 0)
+        self.assertGreater(rates.write_rate, 0)
+        self.assertGreaterEqual(rates.journal_blocks_rate, 0)
+        self.assertGreaterEqual(rates.write_amplification_ratio, 0)
+
+        # snapshots in the wrong order
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_vdo_get_rates(cur, prev)
+
+    @tag_test(TestTags.SLOW)
+    def test_vdo_pool_create_tuning(self):
+        tuning = BlockDev.LVMVDOTuning(cpu_threads=2, bio_threads=2, hash_zone_threads=2,
+                                       logical_threads=2, physical_threads=1,
+                                       block_map_cache_size=256 * 1024**2)
+        succ = BlockDev.lvm_vdo_pool_create_with_tuning("testVDOVG", "vdoLV", "vdoPool", 7 * 1024**3, 35 * 1024**3,
+                                                        tuning=tuning)
+        self.assertTrue(succ)
+
+        lv_info = BlockDev.lvm_lvinfo("testVDOVG", "vdoLV")
+        self.assertIsNotNone(lv_info)
+        self.assertEqual(lv_info.segtype, "vdo")
+
+        active = BlockDev.lvm_vdo_get_tuning("testVDOVG", "vdoPool")
+        self.assertIsNotNone(active)
+        self.assertEqual(active.cpu_threads, 2)
+        self.assertEqual(active.bio_threads, 2)
+        self.assertEqual(active.hash_zone_threads, 2)
+        self.assertEqual(active.logical_threads, 2)
+        self.assertEqual(active.physical_threads, 1)
+        self.assertEqual(active.block_map_cache_size, 256 * 1024**2)
+
+        # not a VDO pool
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_vdo_get_tuning("testVDOVG", "vdoLV")
+
+        # block map cache size has to be a multiple of 1 MiB
+        tuning = BlockDev.LVMVDOTuning(block_map_cache_size=256 * 1024**2 + 512)
+        with self.assertRaisesRegex(GLib.GError, "multiple of 1 MiB"):
+            BlockDev.lvm_vdo_pool_create_with_tuning("testVDOVG", "vdoLV2", "vdoPool2", 7 * 1024**3, 35 * 1024**3,
+                                                     tuning=tuning)
+
+    @tag_test(TestTags.SLOW)
+    def test_vdo_pool_convert_tuning(self):
+        succ = BlockDev.lvm_lvcreate("testVDOVG", "testLV", 7 * 1024**3)
+        self.assertTrue(succ)
+
+        tuning = BlockDev.LVMVDOTuning(cpu_threads=3, ack_threads=2)
+        succ = BlockDev.lvm_vdo_pool_convert_with_tuning("testVDOVG", "testLV", "vdoLV", 35 * 1024**3,
+                                                         tuning=tuning)
+        self.assertTrue(succ)
+
+        pool_info = BlockDev.lvm_lvinfo("testVDOVG", "testLV")
+        self.assertIsNotNone(pool_info)
+        self.assertEqual(pool_info.segtype, "vdo-pool")
+
+        active = BlockDev.lvm_vdo_get_tuning("testVDOVG", "testLV")
+        self.assertIsNotNone(active)
+        self.assertEqual(active.cpu_threads, 3)
+        self.assertEqual(active.ack_threads, 2)
@@ -1,10 +1,14 @@
 import unittest
 import re
+import ctypes
+import signal
 import os
+import time
+import threading
 import overrides_hack
 from utils import fake_utils, create_sparse_tempfile, create_lio_device, delete_lio_device, run_command, TestTags, tag_test, read_file
 
-from gi.repository import BlockDev, GLib
+from gi.repository import BlockDev, GLib, Gio
 
 
 class UtilsTestCase(unittest.TestCase):
@@ -208,6 +212,46 @@ class UtilsExecLoggingTest(UtilsTestCase):
         self.assertTrue(succ)
         self.assertIn("LC_ALL=C", out)
 
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_env_change(self):
+        """Verify that changes of the environment are passed to the executed processes"""
+
+        self.addCleanup(os.environ.pop, "LIBBLOCKDEV_TEST_VAR", None)
+
+        os.environ["LIBBLOCKDEV_TEST_VAR"] = "value1"
+        succ, out = BlockDev.utils_exec_and_capture_output(["env"])
+        self.assertTrue(succ)
+        self.assertIn("LIBBLOCKDEV_TEST_VAR=value1", out)
+        self.assertIn("LC_ALL=C", out)
+
+        os.environ["LIBBLOCKDEV_TEST_VAR"] = "value2"
+        succ, out = BlockDev.utils_exec_and_capture_output(["env"])
+        self.assertTrue(succ)
+        self.assertIn("LIBBLOCKDEV_TEST_VAR=value2", out)
+
+        del os.environ["LIBBLOCKDEV_TEST_VAR"]
+        succ, out = BlockDev.utils_exec_and_capture_output(["env"])
+        self.assertTrue(succ)
+        self.assertNotIn("LIBBLOCKDEV_TEST_VAR", out)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_stdin_signals(self):
+        """Verify that the executed processes don't inherit stdin and blocked signals"""
+
+        succ, out = BlockDev.utils_exec_and_capture_output(["readlink", "/proc/self/fd/0"])
+        self.assertTrue(succ)
+        self.assertEqual(out.strip(), "/dev/null")
+
+        if not _have_posix_spawn_backend():
+            # GLib's fork()-based spawning keeps the signal mask
+            return
+
+        old_mask = signal.pthread_sigmask(signal.SIG_BLOCK, {signal.SIGTERM})
+        self.addCleanup(signal.pthread_sigmask, signal.SIG_SETMASK, old_mask)
+        succ, out = BlockDev.utils_exec_and_capture_output(["grep", "^SigBlk:", "/proc/self/status"])
+        self.assertTrue(succ)
+        self.assertEqual(int(out.split()[1], 16), 0)
+
     @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
     def test_exec_buffer_bloat(self):
         """Verify that very large output from a command is handled properly"""
@@ -354,6 +398,49 @@ class UtilsExecLoggingTest(UtilsTestCase):
         status = BlockDev.utils_exec_and_report_progress(["bash", "-c", "for i in {1..%d}; do echo -e \"%s\\0%s\"; echo -e \"%s\\0%s\" >&2; done" % (cnt, self.EXEC_PROGRESS_MSG, self.EXEC_PROGRESS_MSG, self.EXEC_PROGRESS_MSG, self.EXEC_PROGRESS_MSG)], None, None)
         self.assertTrue(status)
 
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_process_lines(self):
+        """Verify that output can be processed line by line"""
+
+        lines = []
+
+        def add_line(line, _data):
+            lines.append(line)
+            return True
+
+        succ = BlockDev.utils_exec_and_process_lines(["seq", "1", "100000"], None, add_line, None, 0)
+        self.assertTrue(succ)
+        self.assertEqual(len(lines), 100000)
+        self.assertEqual(lines[0], "1")
+        self.assertEqual(lines[-1], "100000")
+
+        # last line without the newline character
+        lines.clear()
+        succ = BlockDev.utils_exec_and_process_lines(["printf", "a\\nb"], None, add_line, None, 0)
+        self.assertTrue(succ)
+        self.assertEqual(lines, ["a", "b"])
+
+        # no output at all
+        lines.clear()
+        succ = BlockDev.utils_exec_and_process_lines(["true"], None, add_line, None, 0)
+        self.assertTrue(succ)
+        self.assertEqual(lines, [])
+
+        # processing stopped by the callback
+        def add_ten_lines(line, _data):
+            lines.append(line)
+            return len(lines) < 10
+
+        lines.clear()
+        with self.assertRaisesRegex(GLib.GError, r"Processing of the output stopped"):
+            BlockDev.utils_exec_and_process_lines(["seq", "1", "1000000"], None, add_ten_lines, None, 0)
+        self.assertEqual(len(lines), 10)
+
+        # only the end of the error output is kept
+        with self.assertRaises(GLib.GError) as ctx:
+            BlockDev.utils_exec_and_process_lines(["sh", "-c", "seq 1 1000 >&2; exit 1"], None, add_line, None, 4)
+        self.assertEqual(ctx.exception.message, "Process reported exit code 1: 000\n")
+
     def test_exec_large_input(self):
         """Verify that large input is passed to the process properly"""
 
@@ -377,6 +464,287 @@ class UtilsExecLoggingTest(UtilsTestCase):
         self.assertTrue(status)
 
 
+class UtilsExecCancellableTest(UtilsTestCase):
+    def _deadline(self, seconds):
+        return GLib.get_monotonic_time() + int(seconds * 1000000)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_deadline(self):
+        """Verify that processes are killed when they don't finish in time"""
+
+        succ = BlockDev.utils_exec_and_report_error_cancellable(["true"], None, None, self._deadline(10))
+        self.assertTrue(succ)
+
+        start = time.monotonic()
+        with self.assertRaisesRegex(GLib.GError, r"didn't finish in time"):
+            BlockDev.utils_exec_and_report_error_cancellable(["sleep", "60"], None, None, self._deadline(0.5))
+        self.assertLess(time.monotonic() - start, 10)
+
+        # SIGTERM ignored, SIGKILL needed
+        start = time.monotonic()
+        with self.assertRaisesRegex(GLib.GError, r"didn't finish in time"):
+            BlockDev.utils_exec_and_capture_output_cancellable(["sh", "-c", "trap '' TERM; sleep 60"], None, None, self._deadline(0.5))
+        self.assertLess(time.monotonic() - start, 15)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_cancel(self):
+        """Verify that processes are killed when cancelled"""
+
+        cancellable = Gio.Cancellable()
+        timer = threading.Timer(0.5, cancellable.cancel)
+        timer.start()
+        self.addCleanup(timer.cancel)
+
+        start = time.monotonic()
+        with self.assertRaises(GLib.GError) as ctx:
+            BlockDev.utils_exec_and_report_error_cancellable(["sleep", "60"], None, cancellable, 0)
+        self.assertTrue(ctx.exception.matches(Gio.io_error_quark(), Gio.IOErrorEnum.CANCELLED))
+        self.assertLess(time.monotonic() - start, 10)
+
+        # already cancelled
+        with self.assertRaises(GLib.GError):
+            BlockDev.utils_exec_and_capture_output_cancellable(["echo", "hi"], None, cancellable, 0)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_thread_cancellable(self):
+        """Verify that the thread's deadline applies to all executed processes"""
+
+        self.addCleanup(BlockDev.utils_set_thread_cancellable, None, 0)
+
+        BlockDev.utils_set_thread_cancellable(None, self._deadline(0.5))
+        with self.assertRaisesRegex(GLib.GError, r"didn't finish in time"):
+            BlockDev.utils_exec_and_report_error(["sleep", "60"])
+        with self.assertRaisesRegex(GLib.GError, r"didn't finish in time"):
+            BlockDev.utils_exec_and_report_error_no_progress(["sleep", "60"])
+
+        BlockDev.utils_set_thread_cancellable(None, 0)
+        self.assertTrue(BlockDev.utils_exec_and_report_error(["true"]))
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_async(self):
+        """Verify that processes can be executed asynchronously"""
+
+        loop = GLib.MainLoop()
+        results = []
+
+        def done(_source, result, _data):
+            try:
+                results.append(BlockDev.utils_exec_finish(result))
+            except GLib.GError as e:
+                results.append(e)
+            loop.quit()
+
+        BlockDev.utils_exec_async(["echo", "hello"], None, 0, None, done, None)
+        loop.run()
+        succ, out = results[-1]
+        self.assertTrue(succ)
+        self.assertEqual(out, "hello\n")
+
+        BlockDev.utils_exec_async(["false"], None, 0, None, done, None)
+        loop.run()
+        self.assertIsInstance(results[-1], GLib.GError)
+
+        cancellable = Gio.Cancellable()
+        BlockDev.utils_exec_async(["sleep", "60"], None, 0, cancellable, done, None)
+        GLib.timeout_add(500, lambda: cancellable.cancel() and False)
+        loop.run()
+        self.assertIsInstance(results[-1], GLib.GError)
+
+
+class UtilsExecBatchTest(UtilsTestCase):
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_batch(self):
+        """Verify that batches of commands run in parallel"""
+
+        batch = BlockDev.UtilsBatch.new()
+        for _i in range(4):
+            batch.add_command(["sleep", "0.5"], None, None)
+
+        start = time.monotonic()
+        succ = BlockDev.utils_exec_batch(batch, 4)
+        self.assertTrue(succ)
+        self.assertLess(time.monotonic() - start, 1.5)
+
+        for i in range(4):
+            self.assertTrue(batch.get_result(i))
+
+        # a batch can only be run once
+        with self.assertRaisesRegex(GLib.GError, r"already been run"):
+            BlockDev.utils_exec_batch(batch, 4)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_batch_same_device(self):
+        """Verify that batch items working with the same device don't run in parallel"""
+
+        batch = BlockDev.UtilsBatch.new()
+        batch.add_command(["sleep", "0.5"], None, "/nonexistent/disk")
+        batch.add_command(["sleep", "0.5"], None, "/nonexistent/disk")
+        batch.add_command(["sleep", "0.5"], None, "/nonexistent/other_disk")
+
+        start = time.monotonic()
+        succ = BlockDev.utils_exec_batch(batch, 4)
+        self.assertTrue(succ)
+        self.assertGreaterEqual(time.monotonic() - start, 1.0)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_batch_failures(self):
+        """Verify that errors of batch items are reported"""
+
+        batch = BlockDev.UtilsBatch.new()
+        batch.add_command(["true"], None, None)
+        batch.add_command(["sh", "-c", "echo failure >&2; exit 3"], None, None)
+        batch.add_command(["libblockdev-nonexistent-util"], None, None)
+
+        with self.assertRaisesRegex(GLib.GError, r"2 of 3 items of the batch failed"):
+            BlockDev.utils_exec_batch(batch, 0)
+
+        self.assertTrue(batch.get_result(0))
+        with self.assertRaisesRegex(GLib.GError, r"Process reported exit code 3: failure"):
+            batch.get_result(1)
+        with self.assertRaises(GLib.GError):
+            batch.get_result(2)
+        with self.assertRaisesRegex(GLib.GError, r"Invalid batch item index"):
+            batch.get_result(3)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_batch_thread_cancellable(self):
+        """Verify that the thread's deadline applies to the batch items"""
+
+        self.addCleanup(BlockDev.utils_set_thread_cancellable, None, 0)
+
+        BlockDev.utils_set_thread_cancellable(None, GLib.get_monotonic_time() + 500000)
+        batch = BlockDev.UtilsBatch.new()
+        BlockDev.utils_set_thread_cancellable(None, 0)
+        batch.add_command(["sleep", "60"], None, None)
+        batch.add_command(["sleep", "60"], None, None)
+
+        start = time.monotonic()
+        with self.assertRaisesRegex(GLib.GError, r"2 of 2 items of the batch failed"):
+            BlockDev.utils_exec_batch(batch, 2)
+        self.assertLess(time.monotonic() - start, 10)
+
+        with self.assertRaisesRegex(GLib.GError, r"didn't finish in time"):
+            batch.get_result(0)
+
+
+class UtilsExecStatsTest(UtilsTestCase):
+    def setUp(self):
+        BlockDev.utils_reset_exec_stats()
+        self.addCleanup(BlockDev.utils_reset_exec_stats)
+        self.addCleanup(BlockDev.utils_set_exec_stats_enabled, False)
+
+    def _get_stats(self):
+        return {stats.util: stats for stats in BlockDev.utils_get_exec_stats()}
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_stats(self):
+        """Verify that statistics about executed utilities are collected"""
+
+        # disabled by default
+        BlockDev.utils_exec_and_report_error(["true"])
+        self.assertEqual(self._get_stats(), {})
+
+        BlockDev.utils_set_exec_stats_enabled(True)
+        for _i in range(2):
+            BlockDev.utils_exec_and_report_error(["/bin/true"])
+        BlockDev.utils_exec_and_report_error_no_progress(["true"])
+        with self.assertRaises(GLib.GError):
+            BlockDev.utils_exec_and_report_error(["false"])
+        with self.assertRaises(GLib.GError):
+            BlockDev.utils_exec_and_report_error(["libblockdev-nonexistent-util"])
+        succ, out = BlockDev.utils_exec_and_capture_output(["echo", "hello"])
+        self.assertTrue(succ)
+        succ = BlockDev.utils_exec_and_process_lines(["seq", "1", "10"], None, lambda _line, _data: True, None, 0)
+        self.assertTrue(succ)
+
+        stats = self._get_stats()
+        self.assertEqual(set(stats.keys()), {"true", "false", "libblockdev-nonexistent-util", "echo", "seq"})
+
+        self.assertEqual(stats["true"].calls, 3)
+        self.assertEqual(stats["true"].failures, 0)
+        self.assertGreater(stats["true"].total_time, 0)
+        self.assertGreaterEqual(stats["true"].total_time, stats["true"].max_time)
+        self.assertLessEqual(stats["true"].time_p50, stats["true"].time_p99)
+        self.assertLessEqual(stats["true"].time_p99, stats["true"].max_time)
+        self.assertLessEqual(stats["true"].total_spawn_time, stats["true"].total_time)
+
+        self.assertEqual(stats["false"].calls, 1)
+        self.assertEqual(stats["false"].failures, 1)
+        self.assertEqual(stats["libblockdev-nonexistent-util"].failures, 1)
+
+        self.assertEqual(stats["echo"].stdout_bytes, len("hello\n"))
+        self.assertEqual(stats["echo"].stderr_bytes, 0)
+        self.assertEqual(stats["seq"].stdout_bytes, len("".join("%d\n" % i for i in range(1, 11))))
+
+        # disabling keeps the collected data
+        BlockDev.utils_set_exec_stats_enabled(False)
+        BlockDev.utils_exec_and_report_error(["true"])
+        self.assertEqual(self._get_stats()["true"].calls, 3)
+
+        BlockDev.utils_reset_exec_stats()
+        self.assertEqual(self._get_stats(), {})
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_stats_prometheus(self):
+        """Verify that statistics about executed utilities can be exported for Prometheus"""
+
+        BlockDev.utils_set_exec_stats_enabled(True)
+        BlockDev.utils_exec_and_report_error(["true"])
+        with self.assertRaises(GLib.GError):
+            BlockDev.utils_exec_and_report_error(["false"])
+
+        text = BlockDev.utils_get_exec_stats_prometheus()
+        self.assertIn("# TYPE bd_utils_exec_calls_total counter\n", text)
+        self.assertIn('bd_utils_exec_calls_total{util="true"} 1\n', text)
+        self.assertIn('bd_utils_exec_failures_total{util="false"} 1\n', text)
+        self.assertIn('bd_utils_exec_failures_total{util="true"} 0\n', text)
+        self.assertIn("# TYPE bd_utils_exec_duration_seconds histogram\n", text)
+        self.assertIn('bd_utils_exec_duration_seconds_bucket{util="true",le="+Inf"} 1\n', text)
+        self.assertIn('bd_utils_exec_duration_seconds_count{util="false"} 1\n', text)
+
+
+def _have_posix_spawn_backend():
+    # the posix_spawn() backend is only used if libc has this function (glibc >= 2.34),
+    # otherwise the utilities are still started with fork() by GLib
+    try:
+        ctypes.CDLL(None).posix_spawn_file_actions_addclosefrom_np
+    except AttributeError:
+        return False
+    return True
+
+
+@unittest.skipUnless(_have_posix_spawn_backend(), "posix_spawn backend not available")
+class UtilsExecSpawnBenchmark(UtilsTestCase):
+    RUNS = 50
+    RSS_SIZES = (0, 128 * 1024**2, 512 * 1024**2)
+
+    def _spawn_latency(self, rss_size):
+        # make the memory resident (touch every page)
+        ballast = bytearray(rss_size)
+        ballast[::4096] = b"\x01" * len(range(0, rss_size, 4096))
+
+        start = time.monotonic()
+        for _i in range(self.RUNS):
+            self.assertTrue(BlockDev.utils_exec_and_report_error(["true"]))
+        latency = (time.monotonic() - start) / self.RUNS
+
+        del ballast
+        return latency
+
+    @tag_test(TestTags.SLOW, TestTags.NOSTORAGE)
+    def test_spawn_latency(self):
+        """Verify that the latency of running utilities doesn't grow with memory usage"""
+
+        latencies = {size: self._spawn_latency(size) for size in self.RSS_SIZES}
+        baseline = latencies[0]
+
+        # copying the page tables of the parent process (fork()) would make
+        # this grow with the RSS, leave some room for noise
+        for size, latency in latencies.items():
+            self.assertLess(latency, baseline * 3 + 0.005,
+                            "spawn latency with %d MiB RSS: %f s (baseline: %f s)" % (size // 1024**2, latency, baseline))
+
+
 class UtilsDevUtilsTestCase(UtilsTestCase):
     @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
     def test_resolve_device(self):
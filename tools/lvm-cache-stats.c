@@ -9,10 +9,13 @@
 
 void print_usage (const char *cmd) {
     fprintf (stderr,
-             "Usage: %s CACHED_LV [CACHED_LV2...]\n"
-             "-h    --help   Print this usage info\n"
-             "-j    --json   Print stats as JSON\n"
-             "Options need to be specified before LVs.\n",
+             "Usage: %s [OPTIONS] CACHED_LV|VG [CACHED_LV2|VG2...]\n"
+             "-h    --help          Print this usage info\n"
+             "-j    --json          Print stats as JSON (one object per line)\n"
+             "-i N  --interval N    Sample the stats every N seconds (default: 1 with --count > 1)\n"
+             "-c M  --count M       Stop after M samples (default: 1 without --interval, unlimited with it)\n"
+             "Cached LVs are specified in the VG/LV format, all cached LVs of a VG are watched\n"
+             "if just VG is specified.\n",
              cmd);
 }
 
@@ -25,87 +28,300 @@ void print_size (guint64 bytes, gboolean newline) {
 }
 
 void print_ratio (guint64 part, guint64 total, gboolean space, gboolean newline) {
-    float percent = ((float) part / total) * 100;
+    float percent = total ? ((float) part / total) * 100 : 0;
     printf ("%s[%6.2f%%]%s", space ? " " : "", percent, newline ? "\n" : "");
 }
 
-gboolean print_lv_stats (const char *vg_name, const char *lv_name, GError **error) {
-    BDLVMLVdata *lv_data = bd_lvm_lvinfo (vg_name, lv_name, error);
-    if (!lv_data)
-        return FALSE;
-    BDLVMCacheStats *stats = bd_lvm_cache_stats (vg_name, lv_name, error);
-    if (!stats)
-        return FALSE;
+double get_ratio (guint64 part, guint64 total) {
+    return total ? (double) part / total : 0.0;
+}
+
+/* per-second rate of the change of a counter between two samples */
+double get_rate (guint64 cur, guint64 prev, double seconds) {
+    /* counters are reset when the cache is reloaded */
+    if (cur < prev || seconds <= 0)
+        return 0.0;
+    return (cur - prev) / seconds;
+}
+
+/* one of the VG/LV or VG arguments */
+typedef struct LVSpec {
+    char *vg_name;
+    char *lv_name;  /* NULL for all cached LVs in the VG */
+    gboolean found;
+} LVSpec;
+
+/* stats of a watched cached LV from the previous sample */
+typedef struct WatchedLV {
+    guint64 lv_size;
+    BDLVMCacheStats *stats;
+    gint64 time;
+} WatchedLV;
+
+void watched_lv_free (WatchedLV *lv) {
+    bd_lvm_cache_stats_free (lv->stats);
+    g_free (lv);
+}
 
+void print_lv_stats (const char *vg_name, const char *lv_name, guint64 lv_size, const BDLVMCacheStats *stats) {
     printf ("%s/%s:\n", vg_name, lv_name);
-    printf ("  mode:      %13s\n", bd_lvm_cache_get_mode_str (stats->mode, error)); /* ignoring 'error', must be a valid mode */
-    printf ("  LV size:      "); print_size (lv_data->size, TRUE);
+    printf ("  mode:      %13s\n", bd_lvm_cache_get_mode_str (stats->mode, NULL)); /* must be a valid mode */
+    printf ("  LV size:      "); print_size (lv_size, TRUE);
     printf ("  cache size:   "); print_size (stats->cache_size, TRUE);
     printf ("  cache used:   "); print_size (stats->cache_used, FALSE); print_ratio (stats->cache_used, stats->cache_size, TRUE, TRUE);
+    printf ("  cache dirty:  "); print_size (stats->cache_dirty, FALSE); print_ratio (stats->cache_dirty, stats->cache_size, TRUE, TRUE);
     printf ("  read misses:  %10"G_GUINT64_FORMAT"\n", stats->read_misses);
     printf ("  read hits:    %10"G_GUINT64_FORMAT, stats->read_hits); print_ratio (stats->read_hits, stats->read_hits + stats->read_misses, TRUE, TRUE);
     printf ("  write misses: %10"G_GUINT64_FORMAT"\n", stats->write_misses);
     printf ("  write hits:   %10"G_GUINT64_FORMAT, stats->write_hits); print_ratio (stats->write_hits, stats->write_hits + stats->write_misses, TRUE, TRUE);
+    printf ("  promotions:   %10"G_GUINT64_FORMAT"\n", stats->promotions);
+    printf ("  demotions:    %10"G_GUINT64_FORMAT"\n", stats->demotions);
+}
+
+void print_lv_rates_header (void) {
+    printf ("%-24s %10s %10s %8s %10s %10s %8s %9s %9s %10s %12s\n",
+            "LV", "rd-hit/s", "rd-miss/s", "rd-hit%", "wr-hit/s", "wr-miss/s", "wr-hit%",
+            "promo/s", "demo/s", "dirty", "dirty-delta");
+}
 
-    bd_lvm_lvdata_free (lv_data);
-    bd_lvm_cache_stats_free (stats);
+void print_lv_rates (const char *vg_name, const char *lv_name, const BDLVMCacheStats *stats,
+                     const BDLVMCacheStats *prev, double seconds) {
+    gchar *name = g_strdup_printf ("%s/%s", vg_name, lv_name);
+    guint64 read_hits = stats->read_hits >= prev->read_hits ? stats->read_hits - prev->read_hits : 0;
+    guint64 read_misses = stats->read_misses >= prev->read_misses ? stats->read_misses - prev->read_misses : 0;
+    guint64 write_hits = stats->write_hits >= prev->write_hits ? stats->write_hits - prev->write_hits : 0;
+    guint64 write_misses = stats->write_misses >= prev->write_misses ? stats->write_misses - prev->write_misses : 0;
+    gint64 dirty_delta = (gint64) stats->cache_dirty - (gint64) prev->cache_dirty;
 
-    return TRUE;
+    printf ("%-24s %10.1f %10.1f %7.2f%% %10.1f %10.1f %7.2f%% %9.1f %9.1f",
+            name,
+            get_rate (stats->read_hits, prev->read_hits, seconds),
+            get_rate (stats->read_misses, prev->read_misses, seconds),
+            get_ratio (read_hits, read_hits + read_misses) * 100,
+            get_rate (stats->write_hits, prev->write_hits, seconds),
+            get_rate (stats->write_misses, prev->write_misses, seconds),
+            get_ratio (write_hits, write_hits + write_misses) * 100,
+            get_rate (stats->promotions, prev->promotions, seconds),
+            get_rate (stats->demotions, prev->demotions, seconds));
+    printf (" "); print_size (stats->cache_dirty, FALSE);
+    printf (" %+9.2f MiB\n", (double) dirty_delta / (1024 * 1024));
+
+    g_free (name);
 }
 
-gboolean print_lv_stats_json(const char *vg_name, const char *lv_name, GError **error) {
-    BDLVMLVdata *lv_data = bd_lvm_lvinfo (vg_name, lv_name, error);
-    if (!lv_data)
-        return FALSE;
-    BDLVMCacheStats *stats = bd_lvm_cache_stats (vg_name, lv_name, error);
-    if (!stats)
-        return FALSE;
+/* prints @str as a JSON string (including the quotes) */
+void print_json_str (const char *str) {
+    putchar ('"');
+    for (const char *c = str; *c; c++) {
+        if (*c == '"' || *c == '\\')
+            printf ("\\%c", *c);
+        else if ((unsigned char) *c < 0x20)
+            printf ("\\u%04x", (unsigned char) *c);
+        else
+            putchar (*c);
+    }
+    putchar ('"');
+}
+
+void print_lv_stats_json (const char *vg_name, const char *lv_name, guint64 lv_size, const BDLVMCacheStats *stats,
+                          const BDLVMCacheStats *prev, double seconds, gint64 timestamp) {
+    printf ("{\"timestamp\": %0.3f, ", (double) timestamp / G_USEC_PER_SEC);
+    gchar *name = g_strdup_printf ("%s/%s", vg_name, lv_name);
+    printf ("\"lv\": "); print_json_str (name); printf (", ");
+    g_free (name);
+    printf ("\"mode\": \"%s\", ", bd_lvm_cache_get_mode_str (stats->mode, NULL)); /* must be a valid mode */
+    printf ("\"lv-size\": %"G_GUINT64_FORMAT", ", lv_size);
+    printf ("\"cache-size\": %"G_GUINT64_FORMAT", ", stats->cache_size);
+    printf ("\"cache-used\": %"G_GUINT64_FORMAT", ", stats->cache_used);
+    printf ("\"cache-used-pct\": %0.2f, ", get_ratio (stats->cache_used, stats->cache_size) * 100);
+    printf ("\"cache-dirty\": %"G_GUINT64_FORMAT", ", stats->cache_dirty);
+    printf ("\"read-misses\": %"G_GUINT64_FORMAT", ", stats->read_misses);
+    printf ("\"read-hits\": %"G_GUINT64_FORMAT", ", stats->read_hits);
+    printf ("\"read-hit-ratio\": %0.2f, ", get_ratio (stats->read_hits, stats->read_hits + stats->read_misses));
+    printf ("\"write-misses\": %"G_GUINT64_FORMAT", ", stats->write_misses);
+    printf ("\"write-hits\": %"G_GUINT64_FORMAT", ", stats->write_hits);
+    printf ("\"write-hit-ratio\": %0.2f, ", get_ratio (stats->write_hits, stats->write_hits + stats->write_misses));
+    printf ("\"promotions\": %"G_GUINT64_FORMAT", ", stats->promotions);
+    printf ("\"demotions\": %"G_GUINT64_FORMAT, stats->demotions);
+
+    if (prev) {
+        guint64 read_hits = stats->read_hits >= prev->read_hits ? stats->read_hits - prev->read_hits : 0;
+        guint64 read_misses = stats->read_misses >= prev->read_misses ? stats->read_misses - prev->read_misses : 0;
+        guint64 write_hits = stats->write_hits >= prev->write_hits ? stats->write_hits - prev->write_hits : 0;
+        guint64 write_misses = stats->write_misses >= prev->write_misses ? stats->write_misses - prev->write_misses : 0;
+
+        printf (", \"interval\": %0.3f, ", seconds);
+        printf ("\"read-hits-per-sec\": %0.2f, ", get_rate (stats->read_hits, prev->read_hits, seconds));
+        printf ("\"read-misses-per-sec\": %0.2f, ", get_rate (stats->read_misses, prev->read_misses, seconds));
+        printf ("\"interval-read-hit-ratio\": %0.2f, ", get_ratio (read_hits, read_hits + read_misses));
+        printf ("\"write-hits-per-sec\": %0.2f, ", get_rate (stats->write_hits, prev->write_hits, seconds));
+        printf ("\"write-misses-per-sec\": %0.2f, ", get_rate (stats->write_misses, prev->write_misses, seconds));
+        printf ("\"interval-write-hit-ratio\": %0.2f, ", get_ratio (write_hits, write_hits + write_misses));
+        printf ("\"promotions-per-sec\": %0.2f, ", get_rate (stats->promotions, prev->promotions, seconds));
+        printf ("\"demotions-per-sec\": %0.2f, ", get_rate (stats->demotions, prev->demotions, seconds));
+        printf ("\"cache-dirty-delta\": %"G_GINT64_FORMAT, (gint64) stats->cache_dirty - (gint64) prev->cache_dirty);
+    }
 
-    printf ("{\n");
-    printf ("  \"lv\": \"%s/%s\",\n", vg_name, lv_name);
-    printf ("  \"mode\": \"%s\",\n", bd_lvm_cache_get_mode_str (stats->mode, error)); /* ignoring 'error', must be a valid mode */
-    printf ("  \"lv-size\": %"G_GUINT64_FORMAT",\n", lv_data->size);
-    printf ("  \"cache-size\": %"G_GUINT64_FORMAT",\n", stats->cache_size);
-    printf ("  \"cache-used\": %"G_GUINT64_FORMAT",\n", stats->cache_size);
-    printf ("  \"cache-used-pct\": %0.2f,\n", (double) stats->cache_used / stats->cache_size);
-    printf ("  \"read-misses\": %"G_GUINT64_FORMAT",\n", stats->read_misses);
-    printf ("  \"read-hits\": %"G_GUINT64_FORMAT",\n", stats->read_hits);
-    printf ("  \"read-hit-ratio\": %0.2f,\n", (double)stats->read_hits / (stats->read_hits + stats->read_misses));
-    printf ("  \"write-misses\": %"G_GUINT64_FORMAT",\n", stats->write_misses);
-    printf ("  \"write-hits\": %"G_GUINT64_FORMAT",\n", stats->write_hits);
-    printf ("  \"write-hit-ratio\": %0.2f\n", (double)stats->write_hits / (stats->write_hits + stats->write_misses));
     printf ("}\n");
+}
+
+LVSpec* find_spec (LVSpec *specs, guint n_specs, const char *vg_name, const char *lv_name) {
+    for (guint i = 0; i < n_specs; i++)
+        if (g_strcmp0 (specs[i].vg_name, vg_name) == 0 &&
+            (!specs[i].lv_name || g_strcmp0 (specs[i].lv_name, lv_name) == 0))
+            return &(specs[i]);
+    return NULL;
+}
+
+/**
+ * Takes one sample of the stats of all the watched LVs and prints it.
+ *
+ * All the stats are taken from a single bd_lvm_cache_stats_all() call which
+ * only queries the DM maps, the LV sizes are looked up in @lv_sizes which is
+ * filled only once at startup so no LVM commands are run for the samples.
+ */
+gboolean sample (LVSpec *specs, guint n_specs, GHashTable *lv_sizes, GHashTable *watched, gboolean json,
+                 guint64 n_sample, GError **error) {
+    BDLVMCachedLVStats **all_stats = NULL;
+    gint64 now = 0;
+    gboolean printed = FALSE;
+    gboolean ok = TRUE;
+
+    all_stats = bd_lvm_cache_stats_all (error);
+    if (!all_stats)
+        return FALSE;
+    now = g_get_monotonic_time ();
+
+    for (guint i = 0; i < n_specs; i++)
+        specs[i].found = FALSE;
+
+    if (!json && n_sample > 0)
+        print_lv_rates_header ();
 
-    bd_lvm_lvdata_free (lv_data);
-    bd_lvm_cache_stats_free (stats);
+    for (BDLVMCachedLVStats **lv_stats_p = all_stats; *lv_stats_p; lv_stats_p++) {
+        BDLVMCachedLVStats *lv_stats = *lv_stats_p;
+        LVSpec *spec = find_spec (specs, n_specs, lv_stats->vg_name, lv_stats->lv_name);
+        if (!spec)
+            continue;
+        spec->found = TRUE;
+
+        gchar *key = g_strdup_printf ("%s/%s", lv_stats->vg_name, lv_stats->lv_name);
+        WatchedLV *lv = g_hash_table_lookup (watched, key);
+        if (!lv) {
+            guint64 *lv_size = g_hash_table_lookup (lv_sizes, key);
+            lv = g_new0 (WatchedLV, 1);
+            lv->lv_size = lv_size ? *lv_size : 0;
+            g_hash_table_insert (watched, key, lv);
+        } else
+            g_free (key);
+
+        double seconds = (double) (now - lv->time) / G_USEC_PER_SEC;
+        const BDLVMCacheStats *prev = lv->stats;
+
+        if (json)
+            print_lv_stats_json (lv_stats->vg_name, lv_stats->lv_name, lv->lv_size, lv_stats->stats, prev, seconds, g_get_real_time ());
+        else if (prev)
+            print_lv_rates (lv_stats->vg_name, lv_stats->lv_name, lv_stats->stats, prev, seconds);
+        else {
+            /* Add one blank line between stats for the individual LVs */
+            if (printed)
+                printf ("\n");
+            print_lv_stats (lv_stats->vg_name, lv_stats->lv_name, lv->lv_size, lv_stats->stats);
+        }
+        printed = TRUE;
+
+        bd_lvm_cache_stats_free (lv->stats);
+        lv->stats = bd_lvm_cache_stats_copy (lv_stats->stats);
+        lv->time = now;
+    }
 
-    return TRUE;
+    for (guint i = 0; i < n_specs; i++) {
+        if (specs[i].found)
+            continue;
+        if (specs[i].lv_name)
+            fprintf (stderr, "Failed to get stats for '%s/%s': not an active cached LV\n",
+                     specs[i].vg_name, specs[i].lv_name);
+        else
+            fprintf (stderr, "No active cached LVs found in the VG '%s'\n", specs[i].vg_name);
+        ok = FALSE;
+    }
+
+    for (BDLVMCachedLVStats **lv_stats_p = all_stats; *lv_stats_p; lv_stats_p++)
+        bd_lvm_cached_lv_stats_free (*lv_stats_p);
+    g_free (all_stats);
+
+    fflush (stdout);
+
+    return ok;
 }
 
 int main (int argc, char *argv[]) {
     gboolean ret = FALSE;
     GError *error = NULL;
-
-    if ((g_strcmp0 (argv[1], "-h") == 0) || g_strcmp0 (argv[1], "--help") == 0) {
-        print_usage (argv[0]);
-        return 1;
-    }
-
     gboolean json = FALSE;
-    int first_lv_arg = 1;
-    for (int i=0; i < argc; i++) {
-        if ((g_strcmp0 (argv[i], "-j") == 0) || g_strcmp0 (argv[i], "--json") == 0) {
+    guint64 interval = 0;
+    guint64 count = 0;
+    gboolean count_set = FALSE;
+    LVSpec *specs = g_new0 (LVSpec, argc);
+    guint n_specs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if ((g_strcmp0 (argv[i], "-h") == 0) || g_strcmp0 (argv[i], "--help") == 0) {
+            print_usage (argv[0]);
+            return 1;
+        } else if ((g_strcmp0 (argv[i], "-j") == 0) || g_strcmp0 (argv[i], "--json") == 0) {
             json = TRUE;
-            first_lv_arg++;
+        } else if ((g_strcmp0 (argv[i], "-i") == 0) || g_strcmp0 (argv[i], "--interval") == 0 ||
+                   (g_strcmp0 (argv[i], "-c") == 0) || g_strcmp0 (argv[i], "--count") == 0) {
+            gboolean is_interval = (g_strcmp0 (argv[i], "-i") == 0) || g_strcmp0 (argv[i], "--interval") == 0;
+            gchar *end = NULL;
+            guint64 value = 0;
+
+            if (i + 1 >= argc) {
+                fprintf (stderr, "Option '%s' requires a value!\n", argv[i]);
+                print_usage (argv[0]);
+                return 1;
+            }
+            value = g_ascii_strtoull (argv[i + 1], &end, 10);
+            if (!end || *end != '\0' || value == 0) {
+                fprintf (stderr, "Invalid value for '%s': '%s'\n", argv[i], argv[i + 1]);
+                print_usage (argv[0]);
+                return 1;
+            }
+            if (is_interval)
+                interval = value;
+            else {
+                count = value;
+                count_set = TRUE;
+            }
+            i++;
+        } else {
+            char *slash = strchr (argv[i], '/');
+            if (slash) {
+                *slash = '\0';
+                specs[n_specs].lv_name = slash + 1;
+            }
+            specs[n_specs].vg_name = argv[i];
+            if (strlen (specs[n_specs].vg_name) == 0 || (slash && strlen (specs[n_specs].lv_name) == 0)) {
+                fprintf (stderr, "Invalid LV or VG specified: '%s'. Has to be in the VG/LV or VG format.\n", argv[i]);
+                return 1;
+            }
+            n_specs++;
         }
     }
 
-    if (first_lv_arg >= argc) {
+    if (n_specs == 0) {
         fprintf (stderr, "No cached LV to get the stats for specified!\n");
         print_usage (argv[0]);
         return 1;
     }
 
+    if (!count_set)
+        count = interval ? 0 : 1;
+    else if (count > 1 && interval == 0)
+        /* rates computed from back-to-back samples would make no sense */
+        interval = 1;
+
     /* check that we are runnig as root */
     if ((getuid() != 0) || (geteuid() != 0)) {
         fprintf (stderr, "This utility must be run as root.\n");
@@ -123,33 +339,50 @@ int main (int argc, char *argv[]) {
         return 2;
     }
 
+    /* the LV sizes don't change (often) so only get them once, the stats are
+       then taken from DM only */
+    GHashTable *lv_sizes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    BDLVMLVdata **lvs = bd_lvm_lvs (NULL, &error);
+    if (!lvs) {
+        fprintf (stderr, "Failed to get information about LVs: %s\n", error->message);
+        return 3;
+    }
+    for (BDLVMLVdata **lv_p = lvs; *lv_p; lv_p++) {
+        guint64 *size = g_new (guint64, 1);
+        *size = (*lv_p)->size;
+        g_hash_table_insert (lv_sizes, g_strdup_printf ("%s/%s", (*lv_p)->vg_name, (*lv_p)->lv_name), size);
+        bd_lvm_lvdata_free (*lv_p);
+    }
+    g_free (lvs);
+
+    GHashTable *watched = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) watched_lv_free);
     gboolean ok = TRUE;
-    for (int i = first_lv_arg; i < argc; i++) {
-        /* Add one blank line between stats for the individual LVs */
-        if (i > first_lv_arg)
-            printf("\n");
-
-        char *slash = strchr (argv[i], '/');
-        if (!slash) {
-            fprintf (stderr, "Invalid LV specified: '%s'. Has to be in the VG/LV format.\n", argv[i]);
-            ok = FALSE;
-            continue;
+    gint64 next_sample = g_get_monotonic_time ();
+    for (guint64 n = 0; count == 0 || n < count; n++) {
+        if (n > 0) {
+            gint64 now = g_get_monotonic_time ();
+            next_sample += interval * G_USEC_PER_SEC;
+            if (next_sample > now)
+                g_usleep (next_sample - now);
+            if (!json)
+                printf ("\n");
         }
-        *slash = '\0';
-        const char *vg_name = argv[i];
-        const char *lv_name = slash + 1;
 
-        if (json)
-            ret = print_lv_stats_json (vg_name, lv_name, &error);
-        else
-            ret = print_lv_stats (vg_name, lv_name, &error);
-
-        if (!ret) {
-            fprintf (stderr, "Failed to get stats for '%s/%s': %s\n",
-                     vg_name, lv_name, error->message);
+        if (!sample (specs, n_specs, lv_sizes, watched, json, n, &error)) {
+            if (error) {
+                fprintf (stderr, "Failed to get cache stats: %s\n", error->message);
+                g_clear_error (&error);
+            }
             ok = FALSE;
+            /* nothing to watch */
+            if (n == 0)
+                break;
         }
     }
 
+    g_hash_table_destroy (watched);
+    g_hash_table_destroy (lv_sizes);
+    g_free (specs);
+
     return ok ? 0 : 3;
 }